@@ -35,6 +35,9 @@
 #define __GANDER_ANGLECONVERSION_H__
 
 #include <math.h>
+#include <cstddef>
+
+#include "Gander/Math.h"
 
 namespace Gander
 {
@@ -51,6 +54,67 @@ inline T radiansToDegrees( T r )
 	return r * ( T( 180. ) / T( M_PI ) );
 }
 
+/// Converts an array of angles from degrees to radians.
+/// The conversion is vectorised and large arrays are split across the available hardware threads.
+/// @param degrees A pointer to the n angles to convert.
+/// @param radians A pointer to n values to write the result into. This may be the same as degrees.
+/// @param n The number of angles to convert.
+template< class Real >
+void degreesToRadians( const Real *degrees, Real *radians, std::size_t n );
+
+/// Converts an array of angles from radians to degrees.
+/// The conversion is vectorised and large arrays are split across the available hardware threads.
+/// @param radians A pointer to the n angles to convert.
+/// @param degrees A pointer to n values to write the result into. This may be the same as radians.
+/// @param n The number of angles to convert.
+template< class Real >
+void radiansToDegrees( const Real *radians, Real *degrees, std::size_t n );
+
+/// The array conversions below operate on structures of arrays where each row holds one rotation and each column one of its components.
+/// Euler angles are held as the ( x, y, z ) rotations, in radians, of the matrix Rz * Ry * Rx. Rotation matrices are held as the
+/// elements ( row * 3 + column ), as with the batched givensDecomposeRQ3x3(), and quaternions are held as the ( x, y, z, w ) coefficients
+/// in the same order as Eigen::Quaternion::coeffs(). The kernels are vectorised across rotations and large arrays are split across the
+/// available hardware threads.
+
+/// Converts an array of euler angles into rotation matrices.
+/// @param angles The ( x, y, z ) euler angles to convert.
+/// @param matrices The returned rotation matrices.
+template< class Real >
+void eulerAnglesToRotationMatrices( const Eigen::Array< Real, Eigen::Dynamic, 3 > &angles, Eigen::Array< Real, Eigen::Dynamic, 9 > &matrices );
+
+/// Extracts the euler angles from an array of rotation matrices.
+/// The returned x and z rotations are within [-PI, PI] and the y rotation within [-PI/2, PI/2].
+/// @param matrices The rotation matrices to convert.
+/// @param angles The returned ( x, y, z ) euler angles.
+template< class Real >
+void rotationMatricesToEulerAngles( const Eigen::Array< Real, Eigen::Dynamic, 9 > &matrices, Eigen::Array< Real, Eigen::Dynamic, 3 > &angles );
+
+/// Converts an array of euler angles into unit quaternions.
+/// @param angles The ( x, y, z ) euler angles to convert.
+/// @param quaternions The returned ( x, y, z, w ) quaternion coefficients.
+template< class Real >
+void eulerAnglesToQuaternions( const Eigen::Array< Real, Eigen::Dynamic, 3 > &angles, Eigen::Array< Real, Eigen::Dynamic, 4 > &quaternions );
+
+/// Converts an array of unit quaternions into rotation matrices.
+/// @param quaternions The ( x, y, z, w ) quaternion coefficients to convert.
+/// @param matrices The returned rotation matrices.
+template< class Real >
+void quaternionsToRotationMatrices( const Eigen::Array< Real, Eigen::Dynamic, 4 > &quaternions, Eigen::Array< Real, Eigen::Dynamic, 9 > &matrices );
+
+/// Extracts the euler angles from an array of unit quaternions.
+/// The returned angles are within the same ranges as those returned by rotationMatricesToEulerAngles().
+/// @param quaternions The ( x, y, z, w ) quaternion coefficients to convert.
+/// @param angles The returned ( x, y, z ) euler angles.
+template< class Real >
+void quaternionsToEulerAngles( const Eigen::Array< Real, Eigen::Dynamic, 4 > &quaternions, Eigen::Array< Real, Eigen::Dynamic, 3 > &angles );
+
+/// Converts an array of rotation matrices into unit quaternions.
+/// As q and -q represent the same rotation, the returned quaternions are the ones with a non-negative w coefficient.
+/// @param matrices The rotation matrices to convert.
+/// @param quaternions The returned ( x, y, z, w ) quaternion coefficients.
+template< class Real >
+void rotationMatricesToQuaternions( const Eigen::Array< Real, Eigen::Dynamic, 9 > &matrices, Eigen::Array< Real, Eigen::Dynamic, 4 > &quaternions );
+
 }; // namespace Gander
 
 #endif
@@ -0,0 +1,145 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDER_BOUNDEDQUEUE_H__
+#define __GANDER_BOUNDEDQUEUE_H__
+
+#include <vector>
+#include <cstddef>
+
+#include "Gander/Common.h"
+#include "Gander/Assert.h"
+
+namespace Gander
+{
+
+/// A lock-free queue of a fixed capacity that passes values from one thread to another.
+/// Exactly one thread may call push() and exactly one other thread may call pop(). Neither call blocks: push()
+/// returns false when the queue is full and pop() returns false when it is empty, leaving the caller to decide
+/// how to wait. The queue is a ring buffer whose read and write positions are each only modified by one thread,
+/// so only memory barriers are needed to keep the two threads in step.
+template< class T >
+class BoundedQueue
+{
+	public :
+
+		/// Creates a queue that can hold up to capacity values.
+		BoundedQueue( size_t capacity ) :
+			m_buffer( capacity + 1 ),
+			m_head( 0 ),
+			m_tail( 0 )
+		{
+			GANDER_ASSERT( capacity > 0, "BoundedQueue: The capacity must be greater than 0." );
+		}
+
+		inline size_t capacity() const { return m_buffer.size() - 1; }
+
+		/// Appends a value to the queue. Returns false if the queue is full. Only called by the producing thread.
+		inline bool push( const T &value )
+		{
+			const size_t tail = m_tail;
+			const size_t next = increment( tail );
+			if( next == m_head )
+			{
+				return false;
+			}
+
+			m_buffer[tail] = value;
+			
+			// Make sure that the value is written before the consumer can see it.
+			__sync_synchronize();
+			m_tail = next;
+			return true;
+		}
+
+		/// Removes the value at the front of the queue. Returns false if the queue is empty. Only called by the consuming thread.
+		inline bool pop( T &value )
+		{
+			const size_t head = m_head;
+			if( head == m_tail )
+			{
+				return false;
+			}
+
+			// Make sure that the value isn't read before the producer has finished writing it.
+			__sync_synchronize();
+			value = m_buffer[head];
+
+			// Make sure that the value is read before the producer can reuse its slot.
+			__sync_synchronize();
+			m_head = increment( head );
+			return true;
+		}
+
+		/// Returns true if the queue is empty. This is only a snapshot when the other thread is running.
+		inline bool empty() const
+		{
+			return m_head == m_tail;
+		}
+
+		/// Returns the number of values in the queue. This is only a snapshot when the other thread is running.
+		inline size_t size() const
+		{
+			const size_t head = m_head;
+			const size_t tail = m_tail;
+			return tail >= head ? tail - head : tail + m_buffer.size() - head;
+		}
+
+		/// Removes all of the values. Must not be called while either thread is using the queue.
+		inline void clear()
+		{
+			m_head = m_tail = 0;
+		}
+
+	private :
+
+		inline size_t increment( size_t i ) const
+		{
+			return ++i == m_buffer.size() ? 0 : i;
+		}
+
+		/// One slot is always left empty so that a full queue can be told apart from an empty one.
+		std::vector< T > m_buffer;
+
+		/// The read position, which is only modified by the consumer. It is kept apart from the write position
+		/// so that the two threads don't contend for the same cache line.
+		volatile size_t m_head;
+		char m_padding[64];
+		
+		/// The write position, which is only modified by the producer.
+		volatile size_t m_tail;
+};
+
+}; // namespace Gander
+
+#endif
@@ -48,7 +48,25 @@ namespace Gander
 /// @param Qx The X Givens rotation.
 /// @param Qx The Y Givens rotation.
 /// @param Qx The Z Givens rotation.
-void givensDecomposeRQ3x3( const Eigen::Matrix3d &M, Eigen::Matrix3d &R, Eigen::Matrix3d &Q, Eigen::Matrix3d &Qx, Eigen::Matrix3d &Qy, Eigen::Matrix3d &Qz );
+/// The function is templated on the scalar type of the matrices and is instantiated for both float and double.
+template< class Real >
+void givensDecomposeRQ3x3( const Eigen::Matrix< Real, 3, 3 > &M, Eigen::Matrix< Real, 3, 3 > &R, Eigen::Matrix< Real, 3, 3 > &Q,
+	Eigen::Matrix< Real, 3, 3 > &Qx, Eigen::Matrix< Real, 3, 3 > &Qy, Eigen::Matrix< Real, 3, 3 > &Qz );
+
+/// Performs RQ factorisation on many 3x3 matrices at once using Givens rotations.
+/// The matrices are held in a structure of arrays layout where each row of the array is a matrix and each column
+/// is one of its elements, indexed as ( row * 3 + column ). As Eigen arrays are column major, each element of all of the
+/// matrices is contiguous in memory which allows the decomposition to be computed across several matrices with each SIMD instruction.
+/// The result of each matrix matches that of the single matrix version of givensDecomposeRQ3x3().
+/// @param M The matrices to decompose.
+/// @param R The returned lower triangular matrices.
+/// @param Q The returned orthogonal matrices.
+/// @param Qx An optional pointer to return the X Givens rotations into. Pass NULL to skip building them.
+/// @param Qy An optional pointer to return the Y Givens rotations into. Pass NULL to skip building them.
+/// @param Qz An optional pointer to return the Z Givens rotations into. Pass NULL to skip building them.
+template< class Real >
+void givensDecomposeRQ3x3( const Eigen::Array< Real, Eigen::Dynamic, 9 > &M, Eigen::Array< Real, Eigen::Dynamic, 9 > &R, Eigen::Array< Real, Eigen::Dynamic, 9 > &Q,
+	Eigen::Array< Real, Eigen::Dynamic, 9 > *Qx = NULL, Eigen::Array< Real, Eigen::Dynamic, 9 > *Qy = NULL, Eigen::Array< Real, Eigen::Dynamic, 9 > *Qz = NULL );
 
 }; // namespace Gander
 
@@ -0,0 +1,194 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDER_HALF_H__
+#define __GANDER_HALF_H__
+
+#include <cstddef>
+#include <cstring>
+
+#include "Gander/Common.h"
+
+namespace Gander
+{
+
+/// Returns the bits of the IEEE 754 half precision float that is nearest to f, rounding ties to even.
+/// Values too large to be represented become infinity and NaNs remain NaNs.
+inline int16u floatToHalfBits( float f )
+{
+	int32u x;
+	std::memcpy( &x, &f, sizeof( x ) );
+
+	const int32u sign = ( x >> 16 ) & 0x8000;
+	const int32u absx = x & 0x7fffffff;
+
+	// Infinity and NaN.
+	if( absx >= 0x7f800000 )
+	{
+		return int16u( sign | 0x7c00 | ( absx > 0x7f800000 ? 0x200 | ( ( absx >> 13 ) & 0x3ff ) : 0 ) );
+	}
+
+	// Values of 65520 and above round to infinity.
+	if( absx >= 0x477ff000 )
+	{
+		return int16u( sign | 0x7c00 );
+	}
+
+	// Normalized values.
+	if( absx >= 0x38800000 )
+	{
+		int32u h = ( absx - 0x38000000 ) >> 13;
+		const int32u remainder = absx & 0x1fff;
+		if( remainder > 0x1000 || ( remainder == 0x1000 && ( h & 1 ) ) )
+		{
+			++h;
+		}
+		return int16u( sign | h );
+	}
+
+	// Values of 2^-25 and below round to zero.
+	if( absx <= 0x33000000 )
+	{
+		return int16u( sign );
+	}
+
+	// Subnormal values.
+	const int32u shift = 126 - ( absx >> 23 );
+	const int32u mantissa = ( absx & 0x7fffff ) | 0x800000;
+	int32u h = mantissa >> shift;
+	const int32u remainder = mantissa & ( ( 1u << shift ) - 1 );
+	const int32u halfway = 1u << ( shift - 1 );
+	if( remainder > halfway || ( remainder == halfway && ( h & 1 ) ) )
+	{
+		++h;
+	}
+	return int16u( sign | h );
+}
+
+/// Returns the float that is represented by the bits of an IEEE 754 half precision float.
+/// Every half is exactly representable as a float so the conversion is lossless.
+inline float halfBitsToFloat( int16u h )
+{
+	const int32u sign = int32u( h & 0x8000 ) << 16;
+	const int32u exponent = ( h >> 10 ) & 0x1f;
+	const int32u mantissa = h & 0x3ff;
+
+	if( exponent == 0 )
+	{
+		// Zero and subnormal values are mantissa * 2^-24.
+		const float f = float( mantissa ) * 5.9604644775390625e-8f;
+		return sign ? -f : f;
+	}
+
+	const int32u x = exponent == 0x1f ?
+		sign | 0x7f800000 | ( mantissa << 13 ) :
+		sign | ( ( exponent + 112 ) << 23 ) | ( mantissa << 13 );
+
+	float f;
+	std::memcpy( &f, &x, sizeof( f ) );
+	return f;
+}
+
+/// A 16-bit IEEE 754 half precision floating point type.
+/// The half type is intended as a storage type for channels of an image. It can be used as the type of any of the
+/// layouts and converts to and from float implicitly, so reading and writing channels through channel<C>() converts
+/// transparently. Arithmetic and comparisons are performed by converting to float. Use convertHalfToFloat() and convertFloatToHalf()
+/// to convert whole rows or planes at once.
+class half
+{
+	public :
+
+		inline half() :
+			m_bits( 0 )
+		{
+		}
+
+		inline half( float f ) :
+			m_bits( floatToHalfBits( f ) )
+		{
+		}
+
+		inline half &operator = ( float f )
+		{
+			m_bits = floatToHalfBits( f );
+			return *this;
+		}
+
+		inline operator float() const
+		{
+			return halfBitsToFloat( m_bits );
+		}
+
+		inline half &operator += ( float f ) { return *this = float( *this ) + f; }
+		inline half &operator -= ( float f ) { return *this = float( *this ) - f; }
+		inline half &operator *= ( float f ) { return *this = float( *this ) * f; }
+		inline half &operator /= ( float f ) { return *this = float( *this ) / f; }
+
+		/// Returns the raw bits of the half.
+		inline int16u bits() const
+		{
+			return m_bits;
+		}
+
+		/// Returns a half with the given raw bits.
+		static inline half fromBits( int16u bits )
+		{
+			half h;
+			h.m_bits = bits;
+			return h;
+		}
+
+	private :
+
+		int16u m_bits;
+};
+
+typedef half float16;
+
+/// Converts an array of halfs to floats.
+/// Uses the F16C instructions when the processor supports them and a software conversion otherwise.
+/// @param src A pointer to the n halfs to convert.
+/// @param dst A pointer to n floats to write the result into.
+/// @param n The number of values to convert.
+void convertHalfToFloat( const half *src, float *dst, std::size_t n );
+
+/// Converts an array of floats to halfs, rounding to the nearest even value.
+/// Uses the F16C instructions when the processor supports them and a software conversion otherwise.
+/// @param src A pointer to the n floats to convert.
+/// @param dst A pointer to n halfs to write the result into.
+/// @param n The number of values to convert.
+void convertFloatToHalf( const float *src, half *dst, std::size_t n );
+
+}; // namespace Gander
+
+#endif // __GANDER_HALF_H__
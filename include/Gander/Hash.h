@@ -0,0 +1,118 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDER_HASH_H__
+#define __GANDER_HASH_H__
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <iostream>
+
+#include "Gander/Common.h"
+
+namespace Gander
+{
+
+/// Accumulates a 64 bit hash of a sequence of values.
+/// The hash is built with the FNV-1a algorithm, so appending the same values in the same order always produces
+/// the same hash, on any machine of the same byte order. It is intended for identifying content, such as the
+/// parameters of an image processing graph, and is not suitable for cryptographic use.
+class Hash
+{
+	public :
+
+		inline Hash() :
+			m_value( OffsetBasis )
+		{
+		}
+
+		/// Appends size bytes starting at data to the hash.
+		inline Hash &append( const void *data, size_t size )
+		{
+			const int8u *bytes = static_cast< const int8u * >( data );
+			for( size_t i = 0; i < size; ++i )
+			{
+				m_value = ( m_value ^ bytes[i] ) * Prime;
+			}
+			return *this;
+		}
+
+		/// Appends the bytes of a value that has no padding, such as an integer, float or enum.
+		template< class T >
+		inline Hash &append( const T &value )
+		{
+			return append( &value, sizeof( T ) );
+		}
+		
+		/// Appends the characters of a string, followed by its length so that consecutive strings can't run into each other.
+		inline Hash &append( const char *value )
+		{
+			const size_t size = std::strlen( value );
+			append( value, size );
+			return append( size );
+		}
+
+		inline Hash &append( const std::string &value )
+		{
+			return append( value.c_str() );
+		}
+
+		inline Hash &append( const Hash &hash )
+		{
+			return append( hash.m_value );
+		}
+
+		inline int64u value() const { return m_value; }
+
+		inline bool operator == ( const Hash &rhs ) const { return m_value == rhs.m_value; }
+		inline bool operator != ( const Hash &rhs ) const { return m_value != rhs.m_value; }
+		inline bool operator < ( const Hash &rhs ) const { return m_value < rhs.m_value; }
+
+	private :
+
+		static const int64u OffsetBasis = 14695981039346656037ULL;
+		static const int64u Prime = 1099511628211ULL;
+
+		int64u m_value;
+};
+
+inline std::ostream &operator << ( std::ostream &out, const Hash &h )
+{
+	out << std::hex << h.value() << std::dec;
+	return out;
+}
+
+}; // namespace Gander
+
+#endif
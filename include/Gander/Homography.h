@@ -41,6 +41,10 @@
 namespace Gander
 {
 
+/// All of the functions below are templated on the scalar type of the points and are instantiated for both float and double.
+/// Single precision is faster to score within RANSAC whilst double precision is more accurate. computePlaneToPlaneHomographyMixedPrecision()
+/// combines the two.
+
 /// Builds a homography that transforms a set of 2D points from one to the other.
 /// Two matrices of 4 points must be supplied where each column is a point and each row a component of the point.
 /// The point matrices must be of the same size with each column a pair of corresponding points. E.G: point1.col(x) maps to point2.col(x).
@@ -50,8 +54,39 @@ namespace Gander
 /// @param H The computed homography.
 /// @param reprojectionErrorThreshold The reprojection error below which a point can be classified as an inlier.
 /// @return Whether the homography was successful or not.
-bool computePlaneToPlaneHomography( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, Eigen::MatrixXd &H,
-	std::vector<bool> &mask, double reprojectionErrorThreshold = 1e-5 );
+template< class Real >
+bool computePlaneToPlaneHomography( const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points1, const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points2,
+	Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &H, std::vector<bool> &mask, double reprojectionErrorThreshold = 1e-5 );
+
+/// Builds a homography in the same way as computePlaneToPlaneHomography() but scores the RANSAC hypotheses in single precision.
+/// The result is then refit in double precision by fitting the homography to its inliers with linear least squares and rescoring
+/// all of the points, which is repeated while the consensus set grows. This is the local optimization step of the double precision
+/// version rather than a Levenberg-Marquardt minimization, so the result matches that of the double precision version to within the
+/// accuracy of the least squares fit. refineHomography() can be applied to the inliers afterwards to reduce the error further.
+/// @param points1 The matrix of 2D points in the first image.
+/// @param points2 The matrix of 2D points in the second image.
+/// @param H The computed homography.
+/// @param reprojectionErrorThreshold The reprojection error below which a point can be classified as an inlier.
+/// @param maxRefits The maximum number of double precision refits to perform.
+/// @return Whether the homography was successful or not.
+bool computePlaneToPlaneHomographyMixedPrecision( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, Eigen::MatrixXd &H,
+	std::vector<bool> &mask, double reprojectionErrorThreshold = 1e-5, int maxRefits = 4 );
+
+/// Builds several homographies from a shared set of 2D point correspondences, such as those of multiple planes being tracked in a shot.
+/// Rather than calling computePlaneToPlaneHomography() repeatedly on a shrinking set of points, the homographies are extracted together
+/// using the multi-model RANSAC estimator, which samples and scores the point correspondences only once.
+/// @param points1 The matrix of 2D points in the first image.
+/// @param points2 The matrix of 2D points in the second image.
+/// @param H The computed homographies, ordered by the number of points that they explain.
+/// @param labels Populated with the index of the homography which maps each point correspondence or -1 if it is an outlier of all of them.
+/// @param maxHomographies The maximum number of homographies to extract.
+/// @param reprojectionErrorThreshold The reprojection error below which a point can be classified as an inlier.
+/// @param minInliers The minimum number of point correspondences that a homography must map to be extracted.
+/// @return The number of homographies that were found.
+template< class Real >
+unsigned int computeMultiplePlaneToPlaneHomographies( const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points1,
+	const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points2, std::vector< Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > > &H,
+	std::vector<int> &labels, unsigned int maxHomographies, double reprojectionErrorThreshold = 1e-5, unsigned int minInliers = 8 );
 
 /// Minimizes the error of a homography transform using Levenberg-Merquardt.
 /// The algorithm is intolerant to outliers.
@@ -59,10 +94,14 @@ bool computePlaneToPlaneHomography( const Eigen::MatrixXd &points1, const Eigen:
 /// @param points2 The list of 2D points in the second image.
 /// @param H The input and output homography to refine.
 /// @return Whether the refinement was successful or not.
-bool refineHomography( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, Eigen::MatrixXd &H, int maxIters );
+template< class Real >
+bool refineHomography( const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points1, const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points2,
+	Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &H, int maxIters );
 
 /// Sets 'error' to a list of error metrics, one for each point correspondence and returns the average error.
-double computePlaneToPlaneHomographyError( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, const Eigen::MatrixXd &H, Eigen::VectorXd &error );
+template< class Real >
+double computePlaneToPlaneHomographyError( const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points1, const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points2,
+	const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &H, Eigen::Matrix< Real, Eigen::Dynamic, 1 > &error );
 
 /// Builds a homography that transforms a set of 2D points from one to the other.
 /// Two matrices of 4 points must be supplied where each column is a point and each row a component of the point.
@@ -71,7 +110,20 @@ double computePlaneToPlaneHomographyError( const Eigen::MatrixXd &points1, const
 /// @param points2 The matrix of 2D points in the second image.
 /// @param H The computed homography.
 /// @return Whether the homography was successful or not.
-bool compute4PointPlaneToPlaneHomography( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, Eigen::MatrixXd &H );
+template< class Real >
+bool compute4PointPlaneToPlaneHomography( const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points1, const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points2,
+	Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &H );
+
+/// Builds the homography that best transforms a set of 2D points from one to the other in a linear least squares sense.
+/// Unlike compute4PointPlaneToPlaneHomography(), any number of point correspondences greater than or equal to 4 may be supplied.
+/// The algorithm is intolerant to outliers and is used by the RANSAC estimator to cheaply refit a model to its inliers.
+/// @param points1 The matrix of 2D points in the first image.
+/// @param points2 The matrix of 2D points in the second image.
+/// @param H The computed homography.
+/// @return Whether the homography was successful or not.
+template< class Real >
+bool computeLeastSquaresPlaneToPlaneHomography( const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points1,
+	const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points2, Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &H );
 
 }; // namespace Gander
 
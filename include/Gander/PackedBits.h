@@ -0,0 +1,220 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDER_PACKEDBITS_H__
+#define __GANDER_PACKEDBITS_H__
+
+#include <cstddef>
+
+#include "Gander/Common.h"
+#include "Gander/BitArray.h"
+
+namespace Gander
+{
+
+/// A reference to a WIDTH bit unsigned integer within a stream of packed bits.
+/// Like UnalignedArrayBits, the value is read and written through a proxy, but it is addressed by a byte pointer
+/// and a bit offset rather than an index so that it can address any element in an arbitrarily long row of packed values.
+/// Bits are packed from the least significant bit of each byte, so element i of a row begins at bit i * WIDTH.
+/// The values are contiguous and may straddle bytes, so this is not the packing of formats such as DPX, which fill
+/// each 32 bit word from its most significant bit and may pad the end of the word.
+template< unsigned WIDTH >
+class PackedBitsReference
+{
+	public :
+
+		enum
+		{
+			Mask = ( 1u << WIDTH ) - 1,
+		};
+
+		inline PackedBitsReference( int8u *data, unsigned int bit ) :
+			m_data( data ),
+			m_bit( bit ),
+			m_value( NULL )
+		{
+		}
+		
+		/// Constructs a reference to a value held by itself in an int16u, such as an element of a channel container.
+		/// There are no neighbouring bits to preserve so the value is read and written directly.
+		inline PackedBitsReference( int16u &value ) :
+			m_data( NULL ),
+			m_bit( 0 ),
+			m_value( &value )
+		{
+		}
+
+		inline operator int16u() const
+		{
+			if( m_value )
+			{
+				return int16u( *m_value & Mask );
+			}
+
+			const unsigned int numberOfBytes = ( m_bit + WIDTH + 7 ) >> 3;
+			int32u bits = 0;
+			for( unsigned int i = 0; i < numberOfBytes; ++i )
+			{
+				bits |= int32u( m_data[i] ) << ( 8 * i );
+			}
+			return int16u( ( bits >> m_bit ) & Mask );
+		}
+
+		inline PackedBitsReference &operator = ( int16u value )
+		{
+			if( m_value )
+			{
+				*m_value = int16u( value & Mask );
+				return *this;
+			}
+
+			const unsigned int numberOfBytes = ( m_bit + WIDTH + 7 ) >> 3;
+			const int32u mask = int32u( Mask ) << m_bit;
+			const int32u bits = ( int32u( value ) & Mask ) << m_bit;
+			for( unsigned int i = 0; i < numberOfBytes; ++i )
+			{
+				m_data[i] = int8u( ( m_data[i] & ~( mask >> ( 8 * i ) ) ) | ( bits >> ( 8 * i ) ) );
+			}
+			return *this;
+		}
+		
+		inline PackedBitsReference &operator = ( const PackedBitsReference &rhs )
+		{
+			return *this = int16u( rhs );
+		}
+
+	private :
+
+		int8u *m_data;
+		unsigned int m_bit;
+		int16u *m_value;
+};
+
+/// A pointer to a WIDTH bit unsigned integer within a stream of packed bits.
+/// The pointer is held as a pointer to a byte and the offset of the first bit within it. Arithmetic on the
+/// pointer moves it by whole elements, so it can be used as the PointerType of a layout in the same way as
+/// a pointer to a built in type.
+template< unsigned WIDTH >
+class PackedBitsPointer
+{
+	public :
+
+		typedef PackedBitsReference< WIDTH > ReferenceType;
+
+		inline PackedBitsPointer() :
+			m_data( NULL ),
+			m_bit( 0 )
+		{
+		}
+		
+		/// Constructs a pointer to the element that starts at the given bit offset from data.
+		explicit inline PackedBitsPointer( void *data, std::ptrdiff_t bit = 0 ) :
+			m_data( static_cast< int8u * >( data ) + ( bit >> 3 ) ),
+			m_bit( unsigned( bit & 7 ) )
+		{
+		}
+
+		inline ReferenceType operator * () const { return ReferenceType( m_data, m_bit ); }
+		inline ReferenceType operator [] ( std::ptrdiff_t i ) const { return *( *this + i ); }
+
+		inline PackedBitsPointer operator + ( std::ptrdiff_t i ) const { return PackedBitsPointer( m_data, std::ptrdiff_t( m_bit ) + i * std::ptrdiff_t( WIDTH ) ); }
+		inline PackedBitsPointer operator - ( std::ptrdiff_t i ) const { return *this + ( -i ); }
+		inline PackedBitsPointer &operator += ( std::ptrdiff_t i ) { return *this = *this + i; }
+		inline PackedBitsPointer &operator -= ( std::ptrdiff_t i ) { return *this = *this + ( -i ); }
+		inline PackedBitsPointer &operator ++ () { return *this += 1; }
+		inline PackedBitsPointer &operator -- () { return *this -= 1; }
+
+		inline bool operator == ( const PackedBitsPointer &rhs ) const { return m_data == rhs.m_data && m_bit == rhs.m_bit; }
+		inline bool operator != ( const PackedBitsPointer &rhs ) const { return !( *this == rhs ); }
+		inline bool operator == ( const void *rhs ) const { return m_data == rhs && m_bit == 0; }
+		inline bool operator != ( const void *rhs ) const { return !( *this == rhs ); }
+
+		/// Returns the byte that the element starts in.
+		inline int8u *data() const { return m_data; }
+		
+		/// Returns the offset of the first bit of the element within the byte returned by data().
+		inline unsigned int bit() const { return m_bit; }
+
+	private :
+
+		int8u *m_data;
+		unsigned int m_bit;
+};
+
+/// A channel storage type for unsigned integers which are WIDTH bits wide and packed contiguously in memory, such as
+/// the 10 and 12 bit channels of DPX and Cineon files. Layouts which are templated on PackedBits access their
+/// channels through a PackedBitsPointer and PackedBitsReference. Use unpackBitsToFloat() and packFloatToBits()
+/// to convert whole rows at once.
+template< unsigned WIDTH >
+struct PackedBits
+{
+	enum
+	{
+		Width = WIDTH,
+		MaximumValue = ( 1u << WIDTH ) - 1,
+	};
+};
+
+typedef PackedBits< 10 > packed10;
+typedef PackedBits< 12 > packed12;
+
+/// The TypeTraits of PackedBits. Values are stored in an int16u when they are held by value.
+template< unsigned WIDTH >
+struct TypeTraits< PackedBits< WIDTH > >
+{
+	typedef PackedBits< WIDTH > Type;
+	typedef int16u StorageType;
+	typedef PackedBitsReference< WIDTH > ReferenceType;
+	typedef int16u ConstReferenceType;
+	typedef PackedBitsPointer< WIDTH > PointerType;
+};
+
+/// Unpacks a row of WIDTH bit values to floats, mapping 0 to 0 and the largest value to 1.
+/// The values are unpacked eight at a time using AVX2 when the processor supports it.
+/// @param src A pointer to the first of the n packed values.
+/// @param dst A pointer to n floats to write the result into.
+/// @param n The number of values to unpack.
+template< unsigned WIDTH >
+void unpackBitsToFloat( PackedBitsPointer< WIDTH > src, float *dst, std::size_t n );
+
+/// Packs a row of floats into WIDTH bit values, mapping 0 to 0 and 1 to the largest value.
+/// Values are clamped to the range [0, 1] and rounded to the nearest integer. Bits outside of the packed values are preserved.
+/// @param src A pointer to the n floats to pack.
+/// @param dst A pointer to the first of the n packed values to write.
+/// @param n The number of values to pack.
+template< unsigned WIDTH >
+void packFloatToBits( const float *src, PackedBitsPointer< WIDTH > dst, std::size_t n );
+
+}; // namespace Gander
+
+#endif // __GANDER_PACKEDBITS_H__
@@ -51,16 +51,29 @@ namespace Gander
 /// 5) This procedure is repeated a fixed number of times, each time producing either a model which is rejected because too few points are part of the consensus set, 
 ///    or a refined model together with a corresponding consensus set size. In the latter case, we keep the refined model if its consensus set is larger than the
 ///    previously saved model.
-class RANSAC
+///
+/// Optionally, a local optimization step (LO-RANSAC) can be enabled. Whenever a new best model is found its consensus set is used to refit the
+/// model with a cheap least squares kernel and the inliers are recounted. This is repeated while the consensus set grows. As the refitted model
+/// gives a better estimate of the true inlier ratio, the number of iterations required to reach the desired confidence drops much sooner.
+///
+/// The estimator is templated on the scalar type of the points and models. Scoring the hypotheses in single precision halves the memory
+/// bandwidth of the error computation, which is where most of the time is spent. The RANSAC and RANSACf typedefs are provided for
+/// the double and float versions which are the only two that are instantiated.
+template< class Real = double >
+class RANSACEstimator
 {
 
 public:
+
+	typedef Real RealType;
+	typedef Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > MatrixType;
+	typedef Eigen::Matrix< Real, Eigen::Dynamic, 1 > VectorType;
 	
 	/// Basic constructor.
 	/// @param modelPoints The number of points required by the model. 
 	/// @param maxBasicSolutions The number of models given to test.
-	RANSAC( int modelPoints, int maxBasicSolutions );
-    virtual ~RANSAC();
+	RANSACEstimator( int modelPoints, int maxBasicSolutions );
+    virtual ~RANSACEstimator();
 
 	/// Runs the RANSAC algorithm.
 	/// @param points1 The first matrix of points stored in column major order with each point stored in a row.
@@ -69,14 +82,37 @@ public:
 	/// @param initialMask An optional mask vector which should be the same size as the number of points if used. It should indicate whether a
 	///                    set of points should be considered an inlier. This vector will be populated by the RANSAC algorithm with the resulting inliers.  
 	/// @return Whether the estimator was successful or not.
-	bool operator()( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, Eigen::MatrixXd &model, std::vector<bool> &initialMask );
+	bool operator()( const MatrixType &points1, const MatrixType &points2, MatrixType &model, std::vector<bool> &initialMask );
+	/// Runs a multi-model variant of the RANSAC algorithm which extracts several models from a shared set of points.
+	/// Rather than running the algorithm once per model on a shrinking set of points, a single pool of hypotheses is sampled from all of
+	/// the points and the inliers of each hypothesis are recorded. Models are then extracted greedily from the pool, each time choosing the
+	/// hypothesis which explains the most points that have not yet been claimed by a previous model. Each extracted model is refit to its
+	/// unclaimed inliers (using the local optimization if it is enabled) and refined before its inliers are claimed.
+	/// @param points1 The first matrix of points stored in column major order with each point stored in a row.
+	/// @param points2 The second matrix of points stored in column major order with each point stored in a row.
+	/// @param models The models to be estimated. The vector should be sized to the maximum number of models to extract and each model sized to
+	///               the dimensions of the model. Upon return it is resized to the number of models that were found.
+	/// @param labels Populated with one label per pair of points. It holds the index of the model that the points are an inlier of or -1 if
+	///               the points are an outlier of all of the models.
+	/// @param minInliers The minimum number of inliers that a model requires to be extracted.
+	/// @return The number of models that were found.
+	unsigned int operator()( const MatrixType &points1, const MatrixType &points2, std::vector<MatrixType> &models,
+			std::vector<int> &labels, unsigned int minInliers );
+	/// Refits a model to its inliers using the local optimization step, regardless of whether it is enabled. This can be used to refit
+	/// a model which was estimated elsewhere, such as one estimated by an estimator of a lower precision.
+	/// @param points1 The first matrix of points stored in column major order with each point stored in a row.
+	/// @param points2 The second matrix of points stored in column major order with each point stored in a row.
+	/// @param model The model to refit.
+	/// @param mask Populated with a flag per pair of points indicating whether they are an inlier of the refit model.
+	/// @return The number of inliers of the refit model.
+	int refitToInliers( const MatrixType &points1, const MatrixType &points2, MatrixType &model, std::vector<bool> &mask );
 	/// Derived classes should override this method to refine the result of the computed model and return true if it was successful.
 	/// A common use for this method would be to implement a non-linear minimizer such as Lenvenberg-Marquardt to reduce the error.
 	/// @param points1 The first matrix of points stored in column major order with each point stored in a row.
 	/// @param points2 The second matrix of points stored in column major order with each point stored in a row.
 	/// @param model The model(s) to be refined.
 	/// @param maxIters The maximum number of iterations to perform when minimizing the error of the model.
-    virtual bool refine( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, Eigen::MatrixXd &model, int maxIters ) { return true; }
+    virtual bool refine( const MatrixType &points1, const MatrixType &points2, MatrixType &model, int maxIters ) { return true; }
 	
 	//! @name Parameter Accessors
 	/// The setter and getter methods for the RANSAC algorithm.
@@ -108,6 +144,18 @@ public:
 	/// Returns the threshold that is used to define when the datum (the points) are considered inliers of the model.
 	/// @return The threshold.
     double getThreshold() const { return m_threshold; }
+	/// Enables or disables the local optimization step which refits each new best model to its inliers using runLeastSquaresKernel().
+	/// @param enable Whether to run the local optimization.
+	void setLocalOptimization( bool enable ) { m_localOptimization = enable; }
+	/// Returns whether the local optimization step is enabled.
+	bool getLocalOptimization() const { return m_localOptimization; }
+	/// Sets the maximum number of times that a new best model is refit to its inliers during the local optimization step.
+	/// @param iterations The maximum number of least squares refits.
+	void setMaxLocalOptimizationIterations( int iterations ) { m_maxLocalOptimizationIters = iterations; }
+	/// Returns the maximum number of least squares refits performed during the local optimization step.
+	int getMaxLocalOptimizationIterations() const { return m_maxLocalOptimizationIters; }
+	/// Returns the number of sampling iterations that were performed by the last call to operator().
+	int getIterationsRun() const { return m_iterationsRun; }
 	//@}
 	
 protected:
@@ -121,14 +169,22 @@ protected:
 	/// @param points2 The second matrix of points stored in column major order with each point stored in a row.
 	/// @param model The model to be estimated.
 	/// @return The number of models that were created and stored within 'model'.
-	virtual int runKernel( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, Eigen::MatrixXd &model ) = 0;
+	virtual int runKernel( const MatrixType &points1, const MatrixType &points2, MatrixType &model ) = 0;
 	/// Should be implemented by derived classes to calculate the error of the given model(s) with the set of points. 
 	/// @param points1 The first matrix of points stored in column major order with each point stored in a row.
 	/// @param points2 The second matrix of points stored in column major order with each point stored in a row.
 	/// @param model The model to be tested.
 	/// @param error A vector of error values, one for each pair of points. 
 	/// @return The average error of the model.
-	virtual double computeModelError( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, const Eigen::MatrixXd &model, Eigen::VectorXd &error ) = 0;
+	virtual double computeModelError( const MatrixType &points1, const MatrixType &points2, const MatrixType &model, VectorType &error ) = 0;
+	/// Derived classes can override this method to fit a single model to an arbitrary number of points using a cheap, non-iterative least squares method.
+	/// It is called by the local optimization step with the inliers of each new best model. The default implementation returns false, which
+	/// disables the local optimization.
+	/// @param points1 The first matrix of inlying points stored in column major order with each point stored in a row.
+	/// @param points2 The second matrix of inlying points stored in column major order with each point stored in a row.
+	/// @param model The refit model.
+	/// @return Whether the model was successfully fit.
+	virtual bool runLeastSquaresKernel( const MatrixType &points1, const MatrixType &points2, MatrixType &model ) { return false; }
 	/// Aquires a subset of points at random, checks them for validity and returns them.
 	/// @param points1 The first matrix of points stored in column major order with each point stored in a row from which to sample.
 	/// @param points2 The second matrix of points stored in column major order with each point stored in a row from which to sample.
@@ -136,8 +192,8 @@ protected:
 	/// @param pointsSample2 The second returned subset of points.
 	/// @param maxAttempts The number of tries at acquiring a good sample set before it fails.
 	/// @return Whether the aquisition was successful.
-	virtual bool subset( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, Eigen::MatrixXd &pointsSample1, 
-			Eigen::MatrixXd &pointsSample2, unsigned int maxAttempts = 1000 );
+	virtual bool subset( const MatrixType &points1, const MatrixType &points2, MatrixType &pointsSample1, 
+			MatrixType &pointsSample2, unsigned int maxAttempts = 1000 );
 	/// Returns the number of inliers from the point sets using the specified model. A vector of the errors for each pair of points is also returned
 	/// along with the average error and a vector of masks that indicate whether the corresponding pair of points are inliers or not.
 	/// @param points1 The first matrix of points stored in column major order with each point stored in a row.
@@ -147,8 +203,8 @@ protected:
 	/// @param avgError The average error.
 	/// @param mask A vector of flags, one per pair of points, indicating whether the corresponding pair of points are inliers to the given model.
 	/// @return The number of inliers.
-	virtual int findInliers( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, const Eigen::MatrixXd &model,
-			Eigen::VectorXd &error, double &avgError, std::vector<bool> &mask );
+	virtual int findInliers( const MatrixType &points1, const MatrixType &points2, const MatrixType &model,
+			VectorType &error, double &avgError, std::vector<bool> &mask );
 
 private:
 	
@@ -156,9 +212,16 @@ private:
 	inline int random( int maxValue ) const { return rand() % maxValue; }
 	
 	/// Returns the validity of a chosen set of sample points.
-	virtual bool checkSubset( const Eigen::MatrixXd &pointSamples, unsigned int nSamples );
+	virtual bool checkSubset( const MatrixType &pointSamples, unsigned int nSamples );
 	/// Updates the number of iterations to use.
 	int updateNumberOfIterations( double ep, int max_iters );
+	/// Copies the points which are flagged in the mask into inliers1 and inliers2.
+	void gatherInliers( const MatrixType &points1, const MatrixType &points2, const std::vector<bool> &mask, unsigned int nInliers,
+			MatrixType &inliers1, MatrixType &inliers2 ) const;
+	/// Repeatedly refits the model to its inliers until the consensus set stops growing. The model, error, mask, average error and
+	/// number of inliers are updated in place if a better model was found.
+	void localOptimization( const MatrixType &points1, const MatrixType &points2, MatrixType &model,
+			VectorType &error, double &avgError, std::vector<bool> &mask, int &nInliers );
 
     int m_seed;
     unsigned int m_modelPoints; // The number of points to sample for the model.
@@ -168,9 +231,15 @@ private:
 	int m_maxIters;
 	int m_maxRefineIters;
 	double m_threshold;
+	bool m_localOptimization;
+	int m_maxLocalOptimizationIters;
+	int m_iterationsRun;
 
 };
 
+typedef RANSACEstimator< double > RANSAC;
+typedef RANSACEstimator< float > RANSACf;
+
 }; // namespace Gander
 
 #endif
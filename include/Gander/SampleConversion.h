@@ -0,0 +1,181 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDER_SAMPLECONVERSION_H__
+#define __GANDER_SAMPLECONVERSION_H__
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#include "Gander/Common.h"
+#include "Gander/Half.h"
+
+namespace Gander
+{
+
+/// How a sample is rounded when it is converted to an integer type.
+enum SampleRounding
+{
+	/// Round to the nearest integer, with ties to even.
+	RoundToNearest = 0,
+	
+	/// Add a small amount of noise before rounding to the nearest integer. This breaks up the banding that
+	/// appears when smooth gradients are quantised.
+	RoundWithDither,
+};
+
+/// Describes how samples are converted between the int8u, int16u, half and float types.
+/// When normalised, the full range of an integer type maps to [0, 1] in the floating point types. Otherwise
+/// the values are unchanged. Conversions to an integer type always clamp to its range, with NaNs becoming zero.
+/// A default constructed SampleConversion leaves the values unchanged; pass true to normalise them.
+struct SampleConversion
+{
+	SampleConversion( bool n = false, SampleRounding r = RoundToNearest, unsigned int phase = 0 ) :
+		normalised( n ),
+		rounding( r ),
+		ditherPhase( phase )
+	{
+	}
+
+	bool normalised;
+	SampleRounding rounding;
+	
+	/// The dither noise repeats every DitherPeriod samples. Callers converting many rows should give each a
+	/// different phase so that the noise doesn't line up vertically.
+	unsigned int ditherPhase;
+};
+
+namespace Detail
+{
+
+enum { DitherPeriod = 256 };
+
+/// Returns a table of DitherPeriod + 3 noise values within ( -0.5, 0.5 ), the last three repeating the first three
+/// so that four consecutive values can always be loaded together.
+const float *ditherNoise();
+
+template< class T > struct SampleTraits { enum { IsInteger = 0 }; };
+template<> struct SampleTraits< int8u > { enum { IsInteger = 1, Maximum = 255 }; };
+template<> struct SampleTraits< int16u > { enum { IsInteger = 1, Maximum = 65535 }; };
+
+template< class T, bool IsInteger = SampleTraits< T >::IsInteger >
+struct SampleToFloat
+{
+	static inline float apply( T s, const SampleConversion &conversion )
+	{
+		return float( s );
+	}
+};
+
+template< class T >
+struct SampleToFloat< T, true >
+{
+	static inline float apply( T s, const SampleConversion &conversion )
+	{
+		return conversion.normalised ? float( s ) * ( 1.f / float( SampleTraits< T >::Maximum ) ) : float( s );
+	}
+};
+
+template< class T, bool IsInteger = SampleTraits< T >::IsInteger >
+struct SampleFromFloat
+{
+	static inline T apply( float f, const SampleConversion &conversion, unsigned int index )
+	{
+		return T( f );
+	}
+};
+
+template< class T >
+struct SampleFromFloat< T, true >
+{
+	static inline T apply( float f, const SampleConversion &conversion, unsigned int index )
+	{
+		const float maximum = float( SampleTraits< T >::Maximum );
+		float x = conversion.normalised ? f * maximum : f;
+		if( conversion.rounding == RoundWithDither )
+		{
+			x += ditherNoise()[ ( conversion.ditherPhase + index ) % DitherPeriod ];
+		}
+		x = x > 0.f ? ( x < maximum ? x : maximum ) : 0.f;
+		return T( lrintf( x ) );
+	}
+};
+
+template< class D, class S >
+struct ConvertSample
+{
+	static inline D apply( S s, const SampleConversion &conversion, unsigned int index )
+	{
+		return SampleFromFloat< D >::apply( SampleToFloat< S >::apply( s, conversion ), conversion, index );
+	}
+};
+
+/// Converting a type to itself is always exact.
+template< class T >
+struct ConvertSample< T, T >
+{
+	static inline T apply( T s, const SampleConversion &conversion, unsigned int index )
+	{
+		return s;
+	}
+};
+
+}; // namespace Detail
+
+/// Returns true if T is one of the types that the sample conversions support.
+template< class T > struct IsConvertibleSample { enum { Value = 0 }; };
+template<> struct IsConvertibleSample< int8u > { enum { Value = 1 }; };
+template<> struct IsConvertibleSample< int16u > { enum { Value = 1 }; };
+template<> struct IsConvertibleSample< half > { enum { Value = 1 }; };
+template<> struct IsConvertibleSample< float > { enum { Value = 1 }; };
+
+/// Converts a single sample. The index is the position of the sample within its row and selects the dither noise.
+template< class D, class S >
+inline D convertSample( S s, const SampleConversion &conversion, unsigned int index = 0 )
+{
+	return Detail::ConvertSample< D, S >::apply( s, conversion, index );
+}
+
+/// Converts an array of samples between any two of the int8u, int16u, half and float types.
+/// The conversion is vectorised and matches convertSample() exactly.
+/// @param src A pointer to the n samples to convert.
+/// @param dst A pointer to n samples to write the result into.
+/// @param n The number of samples to convert.
+/// @param conversion How the samples are scaled and rounded.
+template< class S, class D >
+void convertSamples( const S *src, D *dst, std::size_t n, const SampleConversion &conversion = SampleConversion() );
+
+}; // namespace Gander
+
+#endif // __GANDER_SAMPLECONVERSION_H__
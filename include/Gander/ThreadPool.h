@@ -0,0 +1,132 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDER_THREADPOOL_H__
+#define __GANDER_THREADPOOL_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include "boost/bind.hpp"
+#include "boost/function.hpp"
+#include "boost/noncopyable.hpp"
+#include "boost/thread.hpp"
+
+namespace Gander
+{
+
+/// A pool of threads which are kept between calls to run(), so that code which splits its work between threads
+/// doesn't create and destroy them each time. Every task that is passed to run() gets a thread of its own. Idle
+/// threads are taken from the pool and new ones are only created when there aren't enough of them. This means
+/// that tasks may wait on each other, as the stages of a pipeline do, and that a task may call run() itself.
+class ThreadPool : boost::noncopyable
+{
+	public :
+
+		typedef boost::function< void () > Task;
+
+		ThreadPool();
+		
+		/// Stops and joins the threads of the pool. Must not be called while run() is running.
+		~ThreadPool();
+
+		/// Returns the pool that is shared by the whole process.
+		static ThreadPool &global();
+
+		/// Returns the number of hardware threads, or 1 if it is unknown.
+		static unsigned int hardwareConcurrency();
+
+		/// Runs the tasks concurrently and returns once they have all finished. The first task is run on the calling
+		/// thread. If any of the tasks throw, the message of the first exception is thrown as a std::runtime_error
+		/// after the others have finished.
+		void run( const std::vector< Task > &tasks );
+
+		/// Returns the number of threads that the pool has created.
+		unsigned int numberOfThreads() const;
+
+	private :
+
+		struct Batch;
+
+		struct Job
+		{
+			Task task;
+			Batch *batch;
+		};
+
+		void work();
+
+		boost::mutex m_mutex;
+		boost::condition_variable m_jobQueued;
+		std::deque< Job > m_jobs;
+
+		/// The number of threads that aren't running a task. There are always at least as many as there are jobs.
+		std::size_t m_availableThreads;
+		bool m_stopping;
+		boost::thread_group m_threads;
+};
+
+/// The number of elements, such as samples or pixels, that are worth handing to a thread of their own.
+enum { MinimumElementsPerThread = 1 << 15 };
+
+/// Calls kernel( begin, end ) for contiguous blocks of the range [0, n). The blocks are processed concurrently
+/// by up to numberOfThreads threads from the global pool, or by the number of hardware threads if numberOfThreads
+/// is 0. Each block holds at least minimumBlockSize elements, so small ranges are processed on the calling thread.
+template< class Kernel >
+void parallelFor( std::size_t n, const Kernel &kernel, std::size_t minimumBlockSize = MinimumElementsPerThread, unsigned int numberOfThreads = 0 )
+{
+	const std::size_t maxBlocks = numberOfThreads == 0 ? ThreadPool::hardwareConcurrency() : numberOfThreads;
+	const std::size_t nBlocks = std::min( maxBlocks, n / std::max< std::size_t >( minimumBlockSize, 1 ) );
+	if( nBlocks <= 1 )
+	{
+		if( n != 0 )
+		{
+			kernel( 0, n );
+		}
+		return;
+	}
+
+	const std::size_t blockSize = ( n + nBlocks - 1 ) / nBlocks;
+	std::vector< ThreadPool::Task > tasks;
+	for( std::size_t begin = 0; begin < n; begin += blockSize )
+	{
+		tasks.push_back( boost::bind< void >( kernel, begin, std::min( begin + blockSize, n ) ) );
+	}
+	ThreadPool::global().run( tasks );
+}
+
+}; // namespace Gander
+
+#endif
@@ -36,6 +36,8 @@
 
 #include <iostream>
 #include <stdexcept>
+#include <algorithm>
+#include <cstring>
 
 #include "boost/format.hpp"
 
@@ -48,7 +50,7 @@ namespace Gander
 {
 
 /// A simple wrapper class for defining either a static or dynamic array of data elements.
-/// The Tuple class wraps up either a C-Style array or a std::vector to provide a uniform interface to both.
+/// The Tuple class wraps up either a C-Style array or a growable array to provide a uniform interface to both.
 /// The class takes the data type as the first template argument, the number of elements for the second
 /// and a flag that indicates whether the tuple is dynamic or not for the third.
 template< class T, unsigned NumberOfElements = 1, bool IS_DYNAMIC = true >
@@ -129,6 +131,10 @@ struct Tuple< T, NumberOfElements, false >
 };
 
 /// The dynamic Tuple.
+/// Elements are held in a buffer inside the tuple itself until more elements are required than
+/// it can hold, at which point they are moved to the heap. This means that small tuples, such as
+/// those that hold the channels of a pixel, can be created and copied without allocating.
+/// The inline buffer holds NumberOfElements elements, or MinimumInlineElements if that is greater.
 template< class T, unsigned NumberOfElements >
 struct Tuple< T, NumberOfElements, true >
 {
@@ -140,69 +146,206 @@ struct Tuple< T, NumberOfElements, true >
 		typedef StorageType *PointerType;
 
 		/// iterator Type Declarations 	
-		typedef typename std::vector< StorageType >::const_iterator const_iterator;
-		typedef typename std::vector< StorageType >::iterator iterator;
+		typedef const StorageType * const_iterator;
+		typedef StorageType * iterator;
+
+		enum
+		{
+			MinimumInlineElements = 4,
+			InlineElements = NumberOfElements > unsigned( MinimumInlineElements ) ? NumberOfElements : unsigned( MinimumInlineElements )
+		};
 	
 		/// Default constructor	
 		Tuple() :
-			m_data( NumberOfElements )
-		{}
+			m_data( m_inline ),
+			m_size( 0 ),
+			m_capacity( InlineElements )
+		{
+			resize( NumberOfElements );
+		}
 		
 		Tuple( unsigned int numberOfElements ) :
-			m_data( numberOfElements )
-		{}
+			m_data( m_inline ),
+			m_size( 0 ),
+			m_capacity( InlineElements )
+		{
+			resize( numberOfElements );
+		}
+
+		Tuple( const Tuple &other ) :
+			m_data( m_inline ),
+			m_size( 0 ),
+			m_capacity( InlineElements )
+		{
+			reserve( other.m_size );
+			std::copy( other.m_data, other.m_data + other.m_size, m_data );
+			m_size = other.m_size;
+		}
+
+		/// Takes the elements of other, leaving it empty. Elements that other holds on the heap are taken without being copied.
+		Tuple( Tuple &&other ) :
+			m_data( m_inline ),
+			m_size( 0 ),
+			m_capacity( InlineElements )
+		{
+			take( other );
+		}
+
+		~Tuple()
+		{
+			if( m_data != m_inline )
+			{
+				delete [] m_data;
+			}
+		}
+
+		Tuple &operator = ( const Tuple &other )
+		{
+			if( this != &other )
+			{
+				reserve( other.m_size );
+				std::copy( other.m_data, other.m_data + other.m_size, m_data );
+				m_size = other.m_size;
+			}
+			return *this;
+		}
+
+		Tuple &operator = ( Tuple &&other )
+		{
+			if( this != &other )
+			{
+				if( m_data != m_inline )
+				{
+					delete [] m_data;
+				}
+				m_data = m_inline;
+				m_capacity = InlineElements;
+				take( other );
+			}
+			return *this;
+		}
 
 		inline ReferenceType operator[] ( unsigned int i ) { return m_data[i]; };
 		inline ConstReferenceType operator[] ( unsigned int i ) const { return m_data[i]; };
 		
 		inline unsigned int size() const
 		{
-			return m_data.size();
+			return m_size;
+		};
+
+		/// Returns the number of elements that can be held before the tuple needs to reallocate.
+		inline unsigned int capacity() const
+		{
+			return m_capacity;
 		};
+
+		/// Ensures that the tuple can hold at least size elements without reallocating.
+		inline void reserve( unsigned int size )
+		{
+			if( size <= m_capacity )
+			{
+				return;
+			}
+
+			unsigned int capacity = std::max( size, m_capacity * 2 );
+			StorageType *data = new StorageType[ capacity ];
+			std::copy( m_data, m_data + m_size, data );
+			
+			if( m_data != m_inline )
+			{
+				delete [] m_data;
+			}
+
+			m_data = data;
+			m_capacity = capacity;
+		}
 		
 		inline void resize( unsigned int size )
 		{
-			m_data.resize( size );
+			reserve( size );
+			if( size > m_size )
+			{
+				std::fill( m_data + m_size, m_data + size, StorageType() );
+			}
+			m_size = size;
 		}
 		
+		/// Sets every element to zero, as it does for the static Tuple. Unlike std::vector::clear(), the size is unchanged.
 		inline void clear()
 		{
-			m_data.resize( size(), 0 );
+			std::fill( m_data, m_data + m_size, StorageType( 0 ) );
 		}
 
 		inline const_iterator begin() const
 		{
-			return m_data.begin();
+			return m_data;
 		};
 		
 		inline iterator begin()
 		{
-			return m_data.begin();
+			return m_data;
 		};
 
 		inline const_iterator end() const
 		{
-			return m_data.end();
+			return m_data + m_size;
+		};
+		
+		inline iterator end()
+		{
+			return m_data + m_size;
 		};
 
 		inline void push_back( const StorageType &val )
 		{
-			return m_data.push_back( val );
+			insert( end(), val );
 		}
 		
 		inline iterator insert( iterator it, const StorageType &val )
 		{
-			return m_data.insert( it, val );
+			// Take copies of the index and the value before reserving as either may refer into the old buffer.
+			unsigned int index = it - m_data;
+			StorageType value( val );
+
+			reserve( m_size + 1 );
+			std::copy_backward( m_data + index, m_data + m_size, m_data + m_size + 1 );
+			m_data[index] = value;
+			++m_size;
+			
+			return m_data + index;
 		}
 
 		inline iterator erase( iterator it )
 		{
-			return m_data.erase( it );
+			std::copy( it + 1, m_data + m_size, it );
+			--m_size;
+			return it;
 		}
 
 	private :
 
-		std::vector< StorageType > m_data;
+		/// Takes the elements of other, which must not be this tuple, into this empty, inline tuple.
+		inline void take( Tuple &other )
+		{
+			if( other.m_data != other.m_inline )
+			{
+				m_data = other.m_data;
+				m_capacity = other.m_capacity;
+				other.m_data = other.m_inline;
+				other.m_capacity = InlineElements;
+			}
+			else
+			{
+				std::copy( other.m_data, other.m_data + other.m_size, m_data );
+			}
+			m_size = other.m_size;
+			other.m_size = 0;
+		}
+
+		StorageType *m_data;
+		unsigned int m_size;
+		unsigned int m_capacity;
+		StorageType m_inline[ InlineElements ];
 };
 
 }; // namespace Gander
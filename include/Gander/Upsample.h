@@ -0,0 +1,64 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDER_UPSAMPLE_H__
+#define __GANDER_UPSAMPLE_H__
+
+#include <cstddef>
+
+#include "Gander/Common.h"
+
+namespace Gander
+{
+
+/// Upsamples a row of subsampled values by repeating each of them ratio times.
+/// This reconstructs a full resolution row from a horizontally subsampled channel, such as the chroma of a 4:2:2 image.
+/// @param src A pointer to the ( width + ratio - 1 ) / ratio subsampled values.
+/// @param dst A pointer to width floats to write the result into.
+/// @param width The number of values in the full resolution row.
+/// @param ratio The number of full resolution values that share each subsampled value.
+void upsampleNearest( const float *src, float *dst, std::size_t width, unsigned int ratio );
+
+/// Upsamples a row of subsampled values by linearly interpolating between them.
+/// Each subsampled value is taken to lie at the centre of the ratio full resolution values that it covers and
+/// the values at either end of the row are held. For a ratio of two this is the usual 3:1 weighting of the neighbouring
+/// chroma samples.
+/// @param src A pointer to the ( width + ratio - 1 ) / ratio subsampled values.
+/// @param dst A pointer to width floats to write the result into.
+/// @param width The number of values in the full resolution row.
+/// @param ratio The number of full resolution values that share each subsampled value.
+void upsampleLinear( const float *src, float *dst, std::size_t width, unsigned int ratio );
+
+}; // namespace Gander
+
+#endif
@@ -0,0 +1,141 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDERIMAGE_BOX__
+#define __GANDERIMAGE_BOX__
+
+#include <algorithm>
+#include <iostream>
+
+#include "Gander/Common.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+/// A rectangular region of pixels.
+/// The box includes the pixels from (x, y) up to but not including (r, t), so an empty box is one where r <= x or t <= y.
+class Box
+{
+	public :
+
+		/// Creates an empty box.
+		inline Box() :
+			m_x( 0 ), m_y( 0 ), m_r( 0 ), m_t( 0 )
+		{
+		}
+		
+		inline Box( int32 x, int32 y, int32 r, int32 t ) :
+			m_x( x ), m_y( y ), m_r( r ), m_t( t )
+		{
+		}
+
+		inline int32 x() const { return m_x; }
+		inline int32 y() const { return m_y; }
+		inline int32 r() const { return m_r; }
+		inline int32 t() const { return m_t; }
+
+		inline int32 width() const { return isEmpty() ? 0 : m_r - m_x; }
+		inline int32 height() const { return isEmpty() ? 0 : m_t - m_y; }
+		inline bool isEmpty() const { return m_r <= m_x || m_t <= m_y; }
+
+		inline bool contains( int32 x, int32 y ) const
+		{
+			return x >= m_x && x < m_r && y >= m_y && y < m_t;
+		}
+		
+		inline bool contains( const Box &b ) const
+		{
+			return b.isEmpty() || ( b.m_x >= m_x && b.m_r <= m_r && b.m_y >= m_y && b.m_t <= m_t );
+		}
+
+		/// Returns the region that is covered by both boxes.
+		inline Box intersection( const Box &b ) const
+		{
+			Box result( std::max( m_x, b.m_x ), std::max( m_y, b.m_y ), std::min( m_r, b.m_r ), std::min( m_t, b.m_t ) );
+			return result.isEmpty() ? Box() : result;
+		}
+
+		/// Returns the smallest box that contains both boxes.
+		inline Box merge( const Box &b ) const
+		{
+			if( isEmpty() )
+			{
+				return b;
+			}
+
+			if( b.isEmpty() )
+			{
+				return *this;
+			}
+
+			return Box( std::min( m_x, b.m_x ), std::min( m_y, b.m_y ), std::max( m_r, b.m_r ), std::max( m_t, b.m_t ) );
+		}
+
+		/// Returns the box grown by dx pixels on the left and right and dy pixels on the top and bottom.
+		inline Box padded( int32 dx, int32 dy ) const
+		{
+			return isEmpty() ? Box() : Box( m_x - dx, m_y - dy, m_r + dx, m_t + dy );
+		}
+
+		inline bool operator == ( const Box &b ) const
+		{
+			return ( isEmpty() && b.isEmpty() ) || ( m_x == b.m_x && m_y == b.m_y && m_r == b.m_r && m_t == b.m_t );
+		}
+		
+		inline bool operator != ( const Box &b ) const
+		{
+			return !( *this == b );
+		}
+
+	private :
+
+		int32 m_x;
+		int32 m_y;
+		int32 m_r;
+		int32 m_t;
+};
+
+inline std::ostream &operator << ( std::ostream &out, const Box &b )
+{
+	out << "(" << b.x() << ", " << b.y() << ") - (" << b.r() << ", " << b.t() << ")";
+	return out;
+}
+
+}; // namespace Image
+
+}; // namespace Gander
+
+#endif
@@ -67,6 +67,7 @@ struct BrothersLayout : public StaticLayoutBase< BrothersLayout< T, B >, T >
 			NumberOfChannels = BrotherTraits<B>::NumberOfBrothers,
 			ChannelMask = BrotherTraits<B>::BrothersMask,
 			NumberOfChannelPointers = 1,
+			ChannelPointerStep = BrotherTraits<B>::NumberOfBrothers,
 		};
 
 		typedef BrothersLayout< T, B > Type;
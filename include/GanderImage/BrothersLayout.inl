@@ -44,7 +44,7 @@ inline void BrothersLayout< T, B >::increment( ChannelPointerContainerType &cont
 	typename ChannelPointerContainerType::iterator it( container.begin() );
 	for( ; it != container.end(); ++it )
 	{
-		*it += BrotherTraits<B>::NumberOfBrothers;
+		*it += v * ChannelPointerStep;
 	}
 }
 
@@ -54,7 +54,7 @@ inline void BrothersLayout< T, B >::decrement( ChannelPointerContainerType &cont
 	typename ChannelPointerContainerType::iterator it( container.begin() );
 	for( ; it != container.end(); ++it )
 	{
-		*it -= BrotherTraits<B>::NumberOfBrothers;
+		*it -= v * ChannelPointerStep;
 	}
 }
 
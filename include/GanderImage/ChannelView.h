@@ -0,0 +1,187 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDERIMAGE_CHANNELVIEW__
+#define __GANDERIMAGE_CHANNELVIEW__
+
+#include <type_traits>
+#include <iostream>
+#include <stdexcept>
+
+#include "Gander/Assert.h"
+#include "Gander/Common.h"
+#include "Gander/EnumHelper.h"
+
+#include "GanderImage/StaticAssert.h"
+#include "GanderImage/Channel.h"
+#include "GanderImage/ForEach.h"
+#include "GanderImage/ChannelOps.h"
+#include "GanderImage/PixelIterator.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+namespace Detail
+{
+
+/// Describes the subset of a layout's channels that are visible through a ChannelView.
+/// Only the members that are required by forEachChannel() and the ChannelView are declared.
+template< class Layout, EnumType Mask >
+struct ChannelViewLayout
+{
+	enum
+	{
+		ChannelMask = EnumType( Layout::ChannelMask ) & Mask,
+		IsDynamic = Layout::IsDynamic,
+	};
+	
+	template< ChannelDefault C = Chan_None, bool DisableStaticAsserts = false >
+	struct ChannelTraits : public Layout::template ChannelTraits< C, DisableStaticAsserts >
+	{
+	};
+};
+
+}; // namespace Detail
+
+/// A view of a compile time subset of the channels of a pixel.
+/// The ChannelView refers to the pixel that it was created from rather than copying it, so a view of an iterator
+/// shares the iterator's channel pointers and follows it as it is incremented. Channels that aren't in the Mask
+/// can't be accessed through the view and are ignored by forEachChannel(), so ops that only touch some of the
+/// channels of an image can be run against it without building an iterator of a different layout.
+/// Views are created with the view() function.
+template< class Pixel, EnumType Mask >
+class ChannelView
+{
+	public :
+
+		typedef ChannelView< Pixel, Mask > Type;
+		typedef Detail::ChannelViewLayout< typename Pixel::LayoutType, Mask > LayoutType;
+		typedef Pixel PixelType;
+
+		template< ChannelDefault C, bool DisableStaticAsserts = false >
+		struct ChannelTraits : public LayoutType::template ChannelTraits< C, DisableStaticAsserts >
+		{
+			typedef typename std::conditional<
+				std::is_const< Pixel >::value,
+				typename LayoutType::template ChannelTraits< C, DisableStaticAsserts >::ConstReferenceType,
+				typename LayoutType::template ChannelTraits< C, DisableStaticAsserts >::ReferenceType
+			>::type ReferenceType;
+		};
+
+		inline explicit ChannelView( Pixel &pixel ) :
+			m_pixel( &pixel )
+		{
+		}
+
+		/// Returns the channels of the pixel that are visible through the view.
+		inline ChannelSet channels() const
+		{
+			ChannelSet c( m_pixel->channels() );
+			c &= ChannelSet( Gander::Image::ChannelMask( Mask ) );
+			return c;
+		}
+
+		inline unsigned int numberOfChannels() const { return channels().size(); }
+		inline bool isDynamic() const { return m_pixel->isDynamic(); }
+		
+		/// Returns the channel C of the pixel. C must be in the view's Mask.
+		/// As forEachChannel() instantiates this method for every channel when the layout is dynamic, the mask
+		/// is checked at runtime. The check is resolved at compile time and costs nothing when C is in the Mask.
+		template< ChannelDefault C >
+		inline typename ChannelTraits< C, true >::ReferenceType channel() const
+		{
+			GANDER_ASSERT( ( Mask & ChannelToMask< C >::Value ) != 0, "Channel is not visible through the view." );
+			return m_pixel->template channel< C >();
+		}
+
+		/// Copies the channels that are visible through the view from another pixel or view.
+		template< class T >
+		inline const ChannelView &operator = ( const T &rhs )
+		{
+			forEachChannel( *this, rhs, Copy() );
+			return *this;
+		}
+
+		/// Returns true if all of the channels visible through both views are equal.
+		template< class T >
+		inline bool operator == ( const T &rhs ) const
+		{
+			IsEqual op;
+			forEachChannel( *this, rhs, op );
+			return op.value();
+		}
+		
+		template< class T >
+		inline bool operator != ( const T &rhs ) const
+		{
+			return !( *this == rhs );
+		}
+
+	private :
+
+		Pixel *m_pixel;
+};
+
+/// Returns a view of the channels of a pixel that are in Mask.
+template< EnumType Mask, class Layout >
+inline ChannelView< PixelAccessor< Layout >, Mask > view( PixelIterator< Layout > &it )
+{
+	return ChannelView< PixelAccessor< Layout >, Mask >( *it );
+}
+
+template< EnumType Mask, class Layout >
+inline ChannelView< const PixelAccessor< Layout >, Mask > view( const ConstPixelIterator< Layout > &it )
+{
+	return ChannelView< const PixelAccessor< Layout >, Mask >( *it );
+}
+
+template< EnumType Mask, class Layout >
+inline ChannelView< Gander::Image::Pixel< Layout >, Mask > view( Gander::Image::Pixel< Layout > &pixel )
+{
+	return ChannelView< Gander::Image::Pixel< Layout >, Mask >( pixel );
+}
+
+template< EnumType Mask, class Layout >
+inline ChannelView< const Gander::Image::Pixel< Layout >, Mask > view( const Gander::Image::Pixel< Layout > &pixel )
+{
+	return ChannelView< const Gander::Image::Pixel< Layout >, Mask >( pixel );
+}
+
+}; // namespace Image
+
+}; // namespace Gander
+
+#endif
@@ -55,7 +55,7 @@ namespace Image
 {
 
 /// An empty struct for use as a default template argument to the CompoundLayout class.
-namespace Detail { struct None { struct LayoutTraits { }; enum { ChannelMask = 0, IsDynamic = false }; }; };
+namespace Detail { struct None { struct LayoutTraits { }; enum { ChannelMask = 0, IsDynamic = false, IsConstant = false }; }; };
 
 /// Forward declaration of the CompoundLayout class.
 template<
@@ -303,38 +303,8 @@ struct CompoundLayoutRecurse< Derived, false, None, None, None, None, None, None
 			IsDynamic = false,
 		};
 
-		/// Increments all channel pointers in the container by v.
-		template< class CompoundChannelPointerContainer >
-		inline void increment( CompoundChannelPointerContainer &container, int v )
-		{
-		}
-		
-		/// Decrements all channel pointers in the container by v.
-		template< class CompoundChannelPointerContainer >
-		inline void decrement( CompoundChannelPointerContainer &container, int v )
-		{
-		}
-
 	protected :
-		
-		template< unsigned Index, bool DisableStaticAsserts = false, class ReturnType = typename BaseType::template LayoutTraits< Index, DisableStaticAsserts >::LayoutType >
-		inline ReturnType &child()
-		{
-			GANDER_ASSERT( 0, "The requested layout does not exist at the given index" );
-
-			static typename BaseType::template LayoutTraits< Index, DisableStaticAsserts > l; // We never get here but we still have to return something to keep the compiler happy.
-			return ( ReturnType & ) l;
-		}
-		
-		template< unsigned Index, bool DisableStaticAsserts = false, class ReturnType = typename BaseType::template LayoutTraits< Index, DisableStaticAsserts >::LayoutType >
-		inline const ReturnType &child() const
-		{
-			GANDER_ASSERT( 0, "The requested layout does not exist at the given index" );
 
-			static typename BaseType::template LayoutTraits< Index, DisableStaticAsserts > l; // We never get here but we still have to return something to keep the compiler happy.
-			return ( const ReturnType & ) l;
-		}
-		
 		/// Returns the number of channels that this layout represents.
 		inline unsigned int _numberOfChannels() const
 		{
@@ -388,20 +358,6 @@ struct CompoundLayoutRecurse< Derived, true, T0, None, None, None, None, None, N
 		}
 		//@}
 	
-		/// Increments all channel pointers in the container by v.
-		template< class CompoundChannelPointerContainer >
-		inline void increment( CompoundChannelPointerContainer &container, int v )
-		{
-			m_dynamicLayout.increment( container.template child< CompoundChannelPointerContainer::LayoutType::NumberOfLayouts - Iteration >(), v );
-		}
-		
-		/// Decrements all channel pointers in the container by v.
-		template< class CompoundChannelPointerContainer >
-		inline void decrement( CompoundChannelPointerContainer &container, int v )
-		{
-			m_dynamicLayout.decrement( container.template child< CompoundChannelPointerContainer::LayoutType::NumberOfLayouts - Iteration >(), v );
-		}
-
 	protected :	
 
 		template< unsigned Index, bool DisableStaticAsserts = false, class ReturnType = typename BaseType::template LayoutTraits< Index, DisableStaticAsserts >::LayoutType >
@@ -469,48 +425,40 @@ struct CompoundLayoutRecurse : public CompoundLayoutRecurse< Derived, IS_DYNAMIC
 		// Assert that the any dynamic layouts are the last argument.			
 		GANDER_IMAGE_STATIC_ASSERT( !T0::IsDynamic, ONLY_ONE_DYNAMIC_LAYOUT_MUST_BE_SPECIFED_AS_THE_LAST_TEMPLATE_ARGUMENT );
 
-		/// Increments all channel pointers in the container by v.
-		template< class CompoundChannelPointerContainer >
-		inline void increment( CompoundChannelPointerContainer &container, int v )
-		{
-			m_layout.increment( container.template child< CompoundChannelPointerContainer::LayoutType::NumberOfLayouts - Iteration >(), v );
-			BaseType::template increment< CompoundChannelPointerContainer >( container, v );
-		}
-		
-		/// Decrements all channel pointers in the container by v.
-		template< class CompoundChannelPointerContainer >
-		inline void decrement( CompoundChannelPointerContainer &container, int v )
-		{
-			m_layout.decrement( container.template child< CompoundChannelPointerContainer::LayoutType::NumberOfLayouts - Iteration >(), v );
-			BaseType::template decrement< CompoundChannelPointerContainer >( container, v );
-		}
-
+		/// Returns the child layout at the given index. The recursion is resolved at compile time and ends at
+		/// the last layout, so every child is a member of this instance. Indices which are out of bounds can only
+		/// be requested from code paths which are never executed and are resolved to the last layout.
 		template< unsigned Index, bool DisableStaticAsserts = false, class ReturnType = typename BaseType::template LayoutTraits< Index, DisableStaticAsserts >::LayoutType >
 		inline ReturnType &child()
 		{
-			if( std::is_same< ReturnType, T0 >::value )
-			{
-				return ( ReturnType & ) m_layout;
-			}
-			else
-			{
-				return ( ReturnType & ) BaseType::template child< Index, DisableStaticAsserts, ReturnType >();
-			}
+			return _child< Index, DisableStaticAsserts, ReturnType >(
+				std::integral_constant< bool, EnumType( Index ) == EnumType( Derived::NumberOfLayouts - Iteration ) || Iteration == 1 >()
+			);
 		}
 
 		template< unsigned Index, bool DisableStaticAsserts = false, class ReturnType = typename BaseType::template LayoutTraits< Index, DisableStaticAsserts >::LayoutType >
 		inline const ReturnType &child() const
 		{
-			if( std::is_same< ReturnType, T0 >::value )
-			{
-				return ( const ReturnType & ) m_layout;
-			}
-			else
-			{
-				return ( const ReturnType & ) BaseType::template child< Index, DisableStaticAsserts, ReturnType >();
-			}
+			return const_cast< CompoundLayoutRecurse * >( this )->template child< Index, DisableStaticAsserts, ReturnType >();
 		}
 
+	private :
+
+		template< unsigned Index, bool DisableStaticAsserts, class ReturnType >
+		inline ReturnType &_child( std::true_type )
+		{
+			GANDER_ASSERT( ( EnumType( Index ) == EnumType( Derived::NumberOfLayouts - Iteration ) ), "The requested layout does not exist at the given index" );
+			return ( ReturnType & ) m_layout;
+		}
+		
+		template< unsigned Index, bool DisableStaticAsserts, class ReturnType >
+		inline ReturnType &_child( std::false_type )
+		{
+			return ( ReturnType & ) BaseType::template child< Index, DisableStaticAsserts, ReturnType >();
+		}
+
+	protected :
+
 		T0 m_layout;
 };
 
@@ -534,7 +482,7 @@ struct CompoundLayout : public Detail::CompoundLayoutRecurse<
 		T0, T1, T2, T3, T4, T5, T6, T7
 	> BaseType;
 	
-	typedef CompoundLayout< T0, T1, T2, T3, T4, T6, T7 > Type;
+	typedef CompoundLayout< T0, T1, T2, T3, T4, T5, T6, T7 > Type;
 
 	enum
 	{
@@ -542,24 +490,33 @@ struct CompoundLayout : public Detail::CompoundLayoutRecurse<
 		NumberOfLayouts = BaseType::Iteration,
 		NumberOfChannels = BaseType::NumberOfChannels,
 		ChannelMask = BaseType::ChannelMask,
-		IsDynamic = BaseType::IsDynamic
+		IsDynamic = BaseType::IsDynamic,
+		// The channels of the static child layouts that are constant.
+		ConstantChannelMask =
+			( T0::IsConstant ? T0::ChannelMask : 0 ) | ( T1::IsConstant ? T1::ChannelMask : 0 ) | ( T2::IsConstant ? T2::ChannelMask : 0 ) |
+			( T3::IsConstant ? T3::ChannelMask : 0 ) | ( T4::IsConstant ? T4::ChannelMask : 0 ) | ( T5::IsConstant ? T5::ChannelMask : 0 ) |
+			( T6::IsConstant ? T6::ChannelMask : 0 ) | ( T7::IsConstant ? T7::ChannelMask : 0 )
 	};
 
 	public :
 		
 		typedef typename Gander::Image::Detail::CompoundLayoutContainer< Type, Gander::Image::Detail::ChannelContainer >  ChannelContainerType;
-		typedef typename Gander::Image::Detail::CompoundLayoutContainer< Type, Gander::Image::Detail::ChannelPointerContainer >  ChannelPointerContainerType;
+		typedef typename Gander::Image::Detail::CompoundLayoutContainer<
+			Type, Gander::Image::Detail::ChannelPointerContainer, Detail::HasBuiltInChannelPointers< T0, T1, T2, T3, T4, T5, T6, T7 >::Value
+		> ChannelPointerContainerType;
 
 		/// Increments all channel pointers in the container by v.
+		/// The channel pointers of the static child layouts are held in a single flattened array by the container
+		/// so they are all advanced together rather than by each child in turn.
 		inline void increment( ChannelPointerContainerType &container, int v )
 		{
-			BaseType::template increment< ChannelPointerContainerType >( container, v );
+			container.increment( *this, v );
 		}
 		
 		/// Decrements all channel pointers in the container by v.
 		inline void decrement( ChannelPointerContainerType &container, int v )
 		{
-			BaseType::template decrement< ChannelPointerContainerType >( container, v );
+			container.decrement( *this, v );
 		}
 		
 		template< unsigned Index, bool DisableStaticAsserts = true >
@@ -591,7 +548,7 @@ struct CompoundLayout : public Detail::CompoundLayoutRecurse<
 			
 			GANDER_ASSERT( ( std::is_same< ConstReferenceType, typename LayoutType::ConstReferenceType >::value ), "Incorrect return type specified." );
 	
-			return ( ConstReferenceType & ) child< ChildIndex, true >().template channel< ContainerType, C >( container.template child< ChildIndex >() );
+			return ( ConstReferenceType ) child< ChildIndex, true >().template channel< ContainerType, C >( container.template child< ChildIndex >() );
 		}
 
 		template<
@@ -611,7 +568,7 @@ struct CompoundLayout : public Detail::CompoundLayoutRecurse<
 			
 			GANDER_ASSERT( ( std::is_same< ReferenceType, typename LayoutType::ReferenceType >::value ), "Incorrect return type specified." );
 	
-			return ( ReferenceType & ) child< ChildIndex, true >().template channel< ContainerType, C >( container.template child< ChildIndex >() );
+			return ( ReferenceType ) child< ChildIndex, true >().template channel< ContainerType, C >( container.template child< ChildIndex >() );
 		}
 		
 		template<
@@ -632,7 +589,7 @@ struct CompoundLayout : public Detail::CompoundLayoutRecurse<
 			
 			GANDER_ASSERT( ( std::is_same< ReferenceType, typename LayoutType::ReferenceType >::value ), "Incorrect return type specified." );
 	
-			return ( ReferenceType & ) child< ChildIndex, true >().template channel< ContainerType, C >( container.template child< ChildIndex >() );
+			return ( ReferenceType ) child< ChildIndex, true >().template channel< ContainerType, C >( container.template child< ChildIndex >() );
 		}
 		
 		template<
@@ -653,7 +610,7 @@ struct CompoundLayout : public Detail::CompoundLayoutRecurse<
 			
 			GANDER_ASSERT( ( std::is_same< ConstReferenceType, typename LayoutType::ConstReferenceType >::value ), "Incorrect return type specified." );
 	
-			return ( ConstReferenceType & ) child< ChildIndex, true >().template channel< ContainerType, C >( container.template child< ChildIndex >() );
+			return ( ConstReferenceType ) child< ChildIndex, true >().template channel< ContainerType, C >( container.template child< ChildIndex >() );
 		}
 
 		template<
@@ -675,7 +632,7 @@ struct CompoundLayout : public Detail::CompoundLayoutRecurse<
 			
 			GANDER_ASSERT( ( std::is_same< ConstReferenceType, typename LayoutType::ConstReferenceType >::value ), "Incorrect return type specified." );
 	
-			return ( ConstReferenceType & ) child< ChildIndex, true >().template channelAtIndex< ContainerType, ChannelIndexInLayout, Mask >( container.template child< ChildIndex >() );
+			return ( ConstReferenceType ) child< ChildIndex, true >().template channelAtIndex< ContainerType, ChannelIndexInLayout, Mask >( container.template child< ChildIndex >() );
 		}
 		
 		template<
@@ -697,7 +654,7 @@ struct CompoundLayout : public Detail::CompoundLayoutRecurse<
 			
 			GANDER_ASSERT( ( std::is_same< ReferenceType, typename LayoutType::ReferenceType >::value ), "Incorrect return type specified." );
 	
-			return ( ReferenceType & ) child< ChildIndex, true >().template channelAtIndex< ContainerType, ChannelIndexInLayout, Mask >( container.template child< ChildIndex >() );
+			return ( ReferenceType ) child< ChildIndex, true >().template channelAtIndex< ContainerType, ChannelIndexInLayout, Mask >( container.template child< ChildIndex >() );
 		}
 		
 		template<
@@ -719,7 +676,7 @@ struct CompoundLayout : public Detail::CompoundLayoutRecurse<
 			
 			GANDER_ASSERT( ( std::is_same< ReferenceType, typename LayoutType::ReferenceType >::value ), "Incorrect return type specified." );
 	
-			return ( ReferenceType & ) child< ChildIndex, true >().template channelAtIndex< ContainerType, ChannelIndexInLayout, Mask >( container.template child< ChildIndex >() );
+			return ( ReferenceType ) child< ChildIndex, true >().template channelAtIndex< ContainerType, ChannelIndexInLayout, Mask >( container.template child< ChildIndex >() );
 		}
 		
 		template<
@@ -741,7 +698,7 @@ struct CompoundLayout : public Detail::CompoundLayoutRecurse<
 			
 			GANDER_ASSERT( ( std::is_same< ConstReferenceType, typename LayoutType::ConstReferenceType >::value ), "Incorrect return type specified." );
 	
-			return ( ConstReferenceType & ) child< ChildIndex, true >().template channelAtIndex< ContainerType, ChannelIndexInLayout, Mask >( container.template child< ChildIndex >() );
+			return ( ConstReferenceType ) child< ChildIndex, true >().template channelAtIndex< ContainerType, ChannelIndexInLayout, Mask >( container.template child< ChildIndex >() );
 		}
 	
 		template<
@@ -821,34 +778,34 @@ struct CompoundLayout : public Detail::CompoundLayoutRecurse<
 			switch( channel )
 			{
 				case( 1 ) :
-					setChannelPointer< ChannelDefault( 1 ), true >( container, reinterpret_cast< typename BaseType::template ChannelTraits< ChannelDefault( 1 ), true >::PointerType& >( pointer ) );
+					_setChannelPointer< ChannelDefault( 1 ) >( container, pointer );
 					break;
 				case( 2 ) :
-					setChannelPointer< ChannelDefault( 2 ), true >( container, reinterpret_cast< typename BaseType::template ChannelTraits< ChannelDefault( 2 ), true >::PointerType& >( pointer ) );
+					_setChannelPointer< ChannelDefault( 2 ) >( container, pointer );
 					break;
 				case( 3 ) :
-					setChannelPointer< ChannelDefault( 3 ), true >( container, reinterpret_cast< typename BaseType::template ChannelTraits< ChannelDefault( 3 ), true >::PointerType& >( pointer ) );
+					_setChannelPointer< ChannelDefault( 3 ) >( container, pointer );
 					break;
 				case( 4 ) :
-					setChannelPointer< ChannelDefault( 4 ), true >( container, reinterpret_cast< typename BaseType::template ChannelTraits< ChannelDefault( 4 ), true >::PointerType& >( pointer ) );
+					_setChannelPointer< ChannelDefault( 4 ) >( container, pointer );
 					break;
 				case( 5 ) :
-					setChannelPointer< ChannelDefault( 5 ), true >( container, reinterpret_cast< typename BaseType::template ChannelTraits< ChannelDefault( 5 ), true >::PointerType& >( pointer ) );
+					_setChannelPointer< ChannelDefault( 5 ) >( container, pointer );
 					break;
 				case( 6 ) :
-					setChannelPointer< ChannelDefault( 6 ), true >( container, reinterpret_cast< typename BaseType::template ChannelTraits< ChannelDefault( 6 ), true >::PointerType& >( pointer ) );
+					_setChannelPointer< ChannelDefault( 6 ) >( container, pointer );
 					break;
 				case( 7 ) :
-					setChannelPointer< ChannelDefault( 7 ), true >( container, reinterpret_cast< typename BaseType::template ChannelTraits< ChannelDefault( 7 ), true >::PointerType& >( pointer ) );
+					_setChannelPointer< ChannelDefault( 7 ) >( container, pointer );
 					break;
 				case( 8 ) :
-					setChannelPointer< ChannelDefault( 8 ), true >( container, reinterpret_cast< typename BaseType::template ChannelTraits< ChannelDefault( 8 ), true >::PointerType& >( pointer ) );
+					_setChannelPointer< ChannelDefault( 8 ) >( container, pointer );
 					break;
 				case( 9 ) :
-					setChannelPointer< ChannelDefault( 9 ), true >( container, reinterpret_cast< typename BaseType::template ChannelTraits< ChannelDefault( 9 ), true >::PointerType& >( pointer ) );
+					_setChannelPointer< ChannelDefault( 9 ) >( container, pointer );
 					break;
 				case( 10 ) :
-					setChannelPointer< ChannelDefault( 10 ), true >( container, reinterpret_cast< typename BaseType::template ChannelTraits< ChannelDefault( 10 ), true >::PointerType& >( pointer ) );
+					_setChannelPointer< ChannelDefault( 10 ) >( container, pointer );
 					break;
 				default : GANDER_ASSERT( 0, "Channel does not exist in the CompoundLayout." ); break;
 			}
@@ -891,10 +848,52 @@ struct CompoundLayout : public Detail::CompoundLayoutRecurse<
 			}
 		}
 
+		/// Adds channels that have the same value for every pixel to the DynamicLayout of the compound layout.
+		template< class ContainerType >	
+		inline void addConstantChannels( ContainerType &container, ChannelSet c )
+		{
+			if( IsDynamic )
+			{
+				GANDER_ASSERT(
+					( BaseType::channels().intersection( c ).size() == 0 ),
+					( boost::format( "CompoundLayout: Channels \"%s\" cannot be added as some of the channels are already represented by the layout." ) % c ).str()
+				);
+				
+				child< NumberOfLayouts-1, true >().template addConstantChannels< typename ContainerType::template ChildTraitsAtIndex< NumberOfLayouts - 1 >::ContainerType >(
+					container.template child< NumberOfLayouts - 1 >(), c
+				);
+			}
+			else
+			{
+				GANDER_ASSERT( 0, "Channels can only be added at a CompoundLayout that contains a DynamicLayout." );
+			}
+		}
+
+		/// Returns the channels that have the same value for every pixel, whether they are held by a ConstantChannelLayout
+		/// or were added to the DynamicLayout with addConstantChannels().
+		inline ChannelSet constantChannels() const
+		{
+			ChannelSet result( static_cast< Gander::Image::ChannelMask >( ConstantChannelMask ) );
+			if( IsDynamic )
+			{
+				result += child< NumberOfLayouts-1, true >().constantChannels();
+			}
+			return result;
+		}
+
 	private :
 
 		friend class LayoutBase< Type >;	
 
+		/// Converts the pointer to the PointerType of the layout that holds the channel C and sets it.
+		template< ChannelDefault C >
+		inline void _setChannelPointer( ChannelPointerContainerType &container, void *pointer )
+		{
+			typedef typename BaseType::template ChannelTraits< C, true >::PointerType PointerType;
+			PointerType p( static_cast< PointerType >( pointer ) );
+			setChannelPointer< C, true >( container, p );
+		}
+
 		/// Returns a ChannelSet of the channels that pointers are required for in order
 		/// to access all of the channels in this layout.
 		inline ChannelSet _requiredChannels() const
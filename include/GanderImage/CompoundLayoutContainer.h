@@ -37,6 +37,7 @@
 #include <type_traits>
 #include <iostream>
 #include <stdexcept>
+#include <cstddef>
 
 #include "boost/format.hpp"
 
@@ -58,6 +59,8 @@ namespace Image
 namespace Detail
 {
 
+struct None;
+
 typedef enum
 {
 	ChannelContainer,
@@ -67,7 +70,42 @@ typedef enum
 template< class CompoundLayout, EnumType N, ContainerName Container >
 struct CompoundLayoutContainerRecurse;
 
-template< class CompoundLayout, ContainerName Container >
+/// Declares Value as true if each of the layouts access their channels through pointers to a built in type
+/// which are held in a Tuple and advance by a fixed step for every pixel. The channel pointers of such layouts
+/// can be held in a single flattened array and advanced together.
+template<
+	class T0 = None, class T1 = None, class T2 = None, class T3 = None,
+	class T4 = None, class T5 = None, class T6 = None, class T7 = None
+> struct HasBuiltInChannelPointers
+{
+	enum
+	{
+		Value = HasBuiltInChannelPointers< T0 >::Value && HasBuiltInChannelPointers< T1, T2, T3, T4, T5, T6, T7 >::Value,
+	};
+};
+
+template< class T >
+struct HasBuiltInChannelPointers< T, None, None, None, None, None, None, None >
+{
+	enum
+	{
+		Value = T::IsDynamic || (
+			std::is_pointer< typename T::PointerType >::value &&
+			std::is_base_of< Gander::Tuple< typename T::PointerType, T::NumberOfChannelPointers, false >, typename T::ChannelPointerContainerType >::value
+		),
+	};
+};
+
+template<>
+struct HasBuiltInChannelPointers< None, None, None, None, None, None, None, None >
+{
+	enum
+	{
+		Value = true,
+	};
+};
+
+template< class CompoundLayout, ContainerName Container, bool IsFlattened = false >
 struct CompoundLayoutContainer;
 
 template< class CompoundLayout, ContainerName Container >
@@ -84,29 +122,11 @@ struct CompoundLayoutContainerRecurse< CompoundLayout, 0, Container >
 			return 0;
 		}
 		
-		template< class ReturnType, EnumType Index >
-		inline ReturnType &child()
-		{
-			GANDER_ASSERT( Index >= 0 || Index < CompoundLayout::NumberOfLayouts, "Index is out of bounds." );
-
-			// We never get here but we still need to return something to appease the compiler. So...
-			static typename ReturnType::LayoutType layout; // Create an instance of a layout.
-			static ReturnType r( layout ); // Initialize the container with it.
-			return r; // Return it.
-		};
-		
-		template< class ReturnType, EnumType Index >
-		inline const ReturnType &child() const
+		inline void _addChannels( ChannelSet c, ChannelBrothers b = Brothers_None )
 		{
-			GANDER_ASSERT( Index >= 0 || Index < CompoundLayout::NumberOfLayouts, "Index is out of bounds." );
-
-			// We never get here but we still need to return something to appease the compiler. So...
-			static typename ReturnType::LayoutType layout; // Create an instance of a layout.
-			static ReturnType r( layout ); // Initialize the container with it.
-			return r; // Return it.
-		};
+		}
 		
-		inline void _addChannels( ChannelSet c, ChannelBrothers b = Brothers_None )
+		inline void _increment( CompoundLayout &layout, int v )
 		{
 		}
 };
@@ -135,7 +155,7 @@ struct CompoundLayoutContainerRecurse : public CompoundLayoutContainerRecurse< C
 	
 		inline CompoundLayoutContainerRecurse( CompoundLayout &layout ) :
 			BaseType( layout ),
-			m_container( layout.child< LayoutIndex >() )
+			m_container( layout.template child< LayoutIndex >() )
 		{
 		}
 		
@@ -144,6 +164,13 @@ struct CompoundLayoutContainerRecurse : public CompoundLayoutContainerRecurse< C
 			return m_container.size() + BaseType::size();
 		}
 
+		/// Increments the channel pointers of each of the child layouts by v.
+		inline void _increment( CompoundLayout &layout, int v )
+		{
+			layout.template child< LayoutIndex >().increment( m_container, v );
+			BaseType::_increment( layout, v );
+		}
+
 		inline void _addChannels( CompoundLayout &layout, ChannelSet c, ChannelBrothers b = Brothers_None )
 		{
 			if( !LayoutType::IsDynamic )
@@ -156,39 +183,42 @@ struct CompoundLayoutContainerRecurse : public CompoundLayoutContainerRecurse< C
 			}
 		}
 		
+		/// Returns the container of the child layout at the given index. The recursion is resolved at compile time
+		/// and ends at the container of the last layout, so no instance of a container is ever shared between
+		/// CompoundLayoutContainers. Indices which are out of bounds can only be requested from code paths which are
+		/// never executed and are resolved to the last container.
 		template< class ReturnType, EnumType Index >
 		inline ReturnType &child()
 		{
-			if( Index == LayoutIndex )
-			{
-				return ( ReturnType & ) m_container;
-			}
-			else
-			{
-				return BaseType::template child< ReturnType, Index >();
-			}
+			return _child< ReturnType, Index >( std::integral_constant< bool, Index == LayoutIndex || N == 1 >() );
 		};
 
 		template< class ReturnType, EnumType Index >
 		inline const ReturnType &child() const
 		{
-			if( Index == LayoutIndex )
-			{
-				return ( const ReturnType & ) m_container;
-			}
-			else
-			{
-				return BaseType::template child< ReturnType, Index >();
-			}
+			return const_cast< Type * >( this )->template child< ReturnType, Index >();
 		};
 
 	private :
 
+		template< class ReturnType, EnumType Index >
+		inline ReturnType &_child( std::true_type )
+		{
+			GANDER_ASSERT( Index == LayoutIndex, "Index is out of bounds." );
+			return ( ReturnType & ) m_container;
+		}
+		
+		template< class ReturnType, EnumType Index >
+		inline ReturnType &_child( std::false_type )
+		{
+			return BaseType::template child< ReturnType, Index >();
+		}
+
 		ContainerType m_container;
 		
 };
 
-template< class CompoundLayout, ContainerName Container >
+template< class CompoundLayout, ContainerName Container, bool IsFlattened >
 class CompoundLayoutContainer : public Gander::Image::Detail::CompoundLayoutContainerRecurse< CompoundLayout, CompoundLayout::NumberOfLayouts, Container >
 {
 	private :
@@ -251,6 +281,221 @@ class CompoundLayoutContainer : public Gander::Image::Detail::CompoundLayoutCont
 		{
 			BaseType::_addChannels( c, b );
 		}
+		
+		/// Increments all channel pointers in the container by v.
+		inline void increment( CompoundLayout &layout, int v )
+		{
+			BaseType::_increment( layout, v );
+		}
+		
+		/// Decrements all channel pointers in the container by v.
+		inline void decrement( CompoundLayout &layout, int v )
+		{
+			BaseType::_increment( layout, -v );
+		}
+
+};
+
+/// Holds the channel pointer containers of the first N child layouts of a compound layout as typed members.
+/// The containers of the earlier layouts are held by the base class which precedes the member of the derived class,
+/// so as each container is an array of pointers to a built in type, the pointers of all of the children are contiguous.
+template< class CompoundLayout, EnumType N >
+struct StaticChannelPointerContainers : public StaticChannelPointerContainers< CompoundLayout, N - 1 >
+{
+	public :
+
+		typedef StaticChannelPointerContainers< CompoundLayout, N - 1 > BaseType;
+		typedef typename CompoundLayout::template LayoutTraits< N - 1, true >::LayoutType LayoutType;
+		typedef typename LayoutType::ChannelPointerContainerType ContainerType;
+
+		inline StaticChannelPointerContainers( CompoundLayout &layout ) :
+			BaseType( layout ),
+			m_container( layout.template child< N - 1 >() )
+		{
+			for( unsigned int i = 0; i < LayoutType::NumberOfChannelPointers; ++i )
+			{
+				m_container[i] = NULL;
+			}
+		}
+
+		/// Returns the container of the child layout at the given index. Indices which are out of bounds can only be
+		/// requested from code paths which are never executed and are resolved to the last container.
+		template< class ReturnType, EnumType Index >
+		inline ReturnType &container()
+		{
+			return _container< ReturnType, Index >( std::integral_constant< bool, Index >= N - 1 >() );
+		}
+
+		/// Advances the channel pointers of each of the child layouts by v pixels. The number of pointers and their
+		/// steps are known at compile time so this unrolls into a sequence of adds rather than a call to the
+		/// increment() method of each child.
+		inline void increment( int v )
+		{
+			BaseType::increment( v );
+			for( unsigned int i = 0; i < LayoutType::NumberOfChannelPointers; ++i )
+			{
+				m_container[i] += std::ptrdiff_t( LayoutType::ChannelPointerStep ) * v;
+			}
+		}
+
+	private :
+
+		template< class ReturnType, EnumType Index >
+		inline ReturnType &_container( std::true_type )
+		{
+			GANDER_ASSERT( Index == N - 1, "Index is out of bounds." );
+			return ( ReturnType & ) m_container;
+		}
+
+		template< class ReturnType, EnumType Index >
+		inline ReturnType &_container( std::false_type )
+		{
+			return BaseType::template container< ReturnType, Index >();
+		}
+
+		ContainerType m_container;
+
+};
+
+template< class CompoundLayout >
+struct StaticChannelPointerContainers< CompoundLayout, 0 >
+{
+	public :
+
+		inline StaticChannelPointerContainers( CompoundLayout &layout )
+		{
+		}
+
+		inline void increment( int v )
+		{
+		}
+
+};
+
+/// Stands in for the container of the dynamic child layout when the compound layout has none.
+struct NoDynamicChannelPointerContainer
+{
+	template< class Layout >
+	inline NoDynamicChannelPointerContainer( const Layout &layout )
+	{
+	}
+
+	inline unsigned int size() const
+	{
+		return 0;
+	}
+};
+
+/// The specialization of the CompoundLayoutContainer for channel pointers to built in types.
+/// The containers of all of the static child layouts are held contiguously by a StaticChannelPointerContainers and
+/// their pointers are advanced together by adding the compile time step of each layout, rather than by a call to the
+/// increment() method of each child. The channel pointers of the dynamic layout (if any) are only known at runtime so
+/// they are held in their own container.
+template< class CompoundLayout >
+class CompoundLayoutContainer< CompoundLayout, ChannelPointerContainer, true >
+{
+	private :
+
+		enum
+		{
+			NumberOfLayouts = CompoundLayout::NumberOfLayouts,
+			IsDynamic = CompoundLayout::IsDynamic,
+			NumberOfStaticLayouts = IsDynamic ? NumberOfLayouts - 1 : NumberOfLayouts,
+		};
+
+		typedef typename std::conditional< IsDynamic,
+			typename CompoundLayout::template LayoutTraits< NumberOfLayouts - 1, true >::LayoutType::ChannelPointerContainerType,
+			NoDynamicChannelPointerContainer
+		>::type DynamicContainerType;
+
+	public :
+	
+		typedef CompoundLayout LayoutType;
+			
+		template< EnumType Index >
+		struct ChildTraitsAtIndex
+		{
+			typedef typename CompoundLayout::template LayoutTraits< Index, true >::LayoutType::ChannelPointerContainerType ContainerType;
+		};
+	
+		inline CompoundLayoutContainer( CompoundLayout &layout ) :
+			m_staticContainers( layout ),
+			m_dynamicContainer( layout.template child< NumberOfLayouts - 1 >() )
+		{
+		}
+		
+		template< EnumType Index >
+		inline typename ChildTraitsAtIndex< Index >::ContainerType &child()
+		{
+			return _child< Index >( std::integral_constant< bool, IsDynamic && Index >= NumberOfLayouts - 1 >() );
+		};
+
+		template< EnumType Index >
+		inline const typename ChildTraitsAtIndex< Index >::ContainerType &child() const
+		{
+			return const_cast< CompoundLayoutContainer * >( this )->template child< Index >();
+		};
+
+		inline unsigned int size() const
+		{
+			return static_cast< unsigned int >( CompoundLayout::NumberOfChannelPointers ) + m_dynamicContainer.size();
+		}
+
+		template< EnumType Index, ChannelMask Mask = Mask_All, bool DisableStaticAsserts = false, class ChannelType = typename CompoundLayout::template ChannelTraitsAtIndex< Index, Mask >::StorageType >
+		inline ChannelType &channelAtIndex( CompoundLayout &layout )
+		{
+			enum
+			{
+				ChildIndex = CompoundLayout::template ChannelTraitsAtIndex< Index, Mask, DisableStaticAsserts >::LayoutIndex,
+				ChannelIndexInLayout = CompoundLayout::template ChannelTraitsAtIndex< Index, Mask, DisableStaticAsserts >::ChannelIndexInLayout,
+			};
+			
+			GANDER_ASSERT(
+				( std::is_same< ChannelType, typename CompoundLayout::template ChannelTraitsAtIndex< Index, Mask, DisableStaticAsserts >::StorageType >::value ),
+				"Incorrect return type specified."
+			);
+		
+			return ( ChannelType & ) child< ChildIndex >().template channelAtIndex< ChannelIndexInLayout, Mask, DisableStaticAsserts >();
+		}
+
+		/// Increments all channel pointers in the container by v.
+		inline void increment( CompoundLayout &layout, int v )
+		{
+			m_staticContainers.increment( v );
+			_incrementDynamic( layout, v, std::integral_constant< bool, IsDynamic >() );
+		}
+		
+		/// Decrements all channel pointers in the container by v.
+		inline void decrement( CompoundLayout &layout, int v )
+		{
+			increment( layout, -v );
+		}
+
+	private :
+
+		template< EnumType Index >
+		inline typename ChildTraitsAtIndex< Index >::ContainerType &_child( std::false_type )
+		{
+			return m_staticContainers.template container< typename ChildTraitsAtIndex< Index >::ContainerType, Index >();
+		}
+		
+		template< EnumType Index >
+		inline typename ChildTraitsAtIndex< Index >::ContainerType &_child( std::true_type )
+		{
+			return ( typename ChildTraitsAtIndex< Index >::ContainerType & ) m_dynamicContainer;
+		}
+
+		inline void _incrementDynamic( CompoundLayout &layout, int v, std::false_type )
+		{
+		}
+		
+		inline void _incrementDynamic( CompoundLayout &layout, int v, std::true_type )
+		{
+			layout.template child< NumberOfLayouts - 1 >().increment( m_dynamicContainer, v );
+		}
+
+		StaticChannelPointerContainers< CompoundLayout, NumberOfStaticLayouts > m_staticContainers __attribute__(( aligned( 16 ) ));
+		DynamicContainerType m_dynamicContainer;
 
 };
 
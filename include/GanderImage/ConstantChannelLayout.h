@@ -0,0 +1,207 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDERIMAGE_CONSTANTCHANNELLAYOUT__
+#define __GANDERIMAGE_CONSTANTCHANNELLAYOUT__
+
+#include <type_traits>
+#include <iostream>
+#include <stdexcept>
+
+#include "Gander/Common.h"
+#include "Gander/Assert.h"
+#include "Gander/StaticAssert.h"
+#include "Gander/Tuple.h"
+
+#include "GanderImage/StaticAssert.h"
+#include "GanderImage/StaticLayoutBase.h"
+#include "GanderImage/Channel.h"
+#include "GanderImage/ChannelBrothers.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+/// The value of a channel that is the same for every pixel in an image.
+/// ConstantChannel is the channel type of the ConstantChannelLayout. It converts implicitly to T so that it
+/// can be read like any other channel, but as it is a distinct type, functors that are passed to forEachChannel()
+/// can provide an overload for it in order to handle constant channels differently. For example, an op that
+/// premultiplies by alpha can skip the multiplication when alpha is a constant of 1.
+template< class T >
+struct ConstantChannel
+{
+	public :
+	
+		typedef T Type;
+
+		inline ConstantChannel( T value = T( 0 ) ) : m_value( value ) {}
+
+		inline operator T () const { return m_value; }
+		inline T value() const { return m_value; }
+
+	private :
+
+		T m_value;
+};
+
+}; // namespace Image
+
+/// Constant channels are read only and have no storage that can be pointed to.
+template< class T >
+struct TypeTraits< Image::ConstantChannel< T > >
+{
+	typedef Image::ConstantChannel< T > Type;
+	typedef Image::ConstantChannel< T > StorageType;
+	typedef const Image::ConstantChannel< T > &ReferenceType;
+	typedef const Image::ConstantChannel< T > &ConstReferenceType;
+	typedef const Image::ConstantChannel< T > *PointerType;
+};
+
+namespace Image
+{
+
+/// A layout of a single channel that has the same value for every pixel.
+/// The value is held by the layout rather than in memory, so the layout requires no channel pointers and
+/// is not stepped as a PixelIterator moves. Use it for channels such as an alpha that is exactly one or a
+/// mask that is exactly zero across the image. The channel is read only; its value is set with setValue().
+template< class T, ChannelDefault S >
+struct ConstantChannelLayout : public StaticLayoutBase< ConstantChannelLayout< T, S >, ConstantChannel< T > >
+{
+
+	public :
+
+		enum
+		{
+			NumberOfChannels = 1,
+			ChannelMask = ChannelToMask<S>::Value,
+			NumberOfChannelPointers = 0,
+			IsConstant = true,
+		};
+		
+		typedef ConstantChannelLayout< T, S > Type;
+		typedef Type LayoutType;
+		typedef StaticLayoutBase< Type, ConstantChannel< T > > BaseType;
+		typedef typename BaseType::StorageType ChannelType;
+		typedef typename BaseType::StorageType StorageType;
+		typedef typename BaseType::PointerType PointerType;
+		typedef typename BaseType::ReferenceType ReferenceType;
+		typedef typename BaseType::ConstReferenceType ConstReferenceType;
+		typedef Detail::ChannelContainerWrapper< Type, Gander::template Tuple< StorageType, NumberOfChannels, false > > ChannelContainerType;
+		typedef Detail::ChannelPointerContainerWrapper< Type, Gander::template Tuple< PointerType, NumberOfChannelPointers, false > > ChannelPointerContainerType;
+
+		template< ChannelDefault C = Chan_None, bool DisableStaticAsserts = false >
+		struct ChannelTraits
+		{
+			typedef Type LayoutType;
+			typedef ConstantChannel< T > ChannelType;
+			typedef typename LayoutType::StorageType StorageType;
+			typedef typename LayoutType::PointerType PointerType;
+			typedef typename LayoutType::ReferenceType ReferenceType;
+			typedef typename LayoutType::ConstReferenceType ConstReferenceType;
+			typedef typename LayoutType::ChannelContainerType ChannelContainerType;
+			typedef typename LayoutType::ChannelPointerContainerType ChannelPointerContainerType;
+			
+			enum
+			{
+				LayoutIndex = 0,
+			};
+		};
+		
+		template< int Index, EnumType Mask = Mask_All, bool DisableStaticAsserts = false   >
+		struct ChannelTraitsAtIndex : public BaseType::template LayoutTraits< 0 >
+		{
+			GANDER_IMAGE_STATIC_ASSERT( ( Mask & BaseType::template LayoutTraits< 0 >::LayoutType::ChannelMask ) != 0 || DisableStaticAsserts,  CHANNEL_DOES_NOT_EXIST_IN_THE_LAYOUT );
+			GANDER_STATIC_ASSERT( Index == 0 || DisableStaticAsserts, VALUE_IS_OUT_OF_BOUNDS );
+			
+			enum
+			{	
+				ChannelIndexInLayout = Index,
+			};
+		};
+
+		inline ConstantChannelLayout( T value = T( 0 ) ) : m_value( value ) {}
+
+		/// Sets the value of the channel for every pixel.
+		inline void setValue( T value ) { m_value = ConstantChannel< T >( value ); }
+		
+		/// Returns the value of the channel.
+		inline T value() const { return m_value; }
+
+		/// Constant channels have no pointers to increment.
+		inline void increment( ChannelPointerContainerType &container, int v ) {}
+		
+		/// Constant channels have no pointers to decrement.
+		inline void decrement( ChannelPointerContainerType &container, int v ) {}
+		
+		using BaseType::contains;
+
+	private :
+
+		friend class StaticLayoutBase< Type, ConstantChannel< T > >;	
+		friend class LayoutBase< Type >;	
+
+		/// Returns the value of the channel. The container is ignored as the value is held by the layout.
+		template< ChannelDefault C, class ContainerType >
+		inline ConstReferenceType _channel( const ContainerType &container ) const;
+
+		/// Returns the value of the channel. The container is ignored as the value is held by the layout.
+		template< EnumType Index, class ContainerType >
+		inline ConstReferenceType _channelAtIndex( const ContainerType &container ) const;
+
+		/// Returns an empty ChannelSet as the layout doesn't require any channel pointers.
+		inline ChannelSet _requiredChannels() const;
+
+		/// The layout has no channel pointers to set.
+		inline void _setChannelPointer( ChannelPointerContainerType &container, Channel channel, PointerType pointer );
+		
+		/// Returns the index of a channel in the layout when masked.
+		template< EnumType Index, Gander::Image::ChannelMask Mask = Mask_All, bool DisableStaticAsserts = false >
+		inline int _maskedChannelIndex() const;
+		
+		/// Returns the index of a channel within the layout.	
+		template< EnumType Channel, EnumType Mask = Mask_All, bool DisableStaticAsserts = false >
+		inline unsigned int _indexOfChannel() const;
+	
+		/// The value of the channel.
+		ConstantChannel< T > m_value;
+};
+
+}; // namespace Image
+
+}; // namespace Gander
+
+#include "GanderImage/ConstantChannelLayout.inl"
+
+#endif
@@ -0,0 +1,86 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+namespace Gander
+{
+
+namespace Image
+{
+
+template< class T, ChannelDefault S >
+template< ChannelDefault C, class ContainerType >
+inline typename ConstantChannelLayout< T, S >::ConstReferenceType ConstantChannelLayout< T, S >::_channel( const ContainerType &container ) const
+{
+	return m_value;
+}
+
+template< class T, ChannelDefault S >
+template< EnumType Index, class ContainerType >
+inline typename ConstantChannelLayout< T, S >::ConstReferenceType ConstantChannelLayout< T, S >::_channelAtIndex( const ContainerType &container ) const
+{
+	return m_value;
+}
+
+template< class T, ChannelDefault S >
+inline void ConstantChannelLayout< T, S >::_setChannelPointer( ChannelPointerContainerType &container, Channel channel, PointerType pointer )
+{
+	GANDER_ASSERT( false, "A constant channel has no channel pointer." );
+}
+
+template< class T, ChannelDefault S >
+inline ChannelSet ConstantChannelLayout< T, S >::_requiredChannels() const
+{
+	return ChannelSet();
+}
+
+/// Returns the index of a channel in the layout when masked.
+template< class T, ChannelDefault S >
+template< EnumType Index, Gander::Image::ChannelMask Mask, bool DisableStaticAsserts >
+inline int ConstantChannelLayout< T, S >::_maskedChannelIndex() const
+{
+	GANDER_IMAGE_STATIC_ASSERT( ( Mask & ChannelMask ) != 0 || DisableStaticAsserts, CHANNEL_DOES_NOT_EXIST_IN_THE_LAYOUT );
+	return 0;
+}
+
+/// Returns the index of a channel within the layout.	
+template< class T, ChannelDefault S >
+template< EnumType Channel, EnumType Mask, bool DisableStaticAsserts >
+inline unsigned int ConstantChannelLayout< T, S >::_indexOfChannel() const
+{
+	GANDER_IMAGE_STATIC_ASSERT( ( Mask & ChannelMask ) != 0 || DisableStaticAsserts, CHANNEL_DOES_NOT_EXIST_IN_THE_LAYOUT );
+	return 0;
+}
+
+}; // namespace Image
+
+}; // namespace Gander
@@ -0,0 +1,202 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDERIMAGE_CONVERTLAYOUT__
+#define __GANDERIMAGE_CONVERTLAYOUT__
+
+#include "Gander/Assert.h"
+#include "Gander/Common.h"
+#include "Gander/SampleConversion.h"
+#include "Gander/ThreadPool.h"
+
+#include "GanderImage/BrothersLayout.h"
+#include "GanderImage/Channel.h"
+#include "GanderImage/ChannelLayout.h"
+#include "GanderImage/CompoundLayout.h"
+#include "GanderImage/CopyPlan.h"
+#include "GanderImage/PixelIterator.h"
+#include "GanderImage/StaticAssert.h"
+#include "GanderImage/SubsampledChannelLayout.h"
+
+#include "GanderImage/Detail/ConvertLayout.inl"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+/// Converts rows of pixels from one layout to another using a kernel that is chosen at compile time for the pair of layouts.
+/// Identical packed layouts are copied with memcpy, interleaved layouts that hold the same channels in a different order
+/// are swizzled (with a single shuffle per pixel where SSE is available) and any other pair, such as planar to interleaved,
+/// is converted a channel at a time with a strided loop. Channels that change between the int8u, int16u, half and float types
+/// are converted as described by a SampleConversion, which by default (as with SampleConversion itself) leaves their values unscaled.
+/// Like a CopyPlan, the channels are checked once when the converter is made.
+template< class DstLayout, class SrcLayout >
+class LayoutConverter
+{
+	public :
+
+		enum
+		{
+			Kernel = Detail::ConversionKernelSelector< DstLayout, SrcLayout >::Value,
+		};
+		
+		/// Creates a converter between pixels with the same channels as dst and src.
+		/// Only the channels that the two pixels share are ever converted. The copyAvailableChannels flag
+		/// only relaxes the check made here: unless it is true, the two pixels must have the same channels.
+		LayoutConverter( const PixelAccessor< DstLayout > &dst, const PixelAccessor< SrcLayout > &src, bool copyAvailableChannels = false,
+			const SampleConversion &conversion = SampleConversion()
+		) :
+			m_conversion( conversion )
+		{
+			GANDER_ASSERT( dst.channels() == src.channels() || copyAvailableChannels,
+				"Cannot convert one layout to another if they have different channels."
+			);
+		}
+		
+		/// Returns how the converter changes the type of a channel.
+		inline const SampleConversion &conversion() const { return m_conversion; }
+		
+		/// Converts width pixels from src to dst. The row offsets the phase of any dither so that it differs from row to row.
+		inline void operator () ( PixelIterator< DstLayout > dst, ConstPixelIterator< SrcLayout > src, unsigned int width, unsigned int row = 0 ) const
+		{
+			if( row == 0 )
+			{
+				Detail::ConvertRow< Kernel, DstLayout, SrcLayout >()( dst, src, width, m_conversion );
+				return;
+			}
+
+			SampleConversion rowConversion( m_conversion );
+			rowConversion.ditherPhase += row * DitherRowPhase;
+			Detail::ConvertRow< Kernel, DstLayout, SrcLayout >()( dst, src, width, rowConversion );
+		}
+
+	private :
+
+		enum
+		{
+			/// An odd offset so that successive rows visit every phase of the dither.
+			DitherRowPhase = 101,
+		};
+		
+		SampleConversion m_conversion;
+};
+
+/// Converts the row of width pixels that starts at first to the row that starts at result, returning the end of that row.
+/// See LayoutConverter for the meaning of copyAvailableChannels.
+template< class DstLayout, class SrcLayout >
+PixelIterator< DstLayout > convertPixels( ConstPixelIterator< SrcLayout > first, unsigned int width, PixelIterator< DstLayout > result,
+	bool copyAvailableChannels = false, const SampleConversion &conversion = SampleConversion()
+)
+{
+	if( width == 0 )
+	{
+		return result;
+	}
+	
+	const LayoutConverter< DstLayout, SrcLayout > converter( *result, *first, copyAvailableChannels, conversion );
+	converter( result, first, width );
+	return result + width;
+}
+
+namespace Detail
+{
+
+template< class DstLayout, class SrcLayout >
+struct ConvertRows
+{
+	ConvertRows( const LayoutConverter< DstLayout, SrcLayout > &converter,
+		ConstPixelIterator< SrcLayout > src, int srcRowStride, PixelIterator< DstLayout > dst, int dstRowStride, unsigned int width
+	) :
+		m_converter( &converter ), m_src( src ), m_srcRowStride( srcRowStride ), m_dst( dst ), m_dstRowStride( dstRowStride ), m_width( width )
+	{
+	}
+
+	void operator()( unsigned int begin, unsigned int end ) const
+	{
+		PixelIterator< DstLayout > dst( m_dst );
+		ConstPixelIterator< SrcLayout > src( m_src );
+		dst.increment( int( begin ) * m_dstRowStride );
+		src.increment( int( begin ) * m_srcRowStride );
+		for( unsigned int y = begin; y < end; ++y, dst.increment( m_dstRowStride ), src.increment( m_srcRowStride ) )
+		{
+			( *m_converter )( dst, src, m_width, y );
+		}
+	}
+
+	const LayoutConverter< DstLayout, SrcLayout > *m_converter;
+	ConstPixelIterator< SrcLayout > m_src;
+	int m_srcRowStride;
+	PixelIterator< DstLayout > m_dst;
+	int m_dstRowStride;
+	unsigned int m_width;
+};
+
+}; // namespace Detail
+
+/// Converts an image of width by height pixels. Each row starts rowStride pixels after the previous one.
+/// The rows are split into contiguous blocks which are converted concurrently by up to numberOfThreads threads,
+/// or by the available hardware threads if numberOfThreads is 0. Small images are converted on the calling thread.
+/// See LayoutConverter for the meaning of copyAvailableChannels. Layouts with vertically subsampled channels are rejected
+/// when compiled, as their rows can't be reached by a stride.
+template< class DstLayout, class SrcLayout >
+void convertImage(
+	ConstPixelIterator< SrcLayout > src, int srcRowStride, PixelIterator< DstLayout > dst, int dstRowStride,
+	unsigned int width, unsigned int height, unsigned int numberOfThreads = 0, bool copyAvailableChannels = false,
+	const SampleConversion &conversion = SampleConversion()
+)
+{
+	GANDER_IMAGE_STATIC_ASSERT(
+		!Detail::IsVerticallySubsampled< DstLayout >::Value && !Detail::IsVerticallySubsampled< SrcLayout >::Value,
+		CONVERT_IMAGE_DOES_NOT_SUPPORT_VERTICALLY_SUBSAMPLED_LAYOUTS
+	);
+
+	if( width == 0 || height == 0 )
+	{
+		return;
+	}
+	
+	const LayoutConverter< DstLayout, SrcLayout > converter( *dst, *src, copyAvailableChannels, conversion );
+	const Detail::ConvertRows< DstLayout, SrcLayout > rows( converter, src, srcRowStride, dst, dstRowStride, width );
+
+	// An explicit number of threads is honoured for any image, otherwise each thread gets enough rows to be worth it.
+	const unsigned int minimumRows = numberOfThreads == 0 ? ( MinimumElementsPerThread + width - 1 ) / width : 1;
+	parallelFor( height, rows, minimumRows, numberOfThreads );
+}
+
+}; // namespace Image
+
+}; // namespace Gander
+
+#endif
@@ -0,0 +1,97 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDERIMAGE_CONVOLVE__
+#define __GANDERIMAGE_CONVOLVE__
+
+#include <vector>
+
+#include "Gander/Common.h"
+
+#include "GanderImage/Op.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+/// Convolves its input with a separable kernel: a horizontal kernel followed by a vertical one.
+/// Each kernel has an odd number of taps and is centred on the sample that it computes. The input is requested
+/// over the region of the output, padded by the radius of the kernels, so the samples beyond the edges of an
+/// image are whatever the op upstream gives them.
+/// Each block of rows is computed by filtering each of the input rows that it needs horizontally, once, into
+/// a ring of rows that slides down the block. Each output row is then a weighted sum of the rows in the ring.
+/// Both passes are vectorised across pixels. Kernels whose taps are all the same, such as those made by
+/// boxKernel(), are computed with running sums instead, which costs the same for any radius.
+class Convolve : public Op
+{
+	public :
+
+		/// Creates a convolution that leaves its input unchanged.
+		Convolve();
+		Convolve( const std::vector< float > &horizontal, const std::vector< float > &vertical );
+		virtual ~Convolve();
+
+		inline const std::vector< float > &horizontal() const { return m_horizontal; }
+		inline const std::vector< float > &vertical() const { return m_vertical; }
+		
+		/// Sets the kernels. Each must have an odd number of taps.
+		void setKernels( const std::vector< float > &horizontal, const std::vector< float > &vertical );
+
+		/// Returns a normalised gaussian kernel with the given standard deviation, truncated at 3 deviations.
+		static std::vector< float > gaussianKernel( float sigma );
+
+		/// Returns a normalised box kernel of 2 * radius + 1 taps.
+		static std::vector< float > boxKernel( int32 radius );
+
+		virtual void hash( Hash &h ) const;
+		virtual Box inputRegion( unsigned int index, const Box &region ) const;
+		virtual int32 minimumBlockHeight() const;
+		virtual void computeRows( int32 y, int32 t, const std::vector< const Tile * > &inputs, Tile &output ) const;
+
+	private :
+
+		std::vector< float > m_horizontal;
+		std::vector< float > m_vertical;
+
+		/// True if all of the taps of a kernel are the same.
+		bool m_horizontalIsBox;
+		bool m_verticalIsBox;
+};
+
+}; // namespace Image
+
+}; // namespace Gander
+
+#endif
@@ -0,0 +1,147 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDERIMAGE_COPYPLAN__
+#define __GANDERIMAGE_COPYPLAN__
+
+#include <type_traits>
+#include <iostream>
+#include <stdexcept>
+
+#include "Gander/Assert.h"
+#include "Gander/Common.h"
+#include "Gander/Tuple.h"
+
+#include "GanderImage/StaticAssert.h"
+#include "GanderImage/Channel.h"
+#include "GanderImage/ForEach.h"
+#include "GanderImage/ChannelOps.h"
+#include "GanderImage/PixelIterator.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+/// A pre-validated plan for copying the channels of one type of pixel to another.
+/// Assigning one pixel to another checks that their channels match on every call. When many pixels are copied
+/// between the same pair of iterators, rows or images, the CopyPlan does that check once when it is created and
+/// records which channels need to be copied. Channels that both layouts hold statically are copied by an unrolled
+/// template and any conversion between their types is resolved at compile time. The dynamic channels that both
+/// pixels share are looked up once and stored, so applying the plan involves no channel set arithmetic or checks.
+/// The plan can be applied to any pair of pixels that have the same channels as the pair that it was created from,
+/// such as the pixels visited by two iterators as they are incremented together.
+template< class Lhs, class Rhs >
+class CopyPlan
+{
+	public :
+
+		typedef CopyPlan< Lhs, Rhs > Type;
+		
+		enum
+		{
+			StaticMask = ( Lhs::LayoutType::ChannelMask & Rhs::LayoutType::ChannelMask & Gander::Image::Mask_All ),
+		};
+
+		/// Creates a plan for copying the channels of rhs to lhs.
+		/// Unless copyAvailableChannels is true, the two pixels must have the same channels.
+		/// Otherwise only the channels that they share are copied.
+		CopyPlan( const Lhs &lhs, const Rhs &rhs, bool copyAvailableChannels = false )
+		{
+			GANDER_ASSERT( lhs.channels() == rhs.channels() || copyAvailableChannels,
+				"Cannot copy one pixel to another if they have different channels."
+			);
+
+			m_channels = lhs.channels();
+			m_channels &= rhs.channels();
+			
+			if( lhs.isDynamic() || rhs.isDynamic() )
+			{
+				ChannelSet dynamicChannels( m_channels - ChannelSet( Gander::Image::ChannelMask( StaticMask ) ) );
+				for( ChannelSet::const_iterator it( dynamicChannels.begin() ); it != dynamicChannels.end(); ++it )
+				{
+					m_dynamicChannels.push_back( *it );
+				}
+			}
+		}
+
+		/// Returns the channels that the plan copies.
+		inline ChannelSet channels() const { return m_channels; }
+
+		/// Copies the channels of rhs to lhs.
+		inline void operator () ( Lhs &lhs, const Rhs &rhs ) const
+		{
+			Copy op;
+			Detail::ForEachRecurse< Lhs, const Rhs, Copy, 0, StaticMask, StaticMask >()( lhs, rhs, op );
+			
+			const unsigned int size = m_dynamicChannels.size();
+			for( unsigned int i = 0; i < size; ++i )
+			{
+				Detail::ForEachDynamicChannel< Lhs, const Rhs, Copy >()( lhs, rhs, op, m_dynamicChannels[i] );
+			}
+		}
+
+	private :
+
+		ChannelSet m_channels;
+		Gander::Tuple< Channel, 0, true > m_dynamicChannels;
+};
+
+/// Copies the pixels in the range [first, last) to the range that starts at result, returning the end of that range.
+/// The channels of the two ranges are checked once, before any pixels are copied.
+template< class InputIterator, class OutputIterator >
+OutputIterator copyPixels( InputIterator first, InputIterator last, OutputIterator result, bool copyAvailableChannels = false )
+{
+	if( first == last )
+	{
+		return result;
+	}
+
+	typedef typename OutputIterator::PixelAccessor LhsType;
+	typedef typename std::remove_const< typename InputIterator::ConstPixelAccessor >::type RhsType;
+	
+	const CopyPlan< LhsType, RhsType > plan( *result, *first, copyAvailableChannels );
+	for( ; first != last; ++first, ++result )
+	{
+		plan( *result, *first );
+	}
+	
+	return result;
+}
+
+}; // namespace Image
+
+}; // namespace Gander
+
+#endif
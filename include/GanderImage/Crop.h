@@ -0,0 +1,74 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDERIMAGE_CROP__
+#define __GANDERIMAGE_CROP__
+
+#include <vector>
+
+#include "Gander/Common.h"
+
+#include "GanderImage/Op.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+/// Crops its input to a box. Samples outside of the box are set to 0.
+/// Only the part of the input that is inside of the box is requested from upstream.
+class Crop : public Op
+{
+	public :
+
+		Crop( const Box &box = Box() );
+		virtual ~Crop();
+		
+		inline const Box &box() const { return m_box; }
+		inline void setBox( const Box &box ) { m_box = box; }
+
+		virtual void hash( Hash &h ) const;
+		virtual Box inputRegion( unsigned int index, const Box &region ) const;
+		virtual void computeRows( int32 y, int32 t, const std::vector< const Tile * > &inputs, Tile &output ) const;
+
+	private :
+
+		Box m_box;
+};
+
+}; // namespace Image
+
+}; // namespace Gander
+
+#endif
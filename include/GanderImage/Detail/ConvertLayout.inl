@@ -0,0 +1,597 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <type_traits>
+
+#if defined( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
+#if defined( __SSSE3__ )
+#include <tmmintrin.h>
+#endif
+
+#include "Gander/Assert.h"
+#include "Gander/SampleConversion.h"
+
+/// This file contains the kernels that convert rows of pixels from one layout to another.
+/// A kernel is chosen at compile time for each pair of layouts by ConversionKernelSelector.
+namespace Gander
+{
+
+namespace Image
+{
+
+namespace Detail
+{
+
+enum ConversionKernel
+{
+	/// The layouts are the same and hold their channels in one contiguous run, so rows are copied with memcpy.
+	ConvertByCopying = 0,
+	
+	/// The layouts are interleaved brothers of the same type and channels, in a different order.
+	ConvertBySwizzling,
+
+	/// Any other pair of layouts. Each channel is copied with a loop over its stride in each layout,
+	/// which transposes between planar and interleaved layouts. Channels that change between the
+	/// int8u, int16u, half and float types are converted with convertSamples().
+	ConvertByStriding,
+};
+
+/// Describes the layouts that hold all of their channels in one contiguous run of samples.
+template< class Layout >
+struct PackedLayoutTraits
+{
+	enum
+	{
+		IsPacked = 0,
+		IsBrothers = 0,
+	};
+	
+	typedef void ChannelType;
+};
+
+template< class T, ChannelBrothers B >
+struct PackedLayoutTraits< BrothersLayout< T, B > >
+{
+	typedef BrotherTraits< B > Traits;
+	
+	enum
+	{
+		IsPacked = 1,
+		IsBrothers = 1,
+		NumberOfChannels = Traits::NumberOfBrothers,
+		LowestChannel = Traits::BrotherOfLowestValue,
+	};
+	
+	typedef T ChannelType;
+
+	/// Returns the offset of the brother with the given index, in order of channel value, from the start of a pixel.
+	template< EnumType Index >
+	struct Offset
+	{
+		enum
+		{
+			Value = Traits::template BrotherIndexToChannelIndex< Index >::Value,
+		};
+	};
+	
+	/// Returns a pointer to the first sample of a pixel.
+	template< class Pixel >
+	static inline T *start( Pixel &p )
+	{
+		return &p.template channel< ChannelDefault( LowestChannel ) >() - int( Offset< 0 >::Value );
+	}
+	
+	template< class Pixel >
+	static inline const T *start( const Pixel &p )
+	{
+		return &p.template channel< ChannelDefault( LowestChannel ) >() - int( Offset< 0 >::Value );
+	}
+};
+
+template< class T, ChannelDefault C >
+struct PackedLayoutTraits< ChannelLayout< T, C > >
+{
+	enum
+	{
+		IsPacked = 1,
+		IsBrothers = 0,
+		NumberOfChannels = 1,
+	};
+	
+	typedef T ChannelType;
+	
+	template< class Pixel >
+	static inline T *start( Pixel &p )
+	{
+		return &p.template channel< C >();
+	}
+	
+	template< class Pixel >
+	static inline const T *start( const Pixel &p )
+	{
+		return &p.template channel< C >();
+	}
+};
+
+/// A compound of a single packed layout is packed too.
+template< class Layout >
+struct PackedLayoutTraits< CompoundLayout< Layout > > : public PackedLayoutTraits< Layout >
+{
+};
+
+template< class DstLayout, class SrcLayout >
+struct ConversionKernelSelector
+{
+	typedef PackedLayoutTraits< DstLayout > DstTraits;
+	typedef PackedLayoutTraits< SrcLayout > SrcTraits;
+	
+	enum
+	{
+		Value =
+			( std::is_same< DstLayout, SrcLayout >::value && DstTraits::IsPacked ) ? ConvertByCopying :
+			( DstTraits::IsBrothers && SrcTraits::IsBrothers &&
+				std::is_same< typename DstTraits::ChannelType, typename SrcTraits::ChannelType >::value &&
+				EnumType( DstLayout::ChannelMask ) == EnumType( SrcLayout::ChannelMask ) ) ? ConvertBySwizzling :
+			ConvertByStriding,
+	};
+};
+
+template< int Kernel, class DstLayout, class SrcLayout > struct ConvertRow;
+
+template< class DstLayout, class SrcLayout >
+struct ConvertRow< ConvertByCopying, DstLayout, SrcLayout >
+{
+	typedef PackedLayoutTraits< DstLayout > Traits;
+	
+	inline void operator () ( PixelIterator< DstLayout > dst, ConstPixelIterator< SrcLayout > src, unsigned int width, const SampleConversion &conversion ) const
+	{
+		std::memcpy( Traits::start( *dst ), Traits::start( *src ), size_t( width ) * Traits::NumberOfChannels * sizeof( typename Traits::ChannelType ) );
+	}
+};
+
+/// Reorders the samples of each pixel. The offsets are compile time constants so the inner loop is unrolled
+/// into a fixed sequence of moves.
+template< class T, class DstTraits, class SrcTraits, int NumberOfChannels = DstTraits::NumberOfChannels >
+struct SwizzleKernel
+{
+	static inline void apply( T *dst, const T *src, unsigned int width )
+	{
+		const unsigned int dstOffsets[4] = {
+			DstTraits::template Offset< 0 >::Value, DstTraits::template Offset< 1 >::Value,
+			DstTraits::template Offset< 2 >::Value, DstTraits::template Offset< 3 >::Value
+		};
+		const unsigned int srcOffsets[4] = {
+			SrcTraits::template Offset< 0 >::Value, SrcTraits::template Offset< 1 >::Value,
+			SrcTraits::template Offset< 2 >::Value, SrcTraits::template Offset< 3 >::Value
+		};
+
+		for( unsigned int x = 0; x < width; ++x, dst += NumberOfChannels, src += NumberOfChannels )
+		{
+			for( int i = 0; i < NumberOfChannels; ++i )
+			{
+				dst[ dstOffsets[i] ] = src[ srcOffsets[i] ];
+			}
+		}
+	}
+};
+
+/// Returns, for each sample of a destination pixel of four brothers, the index of the sample of the
+/// source pixel that it is copied from.
+template< class DstTraits, class SrcTraits >
+struct SwizzleLanes
+{
+	template< EnumType DstLane >
+	struct Lane
+	{
+		enum
+		{
+			Value = SrcTraits::template Offset< DstTraits::Traits::template ChannelIndexToBrotherIndex< DstLane >::Value >::Value,
+		};
+	};
+	
+	enum
+	{
+		Lane0 = Lane< 0 >::Value,
+		Lane1 = Lane< 1 >::Value,
+		Lane2 = Lane< 2 >::Value,
+		Lane3 = Lane< 3 >::Value,
+	};
+};
+
+#if defined( __SSE2__ )
+
+/// Swizzles four float samples at a time with a single shuffle.
+template< class DstTraits, class SrcTraits >
+struct SwizzleKernel< float, DstTraits, SrcTraits, 4 >
+{
+	static inline void apply( float *dst, const float *src, unsigned int width )
+	{
+		typedef SwizzleLanes< DstTraits, SrcTraits > Lanes;
+		for( unsigned int x = 0; x < width; ++x, dst += 4, src += 4 )
+		{
+			const __m128 v = _mm_loadu_ps( src );
+			_mm_storeu_ps( dst, _mm_shuffle_ps( v, v, _MM_SHUFFLE( Lanes::Lane3, Lanes::Lane2, Lanes::Lane1, Lanes::Lane0 ) ) );
+		}
+	}
+};
+
+#endif
+
+#if defined( __SSSE3__ )
+
+/// Swizzles four 8 bit pixels at a time with a single byte shuffle.
+template< class DstTraits, class SrcTraits >
+struct SwizzleKernel< int8u, DstTraits, SrcTraits, 4 >
+{
+	static inline void apply( int8u *dst, const int8u *src, unsigned int width )
+	{
+		typedef SwizzleLanes< DstTraits, SrcTraits > Lanes;
+		const __m128i mask = _mm_setr_epi8(
+			Lanes::Lane0, Lanes::Lane1, Lanes::Lane2, Lanes::Lane3,
+			4 + Lanes::Lane0, 4 + Lanes::Lane1, 4 + Lanes::Lane2, 4 + Lanes::Lane3,
+			8 + Lanes::Lane0, 8 + Lanes::Lane1, 8 + Lanes::Lane2, 8 + Lanes::Lane3,
+			12 + Lanes::Lane0, 12 + Lanes::Lane1, 12 + Lanes::Lane2, 12 + Lanes::Lane3
+		);
+
+		unsigned int x = 0;
+		for( ; x + 4 <= width; x += 4, dst += 16, src += 16 )
+		{
+			_mm_storeu_si128( reinterpret_cast< __m128i * >( dst ), _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast< const __m128i * >( src ) ), mask ) );
+		}
+		
+		for( ; x < width; ++x, dst += 4, src += 4 )
+		{
+			dst[0] = src[ Lanes::Lane0 ];
+			dst[1] = src[ Lanes::Lane1 ];
+			dst[2] = src[ Lanes::Lane2 ];
+			dst[3] = src[ Lanes::Lane3 ];
+		}
+	}
+};
+
+#endif
+
+template< class DstLayout, class SrcLayout >
+struct ConvertRow< ConvertBySwizzling, DstLayout, SrcLayout >
+{
+	typedef PackedLayoutTraits< DstLayout > DstTraits;
+	typedef PackedLayoutTraits< SrcLayout > SrcTraits;
+	
+	inline void operator () ( PixelIterator< DstLayout > dst, ConstPixelIterator< SrcLayout > src, unsigned int width, const SampleConversion &conversion ) const
+	{
+		SwizzleKernel< typename DstTraits::ChannelType, DstTraits, SrcTraits >::apply( DstTraits::start( *dst ), SrcTraits::start( *src ), width );
+	}
+};
+
+/// Applies the functor to every channel that two pixels share, static and dynamic, in a fixed order.
+template< class DstLayout, class SrcLayout, class Op >
+inline void forEachSharedChannel( PixelAccessor< DstLayout > &dst, const PixelAccessor< SrcLayout > &src, Op &op )
+{
+	enum
+	{
+		StaticMask = ( DstLayout::ChannelMask & SrcLayout::ChannelMask & Gander::Image::Mask_All ),
+	};
+	
+	ForEachRecurse< PixelAccessor< DstLayout >, const PixelAccessor< SrcLayout >, Op, Gander::Image::Mask_All, StaticMask, StaticMask >()( dst, src, op );
+}
+
+/// The addresses of the channels of a pair of pixels, in the order in which forEachChannel() visits them.
+struct ChannelAddresses
+{
+	enum
+	{
+		MaxChannels = 32,
+	};
+
+	ChannelAddresses() : size( 0 ), plain( true ) {}
+
+	char *dst[MaxChannels];
+	const char *src[MaxChannels];
+	unsigned int size;
+
+	/// False if any channel is held in a type that can't be copied sample by sample through its address.
+	bool plain;
+};
+
+/// Returns true if samples of type T can be copied through their addresses.
+template< class T >
+struct IsPlainSample
+{
+	enum
+	{
+		Value = std::is_arithmetic< T >::value || IsConvertibleSample< T >::Value,
+	};
+};
+
+/// Describes whether the samples of each channel of a layout are a fixed number of bytes apart along a row.
+/// Horizontally subsampled channels share a sample between neighbouring pixels, so their stride can't be found from two pixels.
+template< class Layout >
+struct HasUniformStrides
+{
+	enum
+	{
+		Value = Layout::XSubsampling == 1,
+	};
+};
+
+template<>
+struct HasUniformStrides< None >
+{
+	enum
+	{
+		Value = 1,
+	};
+};
+
+template< class T0, class T1, class T2, class T3, class T4, class T5, class T6, class T7 >
+struct HasUniformStrides< CompoundLayout< T0, T1, T2, T3, T4, T5, T6, T7 > >
+{
+	enum
+	{
+		Value =
+			HasUniformStrides< T0 >::Value && HasUniformStrides< T1 >::Value && HasUniformStrides< T2 >::Value && HasUniformStrides< T3 >::Value &&
+			HasUniformStrides< T4 >::Value && HasUniformStrides< T5 >::Value && HasUniformStrides< T6 >::Value && HasUniformStrides< T7 >::Value,
+	};
+};
+
+/// Describes whether any channel of a layout shares its values between neighbouring rows.
+template< class Layout >
+struct IsVerticallySubsampled
+{
+	enum
+	{
+		Value = Layout::YSubsampling != 1,
+	};
+};
+
+template<>
+struct IsVerticallySubsampled< None >
+{
+	enum
+	{
+		Value = 0,
+	};
+};
+
+template< class T0, class T1, class T2, class T3, class T4, class T5, class T6, class T7 >
+struct IsVerticallySubsampled< CompoundLayout< T0, T1, T2, T3, T4, T5, T6, T7 > >
+{
+	enum
+	{
+		Value =
+			IsVerticallySubsampled< T0 >::Value || IsVerticallySubsampled< T1 >::Value || IsVerticallySubsampled< T2 >::Value || IsVerticallySubsampled< T3 >::Value ||
+			IsVerticallySubsampled< T4 >::Value || IsVerticallySubsampled< T5 >::Value || IsVerticallySubsampled< T6 >::Value || IsVerticallySubsampled< T7 >::Value,
+	};
+};
+
+/// Records the addresses of the channels of two pixels.
+struct RecordChannelAddresses
+{
+	RecordChannelAddresses( ChannelAddresses &addresses ) : m_addresses( &addresses ) {}
+
+	template< class T, class S >
+	inline void operator () ( T &t, S &s )
+	{
+		GANDER_ASSERT( m_addresses->size < ChannelAddresses::MaxChannels, "Too many channels to convert." );
+		m_addresses->plain &= IsPlainSample< typename std::remove_const< T >::type >::Value && IsPlainSample< typename std::remove_const< S >::type >::Value;
+		m_addresses->dst[ m_addresses->size ] = reinterpret_cast< char * >( &t );
+		m_addresses->src[ m_addresses->size ] = reinterpret_cast< const char * >( &s );
+		++m_addresses->size;
+	}
+
+	ChannelAddresses *m_addresses;
+};
+
+template<
+	class T, class S,
+	bool Plain = IsPlainSample< T >::Value && IsPlainSample< S >::Value,
+	bool Convertible = IsConvertibleSample< T >::Value && IsConvertibleSample< S >::Value && !std::is_same< T, S >::value
+>
+struct StridedChannelCopy
+{
+	static inline void apply( char *dst, ptrdiff_t dstStride, const char *src, ptrdiff_t srcStride, unsigned int width, const SampleConversion &conversion )
+	{
+		if( dstStride == ptrdiff_t( sizeof( T ) ) && srcStride == ptrdiff_t( sizeof( S ) ) && std::is_same< T, S >::value )
+		{
+			std::memcpy( dst, src, size_t( width ) * sizeof( T ) );
+			return;
+		}
+
+		T *d = reinterpret_cast< T * >( dst );
+		const S *s = reinterpret_cast< const S * >( src );
+		const ptrdiff_t ds = dstStride / ptrdiff_t( sizeof( T ) );
+		const ptrdiff_t ss = srcStride / ptrdiff_t( sizeof( S ) );
+		for( unsigned int x = 0; x < width; ++x, d += ds, s += ss )
+		{
+			*d = *s;
+		}
+	}
+};
+
+/// Channels that change between the sample types are scaled, clamped and rounded as the conversion describes.
+template< class T, class S >
+struct StridedChannelCopy< T, S, true, true >
+{
+	static inline void apply( char *dst, ptrdiff_t dstStride, const char *src, ptrdiff_t srcStride, unsigned int width, const SampleConversion &conversion )
+	{
+		T *d = reinterpret_cast< T * >( dst );
+		const S *s = reinterpret_cast< const S * >( src );
+		if( dstStride == ptrdiff_t( sizeof( T ) ) && srcStride == ptrdiff_t( sizeof( S ) ) )
+		{
+			convertSamples( s, d, width, conversion );
+			return;
+		}
+
+		const ptrdiff_t ds = dstStride / ptrdiff_t( sizeof( T ) );
+		const ptrdiff_t ss = srcStride / ptrdiff_t( sizeof( S ) );
+		for( unsigned int x = 0; x < width; ++x, d += ds, s += ss )
+		{
+			*d = convertSample< T >( *s, conversion, x );
+		}
+	}
+};
+
+/// Channels that aren't plain values are converted a pixel at a time instead (see ConvertPixelChannels).
+template< class T, class S, bool Convertible >
+struct StridedChannelCopy< T, S, false, Convertible >
+{
+	static inline void apply( char *dst, ptrdiff_t dstStride, const char *src, ptrdiff_t srcStride, unsigned int width, const SampleConversion &conversion )
+	{
+	}
+};
+
+/// Copies each channel of a row, given the addresses of the channels of its first two pixels.
+struct CopyStridedChannels
+{
+	CopyStridedChannels( const ChannelAddresses &first, const ChannelAddresses &second, unsigned int width, const SampleConversion &conversion ) :
+		m_first( &first ),
+		m_second( &second ),
+		m_width( width ),
+		m_conversion( &conversion ),
+		m_index( 0 )
+	{
+	}
+
+	template< class T, class S >
+	inline void operator () ( T &t, S &s )
+	{
+		const unsigned int i = m_index++;
+		StridedChannelCopy< typename std::remove_const< T >::type, typename std::remove_const< S >::type >::apply(
+			m_first->dst[i], m_second->dst[i] - m_first->dst[i],
+			m_first->src[i], m_second->src[i] - m_first->src[i],
+			m_width, *m_conversion
+		);
+	}
+
+	const ChannelAddresses *m_first;
+	const ChannelAddresses *m_second;
+	unsigned int m_width;
+	const SampleConversion *m_conversion;
+	unsigned int m_index;
+};
+
+/// Converts a channel of one pixel, scaling, clamping and rounding it as StridedChannelCopy does for a row.
+template<
+	class T, class S,
+	bool Convertible = IsConvertibleSample< T >::Value && IsConvertibleSample< S >::Value && !std::is_same< T, S >::value
+>
+struct PixelChannelConversion
+{
+	static inline void apply( T &t, const S &s, const SampleConversion &conversion, unsigned int index )
+	{
+		t = s;
+	}
+};
+
+template< class T, class S >
+struct PixelChannelConversion< T, S, true >
+{
+	static inline void apply( T &t, const S &s, const SampleConversion &conversion, unsigned int index )
+	{
+		t = convertSample< T >( s, conversion, index );
+	}
+};
+
+/// Converts the channels of one pixel. The index is the position of the pixel within its row and selects the dither noise.
+struct ConvertPixelChannels
+{
+	ConvertPixelChannels( const SampleConversion &conversion ) :
+		m_conversion( &conversion ),
+		m_index( 0 )
+	{
+	}
+
+	template< class T, class S >
+	inline void operator () ( T &t, S &s )
+	{
+		PixelChannelConversion< typename std::remove_const< T >::type, typename std::remove_const< S >::type >::apply( t, s, *m_conversion, m_index );
+	}
+
+	const SampleConversion *m_conversion;
+	unsigned int m_index;
+};
+
+template< class DstLayout, class SrcLayout >
+struct ConvertRow< ConvertByStriding, DstLayout, SrcLayout >
+{
+	inline void operator () ( PixelIterator< DstLayout > dst, ConstPixelIterator< SrcLayout > src, unsigned int width, const SampleConversion &conversion ) const
+	{
+		if( width == 0 )
+		{
+			return;
+		}
+		
+		// Find the stride of each channel from the addresses of its samples in the first two pixels.
+		// A row of one pixel has no second pixel so its stride is irrelevant. Layouts whose channels
+		// don't have a uniform stride are converted a pixel at a time instead.
+		ChannelAddresses first, second;
+		RecordChannelAddresses recordFirst( first );
+		forEachSharedChannel( *dst, *src, recordFirst );
+		if( width > 1 )
+		{
+			PixelIterator< DstLayout > dst1( dst + 1 );
+			ConstPixelIterator< SrcLayout > src1( src + 1 );
+			RecordChannelAddresses recordSecond( second );
+			forEachSharedChannel( *dst1, *src1, recordSecond );
+		}
+		else
+		{
+			second = first;
+		}
+
+		if( first.plain && HasUniformStrides< DstLayout >::Value && HasUniformStrides< SrcLayout >::Value )
+		{
+			CopyStridedChannels copy( first, second, width, conversion );
+			forEachSharedChannel( *dst, *src, copy );
+		}
+		else
+		{
+			ConvertPixelChannels convert( conversion );
+			for( ; convert.m_index < width; ++convert.m_index, ++dst, ++src )
+			{
+				forEachSharedChannel( *dst, *src, convert );
+			}
+		}
+	}
+};
+
+}; // namespace Detail
+
+}; // namespace Image
+
+}; // namespace Gander
@@ -47,6 +47,7 @@
 #include "Gander/StaticAssert.h"
 #include "GanderImage/StaticAssert.h"
 #include "GanderImage/DynamicLayoutBase.h"
+#include "GanderImage/DynamicLayoutDescriptor.h"
 #include "GanderImage/Channel.h"
 #include "GanderImage/ChannelBrothers.h"
 
@@ -99,6 +100,8 @@ struct DynamicLayout : DynamicLayoutBase< DynamicLayout< T >, T >
 			};
 		};
 		
+		inline DynamicLayout();
+
 		//! @name Methods required by the base class.
 		/// These methods are required by the base class as this layout is dynamic.
 		//@{
@@ -113,6 +116,14 @@ struct DynamicLayout : DynamicLayoutBase< DynamicLayout< T >, T >
 		inline unsigned int numberOfChannelPointers() const;
 		//@}
 
+		/// Returns the channels that were added with addConstantChannels(). Their pointers address a single value
+		/// that is shared by every pixel, so they need no plane and aren't advanced as a PixelIterator moves.
+		inline ChannelSet constantChannels() const;
+
+		/// Returns the interned description of the channels that this layout represents.
+		/// Layouts that represent the same arrangement of channels return the same descriptor.
+		inline const Detail::DynamicLayoutDescriptor *descriptor() const { return m_descriptor; }
+
 		/// Increments all channel pointers in the container by v.
 		inline void increment( ChannelPointerContainerType &container, int v );
 		
@@ -130,6 +141,14 @@ struct DynamicLayout : DynamicLayoutBase< DynamicLayout< T >, T >
 
 		/// Adds the channel to the Layout and logs all pertenant information.
 		void _addChannels( ChannelSet c, ChannelBrothers b = Brothers_None );
+
+		/// Inserts a new element into the container for each constant channel and adds the channels to the Layout.
+		template< class ContainerType >
+		void _addConstantChannels( ContainerType &container, ChannelSet c );
+
+		/// Inserts an element into the container for each of the channels that the layout gained since it represented currentChannels.
+		template< class ContainerType >
+		void _insertElements( ContainerType &container, ChannelSet currentChannels );
 		
 		/// Returns a ChannelSet of the channels that pointers are required for in order
 		/// to access all of the channels in this layout.
@@ -161,14 +180,9 @@ struct DynamicLayout : DynamicLayoutBase< DynamicLayout< T >, T >
 		/// methods for every channel represented by the layout.
 		inline void _setChannelPointer( ChannelPointerContainerType &container, Channel channel, PointerType pointer );
 
-		/// The channels that this format represents.
-		ChannelSet m_channels;
-
-		/// All channel brothers associated with the channels that this layout contains.
-		ChannelSet m_allBrothers;
-
-		/// The step values for each channel.
-		std::vector< int8u > m_steps;
+		/// The interned description of the channels that this layout represents. It is shared by every
+		/// layout with the same channels, so copying a layout doesn't allocate.
+		const Detail::DynamicLayoutDescriptor *m_descriptor;
 };
 
 }; // namespace Image
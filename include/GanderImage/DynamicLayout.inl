@@ -38,13 +38,19 @@ namespace Gander
 namespace Image
 {
 
+template< class T >
+inline DynamicLayout< T >::DynamicLayout() :
+	m_descriptor( Detail::DynamicLayoutDescriptor::empty() )
+{
+}
+
 template< class T >
 inline void DynamicLayout< T >::increment( ChannelPointerContainerType &container, int v )
 {
 	unsigned int size = container.size();
 	for( unsigned int i = 0; i < size; ++i )
 	{
-		container[i] += m_steps[i];
+		container[i] += v * m_descriptor->step( i );
 	}
 }
 
@@ -54,26 +60,32 @@ inline void DynamicLayout< T >::decrement( ChannelPointerContainerType &containe
 	unsigned int size = container.size();
 	for( unsigned int i = 0; i < size; ++i )
 	{
-		container[i] -= m_steps[i];
+		container[i] -= v * m_descriptor->step( i );
 	}
 }
 
 template< class T >
 inline ChannelSet DynamicLayout<T>::channels() const
 {
-	return m_channels;
+	return m_descriptor->channels();
 }
 
 template< class T >
 inline unsigned int DynamicLayout<T>::numberOfChannels() const
 {
-	return m_channels.size();
+	return m_descriptor->channels().size();
+}
+
+template< class T >
+inline ChannelSet DynamicLayout<T>::constantChannels() const
+{
+	return m_descriptor->constantChannels();
 }
 
 template< class T >
 inline unsigned int DynamicLayout<T>::numberOfChannelPointers() const
 {
-	return m_channels.size();
+	return m_descriptor->channels().size();
 }
 
 template< class T >
@@ -91,7 +103,7 @@ template< class ContainerType >
 void DynamicLayout<T>::_addChannels( ContainerType &container, ChannelSet c, ChannelBrothers b )
 {
 	GANDER_ASSERT(
-			( container.size() == m_channels.size() ),
+			( container.size() == m_descriptor->channels().size() ),
 			"Container has a different number of elements to the Layout's number of channels."
 			);
 
@@ -101,23 +113,41 @@ void DynamicLayout<T>::_addChannels( ContainerType &container, ChannelSet c, Cha
 			);
 
 	GANDER_ASSERT(
-			( !m_allBrothers.contains( c ) ),
+			( !m_descriptor->allBrothers().contains( c ) ),
 			( boost::format( "DynamicLayout: Channels \"%s\" cannot be added as another set of ChannelBrothers represents it." ) % c ).str()
 			);
 
 	GANDER_ASSERT(
-			( m_channels.intersection( c ).size() == 0 ),
+			( m_descriptor->channels().intersection( c ).size() == 0 ),
 			( boost::format( "DynamicLayout: Channels \"%s\" cannot be added as some of the channels are already represented by the layout." ) % c ).str()
 			);
 
-	// Get a set of the current channels and the unique new ones.
-	ChannelSet currentChannels( channels() );
-	ChannelSet newChannels( c - currentChannels );
-
+	const ChannelSet currentChannels( channels() );
 	_addChannels( c, b );
+	_insertElements( container, currentChannels );
+}
 
+template< class T >
+template< class ContainerType >
+void DynamicLayout<T>::_addConstantChannels( ContainerType &container, ChannelSet c )
+{
+	GANDER_ASSERT(
+			( container.size() == m_descriptor->channels().size() ),
+			"Container has a different number of elements to the Layout's number of channels."
+			);
+
+	const ChannelSet currentChannels( channels() );
+	m_descriptor = m_descriptor->addConstantChannels( c );
+	_insertElements( container, currentChannels );
+}
+
+template< class T >
+template< class ContainerType >
+void DynamicLayout<T>::_insertElements( ContainerType &container, ChannelSet currentChannels )
+{
 	// Loop over the new channels and insert a new data element for each one
 	// at the same index that it is stored in the channel set.
+	const ChannelSet newChannels( channels() - currentChannels );
 	ChannelSet::const_iterator it( newChannels.begin() );
 	ChannelSet::const_iterator end( newChannels.end() );
 	for( ; it != end; ++it )
@@ -131,75 +161,34 @@ void DynamicLayout<T>::_addChannels( ContainerType &container, ChannelSet c, Cha
 template< class T >
 void DynamicLayout<T>::_addChannels( ChannelSet c, ChannelBrothers b )
 {
-	GANDER_ASSERT(
-			( b == Brothers_None || BrotherTraits<>::channels( b ).contains( c ) ),
-			( boost::format( "DynamicLayout: Channels \"%s\" do not belong to the specified brothers." ) % c ).str()
-			);
-
-	GANDER_ASSERT(
-			( !m_allBrothers.contains( c ) ),
-			( boost::format( "DynamicLayout: Channels \"%s\" cannot be added as another set of ChannelBrothers represents it." ) % c ).str()
-			);
-
-	GANDER_ASSERT(
-			( m_channels.intersection( c ).size() == 0 ),
-			( boost::format( "DynamicLayout: Channels \"%s\" cannot be added as some of the channels are already represented by the layout." ) % c ).str()
-			);
-
-	int8u step = 1;
-	if( b != Brothers_None )
-	{
-		m_allBrothers += BrotherTraits<>::brotherMask( b );
-		step = BrotherTraits<>::numberOfBrothers( b );
-	}
-	else
-	{
-		m_allBrothers += c;
-	}
-
-	ChannelSet newChannels( c - m_channels );
-	ChannelSet existingChannels( c - newChannels );
-
-	GANDER_ASSERT(
-			( existingChannels.size() == 0 ),
-			( boost::format( "DynamicLayout: DynamicLayout: Cannot add channels \"%s\" as they already exist." ) % existingChannels ).str()
-			);
-
-	ChannelSet::const_iterator it( newChannels.begin() );
-	ChannelSet::const_iterator end( newChannels.end() );
-	for( ; it != end; ++it )
-	{
-		m_channels += *it;
-		int index = m_channels.index( *it );
-		m_steps.insert( m_steps.begin() + index, step );
-	}
+	m_descriptor = m_descriptor->addChannels( c, b );
 }
 
 template< class T >
 inline ChannelSet DynamicLayout<T>::_requiredChannels() const
 {
-	return m_channels;
+	return m_descriptor->channels();
 }
 
 template< class T >
 template< Gander::Image::ChannelMask Mask >
 inline unsigned int DynamicLayout<T>::_maskedChannelIndex( unsigned int index ) const
 {
-	ChannelSet i = m_channels.intersection( Mask );
+	ChannelSet i = m_descriptor->channels().intersection( Mask );
 	GANDER_ASSERT( index < i.size(), "Index is out of bounds when accessing a channel in a masked set." );
-	return m_channels.index( i[ index ] );
+	return m_descriptor->index( i[ index ] );
 }
 
 template< class T >
 inline typename DynamicLayoutBase< DynamicLayout< T >, T >::ConstReferenceType DynamicLayout<T>::_channel( const ChannelContainerType &container, Channel c ) const
 {
-	return container[ m_channels.index( c ) ];
+	return container[ m_descriptor->index( c ) ];
 }
 
 template< class T >
 inline typename DynamicLayoutBase< DynamicLayout< T >, T >::ConstReferenceType DynamicLayout<T>::_channel( const ChannelPointerContainerType &container, Channel c ) const
 {
-	return *container[ m_channels.index( c ) ];
+	return *container[ m_descriptor->index( c ) ];
 }
 
 template< class T >
@@ -217,13 +206,13 @@ inline typename DynamicLayoutBase< DynamicLayout< T >, T >::ConstReferenceType D
 template< class T >
 inline typename DynamicLayoutBase< DynamicLayout< T >, T >::ReferenceType DynamicLayout<T>::_channel( ChannelContainerType &container, Channel c )
 {
-	return container[ m_channels.index( c ) ];
+	return container[ m_descriptor->index( c ) ];
 }
 
 template< class T >
 inline typename DynamicLayoutBase< DynamicLayout< T >, T >::ReferenceType DynamicLayout<T>::_channel( ChannelPointerContainerType &container, Channel c )
 {
-	return *container[ m_channels.index( c ) ];
+	return *container[ m_descriptor->index( c ) ];
 }
 
 template< class T >
@@ -112,6 +112,9 @@ struct DynamicLayoutBase : public LayoutBase< Derived >
 		void addChannels( ContainerType &container, ChannelSet c, ChannelBrothers b = Brothers_None );
 		/// Adds a set of channels to the layout. Whether the channels are brothers can also optionally be defined.
 		void addChannels( ChannelSet c, ChannelBrothers b = Brothers_None );
+		/// Inserts a set of channels that have the same value for every pixel into the passed container and also adds them to the layout.
+		template< class ContainerType >
+		void addConstantChannels( ContainerType &container, ChannelSet c );
 		//@}
 		
 	protected :	
@@ -125,6 +128,9 @@ struct DynamicLayoutBase : public LayoutBase< Derived >
 		
 		void _addChannels( ChannelSet c, ChannelBrothers b = Brothers_None );
 		
+		template< class ContainerType >
+		void _addConstantChannels( ContainerType &container, ChannelSet c );
+		
 };
 
 }; // namespace Image
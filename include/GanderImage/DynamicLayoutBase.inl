@@ -66,6 +66,13 @@ void DynamicLayoutBase< Derived, DataType >::_addChannels( ChannelSet c, Channel
 	GANDER_STATIC_ASSERT_ERROR( DERIVED_CLASS_HAS_NOT_IMPLEMENTED_ALL_PURE_STATIC_METHODS_REQUIRED_BY_THE_BASE_CLASS );
 }
 
+template< class Derived, class DataType >
+template< class ContainerType >
+void DynamicLayoutBase< Derived, DataType >::_addConstantChannels( ContainerType &container, ChannelSet c )
+{
+	GANDER_STATIC_ASSERT_ERROR( DERIVED_CLASS_HAS_NOT_IMPLEMENTED_ALL_PURE_STATIC_METHODS_REQUIRED_BY_THE_BASE_CLASS );
+}
+
 template< class Derived, class DataType >
 template< Gander::Image::ChannelMask Mask >
 inline unsigned int DynamicLayoutBase< Derived, DataType >::maskedChannelIndex( unsigned int index ) const
@@ -166,6 +173,13 @@ void DynamicLayoutBase< Derived, DataType >::addChannels( ChannelSet c, ChannelB
 	return static_cast< Derived * >( this )->_addChannels( c, b );
 }
 
+template< class Derived, class DataType >
+template< class ContainerType >
+void DynamicLayoutBase< Derived, DataType >::addConstantChannels( ContainerType &container, ChannelSet c )
+{
+	return static_cast< Derived * >( this )->_addConstantChannels( container, c );
+}
+
 }; // namespace Image
 
 }; // namespace Gander
@@ -0,0 +1,135 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDERIMAGE_DYNAMICLAYOUTDESCRIPTOR__
+#define __GANDERIMAGE_DYNAMICLAYOUTDESCRIPTOR__
+
+#include <vector>
+
+#include "boost/assert.hpp"
+
+#include "Gander/Common.h"
+
+#include "GanderImage/Channel.h"
+#include "GanderImage/ChannelBrothers.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+namespace Detail
+{
+
+/// An immutable description of the channels that are represented by a DynamicLayout.
+/// Descriptors are interned: there is only ever one instance of a descriptor for each arrangement of channels and
+/// it lives for the lifetime of the process. A DynamicLayout holds a pointer to its descriptor, so copying a layout,
+/// or any Pixel or PixelIterator that holds one, never allocates. Adding channels to a layout swaps its pointer for
+/// the interned descriptor of the new arrangement.
+class DynamicLayoutDescriptor
+{
+	public :
+
+		/// Returns the descriptor of a layout without any channels.
+		static const DynamicLayoutDescriptor *empty();
+
+		/// Returns the descriptor that results from adding the channels c, which optionally belong to the brothers b, to this one.
+		/// Throws if the channels can't be added.
+		const DynamicLayoutDescriptor *addChannels( ChannelSet c, ChannelBrothers b = Brothers_None ) const;
+
+		/// Returns the descriptor that results from adding the channels c to this one as constant channels.
+		/// A constant channel has a step of 0, so its pointer addresses a single value that is shared by every pixel.
+		/// Throws if the channels can't be added.
+		const DynamicLayoutDescriptor *addConstantChannels( ChannelSet c ) const;
+
+		/// Returns the channels represented by the layout.
+		inline const ChannelSet &channels() const { return m_channels; }
+		
+		/// Returns the channels that have the same value for every pixel.
+		inline const ChannelSet &constantChannels() const { return m_constantChannels; }
+
+		/// Returns all of the channel brothers associated with the channels of the layout.
+		inline const ChannelSet &allBrothers() const { return m_allBrothers; }
+
+		/// Returns the number of elements that the pointer to the channel at the given index is advanced by for each pixel.
+		inline int8u step( unsigned int index ) const { return m_steps[index]; }
+		
+		/// Returns the index of a channel within the layout. This is equivalent to channels().index( c ) but is a single lookup.
+		/// As with channels().index( c ), the channel must be one of those represented by the layout.
+		inline int8u index( Channel c ) const
+		{
+			BOOST_ASSERT( m_channels.contains( c ) );
+			return m_indices[c];
+		}
+
+	private :
+
+		enum
+		{
+			// Channels are numbered from 1 and there can be one for each bit of the ChannelSet.
+			MaximumChannelValue = sizeof( ChannelSet ) * 8,
+		};
+
+		DynamicLayoutDescriptor();
+		
+		/// Returns a copy of this descriptor with the channels c added, each of which is advanced by step elements per pixel.
+		/// The copy isn't interned. Throws if the channels can't be added.
+		DynamicLayoutDescriptor added( ChannelSet c, ChannelBrothers b, int8u step ) const;
+
+		/// Returns the interned copy of the descriptor, creating it if necessary.
+		static const DynamicLayoutDescriptor *intern( const DynamicLayoutDescriptor &descriptor );
+
+		/// The channels that the layout represents.
+		ChannelSet m_channels;
+		
+		/// The channels that have the same value for every pixel.
+		ChannelSet m_constantChannels;
+		
+		/// All channel brothers associated with the channels that the layout contains.
+		ChannelSet m_allBrothers;
+		
+		/// The step values for each channel.
+		std::vector< int8u > m_steps;
+		
+		/// The index of each channel within the layout.
+		int8u m_indices[ MaximumChannelValue + 1 ];
+};
+
+}; // namespace Detail
+
+}; // namespace Image
+
+}; // namespace Gander
+
+#endif
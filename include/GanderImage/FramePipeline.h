@@ -0,0 +1,175 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDERIMAGE_FRAMEPIPELINE__
+#define __GANDERIMAGE_FRAMEPIPELINE__
+
+#include <string>
+#include <vector>
+
+#include "boost/function.hpp"
+
+#include "Gander/Common.h"
+#include "Gander/BoundedQueue.h"
+
+#include "GanderImage/Tile.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+/// Reads the frames of a sequence for a FramePipeline.
+class FrameReader
+{
+	public :
+
+		virtual ~FrameReader();
+
+		/// Reads a frame into the tile, resetting it to the frame's region and channels. The tile holds
+		/// an earlier frame, so resetting it to the same size reuses its memory.
+		virtual void read( int32 frame, Tile &tile ) = 0;
+};
+
+/// Processes the frames of a sequence for a FramePipeline.
+class FrameProcessor
+{
+	public :
+
+		virtual ~FrameProcessor();
+
+		/// Processes the input frame into the output tile. As with FrameReader::read(), the output tile
+		/// holds an earlier frame and must be reset.
+		virtual void process( int32 frame, const Tile &input, Tile &output ) = 0;
+};
+
+/// Writes the frames of a sequence for a FramePipeline.
+class FrameWriter
+{
+	public :
+
+		virtual ~FrameWriter();
+
+		virtual void write( int32 frame, const Tile &tile ) = 0;
+};
+
+/// Runs a sequence of frames through a reader, a processor and a writer, with each stage on its own thread
+/// so that frame N+1 is read and frame N-1 written while frame N is processed. The stages are connected by
+/// lock-free queues of a fixed size, and the tiles that hold the frames come from two pools that are allocated
+/// once and recycled, so the memory that is used doesn't grow with the length of the sequence.
+/// The time that each stage spends working is recorded so that the slowest stage can be found.
+class FramePipeline
+{
+	public :
+
+		enum Stage
+		{
+			ReadStage = 0,
+			ProcessStage,
+			WriteStage,
+			NumberOfStages
+		};
+
+		struct StageStatistics
+		{
+			StageStatistics() : frames( 0 ), busySeconds( 0. ), totalSeconds( 0. ) {}
+
+			/// Returns the fraction of the run that the stage spent working rather than waiting for the other stages.
+			inline double utilisation() const { return totalSeconds > 0. ? busySeconds / totalSeconds : 0.; }
+
+			unsigned int frames;
+			double busySeconds;
+			double totalSeconds;
+		};
+
+		/// Creates a pipeline in which up to queueSize frames can wait between each pair of stages.
+		/// Each of the two pools holds queueSize + 2 tiles, one for each of the stages either side of the queue.
+		FramePipeline( FrameReader &reader, FrameProcessor &processor, FrameWriter &writer, unsigned int queueSize = 2 );
+		~FramePipeline();
+
+		/// Reads, processes and writes the frames from first to last inclusive. Frames are written in order.
+		/// If any stage throws then the pipeline stops and the first exception's message is rethrown as a
+		/// std::runtime_error.
+		void run( int32 first, int32 last );
+
+		/// Returns the statistics of a stage for the last run.
+		const StageStatistics &statistics( Stage stage ) const;
+
+		/// Returns the stage with the highest utilisation in the last run, which is the one that limits the
+		/// rate at which frames are processed.
+		Stage bottleneck() const;
+
+	private :
+
+		/// A frame that is passed between stages. A frame without a tile marks the end of the sequence.
+		struct Frame
+		{
+			int32 index;
+			Tile *tile;
+		};
+
+		void readFrames( int32 first, int32 last );
+		void processFrames();
+		void writeFrames();
+		void runStage( const boost::function< void () > &function );
+
+		/// Waits for room in, or a value from, a queue. Returns false if another stage has failed in the meantime.
+		template< class T > bool push( BoundedQueue< T > &queue, const T &value );
+		template< class T > bool pop( BoundedQueue< T > &queue, T &value );
+
+		void fail( const std::string &error );
+
+		FrameReader &m_reader;
+		FrameProcessor &m_processor;
+		FrameWriter &m_writer;
+
+		std::vector< Tile > m_inputTiles;
+		std::vector< Tile > m_outputTiles;
+		
+		BoundedQueue< Frame > m_inputs;
+		BoundedQueue< Frame > m_outputs;
+		BoundedQueue< Tile * > m_freeInputTiles;
+		BoundedQueue< Tile * > m_freeOutputTiles;
+
+		StageStatistics m_statistics[NumberOfStages];
+
+		volatile int m_failed;
+		std::string m_error;
+};
+
+}; // namespace Image
+
+}; // namespace Gander
+
+#endif
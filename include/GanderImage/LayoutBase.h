@@ -108,6 +108,10 @@ struct LayoutBase
 			NumberOfChannels = 0,		// Required if IsDynamic == false
 			ChannelMask = Mask_None,	// Required if IsDynamic == false
 			NumberOfChannelPointers = 0,// Required if IsDynamic == false
+			ChannelPointerStep = 1,		// The number of elements that each channel pointer is advanced by to move to the next pixel.
+			XSubsampling = 1,			// The number of horizontally adjacent pixels that share each value of the channels.
+			YSubsampling = 1,			// The number of vertically adjacent pixels that share each value of the channels.
+			IsConstant = 0,				// Set if the channels have the same value for every pixel and are held by the layout.
 			IsCompound = 0,				// Required if the derived type holds both static and dynamic layouts.
 		};
 
@@ -144,6 +148,10 @@ struct LayoutBase
 		inline ReturnType &child();
 		//@}
 		
+		/// Returns the channels that have the same value for every pixel. These are all of the channels of a layout
+		/// that sets IsConstant and none of the channels of any other static layout.
+		inline ChannelSet constantChannels() const;
+
 		/// Returns whether the layout represents the given set of channels.
 		inline bool contains( ChannelSet channels ) const;
 		
@@ -51,7 +51,7 @@ inline LayoutBase< Derived >::LayoutBase()
 
 	GANDER_IMAGE_STATIC_ASSERT(
 	(
-			( ( !Derived::IsDynamic ) && ( Derived::NumberOfChannels != 0 ) && ( Derived::NumberOfChannelPointers != 0 ) && ( EnumType( Derived::ChannelMask ) != EnumType( Mask_None ) ) )
+			( ( !Derived::IsDynamic ) && ( Derived::NumberOfChannels != 0 ) && ( Derived::NumberOfChannelPointers != 0 || Derived::IsConstant ) && ( EnumType( Derived::ChannelMask ) != EnumType( Mask_None ) ) )
 			|| Derived::IsDynamic
 		),
 		THE_DERIVED_LAYOUT_HASNT_DECLARED_ALL_REQUIRED_ENUM_VALUES
@@ -79,6 +79,12 @@ inline ChannelSet LayoutBase< Derived >::channels() const
 	return ChannelSet( static_cast<Gander::Image::ChannelMask>( Derived::ChannelMask ) );
 }
 		
+template< class Derived >
+inline ChannelSet LayoutBase< Derived >::constantChannels() const
+{
+	return Derived::IsConstant ? static_cast< Derived const * >( this )->channels() : ChannelSet();
+}
+
 template< class Derived >
 inline bool LayoutBase< Derived >::contains( ChannelSet channels ) const
 {
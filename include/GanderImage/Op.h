@@ -1,6 +1,6 @@
 //////////////////////////////////////////////////////////////////////////
 //
-//  Copyright (c) 2013, Luke Goddard. All rights reserved.
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
 //
 //  Redistribution and use in source and binary forms, with or without
 //  modification, are permitted provided that the following conditions are
@@ -35,11 +35,18 @@
 #define __GANDERIMAGE_OP__
 
 #include <iostream>
+#include <vector>
+
+#include "boost/shared_ptr.hpp"
 
 #include "Gander/Common.h"
+#include "Gander/Hash.h"
 
 #include "GanderImage/Channel.h"
 #include "GanderImage/ChannelBrothers.h"
+#include "GanderImage/Box.h"
+#include "GanderImage/Tile.h"
+#include "GanderImage/TileCache.h"
 
 namespace Gander
 {
@@ -47,12 +54,80 @@ namespace Gander
 namespace Image
 {
 
+class Op;
+typedef boost::shared_ptr< Op > OpPtr;
+typedef boost::shared_ptr< const Op > ConstOpPtr;
+
+/// The base class of the nodes in a pull based image processing graph.
+/// Nothing is computed until the output of an Op is requested with evaluate(). The request is then
+/// propagated up the graph: each Op declares, through inputRegion() and inputChannels(), which region
+/// and channels of its inputs it needs in order to compute the region and channels that were asked
+/// of it. Only those rows and channels are computed, so an Op that crops or selects channels stops
+/// the work that is done upstream of it. An Op that is used by several others computes the union of
+/// what they ask for, once.
+/// When evaluate() is given a TileCache, the tiles that are computed are cached against a hash of the op
+/// that computed them and everything upstream of it, so that re-evaluating an unchanged part of a graph
+/// reuses its tiles rather than computing them again.
 class Op
 {
 	public :
-	
+
+		Op( unsigned int numberOfInputs = 0 );
+		virtual ~Op();
+
+		inline unsigned int numberOfInputs() const { return m_inputs.size(); }
+		
+		/// Connects an input of this op to the output of another.
+		void setInput( unsigned int index, ConstOpPtr op );
+		const ConstOpPtr &input( unsigned int index ) const;
+
+		/// Appends everything that affects the output of this op, other than its inputs, to the hash.
+		/// Ops with parameters must call the base class and then append each of their parameters.
+		/// Ops that read data from elsewhere, such as a file, must also append something that changes with it.
+		/// The base class appends the type of the op.
+		virtual void hash( Hash &h ) const;
+
+		/// Returns the region of an input that is needed to compute the given region of the output.
+		/// By default this is the same region.
+		virtual Box inputRegion( unsigned int index, const Box &region ) const;
+
+		/// Returns the channels of an input that are needed to compute the given channels of the output.
+		/// By default these are the same channels.
+		virtual ChannelSet inputChannels( unsigned int index, ChannelSet channels ) const;
+
+		/// Returns the channels, out of those that were asked of the op, that it changes. The rest are passed
+		/// through from the first input by sharing its planes (see Tile), so they are neither computed nor copied,
+		/// and the output tile given to computeRows() only holds the changed channels. By default every channel
+		/// is changed. Ops without inputs always compute every channel.
+		virtual ChannelSet affectedChannels( ChannelSet channels ) const;
+
+		/// Returns the fewest rows that evaluate() should ask computeRows() for at once, other than at the end of a tile.
+		/// Ops that do some work for each block of rows, such as filling a cache of filtered rows, can return more than
+		/// the default of 1 so that the work isn't repeated for small blocks. Tiles too short to give every thread a
+		/// block of this height are split into one block per thread instead.
+		virtual int32 minimumBlockHeight() const;
+
+		/// Computes the rows [y, t) of the output tile from the input tiles.
+		/// The input tiles cover at least the regions and channels returned by inputRegion() and inputChannels()
+		/// for the output tile's region and channels. Rows of the same tile may be computed concurrently, so
+		/// this method must not modify the op.
+		virtual void computeRows( int32 y, int32 t, const std::vector< const Tile * > &inputs, Tile &output ) const = 0;
+
+	private :
+
+		std::vector< ConstOpPtr > m_inputs;
 };
 
+/// Computes the region and channels of the output tile from the graph that ends with op.
+/// The work is shared between numberOfThreads threads, the calling one and the rest from the global ThreadPool.
+/// If it is 0 then all of the hardware threads are used. Each op's tile is allocated when its inputs have been
+/// computed, and released once the ops that use it are done. If any op throws then the first exception's message is
+/// rethrown as a std::runtime_error once all running work has finished.
+/// Unless fusePointOps is false, chains of PointOps are computed in a single pass. See PointOp.
+/// If a cache is given then any op whose tile is found in it isn't computed, and nor is anything upstream
+/// that isn't needed by other ops. The tiles that are computed are added to the cache.
+void evaluate( const Op &op, Tile &output, unsigned int numberOfThreads = 0, bool fusePointOps = true, TileCache *cache = NULL );
+
 }; // namespace Image
 
 }; // namespace Gander
@@ -88,6 +88,22 @@ class PixelBase
 		inline bool isDynamic() const { return m_layout.isDynamic(); }
 		inline void addChannels( ChannelSet c, ChannelBrothers b = Brothers_None ) { m_layout.template addChannels< ContainerType >( m_container, c, b ); };
 		
+		/// Adds channels that have the same value for every pixel to a dynamic layout. Once the pointer to a constant channel
+		/// is set to its value, it isn't advanced as an iterator moves, so the channel needs no plane.
+		inline void addConstantChannels( ChannelSet c ) { m_layout.template addConstantChannels< ContainerType >( m_container, c ); };
+		
+		/// Returns the channels that have the same value for every pixel.
+		inline ChannelSet constantChannels() const { return m_layout.constantChannels(); }
+		
+		/// Sets the value of a channel that is held by a ConstantChannelLayout.
+		template< ChannelDefault C, class T >
+		inline void setConstantValue( T value )
+		{
+			typedef typename Layout::template ChannelTraits< C >::LayoutType ChildLayoutType;
+			GANDER_IMAGE_STATIC_ASSERT( ChildLayoutType::IsConstant, THE_CHANNEL_IS_NOT_HELD_BY_A_CONSTANT_LAYOUT );
+			m_layout.template child< Layout::template ChannelTraits< C >::LayoutIndex, true >().setValue( value );
+		}
+		
 		template< class T >
 		inline bool operator == ( const T &rhs ) const
 		{
@@ -100,15 +116,12 @@ class PixelBase
 			return !this->template equalTo< T >( rhs );
 		}
 
-		/// The copyFrom method is the implementation of the assignment operator.		
+		/// The copyFrom method is the implementation of the assignment operator.
+		/// It checks the channels of the two pixels on every call. To copy many pixels
+		/// between the same pair of layouts, use a CopyPlan or copyPixels() instead.
 		template< class T >
 		inline const Derived & copyFrom( const T &rhs, bool copyAvailableChannels = false )
 		{
-			if( static_cast< Derived * >( this )->channels() != rhs.channels() )
-			{
-				std::cerr <<static_cast< Derived * >( this )->channels().value() << std::endl;
-				std::cerr << rhs.channels().value() << std::endl;
-			}
 			GANDER_ASSERT( static_cast< Derived * >( this )->channels() == rhs.channels() || copyAvailableChannels,
 				"Cannot copy one pixel to another if they have different channels."
 			);
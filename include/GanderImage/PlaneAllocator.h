@@ -0,0 +1,149 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDERIMAGE_PLANEALLOCATOR__
+#define __GANDERIMAGE_PLANEALLOCATOR__
+
+#include <map>
+#include <vector>
+#include <cstddef>
+
+#include "boost/thread/mutex.hpp"
+
+#include "Gander/Common.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+/// Allocates the memory that holds the planes of image data, such as the samples of a Tile.
+/// Freed blocks are kept in pools that are bucketed by size and are handed out again to later requests of a
+/// similar size, so repeatedly evaluating a graph doesn't repeatedly map and fault in the same memory.
+/// Large blocks are mapped directly from the system and can be backed by huge pages. The pools aren't kept per
+/// thread or per memory node, so a block may be reused by a different thread from the one that first wrote to it.
+/// The allocator is thread safe.
+class PlaneAllocator
+{
+	public :
+
+		struct Statistics
+		{
+			Statistics() : usedBytes( 0 ), pooledBytes( 0 ), reservedBytes( 0 ), peakReservedBytes( 0 ), systemAllocations( 0 ), pooledAllocations( 0 ) {}
+
+			/// The bytes of the blocks that are currently allocated.
+			size_t usedBytes;
+
+			/// The bytes of the freed blocks that are held in the pools.
+			size_t pooledBytes;
+
+			/// The bytes that have been reserved from the system and not yet returned to it, which is the sum of usedBytes
+			/// and pooledBytes. Pages of a mapped block that haven't been written to don't take up memory, so this is
+			/// an upper bound on the memory that the allocator holds rather than a measure of it.
+			size_t reservedBytes;
+
+			/// The highest value of reservedBytes since the allocator was created or resetPeak() was called.
+			size_t peakReservedBytes;
+
+			/// The number of allocations that had to get a new block from the system.
+			size_t systemAllocations;
+
+			/// The number of allocations that were satisfied from the pools.
+			size_t pooledAllocations;
+		};
+
+		/// Creates an allocator that holds at most poolLimit bytes of freed blocks for reuse.
+		/// If hugePages is true then large blocks are backed by huge pages where the system supports them.
+		PlaneAllocator( size_t poolLimit = DefaultPoolLimit, bool hugePages = false );
+		~PlaneAllocator();
+
+		/// Returns the allocator that is used for the samples of tiles.
+		static PlaneAllocator &defaultAllocator();
+
+		/// Returns a block of at least size bytes, aligned to at least 64 bytes. The contents of the block are
+		/// undefined. The size of the block that is actually reserved is returned in capacity, which is the size
+		/// that must be passed to deallocate().
+		void *allocate( size_t size, size_t &capacity );
+
+		/// Frees a block that was returned by allocate() with the given capacity.
+		void deallocate( void *block, size_t capacity );
+
+		/// Returns the capacity of the block that allocate() would return for a given size.
+		size_t capacity( size_t size ) const;
+
+		/// Returns all of the pooled blocks to the system.
+		void trim();
+
+		void setPoolLimit( size_t poolLimit );
+		size_t poolLimit() const;
+
+		/// Sets whether blocks that are allocated from now on should be backed by huge pages.
+		void setHugePages( bool hugePages );
+		bool hugePages() const;
+
+		Statistics statistics() const;
+
+		/// Sets the peak reserved bytes to the current reserved bytes.
+		void resetPeak();
+
+		/// The pools of the default allocator last for the lifetime of the process, so by default they hold no more
+		/// than a few frames of film resolution tiles. Use setPoolLimit() to hold more, or trim() to release them.
+		static const size_t DefaultPoolLimit = size_t( 1 ) << 27;
+
+		/// Blocks of at least this size are mapped directly from the system rather than taken from the heap.
+		static const size_t MappedThreshold = size_t( 1 ) << 18;
+
+	private :
+
+		/// The pools, keyed by the capacity of their blocks.
+		typedef std::map< size_t, std::vector< void * > > PoolMap;
+
+		void *allocateFromSystem( size_t capacity );
+		void deallocateToSystem( void *block, size_t capacity );
+
+		/// Frees the largest pooled blocks until the pools are within their limit. Must be called with m_mutex held.
+		void shrinkPools();
+
+		mutable boost::mutex m_mutex;
+		PoolMap m_pools;
+		size_t m_poolLimit;
+		bool m_hugePages;
+		Statistics m_statistics;
+};
+
+}; // namespace Image
+
+}; // namespace Gander
+
+#endif
@@ -0,0 +1,140 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDERIMAGE_POINTOP__
+#define __GANDERIMAGE_POINTOP__
+
+#include <vector>
+
+#include "Gander/Common.h"
+
+#include "GanderImage/Channel.h"
+#include "GanderImage/Op.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+/// The base class of ops that compute each pixel from the same pixel of their single input, such as grades and clamps.
+/// Rather than computing a whole tile, a PointOp transforms a row of samples in place with applyRow(). This lets
+/// evaluate() fuse a chain of point ops into a single pass, where each row is pushed through every op in the chain
+/// while it is in cache, and none of the intermediate tiles are allocated.
+/// Point ops may request additional channels of their input through inputChannels(), as Premultiply does with alpha,
+/// but they must not override inputRegion().
+class PointOp : public Op
+{
+	public :
+
+		PointOp();
+		virtual ~PointOp();
+		
+		/// Transforms row y of the given channels of the tile in place. The tile also holds any channels
+		/// that were requested by inputChannels().
+		virtual void applyRow( Tile &tile, ChannelSet channels, int32 y ) const = 0;
+
+		virtual void computeRows( int32 y, int32 t, const std::vector< const Tile * > &inputs, Tile &output ) const;
+
+		/// Returns the channels of the input to a chain of point ops that are needed to compute the given channels of its output.
+		/// The ops are ordered from the first to be applied to the last.
+		static ChannelSet chainInputChannels( const std::vector< const PointOp * > &chain, ChannelSet channels );
+
+		/// Computes the rows [y, t) of the output by applying a chain of point ops to the input, one row at a time.
+		static void computeChain( const std::vector< const PointOp * > &chain, int32 y, int32 t, const Tile &input, Tile &output );
+};
+
+/// Multiplies the samples by a gain and then adds an offset.
+class Grade : public PointOp
+{
+	public :
+
+		Grade( float gain = 1.f, float offset = 0.f );
+		virtual ~Grade();
+
+		inline float gain() const { return m_gain; }
+		inline void setGain( float gain ) { m_gain = gain; }
+		inline float offset() const { return m_offset; }
+		inline void setOffset( float offset ) { m_offset = offset; }
+
+		virtual void hash( Hash &h ) const;
+		virtual void applyRow( Tile &tile, ChannelSet channels, int32 y ) const;
+
+	private :
+
+		float m_gain;
+		float m_offset;
+};
+
+/// Clamps the samples to the range [minimum, maximum].
+class Clamp : public PointOp
+{
+	public :
+
+		Clamp( float minimum = 0.f, float maximum = 1.f );
+		virtual ~Clamp();
+
+		inline float minimum() const { return m_minimum; }
+		inline void setMinimum( float minimum ) { m_minimum = minimum; }
+		inline float maximum() const { return m_maximum; }
+		inline void setMaximum( float maximum ) { m_maximum = maximum; }
+
+		virtual void hash( Hash &h ) const;
+		virtual void applyRow( Tile &tile, ChannelSet channels, int32 y ) const;
+
+	private :
+
+		float m_minimum;
+		float m_maximum;
+};
+
+/// Multiplies every channel other than alpha by the alpha channel.
+class Premultiply : public PointOp
+{
+	public :
+
+		Premultiply();
+		virtual ~Premultiply();
+
+		virtual ChannelSet inputChannels( unsigned int index, ChannelSet channels ) const;
+		
+		/// Alpha is passed through unchanged.
+		virtual ChannelSet affectedChannels( ChannelSet channels ) const;
+		virtual void applyRow( Tile &tile, ChannelSet channels, int32 y ) const;
+};
+
+}; // namespace Image
+
+}; // namespace Gander
+
+#endif
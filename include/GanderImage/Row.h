@@ -101,7 +101,7 @@ class Row
 			return m_start;
 		}
 
-		const const_iterator &end() const
+		const_iterator end() const
 		{
 			return iterator( m_start ).increment( m_width );
 		}
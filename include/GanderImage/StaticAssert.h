@@ -85,6 +85,11 @@ struct static_assertion<true>
 		DERIVED_CLASS_HAS_NOT_IMPLEMENTED_ALL_TRAITS_STRUCTS_REQUIRED_BY_THE_BASE_CLASS,
 		// This method has only been implemented to support 4 or less channels. It will need to be extended if more are required.
 		THIS_FUNCTION_DOES_NOT_SUPPORT_MORE_THAN_FOUR_CHANNELS__PLEASE_EXTEND_IT_OR_OVERLOAD_IT_TO_ADD_SUPPORT_FOR_MORE,
+		// Only the value of a channel that belongs to a ConstantChannelLayout can be set for every pixel.
+		THE_CHANNEL_IS_NOT_HELD_BY_A_CONSTANT_LAYOUT,
+		// convertImage() moves from row to row by a stride, which can't address channels whose values are shared
+		// between rows. Convert each row with a LayoutConverter instead.
+		CONVERT_IMAGE_DOES_NOT_SUPPORT_VERTICALLY_SUBSAMPLED_LAYOUTS,
 	};
 };
 
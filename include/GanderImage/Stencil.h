@@ -0,0 +1,323 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDERIMAGE_STENCIL__
+#define __GANDERIMAGE_STENCIL__
+
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#include "Gander/Common.h"
+#include "Gander/Assert.h"
+
+#include "GanderImage/Channel.h"
+#include "GanderImage/Box.h"
+#include "GanderImage/Tile.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+/// How the samples that lie outside of a tile are found.
+enum Border
+{
+	/// The nearest sample on the edge of the tile is repeated.
+	Border_Clamp = 0,
+	
+	/// The samples are mirrored about the edge of the tile, without repeating the edge itself.
+	Border_Mirror,
+
+	/// Samples outside of the tile have a constant value.
+	Border_Constant,
+};
+
+namespace Detail
+{
+
+/// Maps a coordinate outside of the range [begin, end) onto it.
+inline int32 borderCoordinate( int32 i, int32 begin, int32 end, Border border )
+{
+	if( i >= begin && i < end )
+	{
+		return i;
+	}
+
+	if( border == Border_Clamp || end - begin == 1 )
+	{
+		return i < begin ? begin : end - 1;
+	}
+	
+	// Mirroring repeats with a period of twice the size of the range, less the two edges.
+	const int32 period = 2 * ( end - begin - 1 );
+	int32 j = ( i - begin ) % period;
+	j = j < 0 ? j + period : j;
+	return begin + ( j < end - begin ? j : period - j );
+}
+
+}; // namespace Detail
+
+/// Gives access to the square window of samples around each pixel of a region of one channel of a tile,
+/// for filters such as convolutions, morphology and gradients. The stencil holds a pointer to each of the
+/// rows of the window, so the samples around a pixel are found by indexing rather than by computing their
+/// addresses. Rows whose window lies inside the tile point straight at its samples. The rest are copied
+/// into padded rows, with the samples beyond the tile's edges filled in according to the border. Moving
+/// the window down a row reuses any padded rows that it still covers.
+/// Usage:
+///
+/// Stencil stencil( tile, Chan_Red, region, 1, Border_Mirror );
+/// for( int32 y = region.y(); y < region.t(); ++y )
+/// {
+/// 	stencil.setRow( y );
+/// 	for( Stencil::Iterator it( stencil.begin() ); it != stencil.end(); ++it )
+/// 	{
+/// 		float dx = it( 1, 0 ) - it( -1, 0 );
+/// 	}
+/// }
+class Stencil
+{
+	public :
+
+		/// A pixel of the current row and the window of samples around it.
+		class Iterator
+		{
+			public :
+			
+				inline Iterator( const float * const *centre, int32 x, int32 i ) :
+					m_centre( centre ),
+					m_x( x ),
+					m_i( i )
+				{
+				}
+
+				/// Returns the position of the pixel.
+				inline int32 x() const { return m_x + m_i; }
+				
+				/// Returns the sample at an offset of ( dx, dy ) from the pixel. Both must be within the radius of the stencil.
+				inline float operator () ( int32 dx, int32 dy ) const
+				{
+					return m_centre[dy][ m_i + dx ];
+				}
+
+				/// Returns a pointer to the sample below ( dy < 0 ) or above the pixel. The samples either side of it
+				/// are found with offsets of up to the radius of the stencil.
+				inline const float *row( int32 dy ) const
+				{
+					return m_centre[dy] + m_i;
+				}
+
+				inline Iterator &operator ++ ()
+				{
+					++m_i;
+					return *this;
+				}
+				
+				inline bool operator == ( const Iterator &rhs ) const { return m_i == rhs.m_i; }
+				inline bool operator != ( const Iterator &rhs ) const { return m_i != rhs.m_i; }
+
+			private :
+
+				const float * const *m_centre;
+				int32 m_x;
+				int32 m_i;
+		};
+
+		/// Creates a stencil of the given radius over the pixels of the region, which may extend beyond the tile.
+		/// The tile must hold at least one sample of the channel.
+		inline Stencil( const Tile &tile, Channel c, const Box &region, int32 radius, Border border = Border_Clamp, float constant = 0.f ) :
+			m_tile( &tile ),
+			m_channel( c ),
+			m_region( region ),
+			m_radius( radius ),
+			m_border( border ),
+			m_y( INT_MIN )
+		{
+			GANDER_ASSERT( radius >= 0, "The radius of a stencil can't be negative." );
+			GANDER_ASSERT( tile.channels().contains( c ) && !tile.box().isEmpty(), "The tile doesn't hold the channel." );
+
+			m_rows.resize( 2 * radius + 1, NULL );
+			m_buffers.resize( 2 * radius + 1 );
+			m_bufferRows.resize( 2 * radius + 1, INT_MIN );
+			m_sourceRows.resize( 2 * radius + 1 );
+
+			// The window can use the rows of the tile directly when it doesn't reach beyond their ends.
+			m_direct = m_region.x() - radius >= tile.box().x() && m_region.r() + radius <= tile.box().r();
+
+			const size_t paddedWidth = size_t( std::max( m_region.width(), 0 ) + 2 * radius );
+			if( border == Border_Constant )
+			{
+				m_constantRow.resize( paddedWidth, constant );
+			}
+		}
+		
+		inline const Box &region() const { return m_region; }
+		inline int32 radius() const { return m_radius; }
+		inline Border border() const { return m_border; }
+
+		/// Returns the row that the window is centred on.
+		inline int32 y() const { return m_y; }
+		
+		/// Centres the window on a row.
+		inline void setRow( int32 y )
+		{
+			const Box &box( m_tile->box() );
+			const size_t paddedWidth = size_t( m_region.width() + 2 * m_radius );
+			const int32 size = 2 * m_radius + 1;
+			m_y = y;
+
+			// Find the rows of the tile that the window covers.
+			std::vector< int32 > &sourceRows( m_sourceRows );
+			for( int32 j = 0; j < size; ++j )
+			{
+				const int32 yy = y + j - m_radius;
+				sourceRows[j] = ( m_border == Border_Constant && ( yy < box.y() || yy >= box.t() ) ) ?
+					INT_MIN : Detail::borderCoordinate( yy, box.y(), box.t(), m_border );
+			}
+
+			for( int32 j = 0; j < size; ++j )
+			{
+				if( sourceRows[j] == INT_MIN )
+				{
+					m_rows[j] = &m_constantRow[ m_radius ];
+					continue;
+				}
+
+				if( m_direct )
+				{
+					m_rows[j] = m_tile->row( m_channel, sourceRows[j] ) + ( m_region.x() - box.x() );
+					continue;
+				}
+				
+				// Reuse a padded row if one already holds the source row. Otherwise fill one that the window no longer covers.
+				int32 buffer = std::find( m_bufferRows.begin(), m_bufferRows.end(), sourceRows[j] ) - m_bufferRows.begin();
+				if( buffer == size )
+				{
+					for( buffer = 0; buffer < size; ++buffer )
+					{
+						if( m_bufferRows[buffer] == INT_MIN || std::find( sourceRows.begin(), sourceRows.end(), m_bufferRows[buffer] ) == sourceRows.end() )
+						{
+							break;
+						}
+					}
+
+					m_buffers[buffer].resize( paddedWidth );
+					fillRow( &m_buffers[buffer][0], sourceRows[j] );
+					m_bufferRows[buffer] = sourceRows[j];
+				}
+
+				m_rows[j] = &m_buffers[buffer][ m_radius ];
+			}
+		}
+		
+		/// Moves the window down to the next row.
+		inline void nextRow()
+		{
+			setRow( m_y + 1 );
+		}
+
+		/// Returns a pointer to the sample at the start of the region in a row of the window, dy rows above its centre.
+		/// The radius samples before and after the region can be read too.
+		inline const float *row( int32 dy ) const
+		{
+			return m_rows[ dy + m_radius ];
+		}
+		
+		/// Returns an iterator to the first pixel of the current row of the region.
+		inline Iterator begin() const
+		{
+			return Iterator( &m_rows[ m_radius ], m_region.x(), 0 );
+		}
+
+		/// Returns an iterator to the pixel after the last one of the current row of the region.
+		inline Iterator end() const
+		{
+			return Iterator( &m_rows[ m_radius ], m_region.x(), m_region.width() );
+		}
+
+	private :
+
+		/// Copies a row of the tile into a padded row, filling in the samples beyond its ends.
+		inline void fillRow( float *buffer, int32 y ) const
+		{
+			const Box &box( m_tile->box() );
+			const float *source = m_tile->row( m_channel, y );
+			const int32 x0 = m_region.x() - m_radius;
+			const int32 x1 = m_region.r() + m_radius;
+			
+			const int32 inside0 = std::min( std::max( x0, box.x() ), x1 );
+			const int32 inside1 = std::max( std::min( x1, box.r() ), inside0 );
+			if( inside1 > inside0 )
+			{
+				std::memcpy( buffer + ( inside0 - x0 ), source + ( inside0 - box.x() ), size_t( inside1 - inside0 ) * sizeof( float ) );
+			}
+
+			for( int32 x = x0; x < inside0; ++x )
+			{
+				buffer[ x - x0 ] = m_border == Border_Constant ? m_constantRow[0] : source[ Detail::borderCoordinate( x, box.x(), box.r(), m_border ) - box.x() ];
+			}
+
+			for( int32 x = inside1; x < x1; ++x )
+			{
+				buffer[ x - x0 ] = m_border == Border_Constant ? m_constantRow[0] : source[ Detail::borderCoordinate( x, box.x(), box.r(), m_border ) - box.x() ];
+			}
+		}
+		
+		const Tile *m_tile;
+		Channel m_channel;
+		Box m_region;
+		int32 m_radius;
+		Border m_border;
+		bool m_direct;
+		int32 m_y;
+
+		/// The rows of the window, from the bottom up. Each points at the sample at the start of the region.
+		std::vector< const float * > m_rows;
+
+		/// The padded rows and the rows of the tile that they hold.
+		std::vector< std::vector< float > > m_buffers;
+		std::vector< int32 > m_bufferRows;
+		
+		/// The rows of the tile that the window covers, kept between calls to setRow() to avoid reallocating them.
+		std::vector< int32 > m_sourceRows;
+
+		std::vector< float > m_constantRow;
+};
+
+}; // namespace Image
+
+}; // namespace Gander
+
+#endif
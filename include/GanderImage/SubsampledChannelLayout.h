@@ -0,0 +1,231 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDERIMAGE_SUBSAMPLEDCHANNELLAYOUT__
+#define __GANDERIMAGE_SUBSAMPLEDCHANNELLAYOUT__
+
+#include <type_traits>
+#include <iostream>
+#include <stdexcept>
+
+#include "Gander/Common.h"
+#include "Gander/Assert.h"
+#include "Gander/StaticAssert.h"
+#include "Gander/Tuple.h"
+
+#include "GanderImage/StaticAssert.h"
+#include "GanderImage/StaticLayoutBase.h"
+#include "GanderImage/Channel.h"
+#include "GanderImage/ChannelBrothers.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+namespace Detail
+{
+
+/// Holds the pointer to the value of a subsampled channel along with the position of the
+/// iterator within the run of full resolution pixels that share that value.
+/// The container deliberately doesn't derive from Tuple so that CompoundLayouts don't try to
+/// advance it along with the channel pointers of their other layouts.
+template< class PointerType >
+struct SubsampledChannelPointerContainer
+{
+	public :
+
+		typedef PointerType StorageType;
+		typedef StorageType &ReferenceType;
+		typedef const StorageType &ConstReferenceType;
+		typedef const StorageType * const_iterator;
+		typedef StorageType * iterator;
+
+		SubsampledChannelPointerContainer( unsigned int numberOfElements = 1 ) :
+			m_pointer( NULL ),
+			m_phase( 0 )
+		{
+			GANDER_ASSERT( numberOfElements == 1, "A subsampled channel has a single channel pointer." );
+		}
+	
+		inline ReferenceType operator[] ( unsigned int i ) { return m_pointer; };
+		inline ConstReferenceType operator[] ( unsigned int i ) const { return m_pointer; };
+		inline unsigned int size() const { return 1; };
+		inline iterator begin() { return &m_pointer; };
+		inline iterator end() { return &m_pointer + 1; };
+		inline const_iterator begin() const { return &m_pointer; };
+		inline const_iterator end() const { return &m_pointer + 1; };
+
+		/// The pointer to the value of the current pixel.
+		PointerType m_pointer;
+
+		/// The offset of the current pixel from the first pixel that shares the value pointed to.
+		int m_phase;
+};
+
+}; // namespace Detail
+
+/// A layout of a single channel which is stored at a reduced resolution.
+/// Each value of the channel is shared by a block of XSubsampling by YSubsampling pixels, such as
+/// the U and V channels of an image with 4:2:2 ( XRatio = 2 ) or 4:2:0 ( XRatio = 2, YRatio = 2 )
+/// chroma subsampling. Incrementing a container by one pixel only advances the channel pointer once
+/// every XRatio pixels. The channel pointer for a row y should point into row subsampledRow( y ) of
+/// the channel data.
+template< class T, ChannelDefault S, unsigned XRatio, unsigned YRatio = 1 >
+struct SubsampledChannelLayout : public StaticLayoutBase< SubsampledChannelLayout< T, S, XRatio, YRatio >, T >
+{
+
+	public :
+
+		enum
+		{
+			NumberOfChannels = 1,
+			ChannelMask = ChannelToMask<S>::Value,
+			NumberOfChannelPointers = 1,
+			XSubsampling = XRatio,
+			YSubsampling = YRatio,
+		};
+		
+		typedef SubsampledChannelLayout< T, S, XRatio, YRatio > Type;
+		typedef Type LayoutType;
+		typedef StaticLayoutBase< Type, T > BaseType;
+		typedef typename BaseType::StorageType ChannelType;
+		typedef typename BaseType::StorageType StorageType;
+		typedef typename BaseType::PointerType PointerType;
+		typedef typename BaseType::ReferenceType ReferenceType;
+		typedef typename BaseType::ConstReferenceType ConstReferenceType;
+		typedef Detail::ChannelContainerWrapper< Type, Gander::template Tuple< StorageType, NumberOfChannels, false > > ChannelContainerType;
+		typedef Detail::ChannelPointerContainerWrapper< Type, Detail::SubsampledChannelPointerContainer< PointerType > > ChannelPointerContainerType;
+
+		template< ChannelDefault C = Chan_None, bool DisableStaticAsserts = false >
+		struct ChannelTraits
+		{
+			typedef Type LayoutType;
+			typedef T ChannelType;
+			typedef typename LayoutType::StorageType StorageType;
+			typedef typename LayoutType::PointerType PointerType;
+			typedef typename LayoutType::ReferenceType ReferenceType;
+			typedef typename LayoutType::ConstReferenceType ConstReferenceType;
+			typedef typename LayoutType::ChannelContainerType ChannelContainerType;
+			typedef typename LayoutType::ChannelPointerContainerType ChannelPointerContainerType;
+			
+			enum
+			{
+				LayoutIndex = 0,
+			};
+		};
+		
+		template< int Index, EnumType Mask = Mask_All, bool DisableStaticAsserts = false   >
+		struct ChannelTraitsAtIndex : public BaseType::template LayoutTraits< 0 >
+		{
+			GANDER_IMAGE_STATIC_ASSERT( ( Mask & BaseType::template LayoutTraits< 0 >::LayoutType::ChannelMask ) != 0 || DisableStaticAsserts,  CHANNEL_DOES_NOT_EXIST_IN_THE_LAYOUT );
+			GANDER_STATIC_ASSERT( Index == 0 || DisableStaticAsserts, VALUE_IS_OUT_OF_BOUNDS );
+			
+			enum
+			{	
+				ChannelIndexInLayout = Index,
+			};
+		};
+
+		/// Returns the row of the subsampled channel data that holds the values for row y of the image.
+		static inline unsigned int subsampledRow( unsigned int y ) { return y / YRatio; }
+		
+		/// Returns the number of values in a row of the subsampled channel data for an image of the given width.
+		static inline unsigned int subsampledWidth( unsigned int width ) { return ( width + XRatio - 1 ) / XRatio; }
+
+		/// Increments the container by v pixels. The channel pointer is advanced once for every XRatio pixels.
+		inline void increment( ChannelPointerContainerType &container, int v );
+		
+		/// Decrements the container by v pixels.
+		inline void decrement( ChannelPointerContainerType &container, int v );
+		
+		using BaseType::contains;
+
+	private :
+
+		friend class StaticLayoutBase< Type, T >;	
+		friend class LayoutBase< Type >;	
+
+		/// Returns a reference to the given channel from the container which is specified by the "C" template argument.
+		template< ChannelDefault C >
+		inline ReferenceType _channel( ChannelContainerType &container );
+		
+		template< ChannelDefault C >
+		inline ConstReferenceType _channel( const ChannelContainerType &container ) const;
+		
+		/// Returns a reference to the given channel from the container which is specified by the "C" template argument.
+		template< ChannelDefault C >
+		inline ReferenceType _channel( ChannelPointerContainerType &container );
+		
+		template< ChannelDefault C >
+		inline ConstReferenceType _channel( const ChannelPointerContainerType &container ) const;
+
+		/// Returns a reference to the channel found at the given index into the number of channels in the layout from the container.
+		template< EnumType Index >
+		inline ReferenceType _channelAtIndex( ChannelContainerType &container );
+		
+		template< EnumType Index >
+		inline ConstReferenceType _channelAtIndex( const ChannelContainerType &container ) const;
+		
+		/// Returns a reference to the channel found at the given index into the number of channels in the layout from the container.
+		template< EnumType Index >
+		inline ReferenceType _channelAtIndex( ChannelPointerContainerType &container );
+		
+		template< EnumType Index >
+		inline ConstReferenceType _channelAtIndex( const ChannelPointerContainerType &container ) const;
+
+		/// Returns a ChannelSet of the channels that pointers are required for in order
+		/// to access all of the channels in this layout.
+		inline ChannelSet _requiredChannels() const;
+
+		/// Sets the value of the pointer to the given channel in the container. The pointer is taken to be
+		/// the value of the first pixel of a block, so the position within the block is reset.
+		inline void _setChannelPointer( ChannelPointerContainerType &container, Channel channel, PointerType pointer );
+		
+		/// Returns the index of a channel in the layout when masked.
+		template< EnumType Index, Gander::Image::ChannelMask Mask = Mask_All, bool DisableStaticAsserts = false >
+		inline int _maskedChannelIndex() const;
+		
+		/// Returns the index of a channel within the layout.	
+		template< EnumType Channel, EnumType Mask = Mask_All, bool DisableStaticAsserts = false >
+		inline unsigned int _indexOfChannel() const;
+};
+
+}; // namespace Image
+
+}; // namespace Gander
+
+#include "GanderImage/SubsampledChannelLayout.inl"
+
+#endif
@@ -0,0 +1,148 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+namespace Gander
+{
+
+namespace Image
+{
+
+template< class T, ChannelDefault S, unsigned XRatio, unsigned YRatio >
+inline void SubsampledChannelLayout< T, S, XRatio, YRatio >::increment( ChannelPointerContainerType &container, int v )
+{
+	// Move the position within the block and carry whole blocks over into the pointer, rounding towards
+	// negative infinity so that the phase always remains within [0, XRatio).
+	const int phase = container.m_phase + v;
+	const int blocks = phase >= 0 ? phase / int( XRatio ) : -( ( int( XRatio ) - 1 - phase ) / int( XRatio ) );
+	container[0] += blocks;
+	container.m_phase = phase - blocks * int( XRatio );
+}
+
+template< class T, ChannelDefault S, unsigned XRatio, unsigned YRatio >
+inline void SubsampledChannelLayout< T, S, XRatio, YRatio >::decrement( ChannelPointerContainerType &container, int v )
+{
+	increment( container, -v );
+}
+
+template< class T, ChannelDefault S, unsigned XRatio, unsigned YRatio >
+template< ChannelDefault C >
+inline typename SubsampledChannelLayout< T, S, XRatio, YRatio >::ReferenceType SubsampledChannelLayout< T, S, XRatio, YRatio >::_channel( ChannelContainerType &container )
+{
+	return container[0];
+}
+
+template< class T, ChannelDefault S, unsigned XRatio, unsigned YRatio >
+template< ChannelDefault C >
+inline typename SubsampledChannelLayout< T, S, XRatio, YRatio >::ConstReferenceType SubsampledChannelLayout< T, S, XRatio, YRatio >::_channel( const ChannelContainerType &container ) const
+{
+	return container[0];
+}
+
+template< class T, ChannelDefault S, unsigned XRatio, unsigned YRatio >
+template< ChannelDefault C >
+inline typename SubsampledChannelLayout< T, S, XRatio, YRatio >::ReferenceType SubsampledChannelLayout< T, S, XRatio, YRatio >::_channel( ChannelPointerContainerType &container )
+{
+	return *container[0];
+}
+
+template< class T, ChannelDefault S, unsigned XRatio, unsigned YRatio >
+template< ChannelDefault C >
+inline typename SubsampledChannelLayout< T, S, XRatio, YRatio >::ConstReferenceType SubsampledChannelLayout< T, S, XRatio, YRatio >::_channel( const ChannelPointerContainerType &container ) const
+{
+	return *container[0];
+}
+
+template< class T, ChannelDefault S, unsigned XRatio, unsigned YRatio >
+template< EnumType Index >
+inline typename SubsampledChannelLayout< T, S, XRatio, YRatio >::ReferenceType SubsampledChannelLayout< T, S, XRatio, YRatio >::_channelAtIndex( ChannelContainerType &container )
+{
+	return container[0];
+}
+
+template< class T, ChannelDefault S, unsigned XRatio, unsigned YRatio >
+template< EnumType Index >
+inline typename SubsampledChannelLayout< T, S, XRatio, YRatio >::ConstReferenceType SubsampledChannelLayout< T, S, XRatio, YRatio >::_channelAtIndex( const ChannelContainerType &container ) const
+{
+	return container[0];
+}
+
+template< class T, ChannelDefault S, unsigned XRatio, unsigned YRatio >
+template< EnumType Index >
+inline typename SubsampledChannelLayout< T, S, XRatio, YRatio >::ReferenceType SubsampledChannelLayout< T, S, XRatio, YRatio >::_channelAtIndex( ChannelPointerContainerType &container )
+{
+	return *container[0];
+}
+
+template< class T, ChannelDefault S, unsigned XRatio, unsigned YRatio >
+template< EnumType Index >
+inline typename SubsampledChannelLayout< T, S, XRatio, YRatio >::ConstReferenceType SubsampledChannelLayout< T, S, XRatio, YRatio >::_channelAtIndex( const ChannelPointerContainerType &container ) const
+{
+	return *container[0];
+}
+
+template< class T, ChannelDefault S, unsigned XRatio, unsigned YRatio >
+inline void SubsampledChannelLayout< T, S, XRatio, YRatio >::_setChannelPointer( ChannelPointerContainerType &container, Channel channel, PointerType pointer )
+{
+	container[0] = pointer;
+	container.m_phase = 0;
+}
+
+/// Returns a ChannelSet of the channels that pointers are required for in order
+/// to access all of the channels in this layout.
+template< class T, ChannelDefault S, unsigned XRatio, unsigned YRatio >
+inline ChannelSet SubsampledChannelLayout< T, S, XRatio, YRatio >::_requiredChannels() const
+{
+	return ChannelSet( S );
+}
+
+/// Returns the index of a channel in the layout when masked.
+template< class T, ChannelDefault S, unsigned XRatio, unsigned YRatio >
+template< EnumType Index, Gander::Image::ChannelMask Mask, bool DisableStaticAsserts >
+inline int SubsampledChannelLayout< T, S, XRatio, YRatio >::_maskedChannelIndex() const
+{
+	GANDER_IMAGE_STATIC_ASSERT( ( Mask & ChannelMask ) != 0 || DisableStaticAsserts, CHANNEL_DOES_NOT_EXIST_IN_THE_LAYOUT );
+	return 0;
+}
+
+/// Returns the index of a channel within the layout.	
+template< class T, ChannelDefault S, unsigned XRatio, unsigned YRatio >
+template< EnumType Channel, EnumType Mask, bool DisableStaticAsserts >
+inline unsigned int SubsampledChannelLayout< T, S, XRatio, YRatio >::_indexOfChannel() const
+{
+	GANDER_IMAGE_STATIC_ASSERT( ( Mask & ChannelMask ) != 0 || DisableStaticAsserts, CHANNEL_DOES_NOT_EXIST_IN_THE_LAYOUT );
+	return 0;
+}
+
+}; // namespace Image
+
+}; // namespace Gander
@@ -0,0 +1,276 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDERIMAGE_TILE__
+#define __GANDERIMAGE_TILE__
+
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#include "boost/shared_ptr.hpp"
+
+#include "Gander/Common.h"
+#include "Gander/Assert.h"
+
+#include "GanderImage/Channel.h"
+#include "GanderImage/Box.h"
+#include "GanderImage/PlaneAllocator.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+namespace Detail
+{
+
+/// The samples of one channel of a tile. A plane can be shared by several tiles, and can cover a larger
+/// region than the tiles that use it.
+struct TilePlane
+{
+	inline TilePlane( const Box &b ) :
+		box( b )
+	{
+		data = static_cast< float * >( PlaneAllocator::defaultAllocator().allocate( size_t( box.width() ) * box.height() * sizeof( float ), capacity ) );
+	}
+
+	inline ~TilePlane()
+	{
+		PlaneAllocator::defaultAllocator().deallocate( data, capacity );
+	}
+
+	inline size_t size() const
+	{
+		return size_t( box.width() ) * box.height();
+	}
+
+	Box box;
+	float *data;
+	size_t capacity;
+};
+
+typedef boost::shared_ptr< TilePlane > TilePlanePtr;
+
+}; // namespace Detail
+
+/// A buffer of float samples that covers a region of an image and a set of its channels.
+/// Each channel is held in its own plane, and the rows of a plane are contiguous. Tiles are
+/// used to pass data between the Ops of a processing graph. The samples are held in memory from
+/// PlaneAllocator::defaultAllocator().
+/// The planes are reference counted and copied on write. Copying a tile, or sharing a channel of one
+/// tile with another, doesn't copy any samples; a plane is only copied when a tile that shares it asks
+/// for a writable row. This lets an op that only changes some channels pass the rest through for free.
+class Tile
+{
+	public :
+
+		inline Tile() {}
+
+		/// Creates a tile for the given region and channels. All samples are set to 0.
+		inline Tile( const Box &box, ChannelSet channels )
+		{
+			reset( box, channels );
+		}
+
+		/// Resizes the tile to the given region and channels. If initialise is true then all samples are set to 0.
+		/// Otherwise they are undefined, which saves clearing a tile whose samples are all about to be written.
+		/// Rows that aren't written can be cleared later with clearRows().
+		/// Planes that aren't shared and are large enough are reused.
+		inline void reset( const Box &box, ChannelSet channels, bool initialise = true )
+		{
+			m_box = box;
+			m_channels = channels;
+			
+			const size_t size = size_t( box.width() ) * box.height();
+			m_planes.resize( channels.size() );
+			for( std::vector< Detail::TilePlanePtr >::iterator it( m_planes.begin() ); it != m_planes.end(); ++it )
+			{
+				if( *it && it->unique() && (*it)->capacity >= size * sizeof( float ) )
+				{
+					(*it)->box = box;
+				}
+				else
+				{
+					it->reset( new Detail::TilePlane( box ) );
+				}
+
+				if( initialise && size )
+				{
+					std::memset( (*it)->data, 0, size * sizeof( float ) );
+				}
+			}
+		}
+
+		/// Sets the samples of the rows from y up to t of all channels to 0.
+		inline void clearRows( int32 y, int32 t )
+		{
+			if( t <= y )
+			{
+				return;
+			}
+			
+			for( ChannelSet::const_iterator c( m_channels.begin() ); c != m_channels.end(); ++c )
+			{
+				for( int32 r = y; r < t; ++r )
+				{
+					std::memset( row( *c, r ), 0, size_t( m_box.width() ) * sizeof( float ) );
+				}
+			}
+		}
+
+		/// Releases the memory that is held by the tile and makes it empty.
+		inline void clear()
+		{
+			m_box = Box();
+			m_channels.clear();
+			std::vector< Detail::TilePlanePtr >().swap( m_planes );
+		}
+
+		/// Makes a channel of this tile share the plane of a channel of another tile, adding the channel
+		/// if the tile doesn't hold it. The other tile must cover this tile's region.
+		inline void shareChannel( const Tile &other, Channel c )
+		{
+			GANDER_ASSERT( other.m_channels.contains( c ), "The tile to share with doesn't hold the channel." );
+			GANDER_ASSERT( other.m_box.contains( m_box ), "The tile to share with doesn't cover the tile." );
+
+			const Detail::TilePlanePtr &plane( other.m_planes[ other.m_channels.index( c ) ] );
+			if( m_channels.contains( c ) )
+			{
+				m_planes[ m_channels.index( c ) ] = plane;
+			}
+			else
+			{
+				m_channels += c;
+				m_planes.insert( m_planes.begin() + m_channels.index( c ), plane );
+			}
+		}
+		
+		/// Returns true if the plane of a channel is shared with another tile.
+		inline bool isShared( Channel c ) const
+		{
+			GANDER_ASSERT( m_channels.contains( c ), "The tile doesn't hold the channel." );
+			return !m_planes[ m_channels.index( c ) ].unique();
+		}
+
+		/// Gives the tile its own copy of every plane that it shares. Writing to a shared plane copies it, which
+		/// isn't safe to do from several threads at once, so a tile that is written to by several threads should
+		/// be made unique first.
+		inline void makeUnique()
+		{
+			for( std::vector< Detail::TilePlanePtr >::iterator it( m_planes.begin() ); it != m_planes.end(); ++it )
+			{
+				if( !it->unique() )
+				{
+					unshare( *it );
+				}
+			}
+		}
+
+		inline const Box &box() const { return m_box; }
+		inline ChannelSet channels() const { return m_channels; }
+		
+		/// Returns the number of bytes that are held by the planes of the tile, including any that are shared.
+		inline size_t memoryUsage() const
+		{
+			size_t result = 0;
+			for( std::vector< Detail::TilePlanePtr >::const_iterator it( m_planes.begin() ); it != m_planes.end(); ++it )
+			{
+				result += (*it)->size() * sizeof( float );
+			}
+			return result;
+		}
+
+		/// Returns a pointer to the sample at column box().x() of row y of a channel.
+		/// The next box().width() samples are the rest of the row. If the channel's plane is
+		/// shared then it is copied first.
+		inline float *row( Channel c, int32 y )
+		{
+			Detail::TilePlanePtr &plane( m_planes[ index( c, y ) ] );
+			if( !plane.unique() )
+			{
+				unshare( plane );
+			}
+			return plane->data + offset( *plane, y );
+		}
+		
+		inline const float *row( Channel c, int32 y ) const
+		{
+			const Detail::TilePlane &plane( *m_planes[ index( c, y ) ] );
+			return plane.data + offset( plane, y );
+		}
+
+		/// Returns the sample at (x, y) of a channel.
+		inline float sample( Channel c, int32 x, int32 y ) const
+		{
+			GANDER_ASSERT( x >= m_box.x() && x < m_box.r(), "The sample is outside of the tile." );
+			return row( c, y )[ x - m_box.x() ];
+		}
+
+	private :
+
+		inline unsigned int index( Channel c, int32 y ) const
+		{
+			GANDER_ASSERT( m_channels.contains( c ), "The tile doesn't hold the channel." );
+			GANDER_ASSERT( y >= m_box.y() && y < m_box.t(), "The row is outside of the tile." );
+			return m_channels.index( c );
+		}
+
+		inline size_t offset( const Detail::TilePlane &plane, int32 y ) const
+		{
+			return size_t( y - plane.box.y() ) * plane.box.width() + ( m_box.x() - plane.box.x() );
+		}
+
+		/// Replaces a shared plane with a copy of the part of it that the tile covers.
+		inline void unshare( Detail::TilePlanePtr &plane )
+		{
+			Detail::TilePlanePtr copy( new Detail::TilePlane( m_box ) );
+			for( int32 y = m_box.y(); y < m_box.t(); ++y )
+			{
+				const float *src( plane->data + offset( *plane, y ) );
+				std::copy( src, src + m_box.width(), copy->data + offset( *copy, y ) );
+			}
+			plane = copy;
+		}
+
+		Box m_box;
+		ChannelSet m_channels;
+		std::vector< Detail::TilePlanePtr > m_planes;
+};
+
+}; // namespace Image
+
+}; // namespace Gander
+
+#endif
@@ -0,0 +1,121 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDERIMAGE_TILECACHE__
+#define __GANDERIMAGE_TILECACHE__
+
+#include <list>
+#include <map>
+
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/mutex.hpp"
+
+#include "Gander/Common.h"
+#include "Gander/Hash.h"
+
+#include "GanderImage/Channel.h"
+#include "GanderImage/Box.h"
+#include "GanderImage/Tile.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+typedef boost::shared_ptr< const Tile > ConstTilePtr;
+
+/// A thread safe cache of the tiles that are computed by the ops of a graph.
+/// Tiles are keyed by the hash of the op that computed them, which covers the op's parameters and those of
+/// everything upstream of it (see Op::hash()). A cached tile can be used for any request of the same op that
+/// it covers, so a tile that was computed for a large region also serves requests for smaller ones. Cached
+/// tiles are immutable and are shared rather than copied. When the memory that is held by the cache exceeds its
+/// limit, the least recently used tiles are evicted.
+class TileCache
+{
+	public :
+
+		/// Creates a cache that holds at most memoryLimit bytes of samples.
+		TileCache( size_t memoryLimit );
+		~TileCache();
+
+		/// Returns a cached tile of the op with the given hash that covers the region and channels, or
+		/// an empty pointer if there isn't one.
+		ConstTilePtr get( const Hash &hash, const Box &region, ChannelSet channels );
+
+		/// Adds a tile that was computed by the op with the given hash. The tile must not be modified afterwards.
+		void insert( const Hash &hash, ConstTilePtr tile );
+
+		/// Removes all of the tiles from the cache.
+		void clear();
+
+		/// Sets the number of bytes that the cache can hold, evicting tiles if it is lowered.
+		void setMemoryLimit( size_t memoryLimit );
+		size_t memoryLimit() const;
+
+		/// Returns the number of bytes held by the tiles in the cache.
+		size_t memoryUsage() const;
+		
+		/// Returns the number of tiles in the cache.
+		size_t size() const;
+
+	private :
+
+		struct Entry
+		{
+			Hash hash;
+			ConstTilePtr tile;
+			size_t memoryUsage;
+		};
+
+		typedef std::list< Entry > EntryList;
+		typedef std::multimap< Hash, EntryList::iterator > EntryMap;
+	
+		/// Evicts the least recently used tiles until the cache is within its limit. Must be called with m_mutex held.
+		void evict();
+		
+		/// The entries, ordered from the most recently used.
+		EntryList m_entries;
+		EntryMap m_map;
+		
+		size_t m_memoryLimit;
+		size_t m_memoryUsage;
+		
+		mutable boost::mutex m_mutex;
+};
+
+}; // namespace Image
+
+}; // namespace Gander
+
+#endif
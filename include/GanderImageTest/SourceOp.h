@@ -0,0 +1,99 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2013, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDERIMAGETEST_SOURCEOP_H__
+#define __GANDERIMAGETEST_SOURCEOP_H__
+
+#include <vector>
+
+#include "Gander/Common.h"
+#include "Gander/Hash.h"
+
+#include "GanderImage/Op.h"
+
+namespace Gander
+{
+
+namespace ImageTest
+{
+
+/// A source op for the tests whose samples are a function of their channel, position and the op's frame.
+/// Each function makes a different type of op, so ops with different functions never share a hash.
+/// The op counts the samples that it computes, so that tests can check which tiles were computed.
+template< float (*Value)( Image::Channel c, int32 x, int32 y, int frame ) >
+class SourceOp : public Image::Op
+{
+	public :
+
+		SourceOp() : Op( 0 ), m_frame( 0 ), m_samples( 0 ) {}
+		
+		static float value( Image::Channel c, int32 x, int32 y, int frame = 0 )
+		{
+			return Value( c, x, y, frame );
+		}
+
+		virtual void hash( Hash &h ) const
+		{
+			Op::hash( h );
+			h.append( m_frame );
+		}
+		
+		virtual void computeRows( int32 y, int32 t, const std::vector< const Image::Tile * > &inputs, Image::Tile &output ) const
+		{
+			const Image::Box &box( output.box() );
+			const Image::ChannelSet channels( output.channels() );
+			for( Image::ChannelSet::const_iterator c( channels.begin() ); c != channels.end(); ++c )
+			{
+				for( int32 row = y; row < t; ++row )
+				{
+					float *dst( output.row( *c, row ) );
+					for( int32 x = box.x(); x < box.r(); ++x )
+					{
+						*dst++ = Value( *c, x, row, m_frame );
+					}
+				}
+			}
+			__sync_fetch_and_add( &m_samples, int( ( t - y ) * box.width() * channels.size() ) );
+		}
+
+		/// Changing the frame changes the samples of the op and its hash.
+		int m_frame;
+		
+		mutable int m_samples;
+};
+
+}; // namespace ImageTest
+
+}; // namespace Gander
+
+#endif // __GANDERIMAGETEST_SOURCEOP_H__
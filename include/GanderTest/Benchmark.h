@@ -0,0 +1,108 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#ifndef __GANDERTEST_BENCHMARK_H__
+#define __GANDERTEST_BENCHMARK_H__
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/date_time/posix_time/posix_time.hpp"
+#include "boost/format.hpp"
+#include "boost/test/unit_test.hpp"
+
+namespace Gander
+{
+
+namespace Test
+{
+
+/// Times several ways of doing the same amount of work and reports the throughput of each as a test message,
+/// which is shown when the tests are run with --log_level=message. The timings are never checked, as they depend
+/// on the machine that the tests are run on, so a benchmark should check the results of the work instead.
+class Benchmark
+{
+	public :
+
+		/// Creates a benchmark of the given amount of work, measured in units per second, such as "Mpixels/s".
+		Benchmark( const std::string &name, const std::string &units, double amount ) :
+			m_name( name ),
+			m_units( units ),
+			m_amount( amount )
+		{
+			start();
+		}
+
+		/// Starts timing a way of doing the work.
+		inline void start()
+		{
+			m_start = boost::posix_time::microsec_clock::universal_time();
+		}
+
+		/// Records the time since start() was called against the label of the way that the work was done.
+		/// Returns the time in seconds.
+		inline double stop( const std::string &label )
+		{
+			const double seconds = double( ( boost::posix_time::microsec_clock::universal_time() - m_start ).total_microseconds() ) * 1e-6;
+			m_timings.push_back( std::make_pair( label, seconds ) );
+			return seconds;
+		}
+
+		/// Reports the throughput of each way of doing the work, in the order that they were timed.
+		void report() const
+		{
+			std::string message( m_name + ":" );
+			for( std::vector< std::pair< std::string, double > >::const_iterator it( m_timings.begin() ); it != m_timings.end(); ++it )
+			{
+				message += ( boost::format( "%s %s %.1f %s" ) % ( it == m_timings.begin() ? "" : "," ) % it->first %
+					( m_amount / std::max( it->second, 1e-6 ) ) % m_units ).str();
+			}
+			BOOST_TEST_MESSAGE( message );
+		}
+
+	private :
+
+		std::string m_name;
+		std::string m_units;
+		double m_amount;
+		boost::posix_time::ptime m_start;
+		std::vector< std::pair< std::string, double > > m_timings;
+};
+
+}; // namespace Test
+
+}; // namespace Gander
+
+#endif // __GANDERTEST_BENCHMARK_H__
@@ -0,0 +1,395 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Gander/AngleConversion.h"
+#include "Gander/ThreadPool.h"
+
+namespace Gander
+{
+
+namespace Detail
+{
+
+template< class Real >
+struct ScaleKernel
+{
+	typedef Eigen::Array< Real, Eigen::Dynamic, 1 > ArrayType;
+
+	ScaleKernel( const Real *src, Real *dst, Real scale ) :
+		m_src( src ), m_dst( dst ), m_scale( scale )
+	{
+	}
+
+	void operator()( std::size_t begin, std::size_t end ) const
+	{
+		const std::size_t size = end - begin;
+		Eigen::Map< ArrayType >( m_dst + begin, size ) = Eigen::Map< const ArrayType >( m_src + begin, size ) * m_scale;
+	}
+
+	const Real *m_src;
+	Real *m_dst;
+	Real m_scale;
+};
+
+template< class Real >
+struct EulerAnglesToRotationMatricesKernel
+{
+	typedef Eigen::Array< Real, Eigen::Dynamic, 1 > ArrayType;
+
+	EulerAnglesToRotationMatricesKernel( const Eigen::Array< Real, Eigen::Dynamic, 3 > &angles, Eigen::Array< Real, Eigen::Dynamic, 9 > &matrices ) :
+		m_angles( angles ), m_matrices( matrices )
+	{
+	}
+
+	void operator()( std::size_t begin, std::size_t end ) const
+	{
+		const std::size_t size = end - begin;
+		const ArrayType cx( m_angles.col( 0 ).segment( begin, size ).cos() ), sx( m_angles.col( 0 ).segment( begin, size ).sin() );
+		const ArrayType cy( m_angles.col( 1 ).segment( begin, size ).cos() ), sy( m_angles.col( 1 ).segment( begin, size ).sin() );
+		const ArrayType cz( m_angles.col( 2 ).segment( begin, size ).cos() ), sz( m_angles.col( 2 ).segment( begin, size ).sin() );
+
+		// R = Rz * Ry * Rx.
+		m_matrices.col( 0 ).segment( begin, size ) = cy * cz;
+		m_matrices.col( 1 ).segment( begin, size ) = sx * sy * cz - cx * sz;
+		m_matrices.col( 2 ).segment( begin, size ) = cx * sy * cz + sx * sz;
+		m_matrices.col( 3 ).segment( begin, size ) = cy * sz;
+		m_matrices.col( 4 ).segment( begin, size ) = sx * sy * sz + cx * cz;
+		m_matrices.col( 5 ).segment( begin, size ) = cx * sy * sz - sx * cz;
+		m_matrices.col( 6 ).segment( begin, size ) = -sy;
+		m_matrices.col( 7 ).segment( begin, size ) = sx * cy;
+		m_matrices.col( 8 ).segment( begin, size ) = cx * cy;
+	}
+
+	const Eigen::Array< Real, Eigen::Dynamic, 3 > &m_angles;
+	Eigen::Array< Real, Eigen::Dynamic, 9 > &m_matrices;
+};
+
+// Extracts the euler angles of the rotation matrix Rz * Ry * Rx from the elements that they depend upon.
+// The cosine of the y rotation, sqrt( m0 * m0 + m3 * m3 ), is passed in as it is computed for a whole block at once.
+template< class Real >
+inline void extractEulerAngles( Real m0, Real m3, Real m4, Real m5, Real m6, Real m7, Real m8, Real cy, Real &x, Real &y, Real &z )
+{
+	const Real epsilon = std::numeric_limits<Real>::epsilon() * Real( 16 );
+	y = std::atan2( -m6, cy );
+
+	if( cy > epsilon )
+	{
+		x = std::atan2( m7, m8 );
+		z = std::atan2( m3, m0 );
+	}
+	else
+	{
+		// Gimbal lock. Only the combined x and z rotation can be recovered so we attribute it all to x.
+		x = std::atan2( -m5, m4 );
+		z = Real( 0 );
+	}
+}
+
+template< class Real >
+struct RotationMatricesToEulerAnglesKernel
+{
+	typedef Eigen::Array< Real, Eigen::Dynamic, 1 > ArrayType;
+
+	RotationMatricesToEulerAnglesKernel( const Eigen::Array< Real, Eigen::Dynamic, 9 > &matrices, Eigen::Array< Real, Eigen::Dynamic, 3 > &angles ) :
+		m_matrices( matrices ), m_angles( angles )
+	{
+	}
+
+	void operator()( std::size_t begin, std::size_t end ) const
+	{
+		const std::size_t size = end - begin;
+		// The cosine of the y rotation.
+		const ArrayType cy( ( m_matrices.col( 0 ).segment( begin, size ).square() + m_matrices.col( 3 ).segment( begin, size ).square() ).sqrt() );
+
+		for( std::size_t i = 0; i < size; ++i )
+		{
+			const std::size_t row = begin + i;
+			extractEulerAngles(
+				m_matrices( row, 0 ), m_matrices( row, 3 ), m_matrices( row, 4 ), m_matrices( row, 5 ),
+				m_matrices( row, 6 ), m_matrices( row, 7 ), m_matrices( row, 8 ), cy( i ),
+				m_angles( row, 0 ), m_angles( row, 1 ), m_angles( row, 2 )
+			);
+		}
+	}
+
+	const Eigen::Array< Real, Eigen::Dynamic, 9 > &m_matrices;
+	Eigen::Array< Real, Eigen::Dynamic, 3 > &m_angles;
+};
+
+template< class Real >
+struct EulerAnglesToQuaternionsKernel
+{
+	typedef Eigen::Array< Real, Eigen::Dynamic, 1 > ArrayType;
+
+	EulerAnglesToQuaternionsKernel( const Eigen::Array< Real, Eigen::Dynamic, 3 > &angles, Eigen::Array< Real, Eigen::Dynamic, 4 > &quaternions ) :
+		m_angles( angles ), m_quaternions( quaternions )
+	{
+	}
+
+	void operator()( std::size_t begin, std::size_t end ) const
+	{
+		const std::size_t size = end - begin;
+		const ArrayType hx( m_angles.col( 0 ).segment( begin, size ) * Real( .5 ) );
+		const ArrayType hy( m_angles.col( 1 ).segment( begin, size ) * Real( .5 ) );
+		const ArrayType hz( m_angles.col( 2 ).segment( begin, size ) * Real( .5 ) );
+		const ArrayType cx( hx.cos() ), sx( hx.sin() ), cy( hy.cos() ), sy( hy.sin() ), cz( hz.cos() ), sz( hz.sin() );
+
+		// q = qz * qy * qx.
+		m_quaternions.col( 0 ).segment( begin, size ) = sx * cy * cz - cx * sy * sz;
+		m_quaternions.col( 1 ).segment( begin, size ) = cx * sy * cz + sx * cy * sz;
+		m_quaternions.col( 2 ).segment( begin, size ) = cx * cy * sz - sx * sy * cz;
+		m_quaternions.col( 3 ).segment( begin, size ) = cx * cy * cz + sx * sy * sz;
+	}
+
+	const Eigen::Array< Real, Eigen::Dynamic, 3 > &m_angles;
+	Eigen::Array< Real, Eigen::Dynamic, 4 > &m_quaternions;
+};
+
+template< class Real >
+struct QuaternionsToRotationMatricesKernel
+{
+	typedef Eigen::Array< Real, Eigen::Dynamic, 1 > ArrayType;
+
+	QuaternionsToRotationMatricesKernel( const Eigen::Array< Real, Eigen::Dynamic, 4 > &quaternions, Eigen::Array< Real, Eigen::Dynamic, 9 > &matrices ) :
+		m_quaternions( quaternions ), m_matrices( matrices )
+	{
+	}
+
+	void operator()( std::size_t begin, std::size_t end ) const
+	{
+		const std::size_t size = end - begin;
+		const ArrayType x( m_quaternions.col( 0 ).segment( begin, size ) );
+		const ArrayType y( m_quaternions.col( 1 ).segment( begin, size ) );
+		const ArrayType z( m_quaternions.col( 2 ).segment( begin, size ) );
+		const ArrayType w( m_quaternions.col( 3 ).segment( begin, size ) );
+		const ArrayType tx( x * Real( 2 ) ), ty( y * Real( 2 ) ), tz( z * Real( 2 ) );
+
+		m_matrices.col( 0 ).segment( begin, size ) = Real( 1 ) - ( ty * y + tz * z );
+		m_matrices.col( 1 ).segment( begin, size ) = tx * y - tz * w;
+		m_matrices.col( 2 ).segment( begin, size ) = tx * z + ty * w;
+		m_matrices.col( 3 ).segment( begin, size ) = tx * y + tz * w;
+		m_matrices.col( 4 ).segment( begin, size ) = Real( 1 ) - ( tx * x + tz * z );
+		m_matrices.col( 5 ).segment( begin, size ) = ty * z - tx * w;
+		m_matrices.col( 6 ).segment( begin, size ) = tx * z - ty * w;
+		m_matrices.col( 7 ).segment( begin, size ) = ty * z + tx * w;
+		m_matrices.col( 8 ).segment( begin, size ) = Real( 1 ) - ( tx * x + ty * y );
+	}
+
+	const Eigen::Array< Real, Eigen::Dynamic, 4 > &m_quaternions;
+	Eigen::Array< Real, Eigen::Dynamic, 9 > &m_matrices;
+};
+
+template< class Real >
+struct QuaternionsToEulerAnglesKernel
+{
+	typedef Eigen::Array< Real, Eigen::Dynamic, 1 > ArrayType;
+
+	QuaternionsToEulerAnglesKernel( const Eigen::Array< Real, Eigen::Dynamic, 4 > &quaternions, Eigen::Array< Real, Eigen::Dynamic, 3 > &angles ) :
+		m_quaternions( quaternions ), m_angles( angles )
+	{
+	}
+
+	void operator()( std::size_t begin, std::size_t end ) const
+	{
+		const std::size_t size = end - begin;
+		const ArrayType x( m_quaternions.col( 0 ).segment( begin, size ) );
+		const ArrayType y( m_quaternions.col( 1 ).segment( begin, size ) );
+		const ArrayType z( m_quaternions.col( 2 ).segment( begin, size ) );
+		const ArrayType w( m_quaternions.col( 3 ).segment( begin, size ) );
+		const ArrayType tx( x * Real( 2 ) ), ty( y * Real( 2 ) ), tz( z * Real( 2 ) );
+
+		// Only the seven elements of the rotation matrix that the euler angles depend upon are built.
+		const ArrayType m0( Real( 1 ) - ( ty * y + tz * z ) );
+		const ArrayType m3( tx * y + tz * w );
+		const ArrayType m4( Real( 1 ) - ( tx * x + tz * z ) );
+		const ArrayType m5( ty * z - tx * w );
+		const ArrayType m6( tx * z - ty * w );
+		const ArrayType m7( ty * z + tx * w );
+		const ArrayType m8( Real( 1 ) - ( tx * x + ty * y ) );
+		const ArrayType cy( ( m0.square() + m3.square() ).sqrt() );
+
+		for( std::size_t i = 0; i < size; ++i )
+		{
+			const std::size_t row = begin + i;
+			extractEulerAngles( m0( i ), m3( i ), m4( i ), m5( i ), m6( i ), m7( i ), m8( i ), cy( i ), m_angles( row, 0 ), m_angles( row, 1 ), m_angles( row, 2 ) );
+		}
+	}
+
+	const Eigen::Array< Real, Eigen::Dynamic, 4 > &m_quaternions;
+	Eigen::Array< Real, Eigen::Dynamic, 3 > &m_angles;
+};
+
+template< class Real >
+struct RotationMatricesToQuaternionsKernel
+{
+	RotationMatricesToQuaternionsKernel( const Eigen::Array< Real, Eigen::Dynamic, 9 > &matrices, Eigen::Array< Real, Eigen::Dynamic, 4 > &quaternions ) :
+		m_matrices( matrices ), m_quaternions( quaternions )
+	{
+	}
+
+	void operator()( std::size_t begin, std::size_t end ) const
+	{
+		const std::size_t size = end - begin;
+		// Each quaternion is computed from the largest of its components to avoid dividing by a small one.
+		// The branches prevent this from being vectorised across rotations.
+		for( std::size_t row = begin; row < begin + size; ++row )
+		{
+			const Real m0( m_matrices( row, 0 ) ), m1( m_matrices( row, 1 ) ), m2( m_matrices( row, 2 ) );
+			const Real m3( m_matrices( row, 3 ) ), m4( m_matrices( row, 4 ) ), m5( m_matrices( row, 5 ) );
+			const Real m6( m_matrices( row, 6 ) ), m7( m_matrices( row, 7 ) ), m8( m_matrices( row, 8 ) );
+
+			Real x, y, z, w;
+			const Real trace = m0 + m4 + m8;
+			if( trace > Real( 0 ) )
+			{
+				const Real s = std::sqrt( trace + Real( 1 ) ) * Real( 2 );
+				w = s * Real( .25 );
+				x = ( m7 - m5 ) / s;
+				y = ( m2 - m6 ) / s;
+				z = ( m3 - m1 ) / s;
+			}
+			else if( m0 > m4 && m0 > m8 )
+			{
+				const Real s = std::sqrt( Real( 1 ) + m0 - m4 - m8 ) * Real( 2 );
+				w = ( m7 - m5 ) / s;
+				x = s * Real( .25 );
+				y = ( m1 + m3 ) / s;
+				z = ( m2 + m6 ) / s;
+			}
+			else if( m4 > m8 )
+			{
+				const Real s = std::sqrt( Real( 1 ) + m4 - m0 - m8 ) * Real( 2 );
+				w = ( m2 - m6 ) / s;
+				x = ( m1 + m3 ) / s;
+				y = s * Real( .25 );
+				z = ( m5 + m7 ) / s;
+			}
+			else
+			{
+				const Real s = std::sqrt( Real( 1 ) + m8 - m0 - m4 ) * Real( 2 );
+				w = ( m3 - m1 ) / s;
+				x = ( m2 + m6 ) / s;
+				y = ( m5 + m7 ) / s;
+				z = s * Real( .25 );
+			}
+
+			// q and -q are the same rotation so return the one with the non-negative w.
+			const Real sign = w < Real( 0 ) ? Real( -1 ) : Real( 1 );
+			m_quaternions( row, 0 ) = x * sign;
+			m_quaternions( row, 1 ) = y * sign;
+			m_quaternions( row, 2 ) = z * sign;
+			m_quaternions( row, 3 ) = w * sign;
+		}
+	}
+
+	const Eigen::Array< Real, Eigen::Dynamic, 9 > &m_matrices;
+	Eigen::Array< Real, Eigen::Dynamic, 4 > &m_quaternions;
+};
+
+} // namespace Detail
+
+template< class Real >
+void degreesToRadians( const Real *degrees, Real *radians, std::size_t n )
+{
+	parallelFor( n, Detail::ScaleKernel< Real >( degrees, radians, Real( M_PI / 180. ) ) );
+}
+
+template< class Real >
+void radiansToDegrees( const Real *radians, Real *degrees, std::size_t n )
+{
+	parallelFor( n, Detail::ScaleKernel< Real >( radians, degrees, Real( 180. / M_PI ) ) );
+}
+
+template< class Real >
+void eulerAnglesToRotationMatrices( const Eigen::Array< Real, Eigen::Dynamic, 3 > &angles, Eigen::Array< Real, Eigen::Dynamic, 9 > &matrices )
+{
+	matrices.resize( angles.rows(), 9 );
+	parallelFor( angles.rows(), Detail::EulerAnglesToRotationMatricesKernel< Real >( angles, matrices ) );
+}
+
+template< class Real >
+void rotationMatricesToEulerAngles( const Eigen::Array< Real, Eigen::Dynamic, 9 > &matrices, Eigen::Array< Real, Eigen::Dynamic, 3 > &angles )
+{
+	angles.resize( matrices.rows(), 3 );
+	parallelFor( matrices.rows(), Detail::RotationMatricesToEulerAnglesKernel< Real >( matrices, angles ) );
+}
+
+template< class Real >
+void eulerAnglesToQuaternions( const Eigen::Array< Real, Eigen::Dynamic, 3 > &angles, Eigen::Array< Real, Eigen::Dynamic, 4 > &quaternions )
+{
+	quaternions.resize( angles.rows(), 4 );
+	parallelFor( angles.rows(), Detail::EulerAnglesToQuaternionsKernel< Real >( angles, quaternions ) );
+}
+
+template< class Real >
+void quaternionsToRotationMatrices( const Eigen::Array< Real, Eigen::Dynamic, 4 > &quaternions, Eigen::Array< Real, Eigen::Dynamic, 9 > &matrices )
+{
+	matrices.resize( quaternions.rows(), 9 );
+	parallelFor( quaternions.rows(), Detail::QuaternionsToRotationMatricesKernel< Real >( quaternions, matrices ) );
+}
+
+template< class Real >
+void quaternionsToEulerAngles( const Eigen::Array< Real, Eigen::Dynamic, 4 > &quaternions, Eigen::Array< Real, Eigen::Dynamic, 3 > &angles )
+{
+	angles.resize( quaternions.rows(), 3 );
+	parallelFor( quaternions.rows(), Detail::QuaternionsToEulerAnglesKernel< Real >( quaternions, angles ) );
+}
+
+template< class Real >
+void rotationMatricesToQuaternions( const Eigen::Array< Real, Eigen::Dynamic, 9 > &matrices, Eigen::Array< Real, Eigen::Dynamic, 4 > &quaternions )
+{
+	quaternions.resize( matrices.rows(), 4 );
+	parallelFor( matrices.rows(), Detail::RotationMatricesToQuaternionsKernel< Real >( matrices, quaternions ) );
+}
+
+// Explicitly instantiate the float and double versions of the array conversions.
+#define GANDER_INSTANTIATE_ANGLE_CONVERSION( REAL ) \
+	template void degreesToRadians< REAL >( const REAL *, REAL *, std::size_t ); \
+	template void radiansToDegrees< REAL >( const REAL *, REAL *, std::size_t ); \
+	template void eulerAnglesToRotationMatrices< REAL >( const Eigen::Array< REAL, Eigen::Dynamic, 3 > &, Eigen::Array< REAL, Eigen::Dynamic, 9 > & ); \
+	template void rotationMatricesToEulerAngles< REAL >( const Eigen::Array< REAL, Eigen::Dynamic, 9 > &, Eigen::Array< REAL, Eigen::Dynamic, 3 > & ); \
+	template void eulerAnglesToQuaternions< REAL >( const Eigen::Array< REAL, Eigen::Dynamic, 3 > &, Eigen::Array< REAL, Eigen::Dynamic, 4 > & ); \
+	template void quaternionsToRotationMatrices< REAL >( const Eigen::Array< REAL, Eigen::Dynamic, 4 > &, Eigen::Array< REAL, Eigen::Dynamic, 9 > & ); \
+	template void quaternionsToEulerAngles< REAL >( const Eigen::Array< REAL, Eigen::Dynamic, 4 > &, Eigen::Array< REAL, Eigen::Dynamic, 3 > & ); \
+	template void rotationMatricesToQuaternions< REAL >( const Eigen::Array< REAL, Eigen::Dynamic, 9 > &, Eigen::Array< REAL, Eigen::Dynamic, 4 > & );
+
+GANDER_INSTANTIATE_ANGLE_CONVERSION( float )
+GANDER_INSTANTIATE_ANGLE_CONVERSION( double )
+
+}; // namespace Gander
+
@@ -42,10 +42,65 @@
 namespace Gander
 {
 
-void givensDecomposeRQ3x3( const Eigen::Matrix3d &A, Eigen::Matrix3d &R, Eigen::Matrix3d &Q, Eigen::Matrix3d &Qx, Eigen::Matrix3d &Qy, Eigen::Matrix3d &Qz )
+namespace Detail
 {
-	double z, c, s;
-	Eigen::Matrix3d M;
+
+// The tolerance used to validate the result of the decomposition.
+template< class Real > struct DecomposeRQ3x3Tolerance;
+template<> struct DecomposeRQ3x3Tolerance< float > { static float value() { return 10e-4f; } };
+template<> struct DecomposeRQ3x3Tolerance< double > { static double value() { return 10e-10; } };
+
+// Copies the matrix held in the given row of a structure of arrays into a 3x3 matrix.
+template< class Real >
+inline void getMatrix3x3( const Eigen::Array< Real, Eigen::Dynamic, 9 > &array, int index, Eigen::Matrix< Real, 3, 3 > &m )
+{
+	for( int r = 0; r < 3; ++r )
+	{
+		for( int c = 0; c < 3; ++c )
+		{
+			m( r, c ) = array( index, r * 3 + c );
+		}
+	}
+}
+
+// Copies a 3x3 matrix into the given row of a structure of arrays.
+template< class Real >
+inline void setMatrix3x3( Eigen::Array< Real, Eigen::Dynamic, 9 > &array, int index, const Eigen::Matrix< Real, 3, 3 > &m )
+{
+	for( int r = 0; r < 3; ++r )
+	{
+		for( int c = 0; c < 3; ++c )
+		{
+			array( index, r * 3 + c ) = m( r, c );
+		}
+	}
+}
+
+// Builds the Givens rotations which rotate the plane of the axes a and b into a structure of arrays.
+// The rotations are defined by their cosines and sines such that element (a,a) = c, (a,b) = -s, (b,a) = s and (b,b) = c.
+template< class Real >
+void buildGivensRotations( Eigen::Array< Real, Eigen::Dynamic, 9 > &Q, int a, int b, const Eigen::Array< Real, Eigen::Dynamic, 1 > &c, const Eigen::Array< Real, Eigen::Dynamic, 1 > &s )
+{
+	const int axis = 3 - a - b;
+	Q.resize( c.rows(), 9 );
+	Q.setZero();
+	Q.col( axis * 3 + axis ).setOnes();
+	Q.col( a * 3 + a ) = c;
+	Q.col( a * 3 + b ) = -s;
+	Q.col( b * 3 + a ) = s;
+	Q.col( b * 3 + b ) = c;
+}
+
+} // namespace Detail
+
+template< class Real >
+void givensDecomposeRQ3x3( const Eigen::Matrix< Real, 3, 3 > &A, Eigen::Matrix< Real, 3, 3 > &R, Eigen::Matrix< Real, 3, 3 > &Q,
+	Eigen::Matrix< Real, 3, 3 > &Qx, Eigen::Matrix< Real, 3, 3 > &Qy, Eigen::Matrix< Real, 3, 3 > &Qz )
+{
+	typedef Eigen::Matrix< Real, 3, 1 > Vector3Type;
+
+	Real z, c, s;
+	Eigen::Matrix< Real, 3, 3 > M;
 	M = A;
 
 	// Find Givens rotation Qx for x axis (left multiplication).
@@ -56,13 +111,13 @@ void givensDecomposeRQ3x3( const Eigen::Matrix3d &A, Eigen::Matrix3d &R, Eigen::
 	//
 	s = M(1,2);
 	c = M(2,2);
-	z = 1. / sqrt( c * c + s * s + std::numeric_limits<double>::epsilon() );
+	z = 1. / sqrt( c * c + s * s + std::numeric_limits<Real>::epsilon() );
 	c *= z;
 	s *= z;
 	Qx << 1, 0, 0, 0, c, -s, 0, s, c;
 	
 	R = Qx * M;        
-	BOOST_ASSERT( fabs( R(1,2) ) < std::numeric_limits<double>::epsilon() );
+	BOOST_ASSERT( fabs( R(1,2) ) < std::numeric_limits<Real>::epsilon() );
 	R(1,2) = 0.;
 
 	// Find Givens rotation for y axis.
@@ -73,7 +128,7 @@ void givensDecomposeRQ3x3( const Eigen::Matrix3d &A, Eigen::Matrix3d &R, Eigen::
 	//
 	s = -R(0,2);
 	c = R(2,2);
-	z = 1. / sqrt( c * c + s * s + std::numeric_limits<double>::epsilon() );
+	z = 1. / sqrt( c * c + s * s + std::numeric_limits<Real>::epsilon() );
 	c *= z;
 	s *= z;
 
@@ -91,7 +146,7 @@ void givensDecomposeRQ3x3( const Eigen::Matrix3d &A, Eigen::Matrix3d &R, Eigen::
 	//
 	s = M(0,1);
 	c = M(1,1);
-	z = 1. / sqrt( c * c + s * s + std::numeric_limits<double>::epsilon() );
+	z = 1. / sqrt( c * c + s * s + std::numeric_limits<Real>::epsilon() );
 	c *= z;
 	s *= z;
 	
@@ -167,17 +222,182 @@ void givensDecomposeRQ3x3( const Eigen::Matrix3d &A, Eigen::Matrix3d &R, Eigen::
 	Q = Qx.transpose() * Qy.transpose() * Qz.transpose();
 
 	// Validate the result and if fails then attempt to extract euler rotations from Q and rebuild R.
-	if( !areClose( Q*R, A, 10e-10, 10e-10 ) )
+	const Real tolerance = Detail::DecomposeRQ3x3Tolerance< Real >::value();
+	if( !areClose( Q*R, A, tolerance, tolerance ) )
 	{
-		Eigen::Vector3d zyx = Q.eulerAngles( 2, 1, 0 );
+		Vector3Type zyx = Q.eulerAngles( 2, 1, 0 );
 
-		Q = Eigen::AngleAxisd( zyx[0], Eigen::Vector3d::UnitZ() )
-			* Eigen::AngleAxisd( zyx[1], Eigen::Vector3d::UnitY() )
-			* Eigen::AngleAxisd( zyx[2], Eigen::Vector3d::UnitX() );
+		Q = Eigen::AngleAxis< Real >( zyx[0], Vector3Type::UnitZ() )
+			* Eigen::AngleAxis< Real >( zyx[1], Vector3Type::UnitY() )
+			* Eigen::AngleAxis< Real >( zyx[2], Vector3Type::UnitX() );
 
 		R = Q.transpose() * A;
 	}
 }
 
+template< class Real >
+void givensDecomposeRQ3x3( const Eigen::Array< Real, Eigen::Dynamic, 9 > &A, Eigen::Array< Real, Eigen::Dynamic, 9 > &R, Eigen::Array< Real, Eigen::Dynamic, 9 > &Q,
+	Eigen::Array< Real, Eigen::Dynamic, 9 > *Qx, Eigen::Array< Real, Eigen::Dynamic, 9 > *Qy, Eigen::Array< Real, Eigen::Dynamic, 9 > *Qz )
+{
+	typedef Eigen::Array< Real, Eigen::Dynamic, 1 > ArrayType;
+	typedef Eigen::Array< bool, Eigen::Dynamic, 1 > MaskType;
+
+	// Each of the steps below mirrors those of the single matrix version but operates on a column of elements,
+	// one from each of the matrices, at a time. Element (r,c) of each matrix is held in column ( r * 3 + c ).
+	const int n = A.rows();
+	const Real epsilon = std::numeric_limits<Real>::epsilon();
+	Eigen::Array< Real, Eigen::Dynamic, 9 > M( n, 9 );
+	R.resize( n, 9 );
+	Q.resize( n, 9 );
+
+	// Find the Givens rotations Qx for the x axis and compute R = Qx * A.
+	ArrayType cx( A.col( 8 ) ), sx( A.col( 5 ) );
+	ArrayType z( ( cx * cx + sx * sx + epsilon ).sqrt().inverse() );
+	cx *= z;
+	sx *= z;
+
+	for( int c = 0; c < 3; ++c )
+	{
+		R.col( c ) = A.col( c );
+		R.col( 3 + c ) = cx * A.col( 3 + c ) - sx * A.col( 6 + c );
+		R.col( 6 + c ) = sx * A.col( 3 + c ) + cx * A.col( 6 + c );
+	}
+	R.col( 5 ).setZero();
+
+	// Find the Givens rotations Qy for the y axis and compute M = Qy * R.
+	ArrayType cy( R.col( 8 ) ), sy( -R.col( 2 ) );
+	z = ( cy * cy + sy * sy + epsilon ).sqrt().inverse();
+	cy *= z;
+	sy *= z;
+
+	for( int c = 0; c < 3; ++c )
+	{
+		M.col( c ) = cy * R.col( c ) + sy * R.col( 6 + c );
+		M.col( 3 + c ) = R.col( 3 + c );
+		M.col( 6 + c ) = cy * R.col( 6 + c ) - sy * R.col( c );
+	}
+	M.col( 2 ).setZero();
+
+	// Find the Givens rotations Qz for the z axis and compute R = Qz * M.
+	ArrayType cz( M.col( 4 ) ), sz( M.col( 1 ) );
+	z = ( cz * cz + sz * sz + epsilon ).sqrt().inverse();
+	cz *= z;
+	sz *= z;
+
+	for( int c = 0; c < 3; ++c )
+	{
+		R.col( c ) = cz * M.col( c ) - sz * M.col( 3 + c );
+		R.col( 3 + c ) = sz * M.col( c ) + cz * M.col( 3 + c );
+		R.col( 6 + c ) = M.col( 6 + c );
+	}
+	R.col( 1 ).setZero();
+
+	// Solve the decomposition ambiguity. Rather than branching on each matrix, the elements of R and the cosines
+	// and sines of the rotations which are negated by each of the 180 degree rotations are selected using masks.
+	// Negating both c and s of a rotation is equivalent to negating its 2x2 block and negating s alone transposes it.
+	const MaskType negative0( R.col( 0 ) < Real( 0 ) ), negative1( R.col( 4 ) < Real( 0 ) );
+	const MaskType positive0( R.col( 0 ) >= Real( 0 ) ), positive1( R.col( 4 ) >= Real( 0 ) );
+	const MaskType rotateZ( negative0 && negative1 ); // Rotate around z by 180 degrees.
+	const MaskType rotateY( negative0 && positive1 ); // Rotate around y by 180 degrees.
+	const MaskType rotateX( positive0 && negative1 ); // Rotate around x by 180 degrees.
+	const MaskType rotateXY( rotateX || rotateY );
+
+	R.col( 0 ) = negative0.select( -R.col( 0 ), R.col( 0 ) );
+	R.col( 3 ) = negative1.select( -R.col( 3 ), R.col( 3 ) );
+	R.col( 4 ) = negative1.select( -R.col( 4 ), R.col( 4 ) );
+	for( int c = 6; c < 9; ++c )
+	{
+		R.col( c ) = rotateXY.select( -R.col( c ), R.col( c ) );
+	}
+
+	cz = rotateZ.select( -cz, cz );
+	sz = ( rotateZ || rotateXY ).select( -sz, sz );
+	cy = rotateY.select( -cy, cy );
+	sy = rotateXY.select( -sy, sy );
+	cx = rotateX.select( -cx, cx );
+	sx = rotateX.select( -sx, sx );
+
+	// Calculate the orthogonal matrices Q = Qx^T * Qy^T * Qz^T, expanded in terms of the cosines and sines.
+	Q.col( 0 ) = cy * cz;
+	Q.col( 1 ) = cy * sz;
+	Q.col( 2 ) = -sy;
+	Q.col( 3 ) = sx * sy * cz - cx * sz;
+	Q.col( 4 ) = sx * sy * sz + cx * cz;
+	Q.col( 5 ) = sx * cy;
+	Q.col( 6 ) = cx * sy * cz + sx * sz;
+	Q.col( 7 ) = cx * sy * sz - sx * cz;
+	Q.col( 8 ) = cx * cy;
+
+	if( Qx != NULL )
+	{
+		Detail::buildGivensRotations< Real >( *Qx, 1, 2, cx, sx );
+	}
+
+	if( Qy != NULL )
+	{
+		Detail::buildGivensRotations< Real >( *Qy, 2, 0, cy, sy );
+	}
+
+	if( Qz != NULL )
+	{
+		Detail::buildGivensRotations< Real >( *Qz, 0, 1, cz, sz );
+	}
+
+	// Validate the results using the same test as the single matrix version and
+	// decompose any matrices which fail using it so that they are handled identically.
+	const Real tolerance = Detail::DecomposeRQ3x3Tolerance< Real >::value();
+	MaskType valid( MaskType::Constant( n, true ) );
+	for( int r = 0; r < 3; ++r )
+	{
+		for( int c = 0; c < 3; ++c )
+		{
+			ArrayType qr( Q.col( r * 3 ) * R.col( c ) + Q.col( r * 3 + 1 ) * R.col( 3 + c ) + Q.col( r * 3 + 2 ) * R.col( 6 + c ) );
+			valid = valid && ( ( qr - A.col( r * 3 + c ) ).abs() <= ( tolerance + tolerance * A.col( r * 3 + c ).abs() ) );
+		}
+	}
+
+	if( valid.all() )
+	{
+		return;
+	}
+
+	Eigen::Matrix< Real, 3, 3 > a, r, q, qx, qy, qz;
+	for( int i = 0; i < n; ++i )
+	{
+		if( valid( i ) )
+		{
+			continue;
+		}
+
+		Detail::getMatrix3x3( A, i, a );
+		givensDecomposeRQ3x3( a, r, q, qx, qy, qz );
+		Detail::setMatrix3x3( R, i, r );
+		Detail::setMatrix3x3( Q, i, q );
+
+		if( Qx != NULL )
+		{
+			Detail::setMatrix3x3( *Qx, i, qx );
+		}
+
+		if( Qy != NULL )
+		{
+			Detail::setMatrix3x3( *Qy, i, qy );
+		}
+
+		if( Qz != NULL )
+		{
+			Detail::setMatrix3x3( *Qz, i, qz );
+		}
+	}
+}
+
+// Explicitly instantiate the float and double versions of the decompositions.
+template void givensDecomposeRQ3x3< float >( const Eigen::Matrix3f &, Eigen::Matrix3f &, Eigen::Matrix3f &, Eigen::Matrix3f &, Eigen::Matrix3f &, Eigen::Matrix3f & );
+template void givensDecomposeRQ3x3< double >( const Eigen::Matrix3d &, Eigen::Matrix3d &, Eigen::Matrix3d &, Eigen::Matrix3d &, Eigen::Matrix3d &, Eigen::Matrix3d & );
+template void givensDecomposeRQ3x3< float >( const Eigen::Array< float, Eigen::Dynamic, 9 > &, Eigen::Array< float, Eigen::Dynamic, 9 > &, Eigen::Array< float, Eigen::Dynamic, 9 > &,
+	Eigen::Array< float, Eigen::Dynamic, 9 > *, Eigen::Array< float, Eigen::Dynamic, 9 > *, Eigen::Array< float, Eigen::Dynamic, 9 > * );
+template void givensDecomposeRQ3x3< double >( const Eigen::Array< double, Eigen::Dynamic, 9 > &, Eigen::Array< double, Eigen::Dynamic, 9 > &, Eigen::Array< double, Eigen::Dynamic, 9 > &,
+	Eigen::Array< double, Eigen::Dynamic, 9 > *, Eigen::Array< double, Eigen::Dynamic, 9 > *, Eigen::Array< double, Eigen::Dynamic, 9 > * );
+
 }; // namespace Gander
 
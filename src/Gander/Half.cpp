@@ -0,0 +1,124 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "Gander/Half.h"
+
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define GANDER_HAS_F16C_KERNELS
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace Gander
+{
+
+namespace Detail
+{
+
+#ifdef GANDER_HAS_F16C_KERNELS
+
+// Returns true if the processor and operating system support the AVX and F16C instructions.
+static bool hasF16C()
+{
+	__builtin_cpu_init();
+
+	unsigned int a = 0, b = 0, c = 0, d = 0;
+	if( !__get_cpuid( 1, &a, &b, &c, &d ) )
+	{
+		return false;
+	}
+	return ( c & bit_F16C ) != 0 && __builtin_cpu_supports( "avx" );
+}
+
+static const bool g_hasF16C = hasF16C();
+
+// Converts the largest multiple of 8 values that fits within n and returns the number converted.
+__attribute__(( target( "avx,f16c" ) ))
+static std::size_t convertHalfToFloatF16C( const half *src, float *dst, std::size_t n )
+{
+	std::size_t i = 0;
+	for( ; i + 8 <= n; i += 8 )
+	{
+		_mm256_storeu_ps( dst + i, _mm256_cvtph_ps( _mm_loadu_si128( reinterpret_cast< const __m128i * >( src + i ) ) ) );
+	}
+	return i;
+}
+
+// Converts the largest multiple of 8 values that fits within n and returns the number converted.
+__attribute__(( target( "avx,f16c" ) ))
+static std::size_t convertFloatToHalfF16C( const float *src, half *dst, std::size_t n )
+{
+	std::size_t i = 0;
+	for( ; i + 8 <= n; i += 8 )
+	{
+		_mm_storeu_si128( reinterpret_cast< __m128i * >( dst + i ), _mm256_cvtps_ph( _mm256_loadu_ps( src + i ), _MM_FROUND_TO_NEAREST_INT ) );
+	}
+	return i;
+}
+
+#endif
+
+}; // namespace Detail
+
+void convertHalfToFloat( const half *src, float *dst, std::size_t n )
+{
+	std::size_t i = 0;
+#ifdef GANDER_HAS_F16C_KERNELS
+	if( Detail::g_hasF16C )
+	{
+		i = Detail::convertHalfToFloatF16C( src, dst, n );
+	}
+#endif
+	for( ; i < n; ++i )
+	{
+		dst[i] = halfBitsToFloat( src[i].bits() );
+	}
+}
+
+void convertFloatToHalf( const float *src, half *dst, std::size_t n )
+{
+	std::size_t i = 0;
+#ifdef GANDER_HAS_F16C_KERNELS
+	if( Detail::g_hasF16C )
+	{
+		i = Detail::convertFloatToHalfF16C( src, dst, n );
+	}
+#endif
+	for( ; i < n; ++i )
+	{
+		dst[i] = half::fromBits( floatToHalfBits( src[i] ) );
+	}
+}
+
+}; // namespace Gander
@@ -50,78 +50,100 @@ namespace Detail
 {
 
 // The Levenberg Marquardt function.
+template< class Real >
 class HomographyLeastSquaresFn : public Gander::ErrorFn
 {
 
 public:
+
+	typedef Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > MatrixType;
+	typedef Eigen::Matrix< Real, Eigen::Dynamic, 1 > VectorType;
 	
-	HomographyLeastSquaresFn( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2 ) :
+	HomographyLeastSquaresFn( const MatrixType &points1, const MatrixType &points2 ) :
 		Gander::ErrorFn( points1.cols(), 2 ),
 		m_points1( points1 ),
 		m_points2( points2 )
 	{
 	}
 
-	int operator()( const Eigen::VectorXd &x, Eigen::VectorXd &fvec ) const
+	int operator()( const VectorType &x, VectorType &fvec ) const
 	{
 		// Build the homography matrix that we are going to refine.
-		Eigen::Matrix3d H;
+		Eigen::Matrix< Real, 3, 3 > H;
 		H << x(0), x(3), x(6), x(1), x(4), x(7), x(2), x(5), 1.;
 		
 		// Test the transformation of each point using the new homography.
 		const unsigned int nPoints( m_points1.cols() );
 		for( unsigned int i = 0; i < nPoints; i++ )
 		{
-			Eigen::Vector3d p1 = H * m_points1.col(i).homogeneous();
-			Eigen::Vector3d p2 = m_points2.col(i).homogeneous();
-			p1 /= p1[2];
-			double err = (p1 - p2).norm();
-			fvec(i) = err * err;
+			// The residual is taken from the x and y components alone. The homogeneous components are both 1 so they
+			// contribute nothing and subtracting the 3 element vectors lets the single precision version read past them.
+			Eigen::Matrix< Real, 3, 1 > p1 = H * m_points1.col(i).homogeneous();
+			Real dx = p1[0] / p1[2] - m_points2(0,i);
+			Real dy = p1[1] / p1[2] - m_points2(1,i);
+			fvec(i) = dx * dx + dy * dy;
 		}
 		return 0;
 	}
 
 private :
 
-	const Eigen::MatrixXd &m_points1;
-	const Eigen::MatrixXd &m_points2;
+	const MatrixType &m_points1;
+	const MatrixType &m_points2;
 
 };
 
 // The RANSAC estimator class.
-class HomographyEstimator : public Gander::RANSAC
+template< class Real >
+class HomographyEstimator : public Gander::RANSACEstimator< Real >
 {
 
 public :
 
+	typedef Gander::RANSACEstimator< Real > BaseType;
+	typedef typename BaseType::MatrixType MatrixType;
+	typedef typename BaseType::VectorType VectorType;
+
     HomographyEstimator( int modelPoints = 4 )
-		: RANSAC( std::max( modelPoints, 4 ), 1 )
+		: BaseType( std::max( modelPoints, 4 ), 1 )
 	{
+		this->setLocalOptimization( true );
 	}
 
 protected :
 	
-	virtual int runKernel( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, Eigen::MatrixXd &model )
+	virtual int runKernel( const MatrixType &points1, const MatrixType &points2, MatrixType &model )
 	{
 		return compute4PointPlaneToPlaneHomography( points1, points2, model ) == true ? 1 : 0;
 	}
 
-	virtual double computeModelError( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, const Eigen::MatrixXd &model, Eigen::VectorXd &error )
+	virtual double computeModelError( const MatrixType &points1, const MatrixType &points2, const MatrixType &model, VectorType &error )
 	{
 		return computePlaneToPlaneHomographyError( points1, points2, model, error );
 	}
 
+	virtual bool runLeastSquaresKernel( const MatrixType &points1, const MatrixType &points2, MatrixType &model )
+	{
+		return computeLeastSquaresPlaneToPlaneHomography( points1, points2, model );
+	}
+
 };
 
 } // namespace Detail
 
-bool refineHomography( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, Eigen::MatrixXd &H, int maxIters )
+template< class Real >
+bool refineHomography(
+		const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points1,
+		const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points2,
+		Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &H,
+		int maxIters
+	)
 {
-	Detail::HomographyLeastSquaresFn functor( points1, points2 );
-	ForwardDifferenceJacobian< Detail::HomographyLeastSquaresFn, double > fn( functor );
-	Eigen::LevenbergMarquardt< ForwardDifferenceJacobian< Detail::HomographyLeastSquaresFn, double >, double > lm( fn );
+	Detail::HomographyLeastSquaresFn< Real > functor( points1, points2 );
+	ForwardDifferenceJacobian< Detail::HomographyLeastSquaresFn< Real >, Real > fn( functor );
+	Eigen::LevenbergMarquardt< ForwardDifferenceJacobian< Detail::HomographyLeastSquaresFn< Real >, Real >, Real > lm( fn );
 
-	Eigen::VectorXd x(8);
+	Eigen::Matrix< Real, Eigen::Dynamic, 1 > x(8);
 	x << H(0,0), H(1,0), H(2,0), H(0,1), H(1,1), H(2,1), H(0,2), H(1,2);
 	
 	lm.parameters.ftol = 10e-6;
@@ -134,11 +156,12 @@ bool refineHomography( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &po
 	return true;
 }
 
+template< class Real >
 double computePlaneToPlaneHomographyError(
-		const Eigen::MatrixXd &points1,
-		const Eigen::MatrixXd &points2,
-		const Eigen::MatrixXd &H,
-		Eigen::VectorXd &error
+		const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points1,
+		const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points2,
+		const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &H,
+		Eigen::Matrix< Real, Eigen::Dynamic, 1 > &error
 	)
 {
 	double sum = 0;
@@ -147,17 +170,22 @@ double computePlaneToPlaneHomographyError(
 
 	for( unsigned int i = 0; i < nPoints; i++ )
 	{
-		Eigen::Vector3d p1 = H * points1.col(i).homogeneous();
-		Eigen::Vector3d p2 = points2.col(i).homogeneous();
-		p1 /= p1[2];
-		double err = (p1 - p2).norm();
-		sum += error[i] = err * err;
+		Eigen::Matrix< Real, 3, 1 > p1 = H * points1.col(i).homogeneous();
+		Real dx = p1[0] / p1[2] - points2(0,i);
+		Real dy = p1[1] / p1[2] - points2(1,i);
+		sum += error[i] = dx * dx + dy * dy;
 	}
 	return sum / double( nPoints );
 }
 
-bool computePlaneToPlaneHomography( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, Eigen::MatrixXd &H,
-	std::vector<bool> &mask, double reprojectionErrorThreshold )
+template< class Real >
+bool computePlaneToPlaneHomography(
+		const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points1,
+		const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points2,
+		Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &H,
+		std::vector<bool> &mask,
+		double reprojectionErrorThreshold
+	)
 {
 	if( points1.size() != points2.size() )
 	{
@@ -179,7 +207,7 @@ bool computePlaneToPlaneHomography( const Eigen::MatrixXd &points1, const Eigen:
 	else
 	{
 		// Otherwise, use RANSAC to remove the outliers.
-		Detail::HomographyEstimator estimator(4);
+		Detail::HomographyEstimator< Real > estimator(4);
 		estimator.setThreshold( reprojectionErrorThreshold );
 		result = estimator( points1, points2, H, mask );
 	}
@@ -187,11 +215,82 @@ bool computePlaneToPlaneHomography( const Eigen::MatrixXd &points1, const Eigen:
 	return result;
 }
 
+bool computePlaneToPlaneHomographyMixedPrecision( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, Eigen::MatrixXd &H,
+	std::vector<bool> &mask, double reprojectionErrorThreshold, int maxRefits )
+{
+	if( points1.size() != points2.size() )
+	{
+		throw std::runtime_error( "computePlaneToPlaneHomographyMixedPrecision: Point lists must be of the same length." );
+	}
+
+	// Score the hypotheses in single precision.
+	Eigen::MatrixXf points1f( points1.cast<float>() ), points2f( points2.cast<float>() ), Hf( 3, 3 );
+	if( !computePlaneToPlaneHomography( points1f, points2f, Hf, mask, reprojectionErrorThreshold ) )
+	{
+		return false;
+	}
+	H = Hf.cast<double>();
+
+	// Now refit the result to its inliers in double precision. This recovers any inliers that were lost to rounding whilst scoring.
+	Detail::HomographyEstimator< double > estimator(4);
+	estimator.setThreshold( reprojectionErrorThreshold );
+	estimator.setMaxLocalOptimizationIterations( maxRefits );
+	estimator.refitToInliers( points1, points2, H, mask );
+
+	return true;
+}
+
+template< class Real >
+bool compute4PointPlaneToPlaneHomography(
+		const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points1,
+		const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points2,
+		Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &H
+	)
+{
+	if( points1.cols() != 4 || points2.cols() != 4 )
+	{
+		throw std::runtime_error( "computePlaneToPlaneHomography: Only 4 point correspondences may be specified." );
+	}
+
+	return computeLeastSquaresPlaneToPlaneHomography( points1, points2, H );
+}
+
+template< class Real >
+unsigned int computeMultiplePlaneToPlaneHomographies(
+		const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points1,
+		const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points2,
+		std::vector< Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > > &H,
+		std::vector<int> &labels,
+		unsigned int maxHomographies,
+		double reprojectionErrorThreshold,
+		unsigned int minInliers
+	)
+{
+	if( points1.size() != points2.size() )
+	{
+		throw std::runtime_error( "computeMultiplePlaneToPlaneHomographies: Point lists must be of the same length." );
+	}
+
+	H.assign( maxHomographies, Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic >::Identity( 3, 3 ) );
+
+	Detail::HomographyEstimator< Real > estimator(4);
+	estimator.setThreshold( reprojectionErrorThreshold );
+	return estimator( points1, points2, H, labels, minInliers );
+}
+
 // Compute the homography matrix using a Homogeneous solution and minimize using SVD.
 // See the following link for details...
 // http://www.robots.ox.ac.uk/~vgg/presentations/bmvc97/criminispaper/node3.html
-bool compute4PointPlaneToPlaneHomography( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, Eigen::MatrixXd &H )
+template< class Real >
+bool computeLeastSquaresPlaneToPlaneHomography(
+		const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points1,
+		const Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &points2,
+		Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > &H
+	)
 {
+	typedef Eigen::Matrix< Real, Eigen::Dynamic, Eigen::Dynamic > MatrixType;
+	typedef Eigen::Matrix< Real, 2, 1 > Vector2Type;
+
 	if( points1.cols() != points2.cols() || points1.rows() != points2.rows() )
 	{
 		throw std::runtime_error( "computePlaneToPlaneHomography: Point lists must be of the same length." );
@@ -204,9 +303,9 @@ bool compute4PointPlaneToPlaneHomography( const Eigen::MatrixXd &points1, const
 	}
 	
 	const unsigned int nPoints = points1.cols();
-	if( nPoints != 4 )
+	if( nPoints < 4 )
 	{
-		throw std::runtime_error( "computePlaneToPlaneHomography: Only 4 point correspondences may be specified." );
+		throw std::runtime_error( "computePlaneToPlaneHomography: At least 4 point correspondences must be specified." );
 	}
 	
 	if( H.cols() != 3 || H.rows() != 3 )
@@ -216,18 +315,18 @@ bool compute4PointPlaneToPlaneHomography( const Eigen::MatrixXd &points1, const
 
 	// To aid the decomposition we normalize the two point clouds by moving their centroid to the origin and then scaling them so the average distance
 	// to the origin is sqrt(s).
-	Eigen::Vector2d centroid1( 0., 0. );
-	Eigen::Vector2d centroid2( 0., 0. );
+	Vector2Type centroid1( 0., 0. );
+	Vector2Type centroid2( 0., 0. );
 	for( unsigned int i = 0; i < nPoints; ++i )
 	{
 		centroid1 += points1.col(i);
 		centroid2 += points2.col(i);
 	}
-	centroid1 /= double( nPoints );
-	centroid2 /= double( nPoints );
+	centroid1 /= Real( nPoints );
+	centroid2 /= Real( nPoints );
 
-	Eigen::Vector2d sm1( 0., 0. );
-	Eigen::Vector2d sm2( 0., 0. );
+	Vector2Type sm1( 0., 0. );
+	Vector2Type sm2( 0., 0. );
     for( unsigned int i = 0; i < nPoints; ++i )
     {
         sm1[0] += fabs( points1(0,i) - centroid1[0] );
@@ -236,35 +335,35 @@ bool compute4PointPlaneToPlaneHomography( const Eigen::MatrixXd &points1, const
         sm2[1] += fabs( points2(1,i) - centroid2[1] );
     }
     
-	if( fabs( sm1[0] ) < std::numeric_limits<double>::epsilon() 
-			|| fabs( sm1[1] ) < std::numeric_limits<double>::epsilon() 
-			|| fabs( sm2[0] ) < std::numeric_limits<double>::epsilon() 
-			|| fabs( sm2[1] ) < std::numeric_limits<double>::epsilon()
+	if( fabs( sm1[0] ) < std::numeric_limits<Real>::epsilon() 
+			|| fabs( sm1[1] ) < std::numeric_limits<Real>::epsilon() 
+			|| fabs( sm2[0] ) < std::numeric_limits<Real>::epsilon() 
+			|| fabs( sm2[1] ) < std::numeric_limits<Real>::epsilon()
 		)
 	{
         return false;
 	}
 
-	sm1[0] = double( nPoints ) / sm1[0];
-	sm1[1] = double( nPoints ) / sm1[1];
-	sm2[0] = double( nPoints ) / sm2[0];
-	sm2[1] = double( nPoints ) / sm2[1];
+	sm1[0] = Real( nPoints ) / sm1[0];
+	sm1[1] = Real( nPoints ) / sm1[1];
+	sm2[0] = Real( nPoints ) / sm2[0];
+	sm2[1] = Real( nPoints ) / sm2[1];
 
 	// Build the matrices that can normalize and un-normalize the points.	
-	Eigen::MatrixXd invHnorm(3,3), Hnorm2(3,3);
+	MatrixType invHnorm(3,3), Hnorm2(3,3);
 	invHnorm << 1. / sm2[0], 0., 0., 0., 1. / sm2[1], 0., centroid2[0], centroid2[1], 1.;
 	Hnorm2 << sm1[0], 0., 0., 0., sm1[1], 0., -centroid1[0]*sm1[0], -centroid1[1]*sm1[1], 1.;
 	
-	Eigen::MatrixXd A = Eigen::MatrixXd::Zero(9, 9);
+	MatrixType A = MatrixType::Zero(9, 9);
 	for( unsigned int i = 0; i < nPoints; ++i )
 	{
-		const Eigen::Vector2d &p1( points1.col(i) );
-		const Eigen::Vector2d &p2( points2.col(i) );
+		const Vector2Type &p1( points1.col(i) );
+		const Vector2Type &p2( points2.col(i) );
         
-        double x1 = ( p1[0] - centroid1[0] ) * sm1[0], y1 = ( p1[1] - centroid1[1] ) * sm1[1];
-        double x2 = ( p2[0] - centroid2[0] ) * sm2[0], y2 = ( p2[1] - centroid2[1] ) * sm2[1];
-        double Lx[] = { x1, y1, 1, 0, 0, 0, -x2*x1, -x2*y1, -x2 };
-        double Ly[] = { 0, 0, 0, x1, y1, 1, -y2*x1, -y2*y1, -y2 };
+        Real x1 = ( p1[0] - centroid1[0] ) * sm1[0], y1 = ( p1[1] - centroid1[1] ) * sm1[1];
+        Real x2 = ( p2[0] - centroid2[0] ) * sm2[0], y2 = ( p2[1] - centroid2[1] ) * sm2[1];
+        Real Lx[] = { x1, y1, 1, 0, 0, 0, -x2*x1, -x2*y1, -x2 };
+        Real Ly[] = { 0, 0, 0, x1, y1, 1, -y2*x1, -y2*y1, -y2 };
         for( int j = 0; j < 9; j++ )
 		{
             for( int k = j; k < 9; k++ )
@@ -283,9 +382,9 @@ bool compute4PointPlaneToPlaneHomography( const Eigen::MatrixXd &points1, const
 			A(k,j) = A(j,k);
 		}
 	}
-	Eigen::JacobiSVD<Eigen::MatrixXd> svdOfA( A, Eigen::ComputeFullV );
+	Eigen::JacobiSVD<MatrixType> svdOfA( A, Eigen::ComputeFullV );
 
-	const Eigen::MatrixXd V = svdOfA.matrixV();
+	const MatrixType V = svdOfA.matrixV();
 	for( int i = 0, k = 0; i < 3; ++i )
 	{
 		for( int j = 0; j < 3; ++j, ++k )
@@ -301,5 +400,24 @@ bool compute4PointPlaneToPlaneHomography( const Eigen::MatrixXd &points1, const
 	return true;
 }
 
-}; // namespace Gander
+// Explicitly instantiate the float and double versions of the functions.
+#define GANDER_INSTANTIATE_HOMOGRAPHY( REAL ) \
+	template bool computePlaneToPlaneHomography< REAL >( const Eigen::Matrix< REAL, Eigen::Dynamic, Eigen::Dynamic > &, \
+		const Eigen::Matrix< REAL, Eigen::Dynamic, Eigen::Dynamic > &, Eigen::Matrix< REAL, Eigen::Dynamic, Eigen::Dynamic > &, std::vector<bool> &, double ); \
+	template unsigned int computeMultiplePlaneToPlaneHomographies< REAL >( const Eigen::Matrix< REAL, Eigen::Dynamic, Eigen::Dynamic > &, \
+		const Eigen::Matrix< REAL, Eigen::Dynamic, Eigen::Dynamic > &, std::vector< Eigen::Matrix< REAL, Eigen::Dynamic, Eigen::Dynamic > > &, \
+		std::vector<int> &, unsigned int, double, unsigned int ); \
+	template bool refineHomography< REAL >( const Eigen::Matrix< REAL, Eigen::Dynamic, Eigen::Dynamic > &, \
+		const Eigen::Matrix< REAL, Eigen::Dynamic, Eigen::Dynamic > &, Eigen::Matrix< REAL, Eigen::Dynamic, Eigen::Dynamic > &, int ); \
+	template double computePlaneToPlaneHomographyError< REAL >( const Eigen::Matrix< REAL, Eigen::Dynamic, Eigen::Dynamic > &, \
+		const Eigen::Matrix< REAL, Eigen::Dynamic, Eigen::Dynamic > &, const Eigen::Matrix< REAL, Eigen::Dynamic, Eigen::Dynamic > &, \
+		Eigen::Matrix< REAL, Eigen::Dynamic, 1 > & ); \
+	template bool compute4PointPlaneToPlaneHomography< REAL >( const Eigen::Matrix< REAL, Eigen::Dynamic, Eigen::Dynamic > &, \
+		const Eigen::Matrix< REAL, Eigen::Dynamic, Eigen::Dynamic > &, Eigen::Matrix< REAL, Eigen::Dynamic, Eigen::Dynamic > & ); \
+	template bool computeLeastSquaresPlaneToPlaneHomography< REAL >( const Eigen::Matrix< REAL, Eigen::Dynamic, Eigen::Dynamic > &, \
+		const Eigen::Matrix< REAL, Eigen::Dynamic, Eigen::Dynamic > &, Eigen::Matrix< REAL, Eigen::Dynamic, Eigen::Dynamic > & );
+
+GANDER_INSTANTIATE_HOMOGRAPHY( float )
+GANDER_INSTANTIATE_HOMOGRAPHY( double )
 
+}; // namespace Gander
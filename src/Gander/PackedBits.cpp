@@ -0,0 +1,210 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+
+#include "Gander/PackedBits.h"
+
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define GANDER_HAS_AVX2_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace Gander
+{
+
+namespace Detail
+{
+
+#ifdef GANDER_HAS_AVX2_KERNELS
+
+// Returns true if the processor and operating system support the AVX2 instructions.
+static bool hasAVX2()
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports( "avx2" );
+}
+
+static const bool g_hasAVX2 = hasAVX2();
+
+// Unpacks groups of 8 values which start at the given bit offset into the first byte of src and returns the number unpacked.
+// Each group of 8 values occupies WIDTH whole bytes, so every group starts at the same bit offset. The 16 bytes that hold a
+// group are loaded into both lanes of a register and shuffled so that each 32-bit element holds the bytes that its value
+// starts in. The elements are then shifted into place by their bit offsets.
+template< unsigned WIDTH >
+__attribute__(( target( "avx2" ) ))
+static std::size_t unpackBitsToFloatAVX2( const int8u *src, unsigned int bit, float *dst, std::size_t n )
+{
+	int8u shuffle[32];
+	int32u shifts[8];
+	for( unsigned int i = 0; i < 8; ++i )
+	{
+		const unsigned int start = bit + i * WIDTH;
+		const unsigned int numberOfBytes = ( ( start & 7 ) + WIDTH + 7 ) >> 3;
+		for( unsigned int j = 0; j < 4; ++j )
+		{
+			shuffle[i * 4 + j] = j < numberOfBytes ? int8u( ( start >> 3 ) + j ) : int8u( 0x80 );
+		}
+		shifts[i] = start & 7;
+	}
+
+	const __m256i shuffleMask = _mm256_loadu_si256( reinterpret_cast< const __m256i * >( shuffle ) );
+	const __m256i shiftMask = _mm256_loadu_si256( reinterpret_cast< const __m256i * >( shifts ) );
+	const __m256i valueMask = _mm256_set1_epi32( PackedBits< WIDTH >::MaximumValue );
+	const __m256 scale = _mm256_set1_ps( 1.f / float( PackedBits< WIDTH >::MaximumValue ) );
+
+	std::size_t i = 0;
+	const std::size_t totalBytes = ( bit + n * WIDTH + 7 ) >> 3;
+	for( ; i + 8 <= n && ( i / 8 ) * WIDTH + 16 <= totalBytes; i += 8 )
+	{
+		const __m128i bytes = _mm_loadu_si128( reinterpret_cast< const __m128i * >( src + ( i / 8 ) * WIDTH ) );
+		__m256i values = _mm256_shuffle_epi8( _mm256_broadcastsi128_si256( bytes ), shuffleMask );
+		values = _mm256_and_si256( _mm256_srlv_epi32( values, shiftMask ), valueMask );
+		_mm256_storeu_ps( dst + i, _mm256_mul_ps( _mm256_cvtepi32_ps( values ), scale ) );
+	}
+	return i;
+}
+
+// Converts groups of 8 floats into integer values using AVX2 and returns the number converted.
+template< unsigned WIDTH >
+__attribute__(( target( "avx2" ) ))
+static std::size_t quantizeAVX2( const float *src, int32u *dst, std::size_t n )
+{
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps( 1.f );
+	const __m256 scale = _mm256_set1_ps( float( PackedBits< WIDTH >::MaximumValue ) );
+
+	std::size_t i = 0;
+	for( ; i + 8 <= n; i += 8 )
+	{
+		// The comparison is ordered so that NaNs are clamped to 0.
+		const __m256 v = _mm256_min_ps( _mm256_max_ps( _mm256_loadu_ps( src + i ), zero ), one );
+		_mm256_storeu_si256( reinterpret_cast< __m256i * >( dst + i ), _mm256_cvtps_epi32( _mm256_mul_ps( v, scale ) ) );
+	}
+	return i;
+}
+
+#endif
+
+// Clamps f to the range [0, 1] and returns the nearest WIDTH bit value, rounding ties to even as _mm256_cvtps_epi32() does.
+template< unsigned WIDTH >
+inline int32u quantize( float f )
+{
+	f = f > 0.f ? ( f < 1.f ? f : 1.f ) : 0.f;
+	return int32u( nearbyintf( f * float( PackedBits< WIDTH >::MaximumValue ) ) );
+}
+
+}; // namespace Detail
+
+template< unsigned WIDTH >
+void unpackBitsToFloat( PackedBitsPointer< WIDTH > src, float *dst, std::size_t n )
+{
+	std::size_t i = 0;
+#ifdef GANDER_HAS_AVX2_KERNELS
+	// The 16 bytes that are loaded for each group of 8 values must include the last byte of the group.
+	if( Detail::g_hasAVX2 && WIDTH <= 14 )
+	{
+		i = Detail::unpackBitsToFloatAVX2< WIDTH >( src.data(), src.bit(), dst, n );
+	}
+#endif
+	const float scale = 1.f / float( PackedBits< WIDTH >::MaximumValue );
+	for( ; i < n; ++i )
+	{
+		dst[i] = float( int16u( src[i] ) ) * scale;
+	}
+}
+
+template< unsigned WIDTH >
+void packFloatToBits( const float *src, PackedBitsPointer< WIDTH > dst, std::size_t n )
+{
+	// There is nothing to write, and the first byte of dst may not exist.
+	if( n == 0 )
+	{
+		return;
+	}
+
+	// The floats are quantized in blocks and then the bits of each value are appended to an accumulator
+	// which is written out a byte at a time.
+	enum { BlockSize = 256 };
+	int32u values[BlockSize];
+
+	int8u *data = dst.data();
+	int64u accumulator = data[0] & ( ( 1u << dst.bit() ) - 1 );
+	unsigned int numberOfBits = dst.bit();
+	
+	for( std::size_t block = 0; block < n; block += BlockSize )
+	{
+		const std::size_t size = std::min< std::size_t >( BlockSize, n - block );
+		std::size_t i = 0;
+#ifdef GANDER_HAS_AVX2_KERNELS
+		if( Detail::g_hasAVX2 )
+		{
+			i = Detail::quantizeAVX2< WIDTH >( src + block, values, size );
+		}
+#endif
+		for( ; i < size; ++i )
+		{
+			values[i] = Detail::quantize< WIDTH >( src[block + i] );
+		}
+
+		for( i = 0; i < size; ++i )
+		{
+			accumulator |= int64u( values[i] ) << numberOfBits;
+			numberOfBits += WIDTH;
+			while( numberOfBits >= 8 )
+			{
+				*data++ = int8u( accumulator );
+				accumulator >>= 8;
+				numberOfBits -= 8;
+			}
+		}
+	}
+
+	// Merge the remaining bits with those of the last byte that follow the packed values.
+	if( numberOfBits > 0 )
+	{
+		const int8u mask = int8u( ( 1u << numberOfBits ) - 1 );
+		*data = int8u( ( *data & ~mask ) | ( int8u( accumulator ) & mask ) );
+	}
+}
+
+#define GANDER_INSTANTIATE_PACKED_BITS( WIDTH ) \
+template void unpackBitsToFloat< WIDTH >( PackedBitsPointer< WIDTH > src, float *dst, std::size_t n ); \
+template void packFloatToBits< WIDTH >( const float *src, PackedBitsPointer< WIDTH > dst, std::size_t n );
+
+GANDER_INSTANTIATE_PACKED_BITS( 10 )
+GANDER_INSTANTIATE_PACKED_BITS( 12 )
+
+}; // namespace Gander
@@ -43,7 +43,28 @@
 namespace Gander
 {
 
-RANSAC::RANSAC( int modelPoints, int maxBasicSolutions )
+namespace Detail
+{
+
+/// Returns the average error of the points which are flagged as inliers by the mask.
+template< class Vector >
+double consensusError( const Vector &error, const std::vector<bool> &mask, int nInliers )
+{
+	double sum = 0.;
+	for( unsigned int i = 0; i < mask.size(); ++i )
+	{
+		if( mask[i] )
+		{
+			sum += error[i];
+		}
+	}
+	return nInliers > 0 ? sum / double( nInliers ) : 0.;
+}
+
+} // namespace Detail
+
+template< class Real >
+RANSACEstimator< Real >::RANSACEstimator( int modelPoints, int maxBasicSolutions )
 	: m_seed( -1 ),
 	m_modelPoints( modelPoints ),
 	m_maxBasicSolutions( maxBasicSolutions ),
@@ -51,17 +72,22 @@ RANSAC::RANSAC( int modelPoints, int maxBasicSolutions )
 	m_confidence( .99 ),
 	m_maxIters( 2000 ),
 	m_maxRefineIters( 10 ),
-	m_threshold( .0001 )
+	m_threshold( .0001 ),
+	m_localOptimization( false ),
+	m_maxLocalOptimizationIters( 4 ),
+	m_iterationsRun( 0 )
 {
 }
 
-RANSAC::~RANSAC()
+template< class Real >
+RANSACEstimator< Real >::~RANSACEstimator()
 {
 }
 
-int RANSAC::findInliers(
-		const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2,
-		const Eigen::MatrixXd &model, Eigen::VectorXd &error, double &avgError,
+template< class Real >
+int RANSACEstimator< Real >::findInliers(
+		const MatrixType &points1, const MatrixType &points2,
+		const MatrixType &model, VectorType &error, double &avgError,
 		std::vector<bool> &mask
 	)
 {
@@ -79,7 +105,8 @@ int RANSAC::findInliers(
     return nInliers;
 }
 
-int RANSAC::updateNumberOfIterations( double ep, int max_iters )
+template< class Real >
+int RANSACEstimator< Real >::updateNumberOfIterations( double ep, int max_iters )
 {
     ep = std::max( std::min( ep, 1. ), 0. );
 
@@ -98,7 +125,98 @@ int RANSAC::updateNumberOfIterations( double ep, int max_iters )
     return denom >= 0 || -num >= max_iters * ( -denom ) ? max_iters : (int)( round( num / denom ) );
 }
 
-bool RANSAC::checkSubset( const Eigen::MatrixXd &pointSamples, unsigned int nSamples )
+template< class Real >
+void RANSACEstimator< Real >::gatherInliers(
+		const MatrixType &points1, const MatrixType &points2,
+		const std::vector<bool> &mask, unsigned int nInliers,
+		MatrixType &inliers1, MatrixType &inliers2
+	) const
+{
+	inliers1.resize( points1.rows(), nInliers );
+	inliers2.resize( points2.rows(), nInliers );
+
+	unsigned int idx = 0;
+	const unsigned int nPoints = points1.cols();
+	for( unsigned int i = 0; i < nPoints && idx < nInliers; ++i )
+	{
+		if( mask[i] )
+		{
+			inliers1.col(idx) = points1.col(i);
+			inliers2.col(idx) = points2.col(i);
+			++idx;
+		}
+	}
+}
+
+template< class Real >
+void RANSACEstimator< Real >::localOptimization(
+		const MatrixType &points1, const MatrixType &points2,
+		MatrixType &model, VectorType &error, double &avgError,
+		std::vector<bool> &mask, int &nInliers
+	)
+{
+	MatrixType inliers1, inliers2;
+	MatrixType refitModel( model.rows(), model.cols() );
+	VectorType refitError;
+	std::vector<bool> refitMask( mask.size() );
+
+	for( int iter = 0; iter < m_maxLocalOptimizationIters; ++iter )
+	{
+		// Refit the model to the current consensus set.
+		gatherInliers( points1, points2, mask, nInliers, inliers1, inliers2 );
+		refitModel = model;
+		if( !runLeastSquaresKernel( inliers1, inliers2, refitModel ) )
+		{
+			return;
+		}
+
+		// Only keep the refit model if it explains more of the points (or the same points with less error).
+		// The error is compared over the consensus sets alone as the least squares fit does nothing to reduce the error of the outliers.
+		double refitAvgError;
+		int refitInliers = findInliers( points1, points2, refitModel, refitError, refitAvgError, refitMask );
+		if( refitInliers < nInliers || ( refitInliers == nInliers &&
+			Detail::consensusError( refitError, refitMask, refitInliers ) >= Detail::consensusError( error, mask, nInliers ) ) )
+		{
+			return;
+		}
+
+		bool grew = refitInliers > nInliers;
+		model = refitModel;
+		error.swap( refitError );
+		std::swap( mask, refitMask );
+		avgError = refitAvgError;
+		nInliers = refitInliers;
+
+		// Once the consensus set has converged there is nothing more to gain.
+		if( !grew )
+		{
+			return;
+		}
+	}
+}
+
+template< class Real >
+int RANSACEstimator< Real >::refitToInliers( const MatrixType &points1, const MatrixType &points2, MatrixType &model, std::vector<bool> &mask )
+{
+	if( points1.rows() != points2.rows() || points1.cols() != points2.cols() )
+	{
+		throw std::runtime_error( "RANSAC: Point lists have different numbers of elements." );
+	}
+
+	mask.resize( points1.cols() );
+
+	VectorType error;
+	double avgError;
+	int nInliers = findInliers( points1, points2, model, error, avgError, mask );
+	if( nInliers >= int( m_modelPoints ) )
+	{
+		localOptimization( points1, points2, model, error, avgError, mask, nInliers );
+	}
+	return nInliers;
+}
+
+template< class Real >
+bool RANSACEstimator< Real >::checkSubset( const MatrixType &pointSamples, unsigned int nSamples )
 {
     if( nSamples <= 2 )
 	{
@@ -137,7 +255,8 @@ bool RANSAC::checkSubset( const Eigen::MatrixXd &pointSamples, unsigned int nSam
     return i >= nSamples;
 }
 
-bool RANSAC::subset( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, Eigen::MatrixXd &pointsSample1, Eigen::MatrixXd &pointsSample2, unsigned int maxAttempts )
+template< class Real >
+bool RANSACEstimator< Real >::subset( const MatrixType &points1, const MatrixType &points2, MatrixType &pointsSample1, MatrixType &pointsSample2, unsigned int maxAttempts )
 {
 	unsigned int nPoints = points1.cols();
     std::vector<unsigned int> selectionIndices( m_modelPoints );
@@ -179,13 +298,15 @@ bool RANSAC::subset( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &poin
     return i == m_modelPoints && iters < maxAttempts;
 }
 	
-bool RANSAC::operator()( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, Eigen::MatrixXd &model, std::vector<bool> &initialMask )
+template< class Real >
+bool RANSACEstimator< Real >::operator()( const MatrixType &points1, const MatrixType &points2, MatrixType &model, std::vector<bool> &initialMask )
 {
 	// Validate our input parameters.
     m_confidence = std::max( std::min( m_confidence, 1. ), 0. );
 	
 	// Initialize the random number generator.
 	srand( m_seed );
+	m_iterationsRun = 0;
 	
 	unsigned int mostInliersFound = 0, niters = m_maxIters, nPoints = points1.cols();
 	double bestError = std::numeric_limits<double>::max();
@@ -212,10 +333,11 @@ bool RANSAC::operator()( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &
 		initialMask.resize( nPoints, false );
 	}
 
-	Eigen::MatrixXd pointsSample1, pointsSample2; // Holds the points currently being tested.
+	MatrixType pointsSample1, pointsSample2; // Holds the points currently being tested.
 	std::vector<bool> tmask( nPoints ); 
-	Eigen::MatrixXd models( model.rows() * m_maxBasicSolutions, model.cols() ); // Holds all of the models we are testing.
-	Eigen::VectorXd error( nPoints ); // One error per point.
+	MatrixType models( model.rows() * m_maxBasicSolutions, model.cols() ); // Holds all of the models we are testing.
+	VectorType error( nPoints ); // One error per point.
+	const bool useLocalOptimization( m_localOptimization && m_maxLocalOptimizationIters > 0 );
 
 	/// Is this an overdetermind system?
 	bool isOverdetermind( nPoints > m_modelPoints );
@@ -230,8 +352,8 @@ bool RANSAC::operator()( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &
         pointsSample1 = points1;
         pointsSample2 = points2;
     }
-	unsigned int c = 0;	
-	for( unsigned int iter = 0; iter < niters; ++iter )
+	unsigned int iter = 0;
+	for( ; iter < niters; ++iter )
     {
 		// Get a subset of the points to test.
         if( isOverdetermind )
@@ -260,7 +382,7 @@ bool RANSAC::operator()( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &
         for( unsigned int i = 0; i < nModels; i++ )
         {
 			// Get the current model.
-            Eigen::MatrixXd currentModel( model.rows(), model.cols() );
+            MatrixType currentModel( model.rows(), model.cols() );
 			currentModel = models.block( i * model.rows(), 0, model.rows(), model.cols() );
 	
 			// Use the model to divide the points into inliers and outliers.
@@ -269,17 +391,24 @@ bool RANSAC::operator()( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &
 
 			// If the model was better than any so far then keep it.
 			int requiredInliers = std::max( mostInliersFound, m_modelPoints-1 );
-            if( nInliers > requiredInliers || ( avgError > bestError && nInliers == requiredInliers ) )
+            if( nInliers > requiredInliers || ( mostInliersFound > 0 && nInliers == requiredInliers && avgError < bestError ) )
             {
+				// Refit the new best model to its inliers so that the termination criteria below is computed
+				// from a better estimate of the inlier ratio.
+				if( useLocalOptimization )
+				{
+					localOptimization( points1, points2, currentModel, error, avgError, tmask, nInliers );
+				}
+
                 std::swap( tmask, initialMask );
                 model = currentModel;
                 mostInliersFound = nInliers;
 				bestError = avgError;
-                niters = updateNumberOfIterations( double( m_modelPoints - nInliers ) / m_modelPoints, niters );
+                niters = updateNumberOfIterations( double( nPoints - nInliers ) / nPoints, niters );
             }
         }
-		c++;
     }
+	m_iterationsRun = iter;
 	
 	if( mostInliersFound > 0 )
     {
@@ -289,24 +418,196 @@ bool RANSAC::operator()( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &
 	// If we found the best model, refine it using only the inliers that fit it.
 	if( result )
 	{
-		Eigen::MatrixXd inliers1( 2, mostInliersFound );
-		Eigen::MatrixXd inliers2( 2, mostInliersFound );
-		unsigned int idx = 0;
+		MatrixType inliers1, inliers2;
+		gatherInliers( points1, points2, initialMask, mostInliersFound, inliers1, inliers2 );
+		result = refine( inliers1, inliers2, model, m_maxRefineIters );
+	}
+	
+	return result;
+}
+
+template< class Real >
+unsigned int RANSACEstimator< Real >::operator()(
+		const MatrixType &points1, const MatrixType &points2,
+		std::vector<MatrixType> &models, std::vector<int> &labels,
+		unsigned int minInliers
+	)
+{
+	// Validate our input parameters.
+    m_confidence = std::max( std::min( m_confidence, 1. ), 0. );
+	
+	// Initialize the random number generator.
+	srand( m_seed );
+	m_iterationsRun = 0;
+	
+	if( m_modelPoints < 1 )
+	{
+		throw std::runtime_error( "RANSAC: A least one point is required to compute the model." );
+	}
+	
+	if( points1.rows() != points2.rows() || points1.cols() != points2.cols() )
+	{
+		throw std::runtime_error( "RANSAC: Point lists have different numbers of elements." );
+	}
+
+	const unsigned int nPoints = points1.cols(), maxModels = models.size();
+	minInliers = std::max( minInliers, m_modelPoints );
+	labels.assign( nPoints, -1 );
+	
+	/// Test if there are enough points to proceed. 
+	if( maxModels == 0 || nPoints < minInliers || nPoints <= m_modelPoints )
+	{
+		models.clear();
+        return 0;
+	}
+	
+	const int modelRows = models[0].rows(), modelCols = models[0].cols();
+	const bool useLocalOptimization( m_localOptimization && m_maxLocalOptimizationIters > 0 );
+
+	// Buffers which are shared by all of the stages below.
+	MatrixType pointsSample1( points1.rows(), m_modelPoints ), pointsSample2( points2.rows(), m_modelPoints );
+	MatrixType kernelModels( modelRows * m_maxBasicSolutions, modelCols ), currentModel( modelRows, modelCols );
+	VectorType error( nPoints );
+	std::vector<bool> tmask( nPoints );
+	double avgError;
+
+	// Stage 1: Sample a single pool of hypotheses from all of the points. Enough samples are drawn to find the smallest
+	// model that we are interested in with the required confidence. Only the hypotheses which have enough inliers to be
+	// extracted are kept, along with their inlier masks so that they can be rescored later without recomputing their error.
+	const unsigned int niters = updateNumberOfIterations( 1. - double( minInliers ) / nPoints, m_maxIters );
+	std::vector<MatrixType> hypotheses;
+	std::vector<bool> hypothesisInliers;
+	
+	unsigned int iter = 0;
+	for( ; iter < niters; ++iter )
+	{
+		if( !subset( points1, points2, pointsSample1, pointsSample2, 300 ) )
+		{
+			break;
+		}
+
+		unsigned int nModels = runKernel( pointsSample1, pointsSample2, kernelModels );
+		for( unsigned int i = 0; i < nModels; i++ )
+		{
+			currentModel = kernelModels.block( i * modelRows, 0, modelRows, modelCols );
+			if( findInliers( points1, points2, currentModel, error, avgError, tmask ) >= int( minInliers ) )
+			{
+				hypotheses.push_back( currentModel );
+				hypothesisInliers.insert( hypothesisInliers.end(), tmask.begin(), tmask.end() );
+			}
+		}
+	}
+	m_iterationsRun = iter;
+
+	// Stage 2: Greedily extract the models from the pool.
+	std::vector<bool> claimed( nPoints, false ), hypothesisUsed( hypotheses.size(), false );
+	std::vector<unsigned int> unclaimedIndices;
+	unclaimedIndices.reserve( nPoints );
+	MatrixType unclaimed1, unclaimed2, inliers1, inliers2;
+	unsigned int nFound = 0;
+
+	while( nFound < maxModels )
+	{
+		// Find the hypothesis which explains the most points that are still unclaimed.
+		int bestHypothesis = -1;
+		unsigned int mostInliersFound = 0;
+		for( unsigned int h = 0; h < hypotheses.size(); ++h )
+		{
+			if( hypothesisUsed[h] )
+			{
+				continue;
+			}
+
+			std::vector<bool>::const_iterator inlier( hypothesisInliers.begin() + h * nPoints );
+			unsigned int nInliers = 0;
+			for( unsigned int i = 0; i < nPoints; ++i, ++inlier )
+			{
+				nInliers += *inlier && !claimed[i];
+			}
+
+			if( nInliers > mostInliersFound )
+			{
+				mostInliersFound = nInliers;
+				bestHypothesis = h;
+			}
+		}
+
+		if( bestHypothesis < 0 || mostInliersFound < minInliers )
+		{
+			break;
+		}
+		hypothesisUsed[bestHypothesis] = true;
+
+		// Compact the unclaimed points so that the refit only considers them.
+		unclaimedIndices.clear();
 		for( unsigned int i = 0; i < nPoints; ++i )
 		{
-			if( initialMask[i] )
+			if( !claimed[i] )
 			{
-				inliers1.col(idx) = points1.col(i);
-				inliers2.col(idx) = points2.col(i);
-				++idx;
+				unclaimedIndices.push_back( i );
 			}
 		}
+		
+		const unsigned int nUnclaimed = unclaimedIndices.size();
+		unclaimed1.resize( points1.rows(), nUnclaimed );
+		unclaimed2.resize( points2.rows(), nUnclaimed );
+		for( unsigned int i = 0; i < nUnclaimed; ++i )
+		{
+			unclaimed1.col(i) = points1.col( unclaimedIndices[i] );
+			unclaimed2.col(i) = points2.col( unclaimedIndices[i] );
+		}
 
-		result = refine( inliers1, inliers2, model, m_maxRefineIters );
+		currentModel = hypotheses[bestHypothesis];
+		tmask.resize( nUnclaimed );
+		int nInliers = findInliers( unclaimed1, unclaimed2, currentModel, error, avgError, tmask );
+		if( useLocalOptimization )
+		{
+			localOptimization( unclaimed1, unclaimed2, currentModel, error, avgError, tmask, nInliers );
+		}
+
+		if( nInliers < int( minInliers ) )
+		{
+			continue;
+		}
+
+		gatherInliers( unclaimed1, unclaimed2, tmask, nInliers, inliers1, inliers2 );
+		if( !refine( inliers1, inliers2, currentModel, m_maxRefineIters ) )
+		{
+			continue;
+		}
+
+		for( unsigned int i = 0; i < nUnclaimed; ++i )
+		{
+			if( tmask[i] )
+			{
+				claimed[ unclaimedIndices[i] ] = true;
+			}
+		}
+		
+		models[nFound++] = currentModel;
 	}
-	
-	return result;
+	models.resize( nFound );
+
+	// Stage 3: Label each pair of points with the model that explains it best.
+	VectorType bestError = VectorType::Constant( nPoints, m_threshold * m_threshold );
+	for( unsigned int m = 0; m < nFound; ++m )
+	{
+		computeModelError( points1, points2, models[m], error );
+		for( unsigned int i = 0; i < nPoints; ++i )
+		{
+			if( error[i] <= bestError[i] )
+			{
+				bestError[i] = error[i];
+				labels[i] = m;
+			}
+		}
+	}
+
+	return nFound;
 }
 
-}; // namespace Gander
+// Explicitly instantiate the float and double versions of the estimator.
+template class RANSACEstimator< float >;
+template class RANSACEstimator< double >;
 
+}; // namespace Gander
@@ -0,0 +1,270 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#if defined( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
+#include "Gander/SampleConversion.h"
+
+namespace Gander
+{
+
+namespace Detail
+{
+
+namespace
+{
+
+// The noise is a fixed sequence generated by a linear congruential generator, so conversions are repeatable.
+struct DitherNoise
+{
+	DitherNoise()
+	{
+		int32u state = 0x2545f491u;
+		for( unsigned int i = 0; i < DitherPeriod; ++i )
+		{
+			state = state * 1664525u + 1013904223u;
+			values[i] = ( float( state >> 24 ) + 0.5f ) * ( 1.f / 256.f ) - 0.5f;
+		}
+
+		for( unsigned int i = 0; i < 3; ++i )
+		{
+			values[DitherPeriod + i] = values[i];
+		}
+	}
+
+	float values[DitherPeriod + 3];
+};
+
+const DitherNoise g_ditherNoise;
+
+// Samples are converted through a float buffer of this many values.
+enum { BlockSize = 256 };
+
+// Converts n samples to floats, returning a pointer to the result. Floats are returned in place.
+inline const float *toFloat( const float *src, float *buffer, std::size_t n, const SampleConversion &conversion )
+{
+	return src;
+}
+
+inline const float *toFloat( const half *src, float *buffer, std::size_t n, const SampleConversion &conversion )
+{
+	convertHalfToFloat( src, buffer, n );
+	return buffer;
+}
+
+template< class T >
+inline const float *integerToFloat( const T *src, float *buffer, std::size_t n, const SampleConversion &conversion )
+{
+	std::size_t i = 0;
+#if defined( __SSE2__ )
+	const __m128 scale = _mm_set1_ps( conversion.normalised ? 1.f / float( SampleTraits< T >::Maximum ) : 1.f );
+	const __m128i zero = _mm_setzero_si128();
+	for( ; i + 4 <= n; i += 4 )
+	{
+		__m128i v;
+		if( sizeof( T ) == 1 )
+		{
+			int32 bytes;
+			std::memcpy( &bytes, src + i, 4 );
+			v = _mm_unpacklo_epi16( _mm_unpacklo_epi8( _mm_cvtsi32_si128( bytes ), zero ), zero );
+		}
+		else
+		{
+			v = _mm_unpacklo_epi16( _mm_loadl_epi64( reinterpret_cast< const __m128i * >( src + i ) ), zero );
+		}
+		_mm_storeu_ps( buffer + i, _mm_mul_ps( _mm_cvtepi32_ps( v ), scale ) );
+	}
+#endif
+	for( ; i < n; ++i )
+	{
+		buffer[i] = SampleToFloat< T >::apply( src[i], conversion );
+	}
+	return buffer;
+}
+
+inline const float *toFloat( const int8u *src, float *buffer, std::size_t n, const SampleConversion &conversion )
+{
+	return integerToFloat( src, buffer, n, conversion );
+}
+
+inline const float *toFloat( const int16u *src, float *buffer, std::size_t n, const SampleConversion &conversion )
+{
+	return integerToFloat( src, buffer, n, conversion );
+}
+
+// Converts n floats to samples. The index is the position of the first sample within the row.
+inline void fromFloat( const float *src, float *dst, std::size_t n, const SampleConversion &conversion, std::size_t index )
+{
+	if( src != dst )
+	{
+		std::memcpy( dst, src, n * sizeof( float ) );
+	}
+}
+
+inline void fromFloat( const float *src, half *dst, std::size_t n, const SampleConversion &conversion, std::size_t index )
+{
+	convertFloatToHalf( src, dst, n );
+}
+
+template< class T >
+inline void floatToInteger( const float *src, T *dst, std::size_t n, const SampleConversion &conversion, std::size_t index )
+{
+	std::size_t i = 0;
+#if defined( __SSE2__ )
+	const float maximum = float( SampleTraits< T >::Maximum );
+	const __m128 scale = _mm_set1_ps( conversion.normalised ? maximum : 1.f );
+	const __m128 upper = _mm_set1_ps( maximum );
+	const __m128 zero = _mm_setzero_ps();
+	const bool dither = conversion.rounding == RoundWithDither;
+	const float *noise = g_ditherNoise.values;
+	for( ; i + 4 <= n; i += 4 )
+	{
+		__m128 x = _mm_mul_ps( _mm_loadu_ps( src + i ), scale );
+		if( dither )
+		{
+			x = _mm_add_ps( x, _mm_loadu_ps( noise + ( conversion.ditherPhase + index + i ) % DitherPeriod ) );
+		}
+		
+		// The maximum is taken first so that NaNs become zero.
+		x = _mm_min_ps( _mm_max_ps( x, zero ), upper );
+		__m128i v = _mm_cvtps_epi32( x );
+		if( sizeof( T ) == 1 )
+		{
+			v = _mm_packus_epi16( _mm_packs_epi32( v, v ), v );
+			const int32 bytes = _mm_cvtsi128_si32( v );
+			std::memcpy( dst + i, &bytes, 4 );
+		}
+		else
+		{
+			// There is no unsigned saturating pack in SSE2 so the values are offset into the signed range and back.
+			const __m128i offset = _mm_set1_epi32( 0x8000 );
+			v = _mm_xor_si128( _mm_packs_epi32( _mm_sub_epi32( v, offset ), v ), _mm_set1_epi16( short( 0x8000 ) ) );
+			_mm_storel_epi64( reinterpret_cast< __m128i * >( dst + i ), v );
+		}
+	}
+#endif
+	for( ; i < n; ++i )
+	{
+		dst[i] = SampleFromFloat< T >::apply( src[i], conversion, unsigned( index + i ) );
+	}
+}
+
+inline void fromFloat( const float *src, int8u *dst, std::size_t n, const SampleConversion &conversion, std::size_t index )
+{
+	floatToInteger( src, dst, n, conversion, index );
+}
+
+inline void fromFloat( const float *src, int16u *dst, std::size_t n, const SampleConversion &conversion, std::size_t index )
+{
+	floatToInteger( src, dst, n, conversion, index );
+}
+
+template< class S, class D >
+struct ConvertSamples
+{
+	static void apply( const S *src, D *dst, std::size_t n, const SampleConversion &conversion )
+	{
+		float buffer[BlockSize];
+		for( std::size_t i = 0; i < n; i += BlockSize )
+		{
+			const std::size_t size = std::min< std::size_t >( BlockSize, n - i );
+			fromFloat( toFloat( src + i, buffer, size, conversion ), dst + i, size, conversion, i );
+		}
+	}
+};
+
+// A float source needs no buffer and is converted directly.
+template< class D >
+struct ConvertSamples< float, D >
+{
+	static void apply( const float *src, D *dst, std::size_t n, const SampleConversion &conversion )
+	{
+		fromFloat( src, dst, n, conversion, 0 );
+	}
+};
+
+// Converting a type to itself is always exact.
+template< class T >
+struct ConvertSamples< T, T >
+{
+	static void apply( const T *src, T *dst, std::size_t n, const SampleConversion &conversion )
+	{
+		if( src != dst )
+		{
+			std::memcpy( dst, src, n * sizeof( T ) );
+		}
+	}
+};
+
+// Resolves the ambiguity between the two specialisations above.
+template<>
+struct ConvertSamples< float, float >
+{
+	static void apply( const float *src, float *dst, std::size_t n, const SampleConversion &conversion )
+	{
+		fromFloat( src, dst, n, conversion, 0 );
+	}
+};
+
+} // namespace
+
+const float *ditherNoise()
+{
+	return g_ditherNoise.values;
+}
+
+}; // namespace Detail
+
+template< class S, class D >
+void convertSamples( const S *src, D *dst, std::size_t n, const SampleConversion &conversion )
+{
+	Detail::ConvertSamples< S, D >::apply( src, dst, n, conversion );
+}
+
+#define GANDER_INSTANTIATE_CONVERTSAMPLES( S ) \
+	template void convertSamples< S, int8u >( const S *, int8u *, std::size_t, const SampleConversion & ); \
+	template void convertSamples< S, int16u >( const S *, int16u *, std::size_t, const SampleConversion & ); \
+	template void convertSamples< S, half >( const S *, half *, std::size_t, const SampleConversion & ); \
+	template void convertSamples< S, float >( const S *, float *, std::size_t, const SampleConversion & );
+
+GANDER_INSTANTIATE_CONVERTSAMPLES( int8u )
+GANDER_INSTANTIATE_CONVERTSAMPLES( int16u )
+GANDER_INSTANTIATE_CONVERTSAMPLES( half )
+GANDER_INSTANTIATE_CONVERTSAMPLES( float )
+
+}; // namespace Gander
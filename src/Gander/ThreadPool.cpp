@@ -0,0 +1,201 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#include <stdexcept>
+#include <string>
+
+#include "Gander/ThreadPool.h"
+
+namespace Gander
+{
+
+/// The tasks of one call to run(), which waits for them all to finish.
+struct ThreadPool::Batch
+{
+	Batch( std::size_t size ) :
+		remaining( size ),
+		failed( false )
+	{
+	}
+
+	/// Runs one of the tasks, recording the first exception that any of them throw.
+	void runTask( const Task &task )
+	{
+		try
+		{
+			task();
+		}
+		catch( const std::exception &e )
+		{
+			fail( e.what() );
+		}
+		catch( ... )
+		{
+			fail( "ThreadPool: A task threw an unknown exception." );
+		}
+	}
+
+	void fail( const std::string &message )
+	{
+		boost::mutex::scoped_lock lock( mutex );
+		if( !failed )
+		{
+			failed = true;
+			error = message;
+		}
+	}
+
+	void finishTask()
+	{
+		boost::mutex::scoped_lock lock( mutex );
+		if( --remaining == 0 )
+		{
+			finished.notify_all();
+		}
+	}
+
+	boost::mutex mutex;
+	boost::condition_variable finished;
+	std::size_t remaining;
+	bool failed;
+	std::string error;
+};
+
+ThreadPool::ThreadPool() :
+	m_availableThreads( 0 ),
+	m_stopping( false )
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		boost::mutex::scoped_lock lock( m_mutex );
+		m_stopping = true;
+	}
+	m_jobQueued.notify_all();
+	m_threads.join_all();
+}
+
+ThreadPool &ThreadPool::global()
+{
+	static ThreadPool pool;
+	return pool;
+}
+
+unsigned int ThreadPool::hardwareConcurrency()
+{
+	return std::max( boost::thread::hardware_concurrency(), 1u );
+}
+
+void ThreadPool::run( const std::vector< Task > &tasks )
+{
+	if( tasks.empty() )
+	{
+		return;
+	}
+
+	Batch batch( tasks.size() );
+	{
+		boost::mutex::scoped_lock lock( m_mutex );
+		for( std::size_t i = 1; i < tasks.size(); ++i )
+		{
+			const Job job = { tasks[i], &batch };
+			m_jobs.push_back( job );
+			
+			// Make sure that every job has a thread to take it, so that tasks which wait on each other can't deadlock.
+			if( m_jobs.size() > m_availableThreads )
+			{
+				++m_availableThreads;
+				m_threads.create_thread( boost::bind( &ThreadPool::work, this ) );
+			}
+			else
+			{
+				m_jobQueued.notify_one();
+			}
+		}
+	}
+
+	batch.runTask( tasks[0] );
+	batch.finishTask();
+
+	boost::mutex::scoped_lock lock( batch.mutex );
+	while( batch.remaining != 0 )
+	{
+		batch.finished.wait( lock );
+	}
+
+	if( batch.failed )
+	{
+		throw std::runtime_error( batch.error );
+	}
+}
+
+unsigned int ThreadPool::numberOfThreads() const
+{
+	return m_threads.size();
+}
+
+void ThreadPool::work()
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	while( true )
+	{
+		while( m_jobs.empty() && !m_stopping )
+		{
+			m_jobQueued.wait( lock );
+		}
+
+		if( m_jobs.empty() )
+		{
+			--m_availableThreads;
+			return;
+		}
+
+		const Job job( m_jobs.front() );
+		m_jobs.pop_front();
+		--m_availableThreads;
+		lock.unlock();
+		
+		job.batch->runTask( job.task );
+
+		// The thread is available again before run() can return, so that the next call can reuse it.
+		lock.lock();
+		++m_availableThreads;
+		lock.unlock();
+		job.batch->finishTask();
+		lock.lock();
+	}
+}
+
+}; // namespace Gander
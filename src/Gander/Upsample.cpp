@@ -0,0 +1,152 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "Gander/Assert.h"
+#include "Gander/Upsample.h"
+
+#if defined( __SSE2__ )
+#define GANDER_HAS_SSE2_KERNELS
+#include <emmintrin.h>
+#endif
+
+namespace Gander
+{
+
+namespace Detail
+{
+
+// Returns the value of the full resolution row at x by interpolating between the two nearest subsampled values.
+inline float linearSample( const float *src, std::size_t srcWidth, std::size_t x, unsigned int ratio )
+{
+	const float s = ( float( x ) + .5f ) / float( ratio ) - .5f;
+	const float i = std::floor( s );
+	const float f = s - i;
+
+	const std::ptrdiff_t last = std::ptrdiff_t( srcWidth ) - 1;
+	const std::ptrdiff_t i0 = std::ptrdiff_t( i );
+	const float a = src[ i0 < 0 ? 0 : ( i0 > last ? last : i0 ) ];
+	const float b = src[ i0 + 1 > last ? last : i0 + 1 ];
+	return ( 1.f - f ) * a + f * b;
+}
+
+#ifdef GANDER_HAS_SSE2_KERNELS
+
+// Repeats each value of src twice, writing the largest multiple of 8 values that fits within width. Returns the number written.
+static std::size_t upsampleNearest2SSE2( const float *src, float *dst, std::size_t width )
+{
+	std::size_t x = 0;
+	for( ; x + 8 <= width; x += 8 )
+	{
+		const __m128 v = _mm_loadu_ps( src + x / 2 );
+		_mm_storeu_ps( dst + x, _mm_unpacklo_ps( v, v ) );
+		_mm_storeu_ps( dst + x + 4, _mm_unpackhi_ps( v, v ) );
+	}
+	return x;
+}
+
+// Interpolates the full resolution values from 2 up to the largest multiple of 8 that can be computed without
+// reading past either end of src. Returns the index of the first value that was not written.
+static std::size_t upsampleLinear2SSE2( const float *src, std::size_t srcWidth, float *dst, std::size_t width )
+{
+	const __m128 q = _mm_set1_ps( .25f );
+	const __m128 t = _mm_set1_ps( .75f );
+
+	std::size_t i = 1;
+	for( ; i + 5 <= srcWidth && 2 * i + 8 <= width; i += 4 )
+	{
+		const __m128 prev = _mm_loadu_ps( src + i - 1 );
+		const __m128 cur = _mm_loadu_ps( src + i );
+		const __m128 next = _mm_loadu_ps( src + i + 1 );
+		
+		// The weights are applied in the same order as linearSample() so that the results are identical.
+		const __m128 even = _mm_add_ps( _mm_mul_ps( q, prev ), _mm_mul_ps( t, cur ) );
+		const __m128 odd = _mm_add_ps( _mm_mul_ps( t, cur ), _mm_mul_ps( q, next ) );
+		_mm_storeu_ps( dst + 2 * i, _mm_unpacklo_ps( even, odd ) );
+		_mm_storeu_ps( dst + 2 * i + 4, _mm_unpackhi_ps( even, odd ) );
+	}
+	return 2 * i;
+}
+
+#endif
+
+}; // namespace Detail
+
+void upsampleNearest( const float *src, float *dst, std::size_t width, unsigned int ratio )
+{
+	GANDER_ASSERT( ratio > 0, "The subsampling ratio must be greater than zero." );
+
+	std::size_t x = 0;
+
+#ifdef GANDER_HAS_SSE2_KERNELS
+	if( ratio == 2 )
+	{
+		x = Detail::upsampleNearest2SSE2( src, dst, width );
+	}
+#endif
+
+	for( ; x < width; ++x )
+	{
+		dst[x] = src[x / ratio];
+	}
+}
+
+void upsampleLinear( const float *src, float *dst, std::size_t width, unsigned int ratio )
+{
+	GANDER_ASSERT( ratio > 0, "The subsampling ratio must be greater than zero." );
+	
+	const std::size_t srcWidth = ( width + ratio - 1 ) / ratio;
+	std::size_t x = 0;
+
+#ifdef GANDER_HAS_SSE2_KERNELS
+	if( ratio == 2 )
+	{
+		// The first two values are held at the edge and are computed separately.
+		for( ; x < 2 && x < width; ++x )
+		{
+			dst[x] = Detail::linearSample( src, srcWidth, x, ratio );
+		}
+		x = std::max( x, Detail::upsampleLinear2SSE2( src, srcWidth, dst, width ) );
+	}
+#endif
+
+	for( ; x < width; ++x )
+	{
+		dst[x] = Detail::linearSample( src, srcWidth, x, ratio );
+	}
+}
+
+}; // namespace Gander
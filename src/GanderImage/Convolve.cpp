@@ -0,0 +1,333 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cmath>
+
+#if defined( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
+#include "Gander/Assert.h"
+
+#include "GanderImage/Convolve.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+namespace Detail
+{
+
+// Returns true if all of the taps of a kernel are the same.
+static bool isBoxKernel( const std::vector< float > &kernel )
+{
+	return std::count( kernel.begin(), kernel.end(), kernel[0] ) == std::ptrdiff_t( kernel.size() );
+}
+
+// Computes dst[x] = sum( kernel[i] * src[x + i] ) for each of the width samples of dst.
+// The vector and scalar loops add the taps in the same order so their results are identical.
+static void convolveRow( const float *src, const std::vector< float > &kernel, float *dst, int32 width )
+{
+	const int32 size = int32( kernel.size() );
+	const float *k( &kernel[0] );
+	
+	int32 x = 0;
+#if defined( __SSE2__ )
+	for( ; x + 4 <= width; x += 4 )
+	{
+		__m128 sum = _mm_mul_ps( _mm_set1_ps( k[0] ), _mm_loadu_ps( src + x ) );
+		for( int32 i = 1; i < size; ++i )
+		{
+			sum = _mm_add_ps( sum, _mm_mul_ps( _mm_set1_ps( k[i] ), _mm_loadu_ps( src + x + i ) ) );
+		}
+		_mm_storeu_ps( dst + x, sum );
+	}
+#endif
+	for( ; x < width; ++x )
+	{
+		float sum = k[0] * src[x];
+		for( int32 i = 1; i < size; ++i )
+		{
+			sum += k[i] * src[x + i];
+		}
+		dst[x] = sum;
+	}
+}
+
+// Computes dst[x] = weight * sum( src[x + i] ) for i in [0, size) with a running sum.
+static void boxRow( const float *src, int32 size, float weight, float *dst, int32 width )
+{
+	// The sum is held in double precision so that it doesn't drift along long rows.
+	double sum = 0.;
+	for( int32 i = 0; i < size; ++i )
+	{
+		sum += src[i];
+	}
+	
+	dst[0] = float( sum * weight );
+	for( int32 x = 1; x < width; ++x )
+	{
+		sum += double( src[x + size - 1] ) - double( src[x - 1] );
+		dst[x] = float( sum * weight );
+	}
+}
+
+// Computes dst[x] = sum( kernel[j] * rows[j][x] ) for each of the width samples of dst.
+static void combineRows( const std::vector< const float * > &rows, const std::vector< float > &kernel, float *dst, int32 width )
+{
+	const int32 size = int32( kernel.size() );
+	const float *k( &kernel[0] );
+
+	int32 x = 0;
+#if defined( __SSE2__ )
+	for( ; x + 4 <= width; x += 4 )
+	{
+		__m128 sum = _mm_mul_ps( _mm_set1_ps( k[0] ), _mm_loadu_ps( rows[0] + x ) );
+		for( int32 j = 1; j < size; ++j )
+		{
+			sum = _mm_add_ps( sum, _mm_mul_ps( _mm_set1_ps( k[j] ), _mm_loadu_ps( rows[j] + x ) ) );
+		}
+		_mm_storeu_ps( dst + x, sum );
+	}
+#endif
+	for( ; x < width; ++x )
+	{
+		float sum = k[0] * rows[0][x];
+		for( int32 j = 1; j < size; ++j )
+		{
+			sum += k[j] * rows[j][x];
+		}
+		dst[x] = sum;
+	}
+}
+
+// Computes sums[x] += sign * row[x].
+static void accumulateRow( const float *row, float sign, float *sums, int32 width )
+{
+	int32 x = 0;
+#if defined( __SSE2__ )
+	const __m128 s = _mm_set1_ps( sign );
+	for( ; x + 4 <= width; x += 4 )
+	{
+		_mm_storeu_ps( sums + x, _mm_add_ps( _mm_loadu_ps( sums + x ), _mm_mul_ps( s, _mm_loadu_ps( row + x ) ) ) );
+	}
+#endif
+	for( ; x < width; ++x )
+	{
+		sums[x] += sign * row[x];
+	}
+}
+
+// Computes dst[x] = weight * sums[x].
+static void scaleRow( const float *sums, float weight, float *dst, int32 width )
+{
+	int32 x = 0;
+#if defined( __SSE2__ )
+	const __m128 w = _mm_set1_ps( weight );
+	for( ; x + 4 <= width; x += 4 )
+	{
+		_mm_storeu_ps( dst + x, _mm_mul_ps( w, _mm_loadu_ps( sums + x ) ) );
+	}
+#endif
+	for( ; x < width; ++x )
+	{
+		dst[x] = weight * sums[x];
+	}
+}
+
+}; // namespace Detail
+
+Convolve::Convolve() :
+	Op( 1 )
+{
+	setKernels( std::vector< float >( 1, 1.f ), std::vector< float >( 1, 1.f ) );
+}
+
+Convolve::Convolve( const std::vector< float > &horizontal, const std::vector< float > &vertical ) :
+	Op( 1 )
+{
+	setKernels( horizontal, vertical );
+}
+
+Convolve::~Convolve()
+{
+}
+
+void Convolve::setKernels( const std::vector< float > &horizontal, const std::vector< float > &vertical )
+{
+	GANDER_ASSERT( horizontal.size() % 2 == 1 && vertical.size() % 2 == 1, "Convolve: The kernels must have an odd number of taps." );
+	m_horizontal = horizontal;
+	m_vertical = vertical;
+	m_horizontalIsBox = Detail::isBoxKernel( m_horizontal );
+	m_verticalIsBox = Detail::isBoxKernel( m_vertical );
+}
+
+std::vector< float > Convolve::gaussianKernel( float sigma )
+{
+	GANDER_ASSERT( sigma >= 0.f, "Convolve: The deviation of a gaussian can't be negative." );
+	
+	const int32 radius = int32( std::ceil( sigma * 3.f ) );
+	std::vector< float > kernel( 2 * radius + 1, 1.f );
+	if( radius == 0 )
+	{
+		return kernel;
+	}
+	
+	double sum = 0.;
+	for( int32 i = -radius; i <= radius; ++i )
+	{
+		kernel[ i + radius ] = std::exp( -float( i * i ) / ( 2.f * sigma * sigma ) );
+		sum += kernel[ i + radius ];
+	}
+
+	for( std::vector< float >::iterator it( kernel.begin() ); it != kernel.end(); ++it )
+	{
+		*it = float( *it / sum );
+	}
+	return kernel;
+}
+
+std::vector< float > Convolve::boxKernel( int32 radius )
+{
+	GANDER_ASSERT( radius >= 0, "Convolve: The radius of a box can't be negative." );
+	return std::vector< float >( 2 * radius + 1, 1.f / float( 2 * radius + 1 ) );
+}
+
+void Convolve::hash( Hash &h ) const
+{
+	Op::hash( h );
+	h.append( m_horizontal.size() ).append( &m_horizontal[0], m_horizontal.size() * sizeof( float ) );
+	h.append( m_vertical.size() ).append( &m_vertical[0], m_vertical.size() * sizeof( float ) );
+}
+
+Box Convolve::inputRegion( unsigned int index, const Box &region ) const
+{
+	return region.padded( int32( m_horizontal.size() / 2 ), int32( m_vertical.size() / 2 ) );
+}
+
+int32 Convolve::minimumBlockHeight() const
+{
+	// Each block horizontally filters the size - 1 rows around it that the vertical kernel reaches as well as
+	// its own, so a block of height h filters ( size - 1 ) / h more rows than it outputs. Making blocks sixteen
+	// times that height keeps the rows that are filtered twice to about 6%.
+	return std::max< int32 >( 1, 16 * int32( m_vertical.size() - 1 ) );
+}
+
+void Convolve::computeRows( int32 y, int32 t, const std::vector< const Tile * > &inputs, Tile &output ) const
+{
+	const Tile &input( *inputs[0] );
+	const Box &box( output.box() );
+	const int32 width = box.width();
+	const int32 size = int32( m_vertical.size() );
+	const int32 radius = size / 2;
+	const int32 horizontalSize = int32( m_horizontal.size() );
+	if( width == 0 )
+	{
+		return;
+	}
+	
+	// The offset of the first sample of the input that is needed for the first sample of an output row.
+	const int32 inputOffset = box.x() - horizontalSize / 2 - input.box().x();
+	
+	// The ring holds the horizontally filtered input rows that are covered by the vertical kernel.
+	// Input row r is held in slot ( r - first ) % size.
+	const int32 first = y - radius;
+	std::vector< float > ring( size_t( size ) * width );
+	std::vector< const float * > rows( size );
+	std::vector< float > sums( m_verticalIsBox ? width : 0 );
+	
+	const ChannelSet channels( output.channels() );
+	for( ChannelSet::const_iterator c( channels.begin() ); c != channels.end(); ++c )
+	{
+		for( int32 r = first; r < t + radius; ++r )
+		{
+			const int32 row = r - radius;
+			float *slot( &ring[ size_t( ( r - first ) % size ) * width ] );
+
+			// A running vertical sum loses the row that is about to be overwritten.
+			const bool recompute = ( row - y ) % size == 0;
+			if( m_verticalIsBox && row > y && !recompute )
+			{
+				Detail::accumulateRow( slot, -1.f, &sums[0], width );
+			}
+
+			const float *src( input.row( *c, r ) + inputOffset );
+			if( m_horizontalIsBox )
+			{
+				Detail::boxRow( src, horizontalSize, m_horizontal[0], slot, width );
+			}
+			else
+			{
+				Detail::convolveRow( src, m_horizontal, slot, width );
+			}
+			
+			if( row < y )
+			{
+				continue;
+			}
+
+			if( m_verticalIsBox )
+			{
+				// The sums are started again every few rows so that rounding errors can't accumulate.
+				if( recompute )
+				{
+					std::fill( sums.begin(), sums.end(), 0.f );
+					for( int32 j = 0; j < size; ++j )
+					{
+						Detail::accumulateRow( &ring[ size_t( ( row - radius + j - first ) % size ) * width ], 1.f, &sums[0], width );
+					}
+				}
+				else
+				{
+					Detail::accumulateRow( slot, 1.f, &sums[0], width );
+				}
+				Detail::scaleRow( &sums[0], m_vertical[0], output.row( *c, row ), width );
+			}
+			else
+			{
+				for( int32 j = 0; j < size; ++j )
+				{
+					rows[j] = &ring[ size_t( ( row - radius + j - first ) % size ) * width ];
+				}
+				Detail::combineRows( rows, m_vertical, output.row( *c, row ), width );
+			}
+		}
+	}
+}
+
+}; // namespace Image
+
+}; // namespace Gander
@@ -0,0 +1,91 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+
+#include "GanderImage/Crop.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+Crop::Crop( const Box &box ) :
+	Op( 1 ),
+	m_box( box )
+{
+}
+
+Crop::~Crop()
+{
+}
+
+void Crop::hash( Hash &h ) const
+{
+	Op::hash( h );
+	h.append( m_box.x() ).append( m_box.y() ).append( m_box.r() ).append( m_box.t() );
+}
+
+Box Crop::inputRegion( unsigned int index, const Box &region ) const
+{
+	return region.intersection( m_box );
+}
+
+void Crop::computeRows( int32 y, int32 t, const std::vector< const Tile * > &inputs, Tile &output ) const
+{
+	const Box &outputBox( output.box() );
+	const Box inside( outputBox.intersection( m_box ) );
+	const Tile &input( *inputs[0] );
+	
+	const ChannelSet channels( output.channels() );
+	for( ChannelSet::const_iterator c( channels.begin() ); c != channels.end(); ++c )
+	{
+		for( int32 row = y; row < t; ++row )
+		{
+			float *dst( output.row( *c, row ) );
+			std::fill( dst, dst + outputBox.width(), 0.f );
+
+			if( row >= inside.y() && row < inside.t() )
+			{
+				const float *src( input.row( *c, row ) + ( inside.x() - input.box().x() ) );
+				std::copy( src, src + inside.width(), dst + ( inside.x() - outputBox.x() ) );
+			}
+		}
+	}
+}
+
+}; // namespace Image
+
+}; // namespace Gander
+
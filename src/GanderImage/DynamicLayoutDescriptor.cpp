@@ -0,0 +1,165 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+#include "boost/format.hpp"
+#include "boost/thread/mutex.hpp"
+
+#include "Gander/Assert.h"
+#include "GanderImage/DynamicLayoutDescriptor.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+namespace Detail
+{
+
+/// Returns the mutex that guards the registry of interned descriptors. The lock is only taken when channels are
+/// added to a layout and is held just long enough to search the registry.
+static boost::mutex &registryMutex()
+{
+	static boost::mutex m;
+	return m;
+}
+
+/// Returns the registry of all of the interned descriptors. The descriptors are never deleted.
+static std::vector< const DynamicLayoutDescriptor * > &registry()
+{
+	static std::vector< const DynamicLayoutDescriptor * > r;
+	return r;
+}
+
+DynamicLayoutDescriptor::DynamicLayoutDescriptor()
+{
+	std::memset( m_indices, 0, sizeof( m_indices ) );
+}
+
+const DynamicLayoutDescriptor *DynamicLayoutDescriptor::empty()
+{
+	static const DynamicLayoutDescriptor *e = intern( DynamicLayoutDescriptor() );
+	return e;
+}
+
+const DynamicLayoutDescriptor *DynamicLayoutDescriptor::addChannels( ChannelSet c, ChannelBrothers b ) const
+{
+	return intern( added( c, b, b != Brothers_None ? BrotherTraits<>::numberOfBrothers( b ) : 1 ) );
+}
+
+const DynamicLayoutDescriptor *DynamicLayoutDescriptor::addConstantChannels( ChannelSet c ) const
+{
+	DynamicLayoutDescriptor d( added( c, Brothers_None, 0 ) );
+	d.m_constantChannels += c;
+	return intern( d );
+}
+
+DynamicLayoutDescriptor DynamicLayoutDescriptor::added( ChannelSet c, ChannelBrothers b, int8u step ) const
+{
+	GANDER_ASSERT(
+		( b == Brothers_None || BrotherTraits<>::channels( b ).contains( c ) ),
+		( boost::format( "DynamicLayout: Channels \"%s\" do not belong to the specified brothers." ) % c ).str()
+	);
+
+	GANDER_ASSERT(
+		( !m_allBrothers.contains( c ) ),
+		( boost::format( "DynamicLayout: Channels \"%s\" cannot be added as another set of ChannelBrothers represents it." ) % c ).str()
+	);
+	
+	GANDER_ASSERT(
+		( m_channels.intersection( c ).size() == 0 ),
+		( boost::format( "DynamicLayout: Channels \"%s\" cannot be added as some of the channels are already represented by the layout." ) % c ).str()
+	);
+
+	DynamicLayoutDescriptor d( *this );
+	
+	if( b != Brothers_None )
+	{
+		d.m_allBrothers += BrotherTraits<>::brotherMask( b );
+	}
+	else
+	{
+		d.m_allBrothers += c;
+	}
+
+	ChannelSet newChannels( c - m_channels );
+	ChannelSet::const_iterator it( newChannels.begin() );
+	ChannelSet::const_iterator end( newChannels.end() );
+	for( ; it != end; ++it )
+	{
+		d.m_channels += *it;
+		int index = d.m_channels.index( *it );
+		d.m_steps.insert( d.m_steps.begin() + index, step );
+	}
+
+	it = d.m_channels.begin();
+	end = d.m_channels.end();
+	for( ; it != end; ++it )
+	{
+		d.m_indices[ *it ] = d.m_channels.index( *it );
+	}
+
+	return d;
+}
+
+const DynamicLayoutDescriptor *DynamicLayoutDescriptor::intern( const DynamicLayoutDescriptor &descriptor )
+{
+	boost::mutex::scoped_lock lock( registryMutex() );
+	
+	std::vector< const DynamicLayoutDescriptor * > &r( registry() );
+	for( std::vector< const DynamicLayoutDescriptor * >::const_iterator it( r.begin() ); it != r.end(); ++it )
+	{
+		if(
+			( *it )->m_channels == descriptor.m_channels &&
+			( *it )->m_constantChannels == descriptor.m_constantChannels &&
+			( *it )->m_allBrothers == descriptor.m_allBrothers &&
+			( *it )->m_steps == descriptor.m_steps
+		)
+		{
+			return *it;
+		}
+	}
+
+	r.push_back( new DynamicLayoutDescriptor( descriptor ) );
+	return r.back();
+}
+
+}; // namespace Detail
+
+}; // namespace Image
+
+}; // namespace Gander
@@ -0,0 +1,311 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <stdexcept>
+#include <vector>
+
+#include "boost/bind.hpp"
+#include "boost/thread.hpp"
+#include "boost/date_time/posix_time/posix_time_types.hpp"
+
+#include "Gander/Assert.h"
+#include "Gander/ThreadPool.h"
+#include "GanderImage/FramePipeline.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+namespace Detail
+{
+
+static inline boost::posix_time::ptime now()
+{
+	return boost::posix_time::microsec_clock::universal_time();
+}
+
+static inline double secondsSince( const boost::posix_time::ptime &start )
+{
+	return double( ( now() - start ).total_microseconds() ) * 1e-6;
+}
+
+/// Waits for a short time before a queue is checked again. The thread yields at first, which keeps the latency
+/// low when the other stage is about to catch up, and then sleeps so that a stage that is waiting on a much
+/// slower one doesn't take processor time away from it.
+static inline void backOff( unsigned int &attempts )
+{
+	if( ++attempts < 64 )
+	{
+		boost::this_thread::yield();
+	}
+	else
+	{
+		boost::this_thread::sleep( boost::posix_time::microseconds( 100 ) );
+	}
+}
+
+}; // namespace Detail
+
+FrameReader::~FrameReader()
+{
+}
+
+FrameProcessor::~FrameProcessor()
+{
+}
+
+FrameWriter::~FrameWriter()
+{
+}
+
+FramePipeline::FramePipeline( FrameReader &reader, FrameProcessor &processor, FrameWriter &writer, unsigned int queueSize ) :
+	m_reader( reader ),
+	m_processor( processor ),
+	m_writer( writer ),
+	m_inputTiles( queueSize + 2 ),
+	m_outputTiles( queueSize + 2 ),
+	m_inputs( queueSize ),
+	m_outputs( queueSize ),
+	m_freeInputTiles( queueSize + 2 ),
+	m_freeOutputTiles( queueSize + 2 ),
+	m_failed( 0 )
+{
+}
+
+FramePipeline::~FramePipeline()
+{
+}
+
+void FramePipeline::run( int32 first, int32 last )
+{
+	m_inputs.clear();
+	m_outputs.clear();
+	m_freeInputTiles.clear();
+	m_freeOutputTiles.clear();
+	for( unsigned int i = 0; i < m_inputTiles.size(); ++i )
+	{
+		m_freeInputTiles.push( &m_inputTiles[i] );
+		m_freeOutputTiles.push( &m_outputTiles[i] );
+	}
+	
+	for( unsigned int i = 0; i < NumberOfStages; ++i )
+	{
+		m_statistics[i] = StageStatistics();
+	}
+	m_failed = 0;
+	m_error.clear();
+
+	const boost::posix_time::ptime start( Detail::now() );
+	
+	std::vector< ThreadPool::Task > stages;
+	stages.push_back( boost::bind( &FramePipeline::runStage, this, ThreadPool::Task( boost::bind( &FramePipeline::processFrames, this ) ) ) );
+	stages.push_back( boost::bind( &FramePipeline::runStage, this, ThreadPool::Task( boost::bind( &FramePipeline::readFrames, this, first, last ) ) ) );
+	stages.push_back( boost::bind( &FramePipeline::runStage, this, ThreadPool::Task( boost::bind( &FramePipeline::writeFrames, this ) ) ) );
+	ThreadPool::global().run( stages );
+
+	const double totalSeconds = Detail::secondsSince( start );
+	for( unsigned int i = 0; i < NumberOfStages; ++i )
+	{
+		m_statistics[i].totalSeconds = totalSeconds;
+	}
+	
+	if( m_failed )
+	{
+		throw std::runtime_error( m_error );
+	}
+}
+
+const FramePipeline::StageStatistics &FramePipeline::statistics( Stage stage ) const
+{
+	GANDER_ASSERT( stage >= ReadStage && stage < NumberOfStages, "FramePipeline: Invalid stage." );
+	return m_statistics[stage];
+}
+
+FramePipeline::Stage FramePipeline::bottleneck() const
+{
+	Stage result = ReadStage;
+	for( unsigned int i = ProcessStage; i < NumberOfStages; ++i )
+	{
+		if( m_statistics[i].busySeconds > m_statistics[result].busySeconds )
+		{
+			result = Stage( i );
+		}
+	}
+	return result;
+}
+
+void FramePipeline::readFrames( int32 first, int32 last )
+{
+	StageStatistics &statistics( m_statistics[ReadStage] );
+	for( int32 index = first; index <= last; ++index )
+	{
+		Frame frame = { index, NULL };
+		if( !pop( m_freeInputTiles, frame.tile ) )
+		{
+			return;
+		}
+		
+		const boost::posix_time::ptime start( Detail::now() );
+		m_reader.read( index, *frame.tile );
+		statistics.busySeconds += Detail::secondsSince( start );
+		++statistics.frames;
+
+		if( !push( m_inputs, frame ) )
+		{
+			return;
+		}
+	}
+
+	Frame end = { last + 1, NULL };
+	push( m_inputs, end );
+}
+
+void FramePipeline::processFrames()
+{
+	StageStatistics &statistics( m_statistics[ProcessStage] );
+	while( true )
+	{
+		Frame input;
+		if( !pop( m_inputs, input ) )
+		{
+			return;
+		}
+
+		if( !input.tile )
+		{
+			push( m_outputs, input );
+			return;
+		}
+		
+		Frame output = { input.index, NULL };
+		if( !pop( m_freeOutputTiles, output.tile ) )
+		{
+			return;
+		}
+		
+		const boost::posix_time::ptime start( Detail::now() );
+		m_processor.process( input.index, *input.tile, *output.tile );
+		statistics.busySeconds += Detail::secondsSince( start );
+		++statistics.frames;
+
+		if( !push( m_freeInputTiles, input.tile ) || !push( m_outputs, output ) )
+		{
+			return;
+		}
+	}
+}
+
+void FramePipeline::writeFrames()
+{
+	StageStatistics &statistics( m_statistics[WriteStage] );
+	while( true )
+	{
+		Frame frame;
+		if( !pop( m_outputs, frame ) || !frame.tile )
+		{
+			return;
+		}
+
+		const boost::posix_time::ptime start( Detail::now() );
+		m_writer.write( frame.index, *frame.tile );
+		statistics.busySeconds += Detail::secondsSince( start );
+		++statistics.frames;
+		
+		if( !push( m_freeOutputTiles, frame.tile ) )
+		{
+			return;
+		}
+	}
+}
+
+void FramePipeline::runStage( const boost::function< void () > &function )
+{
+	try
+	{
+		function();
+	}
+	catch( const std::exception &e )
+	{
+		fail( e.what() );
+	}
+	catch( ... )
+	{
+		fail( "FramePipeline: Unknown exception." );
+	}
+}
+
+template< class T >
+bool FramePipeline::push( BoundedQueue< T > &queue, const T &value )
+{
+	unsigned int attempts = 0;
+	while( !queue.push( value ) )
+	{
+		if( m_failed )
+		{
+			return false;
+		}
+		Detail::backOff( attempts );
+	}
+	return true;
+}
+
+template< class T >
+bool FramePipeline::pop( BoundedQueue< T > &queue, T &value )
+{
+	unsigned int attempts = 0;
+	while( !queue.pop( value ) )
+	{
+		if( m_failed )
+		{
+			return false;
+		}
+		Detail::backOff( attempts );
+	}
+	return true;
+}
+
+void FramePipeline::fail( const std::string &error )
+{
+	// Only the first stage to fail records its error. The others stop as soon as they next wait on a queue.
+	if( __sync_lock_test_and_set( &m_failed, 1 ) == 0 )
+	{
+		m_error = error;
+	}
+}
+
+}; // namespace Image
+
+}; // namespace Gander
@@ -0,0 +1,574 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#include <stdexcept>
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <typeinfo>
+
+#include "boost/bind.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/format.hpp"
+#include "boost/thread.hpp"
+
+#include "Gander/Assert.h"
+#include "Gander/ThreadPool.h"
+#include "GanderImage/Op.h"
+#include "GanderImage/PointOp.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+Op::Op( unsigned int numberOfInputs ) :
+	m_inputs( numberOfInputs )
+{
+}
+
+Op::~Op()
+{
+}
+
+void Op::setInput( unsigned int index, ConstOpPtr op )
+{
+	GANDER_ASSERT( index < m_inputs.size(), ( boost::format( "Op: Input %d is out of range." ) % index ).str() );
+	m_inputs[index] = op;
+}
+
+const ConstOpPtr &Op::input( unsigned int index ) const
+{
+	GANDER_ASSERT( index < m_inputs.size(), ( boost::format( "Op: Input %d is out of range." ) % index ).str() );
+	return m_inputs[index];
+}
+
+Box Op::inputRegion( unsigned int index, const Box &region ) const
+{
+	return region;
+}
+
+ChannelSet Op::inputChannels( unsigned int index, ChannelSet channels ) const
+{
+	return channels;
+}
+
+ChannelSet Op::affectedChannels( ChannelSet channels ) const
+{
+	return channels;
+}
+
+int32 Op::minimumBlockHeight() const
+{
+	return 1;
+}
+
+void Op::hash( Hash &h ) const
+{
+	h.append( typeid( *this ).name() );
+}
+
+namespace Detail
+{
+
+/// The state of an op during the evaluation of a graph.
+struct OpNode
+{
+	OpNode( const Op *o ) :
+		op( o ),
+		removed( false ),
+		tile( NULL ),
+		result( NULL ),
+		pendingInputs( 0 ),
+		pendingTasks( 0 ),
+		pendingOutputs( 0 )
+	{
+	}
+
+	/// The op that computes the node's tile. If the op is the last of a chain of point ops that have been fused
+	/// then chain holds all of them, ordered from the first to be applied.
+	const Op *op;
+	std::vector< const PointOp * > chain;
+	
+	/// Whether the node has been fused into the node that follows it.
+	bool removed;
+	
+	/// The union of the regions and channels that are requested by the ops that use this one.
+	Box region;
+	ChannelSet channels;
+
+	/// The channels that the op computes. The others are shared with the first input once it has been computed.
+	ChannelSet affected;
+
+	/// The hash of the op and everything upstream of it. This is only computed when a cache is used.
+	Hash hash;
+	
+	/// The tile that the op computes into. This is either ownTile or the output of the evaluation.
+	boost::shared_ptr< Tile > ownTile;
+	Tile *tile;
+	
+	/// The tile that was found in the cache, if any. When a tile is found the op isn't computed.
+	ConstTilePtr cachedTile;
+
+	/// The tile that is read by the ops that use this one.
+	const Tile *result;
+	
+	std::vector< OpNode * > inputs;
+	std::vector< const Tile * > inputTiles;
+	std::vector< OpNode * > outputs;
+
+	/// The number of inputs that are yet to be computed.
+	unsigned int pendingInputs;
+
+	/// The number of blocks of rows that are yet to be computed.
+	unsigned int pendingTasks;
+
+	/// The number of ops that are yet to finish reading this op's tile.
+	unsigned int pendingOutputs;
+};
+
+/// A block of rows of an op's tile.
+struct OpTask
+{
+	OpNode *node;
+	int32 y;
+	int32 t;
+};
+
+/// Evaluates a graph of ops on the threads of the global ThreadPool. Each op's tile is split into blocks of rows which are queued
+/// as soon as all of the op's inputs have been computed, so independent branches of the graph run concurrently.
+class GraphExecutor
+{
+	public :
+
+		GraphExecutor( const Op &op, Tile &output, unsigned int numberOfThreads, bool fusePointOps, TileCache *cache ) :
+			m_numberOfThreads( numberOfThreads == 0 ? ThreadPool::hardwareConcurrency() : numberOfThreads ),
+			m_root( NULL ),
+			m_output( output ),
+			m_cache( cache ),
+			m_finished( false )
+		{
+			// Find the ops in the graph, ordered so that every op appears after its inputs.
+			std::map< const Op *, int > state;
+			m_root = visit( &op, state );
+
+			if( fusePointOps )
+			{
+				fuse();
+			}
+
+			// Propagate the request from the output up the graph. The nodes are visited in reverse order
+			// so that an op has received the requests of all of the ops that use it before it passes on its own.
+			// Ops whose tiles are found in the cache don't make requests of their inputs.
+			m_root->region = output.box();
+			m_root->channels = output.channels();
+			for( std::vector< OpNode * >::reverse_iterator it( m_nodes.rbegin() ); it != m_nodes.rend(); ++it )
+			{
+				OpNode *node( *it );
+				if( node->region.isEmpty() || node->channels.empty() )
+				{
+					continue;
+				}
+
+				if( m_cache && ( node->cachedTile = m_cache->get( node->hash, node->region, node->channels ) ) )
+				{
+					disconnectInputs( node );
+					continue;
+				}
+				
+				node->affected = node->channels;
+				if( !node->inputs.empty() )
+				{
+					ChannelSet affected;
+					for( std::vector< const PointOp * >::const_iterator it( node->chain.begin() ); it != node->chain.end(); ++it )
+					{
+						affected += (*it)->affectedChannels( node->channels );
+					}
+					node->affected &= node->chain.size() > 1 ? affected : node->op->affectedChannels( node->channels );
+				}
+				
+				for( unsigned int i = 0; i < node->inputs.size() && !node->affected.empty(); ++i )
+				{
+					OpNode *input( node->inputs[i] );
+					if( node->chain.size() > 1 )
+					{
+						input->region = input->region.merge( node->region );
+						input->channels += PointOp::chainInputChannels( node->chain, node->affected );
+					}
+					else
+					{
+						input->region = input->region.merge( node->op->inputRegion( i, node->region ) );
+						input->channels += node->op->inputChannels( i, node->affected );
+					}
+				}
+
+				const ChannelSet passed( node->channels - node->affected );
+				if( !passed.empty() )
+				{
+					OpNode *input( node->inputs[0] );
+					input->region = input->region.merge( node->region );
+					input->channels += passed;
+				}
+			}
+		}
+
+		void run()
+		{
+			{
+				boost::mutex::scoped_lock lock( m_mutex );
+				for( std::vector< OpNode * >::iterator it( m_nodes.begin() ); it != m_nodes.end(); ++it )
+				{
+					if( (*it)->pendingInputs == 0 )
+					{
+						schedule( *it );
+					}
+				}
+			}
+			
+			const std::vector< ThreadPool::Task > workers( m_numberOfThreads, boost::bind( &GraphExecutor::work, this ) );
+			ThreadPool::global().run( workers );
+
+			if( !m_error.empty() )
+			{
+				throw std::runtime_error( m_error );
+			}
+
+			// The output op's tile may be its own or come from the cache, in which case it can cover more than
+			// the output. Either way the output shares its planes rather than copying them.
+			if( m_root->result != &m_output && !m_output.box().isEmpty() )
+			{
+				const ChannelSet channels( m_output.channels() );
+				for( ChannelSet::const_iterator c( channels.begin() ); c != channels.end(); ++c )
+				{
+					m_output.shareChannel( *m_root->result, *c );
+				}
+			}
+		}
+
+	private :
+
+		/// Creates the node of an op and its inputs, appending them to m_nodes in dependency order.
+		OpNode *visit( const Op *op, std::map< const Op *, int > &state )
+		{
+			std::map< const Op *, int >::iterator found( state.find( op ) );
+			if( found != state.end() )
+			{
+				GANDER_ASSERT( found->second >= 0, "Op: The graph contains a cycle." );
+				return m_nodes[ found->second ];
+			}
+
+			// Mark the op as being visited so that cycles can be detected.
+			state[op] = -1;
+
+			OpNode *node( new OpNode( op ) );
+			m_ownedNodes.push_back( boost::shared_ptr< OpNode >( node ) );
+			
+			for( unsigned int i = 0; i < op->numberOfInputs(); ++i )
+			{
+				GANDER_ASSERT( op->input( i ), ( boost::format( "Op: Input %d is not connected." ) % i ).str() );
+				OpNode *input( visit( op->input( i ).get(), state ) );
+				node->inputs.push_back( input );
+				input->outputs.push_back( node );
+				++input->pendingOutputs;
+			}
+			
+			if( m_cache )
+			{
+				op->hash( node->hash );
+				for( std::vector< OpNode * >::iterator it( node->inputs.begin() ); it != node->inputs.end(); ++it )
+				{
+					node->hash.append( (*it)->hash );
+				}
+			}
+
+			const PointOp *pointOp( dynamic_cast< const PointOp * >( op ) );
+			if( pointOp )
+			{
+				node->chain.push_back( pointOp );
+			}
+			
+			node->pendingInputs = node->inputs.size();
+			state[op] = m_nodes.size();
+			m_nodes.push_back( node );
+			return node;
+		}
+
+		/// Merges each point op whose input is a point op that isn't used by anything else into a single node,
+		/// which computes the whole chain in one pass.
+		void fuse()
+		{
+			for( std::vector< OpNode * >::iterator it( m_nodes.begin() ); it != m_nodes.end(); ++it )
+			{
+				OpNode *node( *it );
+				if( node->chain.empty() )
+				{
+					continue;
+				}
+				
+				// As the nodes are in dependency order, the input has already absorbed any chain that precedes it.
+				OpNode *input( node->inputs[0] );
+				if( input->chain.empty() || input->outputs.size() != 1 )
+				{
+					continue;
+				}
+
+				node->chain.insert( node->chain.begin(), input->chain.begin(), input->chain.end() );
+				node->inputs = input->inputs;
+				std::replace( node->inputs[0]->outputs.begin(), node->inputs[0]->outputs.end(), input, node );
+				input->removed = true;
+			}
+
+			std::vector< OpNode * > nodes;
+			for( std::vector< OpNode * >::iterator it( m_nodes.begin() ); it != m_nodes.end(); ++it )
+			{
+				if( !(*it)->removed )
+				{
+					nodes.push_back( *it );
+				}
+			}
+			m_nodes.swap( nodes );
+		}
+
+		/// Detaches a node from its inputs once its tile has been found in the cache.
+		void disconnectInputs( OpNode *node )
+		{
+			for( std::vector< OpNode * >::iterator it( node->inputs.begin() ); it != node->inputs.end(); ++it )
+			{
+				std::vector< OpNode * > &outputs( (*it)->outputs );
+				outputs.erase( std::find( outputs.begin(), outputs.end(), node ) );
+				--(*it)->pendingOutputs;
+			}
+			node->inputs.clear();
+			node->pendingInputs = 0;
+		}
+
+		/// Allocates the tile of a node once its inputs have been computed, so that only the tiles of the ops that
+		/// are being computed, and of those whose tiles are still to be read, are held at once. Without a cache the
+		/// output op computes straight into the output. With one, it computes into a tile of its own which is copied
+		/// to the output, so that the cache can share it. The tiles are left uninitialised as every row is computed.
+		/// Must be called with m_mutex held.
+		void allocate( OpNode *node )
+		{
+			if( node->cachedTile )
+			{
+				node->result = node->cachedTile.get();
+				return;
+			}
+
+			if( node == m_root && !m_cache && node->affected == node->channels )
+			{
+				// The output may share its planes, which mustn't be copied on write by several threads at once.
+				m_output.makeUnique();
+				node->tile = &m_output;
+			}
+			else
+			{
+				node->ownTile.reset( new Tile );
+				node->ownTile->reset( node->region, node->affected, false );
+				node->tile = node->ownTile.get();
+			}
+			node->result = node->tile;
+			
+			for( unsigned int i = 0; i < node->inputs.size(); ++i )
+			{
+				node->inputTiles.push_back( node->inputs[i]->result );
+			}
+		}
+
+		/// Queues the blocks of rows of a node whose inputs have all been computed. Must be called with m_mutex held.
+		void schedule( OpNode *node )
+		{
+			allocate( node );
+			if( node->cachedTile )
+			{
+				complete( node );
+				return;
+			}
+			
+			const Box &box( node->tile->box() );
+			if( box.isEmpty() || node->tile->channels().empty() )
+			{
+				complete( node );
+				return;
+			}
+			
+			// Split the rows into enough blocks to balance the load between the threads. The op's minimum block
+			// height gives way when it would leave some of the threads without a block.
+			const int32 height = box.height();
+			const int32 threads = int32( m_numberOfThreads );
+			const int32 minimumHeight = std::min< int32 >( node->op->minimumBlockHeight(), ( height + threads - 1 ) / threads );
+			const int32 blockHeight = std::max< int32 >( std::max< int32 >( minimumHeight, height / ( threads * 4 ) ), 1 );
+			for( int32 y = box.y(); y < box.t(); y += blockHeight )
+			{
+				OpTask task = { node, y, std::min( y + blockHeight, box.t() ) };
+				m_tasks.push_back( task );
+				++node->pendingTasks;
+			}
+			m_condition.notify_all();
+		}
+
+		/// Marks a node as computed, releasing the tiles of inputs that are no longer needed and queuing
+		/// any ops that were waiting on it. Must be called with m_mutex held.
+		void complete( OpNode *node )
+		{
+			// Pass the channels that the op doesn't change through from its first input.
+			const ChannelSet passed( node->channels - node->affected );
+			if( !node->cachedTile && !passed.empty() && !node->region.isEmpty() )
+			{
+				for( ChannelSet::const_iterator c( passed.begin() ); c != passed.end(); ++c )
+				{
+					node->tile->shareChannel( *node->inputTiles[0], *c );
+				}
+			}
+			
+			for( std::vector< OpNode * >::iterator it( node->inputs.begin() ); it != node->inputs.end(); ++it )
+			{
+				if( --(*it)->pendingOutputs == 0 )
+				{
+					(*it)->ownTile.reset();
+					(*it)->cachedTile.reset();
+				}
+			}
+
+			if( m_cache && node->ownTile && !node->region.isEmpty() && !node->channels.empty() )
+			{
+				m_cache->insert( node->hash, node->ownTile );
+			}
+
+			if( node == m_root )
+			{
+				m_finished = true;
+				m_condition.notify_all();
+				return;
+			}
+			
+			for( std::vector< OpNode * >::iterator it( node->outputs.begin() ); it != node->outputs.end(); ++it )
+			{
+				if( --(*it)->pendingInputs == 0 )
+				{
+					schedule( *it );
+				}
+			}
+		}
+
+		void work()
+		{
+			boost::mutex::scoped_lock lock( m_mutex );
+			while( true )
+			{
+				while( m_tasks.empty() && !m_finished && m_error.empty() )
+				{
+					m_condition.wait( lock );
+				}
+
+				if( m_finished || !m_error.empty() )
+				{
+					return;
+				}
+
+				OpTask task( m_tasks.front() );
+				m_tasks.pop_front();
+				
+				lock.unlock();
+				std::string error;
+				try
+				{
+					if( task.node->ownTile )
+					{
+						task.node->tile->clearRows( task.y, task.t );
+					}
+					
+					if( task.node->chain.size() > 1 )
+					{
+						PointOp::computeChain( task.node->chain, task.y, task.t, *task.node->inputTiles[0], *task.node->tile );
+					}
+					else
+					{
+						task.node->op->computeRows( task.y, task.t, task.node->inputTiles, *task.node->tile );
+					}
+				}
+				catch( const std::exception &e )
+				{
+					error = e.what();
+				}
+				catch( ... )
+				{
+					error = "Op: Unknown exception.";
+				}
+				lock.lock();
+
+				if( !error.empty() )
+				{
+					if( m_error.empty() )
+					{
+						m_error = error;
+					}
+					m_condition.notify_all();
+				}
+				else if( --task.node->pendingTasks == 0 )
+				{
+					complete( task.node );
+				}
+			}
+		}
+
+		const unsigned int m_numberOfThreads;
+		
+		/// The nodes of the graph in dependency order.
+		std::vector< OpNode * > m_nodes;
+		std::vector< boost::shared_ptr< OpNode > > m_ownedNodes;
+		OpNode *m_root;
+		
+		Tile &m_output;
+		TileCache *m_cache;
+
+		boost::mutex m_mutex;
+		boost::condition_variable m_condition;
+		std::deque< OpTask > m_tasks;
+		bool m_finished;
+		std::string m_error;
+};
+
+}; // namespace Detail
+
+void evaluate( const Op &op, Tile &output, unsigned int numberOfThreads, bool fusePointOps, TileCache *cache )
+{
+	Detail::GraphExecutor executor( op, output, numberOfThreads, fusePointOps, cache );
+	executor.run();
+}
+
+}; // namespace Image
+
+}; // namespace Gander
+
@@ -0,0 +1,290 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <new>
+#include <algorithm>
+#include <cstdlib>
+#include <sys/mman.h>
+
+#include "GanderImage/PlaneAllocator.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+namespace Detail
+{
+
+static const size_t g_alignment = 64;
+static const size_t g_pageSize = 4096;
+static const size_t g_hugePageSize = size_t( 1 ) << 21;
+
+static inline size_t roundUp( size_t size, size_t multiple )
+{
+	return ( size + multiple - 1 ) / multiple * multiple;
+}
+
+}; // namespace Detail
+
+const size_t PlaneAllocator::DefaultPoolLimit;
+const size_t PlaneAllocator::MappedThreshold;
+
+PlaneAllocator::PlaneAllocator( size_t poolLimit, bool hugePages ) :
+	m_poolLimit( poolLimit ),
+	m_hugePages( hugePages )
+{
+}
+
+PlaneAllocator::~PlaneAllocator()
+{
+	trim();
+}
+
+PlaneAllocator &PlaneAllocator::defaultAllocator()
+{
+	// The allocator is never deleted so that it outlives any static tiles.
+	static PlaneAllocator *allocator = new PlaneAllocator;
+	return *allocator;
+}
+
+size_t PlaneAllocator::capacity( size_t size ) const
+{
+	if( size == 0 )
+	{
+		return 0;
+	}
+
+	// Round up to one of four sizes in each power of two. This wastes at most a quarter of a block while
+	// keeping the number of pools small, so that planes of similar sizes can share blocks.
+	size_t octave = 1;
+	while( octave <= size / 2 )
+	{
+		octave *= 2;
+	}
+	size_t result = Detail::roundUp( Detail::roundUp( size, std::max< size_t >( octave / 4, 1 ) ), Detail::g_alignment );
+
+	if( result >= MappedThreshold )
+	{
+		result = Detail::roundUp( result, Detail::g_pageSize );
+		if( hugePages() && result >= Detail::g_hugePageSize )
+		{
+			result = Detail::roundUp( result, Detail::g_hugePageSize );
+		}
+	}
+	
+	return result;
+}
+
+void *PlaneAllocator::allocate( size_t size, size_t &capacity )
+{
+	capacity = this->capacity( size );
+	if( capacity == 0 )
+	{
+		return NULL;
+	}
+	
+	{
+		boost::mutex::scoped_lock lock( m_mutex );
+		PoolMap::iterator it( m_pools.find( capacity ) );
+		if( it != m_pools.end() && !it->second.empty() )
+		{
+			void *block = it->second.back();
+			it->second.pop_back();
+			m_statistics.pooledBytes -= capacity;
+			m_statistics.usedBytes += capacity;
+			++m_statistics.pooledAllocations;
+			return block;
+		}
+	}
+
+	// The system is called without the lock held so that other threads can use the pools in the meantime.
+	void *block = allocateFromSystem( capacity );
+	
+	boost::mutex::scoped_lock lock( m_mutex );
+	m_statistics.usedBytes += capacity;
+	m_statistics.reservedBytes += capacity;
+	m_statistics.peakReservedBytes = std::max( m_statistics.peakReservedBytes, m_statistics.reservedBytes );
+	++m_statistics.systemAllocations;
+	return block;
+}
+
+void PlaneAllocator::deallocate( void *block, size_t capacity )
+{
+	if( !block )
+	{
+		return;
+	}
+
+	{
+		boost::mutex::scoped_lock lock( m_mutex );
+		m_statistics.usedBytes -= capacity;
+		if( m_statistics.pooledBytes + capacity <= m_poolLimit )
+		{
+			m_pools[capacity].push_back( block );
+			m_statistics.pooledBytes += capacity;
+			return;
+		}
+		m_statistics.reservedBytes -= capacity;
+	}
+
+	deallocateToSystem( block, capacity );
+}
+
+void PlaneAllocator::trim()
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	for( PoolMap::iterator it( m_pools.begin() ); it != m_pools.end(); ++it )
+	{
+		for( std::vector< void * >::iterator block( it->second.begin() ); block != it->second.end(); ++block )
+		{
+			deallocateToSystem( *block, it->first );
+		}
+	}
+	m_pools.clear();
+	m_statistics.reservedBytes -= m_statistics.pooledBytes;
+	m_statistics.pooledBytes = 0;
+}
+
+void PlaneAllocator::setPoolLimit( size_t poolLimit )
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	m_poolLimit = poolLimit;
+	shrinkPools();
+}
+
+size_t PlaneAllocator::poolLimit() const
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	return m_poolLimit;
+}
+
+void PlaneAllocator::setHugePages( bool hugePages )
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	m_hugePages = hugePages;
+}
+
+bool PlaneAllocator::hugePages() const
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	return m_hugePages;
+}
+
+PlaneAllocator::Statistics PlaneAllocator::statistics() const
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	return m_statistics;
+}
+
+void PlaneAllocator::resetPeak()
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	m_statistics.peakReservedBytes = m_statistics.reservedBytes;
+}
+
+void *PlaneAllocator::allocateFromSystem( size_t capacity )
+{
+	if( capacity < MappedThreshold )
+	{
+		void *block = NULL;
+		if( posix_memalign( &block, Detail::g_alignment, capacity ) != 0 )
+		{
+			throw std::bad_alloc();
+		}
+		return block;
+	}
+
+	const bool huge = hugePages() && capacity % Detail::g_hugePageSize == 0;
+	void *block = MAP_FAILED;
+#ifdef MAP_HUGETLB
+	if( huge )
+	{
+		block = mmap( NULL, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+	}
+#endif
+
+	// Fall back to normal pages when no huge pages are reserved, and ask for them to be merged into transparent huge pages instead.
+	if( block == MAP_FAILED )
+	{
+		block = mmap( NULL, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+		if( block == MAP_FAILED )
+		{
+			throw std::bad_alloc();
+		}
+#ifdef MADV_HUGEPAGE
+		if( huge )
+		{
+			madvise( block, capacity, MADV_HUGEPAGE );
+		}
+#endif
+	}
+
+	return block;
+}
+
+void PlaneAllocator::deallocateToSystem( void *block, size_t capacity )
+{
+	if( capacity < MappedThreshold )
+	{
+		std::free( block );
+	}
+	else
+	{
+		munmap( block, capacity );
+	}
+}
+
+void PlaneAllocator::shrinkPools()
+{
+	while( m_statistics.pooledBytes > m_poolLimit )
+	{
+		PoolMap::iterator it( --m_pools.end() );
+		if( it->second.empty() )
+		{
+			m_pools.erase( it );
+			continue;
+		}
+
+		deallocateToSystem( it->second.back(), it->first );
+		it->second.pop_back();
+		m_statistics.pooledBytes -= it->first;
+		m_statistics.reservedBytes -= it->first;
+	}
+}
+
+}; // namespace Image
+
+}; // namespace Gander
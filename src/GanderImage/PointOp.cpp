@@ -0,0 +1,226 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+
+#include "GanderImage/PointOp.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+PointOp::PointOp() :
+	Op( 1 )
+{
+}
+
+PointOp::~PointOp()
+{
+}
+
+void PointOp::computeRows( int32 y, int32 t, const std::vector< const Tile * > &inputs, Tile &output ) const
+{
+	computeChain( std::vector< const PointOp * >( 1, this ), y, t, *inputs[0], output );
+}
+
+ChannelSet PointOp::chainInputChannels( const std::vector< const PointOp * > &chain, ChannelSet channels )
+{
+	for( std::vector< const PointOp * >::const_reverse_iterator it( chain.rbegin() ); it != chain.rend(); ++it )
+	{
+		channels = (*it)->inputChannels( 0, channels );
+	}
+	return channels;
+}
+
+void PointOp::computeChain( const std::vector< const PointOp * > &chain, int32 y, int32 t, const Tile &input, Tile &output )
+{
+	const Box &box( output.box() );
+	const int32 width = box.width();
+	const int32 inputOffset = box.x() - input.box().x();
+
+	// Work out which channels each op is asked for, from the last op back to the first,
+	// and the channels that are needed by any of them.
+	std::vector< ChannelSet > requested( chain.size() );
+	ChannelSet channels( output.channels() );
+	ChannelSet allChannels( channels );
+	for( int i = int( chain.size() ) - 1; i >= 0; --i )
+	{
+		requested[i] = channels;
+		channels = chain[i]->inputChannels( 0, channels );
+		allChannels += channels;
+	}
+	channels &= input.channels();
+
+	// When the ops don't need any channels other than those of the output, the rows are transformed
+	// in the output tile. Otherwise each row is transformed in a scratch tile that holds all of the channels.
+	const bool inPlace = allChannels == output.channels();
+	Tile scratch;
+	
+	for( int32 row = y; row < t; ++row )
+	{
+		Tile *target( &output );
+		if( !inPlace )
+		{
+			scratch.reset( Box( box.x(), row, box.r(), row + 1 ), allChannels );
+			target = &scratch;
+		}
+
+		for( ChannelSet::const_iterator c( channels.begin() ); c != channels.end(); ++c )
+		{
+			const float *src( input.row( *c, row ) + inputOffset );
+			std::copy( src, src + width, target->row( *c, row ) );
+		}
+		
+		for( unsigned int i = 0; i < chain.size(); ++i )
+		{
+			chain[i]->applyRow( *target, requested[i], row );
+		}
+		
+		if( !inPlace )
+		{
+			const ChannelSet outputChannels( output.channels() );
+			for( ChannelSet::const_iterator c( outputChannels.begin() ); c != outputChannels.end(); ++c )
+			{
+				const float *src( scratch.row( *c, row ) );
+				std::copy( src, src + width, output.row( *c, row ) );
+			}
+		}
+	}
+}
+
+Grade::Grade( float gain, float offset ) :
+	m_gain( gain ),
+	m_offset( offset )
+{
+}
+
+Grade::~Grade()
+{
+}
+
+void Grade::hash( Hash &h ) const
+{
+	PointOp::hash( h );
+	h.append( m_gain ).append( m_offset );
+}
+
+void Grade::applyRow( Tile &tile, ChannelSet channels, int32 y ) const
+{
+	const int32 width = tile.box().width();
+	for( ChannelSet::const_iterator c( channels.begin() ); c != channels.end(); ++c )
+	{
+		float *row( tile.row( *c, y ) );
+		for( int32 x = 0; x < width; ++x )
+		{
+			row[x] = row[x] * m_gain + m_offset;
+		}
+	}
+}
+
+Clamp::Clamp( float minimum, float maximum ) :
+	m_minimum( minimum ),
+	m_maximum( maximum )
+{
+}
+
+Clamp::~Clamp()
+{
+}
+
+void Clamp::hash( Hash &h ) const
+{
+	PointOp::hash( h );
+	h.append( m_minimum ).append( m_maximum );
+}
+
+void Clamp::applyRow( Tile &tile, ChannelSet channels, int32 y ) const
+{
+	const int32 width = tile.box().width();
+	for( ChannelSet::const_iterator c( channels.begin() ); c != channels.end(); ++c )
+	{
+		float *row( tile.row( *c, y ) );
+		for( int32 x = 0; x < width; ++x )
+		{
+			row[x] = std::min( std::max( row[x], m_minimum ), m_maximum );
+		}
+	}
+}
+
+Premultiply::Premultiply()
+{
+}
+
+Premultiply::~Premultiply()
+{
+}
+
+ChannelSet Premultiply::inputChannels( unsigned int index, ChannelSet channels ) const
+{
+	if( !( channels - Chan_Alpha ).empty() )
+	{
+		channels += Chan_Alpha;
+	}
+	return channels;
+}
+
+ChannelSet Premultiply::affectedChannels( ChannelSet channels ) const
+{
+	return channels - Chan_Alpha;
+}
+
+void Premultiply::applyRow( Tile &tile, ChannelSet channels, int32 y ) const
+{
+	channels -= Chan_Alpha;
+	if( channels.empty() )
+	{
+		return;
+	}
+
+	const int32 width = tile.box().width();
+	const float *alpha( tile.row( Chan_Alpha, y ) );
+	for( ChannelSet::const_iterator c( channels.begin() ); c != channels.end(); ++c )
+	{
+		float *row( tile.row( *c, y ) );
+		for( int32 x = 0; x < width; ++x )
+		{
+			row[x] *= alpha[x];
+		}
+	}
+}
+
+}; // namespace Image
+
+}; // namespace Gander
+
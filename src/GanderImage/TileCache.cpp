@@ -0,0 +1,156 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#include "GanderImage/TileCache.h"
+
+namespace Gander
+{
+
+namespace Image
+{
+
+TileCache::TileCache( size_t memoryLimit ) :
+	m_memoryLimit( memoryLimit ),
+	m_memoryUsage( 0 )
+{
+}
+
+TileCache::~TileCache()
+{
+}
+
+ConstTilePtr TileCache::get( const Hash &hash, const Box &region, ChannelSet channels )
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	
+	std::pair< EntryMap::iterator, EntryMap::iterator > range( m_map.equal_range( hash ) );
+	for( EntryMap::iterator it( range.first ); it != range.second; ++it )
+	{
+		const Tile &tile( *it->second->tile );
+		if( tile.box().contains( region ) && tile.channels().contains( channels ) )
+		{
+			m_entries.splice( m_entries.begin(), m_entries, it->second );
+			return it->second->tile;
+		}
+	}
+
+	return ConstTilePtr();
+}
+
+void TileCache::insert( const Hash &hash, ConstTilePtr tile )
+{
+	const size_t memoryUsage = tile->memoryUsage();
+
+	boost::mutex::scoped_lock lock( m_mutex );
+	if( memoryUsage > m_memoryLimit )
+	{
+		return;
+	}
+	
+	// Don't hold a tile if an existing one already covers it.
+	std::pair< EntryMap::iterator, EntryMap::iterator > range( m_map.equal_range( hash ) );
+	for( EntryMap::iterator it( range.first ); it != range.second; ++it )
+	{
+		const Tile &cached( *it->second->tile );
+		if( cached.box().contains( tile->box() ) && cached.channels().contains( tile->channels() ) )
+		{
+			m_entries.splice( m_entries.begin(), m_entries, it->second );
+			return;
+		}
+	}
+
+	Entry entry = { hash, tile, memoryUsage };
+	m_entries.push_front( entry );
+	m_map.insert( EntryMap::value_type( hash, m_entries.begin() ) );
+	m_memoryUsage += memoryUsage;
+	evict();
+}
+
+void TileCache::clear()
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	m_entries.clear();
+	m_map.clear();
+	m_memoryUsage = 0;
+}
+
+void TileCache::setMemoryLimit( size_t memoryLimit )
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	m_memoryLimit = memoryLimit;
+	evict();
+}
+
+size_t TileCache::memoryLimit() const
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	return m_memoryLimit;
+}
+
+size_t TileCache::memoryUsage() const
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	return m_memoryUsage;
+}
+
+size_t TileCache::size() const
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	return m_entries.size();
+}
+
+void TileCache::evict()
+{
+	while( m_memoryUsage > m_memoryLimit && !m_entries.empty() )
+	{
+		EntryList::iterator last( --m_entries.end() );
+		
+		std::pair< EntryMap::iterator, EntryMap::iterator > range( m_map.equal_range( last->hash ) );
+		for( EntryMap::iterator it( range.first ); it != range.second; ++it )
+		{
+			if( it->second == last )
+			{
+				m_map.erase( it );
+				break;
+			}
+		}
+
+		m_memoryUsage -= last->memoryUsage;
+		m_entries.erase( last );
+	}
+}
+
+}; // namespace Image
+
+}; // namespace Gander
+
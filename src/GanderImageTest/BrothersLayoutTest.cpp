@@ -35,6 +35,9 @@
 #include <cstdlib>
 
 #include "GanderImage/BrothersLayout.h"
+#include "GanderImage/ChannelLayout.h"
+#include "GanderImage/CompoundLayout.h"
+#include "Gander/PackedBits.h"
 #include "GanderImageTest/BrothersLayoutTest.h"
 
 #include "boost/test/floating_point_comparison.hpp"
@@ -273,6 +276,59 @@ struct BrothersLayoutTest
 		BOOST_CHECK_EQUAL( float( layout.channelAtIndex< Layout::ChannelPointerContainerType, 1, ChannelMask( CombineMasks< Mask_Alpha, Mask_Green >::Value ) >( cp ) ), 4. );
 					
 	}
+
+	void testPackedContainerAccess()
+	{
+		typedef BrothersLayout< packed10, Brothers_RGB > Layout;
+		Layout layout;
+		Layout::ChannelContainerType c( layout );
+		Layout::ChannelPointerContainerType cp( layout );
+
+		layout.channel< Layout::ChannelContainerType, Chan_Red >( c ) = 1023;
+		layout.channel< Layout::ChannelContainerType, Chan_Green >( c ) = 512;
+		BOOST_CHECK_EQUAL( ( layout.channel< Layout::ChannelContainerType, Chan_Red >( c ) ), 1023 );
+		BOOST_CHECK_EQUAL( ( layout.channel< Layout::ChannelContainerType, Chan_Green >( c ) ), 512 );
+
+		// Three pixels of three 10-bit channels occupy 90 bits.
+		int8u rgb[12] = { 0 };
+		layout.setChannelPointer< Layout::ChannelPointerContainerType >( cp, Chan_Red, static_cast< void * >( &rgb[0] ) );
+		for( int i = 0; i < 3; ++i )
+		{
+			layout.channel< Layout::ChannelPointerContainerType, Chan_Red >( cp ) = 100 * i + 1;
+			layout.channel< Layout::ChannelPointerContainerType, Chan_Green >( cp ) = 100 * i + 2;
+			layout.channel< Layout::ChannelPointerContainerType, Chan_Blue >( cp ) = 1023 - i;
+			layout.increment( cp, 1 );
+		}
+		BOOST_CHECK_EQUAL( int( rgb[11] >> 2 ), 0 );
+		
+		layout.decrement( cp, 2 );
+		BOOST_CHECK_EQUAL( ( layout.channel< Layout::ChannelPointerContainerType, Chan_Red >( cp ) ), 101 );
+		BOOST_CHECK_EQUAL( ( layout.channel< Layout::ChannelPointerContainerType, Chan_Green >( cp ) ), 102 );
+		BOOST_CHECK_EQUAL( ( layout.channel< Layout::ChannelPointerContainerType, Chan_Blue >( cp ) ), 1022 );
+		BOOST_CHECK_EQUAL( int( layout.channelAtIndex< Layout::ChannelPointerContainerType, 2 >( cp ) ), 1022 );
+
+		PackedBitsPointer< 10 > p( &rgb[0] );
+		const int expected[9] = { 1, 2, 1023, 101, 102, 1022, 201, 202, 1021 };
+		for( int i = 0; i < 9; ++i )
+		{
+			BOOST_CHECK_EQUAL( int( p[i] ), expected[i] );
+		}
+
+		// Packed layouts can be held by a CompoundLayout alongside layouts of other types.
+		typedef CompoundLayout< Layout, ChannelLayout< float, Chan_Alpha > > CompoundLayout;
+		CompoundLayout compoundLayout;
+		CompoundLayout::ChannelPointerContainerType ccp( compoundLayout );
+		float alpha[3] = { .25f, .5f, .75f };
+		compoundLayout.setChannelPointer( ccp, Chan_Red, &rgb[0] );
+		compoundLayout.setChannelPointer( ccp, Chan_Alpha, &alpha[0] );
+		for( int i = 0; i < 3; ++i )
+		{
+			BOOST_CHECK_EQUAL( int( compoundLayout.channel< Chan_Red >( ccp ) ), expected[i*3] );
+			BOOST_CHECK_EQUAL( int( compoundLayout.channel< Chan_Blue >( ccp ) ), expected[i*3+2] );
+			BOOST_CHECK_EQUAL( compoundLayout.channel< Chan_Alpha >( ccp ), alpha[i] );
+			compoundLayout.increment( ccp, 1 );
+		}
+	}
 };
 
 struct BrothersLayoutTestSuite : public boost::unit_test::test_suite
@@ -285,6 +341,7 @@ struct BrothersLayoutTestSuite : public boost::unit_test::test_suite
 		add( BOOST_CLASS_TEST_CASE( &BrothersLayoutTest::testContainerAccess, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &BrothersLayoutTest::testCommonLayoutInterface, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &BrothersLayoutTest::testMaskedChannelIndex, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &BrothersLayoutTest::testPackedContainerAccess, instance ) );
 	}
 };
 
@@ -0,0 +1,165 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#include <iostream>
+#include <cstdlib>
+
+#include "GanderImage/ChannelView.h"
+#include "GanderImage/BrothersLayout.h"
+#include "GanderImage/ChannelLayout.h"
+#include "GanderImage/CompoundLayout.h"
+#include "GanderImage/DynamicLayout.h"
+#include "GanderImage/PixelIterator.h"
+#include "GanderImageTest/ChannelViewTest.h"
+
+#include "boost/test/floating_point_comparison.hpp"
+#include "boost/test/test_tools.hpp"
+
+using namespace Gander;
+using namespace Gander::Image;
+using namespace Gander::ImageTest;
+using namespace boost;
+using namespace boost::unit_test;
+
+namespace Gander
+{
+
+namespace ImageTest
+{
+
+/// A functor that counts the number of channels that it is applied to.
+struct CountChannels
+{
+	inline void init() { m_count = 0; }
+	
+	template< class T, class S >
+	void operator () ( const T &t, const S &s ) { ++m_count; }
+
+	int m_count;
+};
+
+struct ChannelViewTest
+{
+	void testView()
+	{
+		typedef CompoundLayout< BrothersLayout< float, Brothers_RGBA >, ChannelLayout< float, Chan_Z >, BrothersLayout< float, Brothers_UV > > Layout;
+		typedef PixelIterator< Layout > PixelIterator;
+		typedef ConstPixelIterator< Layout > ConstPixelIterator;
+		
+		float rgba[8] = { 1., 2., 3., 4., 5., 6., 7., 8. };
+		float z[2] = { 9., 10. };
+		float uv[4] = { 11., 12., 13., 14. };
+		
+		PixelIterator it;
+		it->setChannelPointer( Chan_Red, &rgba[0] );
+		it->setChannelPointer( Chan_Z, &z[0] );
+		it->setChannelPointer( Chan_U, &uv[0] );
+
+		ChannelView< PixelAccessor< Layout >, Mask_RGB > rgb( view< Mask_RGB >( it ) );
+		BOOST_CHECK_EQUAL( rgb.channels(), ChannelSet( Mask_RGB ) );
+		BOOST_CHECK_EQUAL( rgb.numberOfChannels(), 3u );
+		BOOST_CHECK_EQUAL( int( decltype( rgb )::LayoutType::ChannelMask ), int( Mask_RGB ) );
+		BOOST_CHECK_EQUAL( rgb.channel< Chan_Green >(), 2. );
+		
+		// The view shares the iterator's pointers, so it follows the iterator.
+		++it;
+		BOOST_CHECK_EQUAL( rgb.channel< Chan_Green >(), 6. );
+		rgb.channel< Chan_Blue >() = 0.;
+		BOOST_CHECK_EQUAL( rgba[6], 0. );
+		
+		// Only the channels in the view are visited by forEachChannel.
+		ConstPixelIterator cit( it );
+		--cit;
+		CountChannels op;
+		const ChannelView< const PixelAccessor< Layout >, Mask_RGB > constRGB( view< Mask_RGB >( cit ) );
+		const ChannelView< PixelAccessor< Layout >, Mask_RGB > &rgbRef( rgb );
+		forEachChannel( rgbRef, constRGB, op );
+		BOOST_CHECK_EQUAL( op.m_count, 3 );
+		BOOST_CHECK( !( rgb == constRGB ) );
+		
+		// Copying through a view only changes the channels in the view.
+		rgb = constRGB;
+		BOOST_CHECK( rgb == constRGB );
+		BOOST_CHECK_EQUAL( rgba[4], 1. );
+		BOOST_CHECK_EQUAL( rgba[5], 2. );
+		BOOST_CHECK_EQUAL( rgba[6], 3. );
+		BOOST_CHECK_EQUAL( rgba[7], 8. );
+		BOOST_CHECK_EQUAL( z[1], 10. );
+		BOOST_CHECK_EQUAL( uv[2], 13. );
+	}
+	
+	void testDynamicView()
+	{
+		typedef CompoundLayout< BrothersLayout< float, Brothers_RGB >, DynamicLayout< float > > Layout;
+		typedef PixelIterator< Layout > PixelIterator;
+
+		PixelIterator it;
+		it->addChannels( Mask_Z | Mask_Alpha );
+		
+		float rgb[3] = { 1., 2., 3. };
+		float alpha = 4., z = 5.;
+		it->setChannelPointer( Chan_Red, &rgb[0] );
+		it->setChannelPointer( Chan_Alpha, &alpha );
+		it->setChannelPointer( Chan_Z, &z );
+		
+		// Channels of the dynamic layout are masked at runtime.
+		enum { Mask = EnumType( Mask_Red ) | EnumType( Mask_Z ) };
+		ChannelView< PixelAccessor< Layout >, Mask > v( view< Mask >( it ) );
+		BOOST_CHECK_EQUAL( v.channels(), ChannelSet( Mask_Red | Mask_Z ) );
+		BOOST_CHECK_EQUAL( v.channel< Chan_Z >(), 5. );
+		
+		CountChannels op;
+		const ChannelView< PixelAccessor< Layout >, Mask > &vRef( v );
+		forEachChannel( vRef, vRef, op );
+		BOOST_CHECK_EQUAL( op.m_count, 2 );
+	}
+};
+
+struct ChannelViewTestSuite : public boost::unit_test::test_suite
+{
+	ChannelViewTestSuite() : boost::unit_test::test_suite( "ChannelViewTestSuite" )
+	{
+		boost::shared_ptr<ChannelViewTest> instance( new ChannelViewTest() );
+		add( BOOST_CLASS_TEST_CASE( &ChannelViewTest::testView, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &ChannelViewTest::testDynamicView, instance ) );
+	}
+};
+
+void addChannelViewTest( boost::unit_test::test_suite *test )
+{
+	test->add( new ChannelViewTestSuite() );
+}
+
+} // namespace ImageTest
+
+} // namespace Gander
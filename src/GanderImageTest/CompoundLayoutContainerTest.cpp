@@ -33,6 +33,9 @@
 //////////////////////////////////////////////////////////////////////////
 #include <iostream>
 #include <cstdlib>
+#include <vector>
+
+#include "boost/thread.hpp"
 
 #include "GanderImage/CompoundLayout.h"
 #include "GanderImage/ChannelLayout.h"
@@ -40,6 +43,7 @@
 #include "GanderImage/DynamicLayout.h"
 #include "GanderImage/CompoundLayoutContainer.h"
 
+#include "GanderTest/Benchmark.h"
 #include "GanderImageTest/CompoundLayoutContainerTest.h"
 
 #include "boost/test/floating_point_comparison.hpp"
@@ -57,6 +61,129 @@ namespace Gander
 namespace ImageTest
 {
 
+/// Iterates over a row of pixels of a multi-layer image using its own instance of a CompoundLayout and
+/// ChannelPointerContainerType, recording whether every channel held the expected value.
+struct CompoundLayoutIterationJob
+{
+	typedef Gander::Image::CompoundLayout<
+		BrothersLayout< float, Brothers_RGBA >, ChannelLayout< float, Chan_Z >, BrothersLayout< float, Brothers_UV >,
+		ChannelLayout< float, Chan_Forward >, ChannelLayout< float, Chan_Backward >
+	> CompoundLayout;
+
+	CompoundLayoutIterationJob( int seed, bool &result ) :
+		m_seed( seed ),
+		m_result( result )
+	{
+	}
+
+	void operator()()
+	{
+		const int width = 1024;
+		const int passes = 16;
+		std::vector< float > rgba( width * 4 ), z( width ), uv( width * 2 ), forward( width ), backward( width );
+		for( int i = 0; i < width; ++i )
+		{
+			for( int c = 0; c < 4; ++c )
+			{
+				rgba[i*4+c] = value( i, c );
+			}
+			z[i] = value( i, 4 );
+			uv[i*2] = value( i, 5 );
+			uv[i*2+1] = value( i, 6 );
+			forward[i] = value( i, 7 );
+			backward[i] = value( i, 8 );
+		}
+
+		bool result = true;
+		for( int pass = 0; pass < passes; ++pass )
+		{
+			CompoundLayout layout;
+			CompoundLayout::ChannelPointerContainerType container( layout );
+			layout.setChannelPointer( container, Chan_Red, &rgba[0] );
+			layout.setChannelPointer( container, Chan_Z, &z[0] );
+			layout.setChannelPointer( container, Chan_U, &uv[0] );
+			layout.setChannelPointer( container, Chan_Forward, &forward[0] );
+			layout.setChannelPointer( container, Chan_Backward, &backward[0] );
+
+			for( int i = 0; i < width; ++i )
+			{
+				result &= layout.channel< Chan_Red >( container ) == value( i, 0 );
+				result &= layout.channel< Chan_Green >( container ) == value( i, 1 );
+				result &= layout.channel< Chan_Blue >( container ) == value( i, 2 );
+				result &= layout.channel< Chan_Alpha >( container ) == value( i, 3 );
+				result &= layout.channel< Chan_Z >( container ) == value( i, 4 );
+				result &= layout.channel< Chan_U >( container ) == value( i, 5 );
+				result &= layout.channel< Chan_V >( container ) == value( i, 6 );
+				result &= layout.channel< Chan_Forward >( container ) == value( i, 7 );
+				result &= layout.channel< Chan_Backward >( container ) == value( i, 8 );
+				layout.increment( container, 1 );
+			}
+		}
+		m_result = result;
+	}
+
+	inline float value( int i, int c ) const
+	{
+		return float( m_seed * 100000 + i * 10 + c );
+	}
+
+	int m_seed;
+	bool &m_result;
+};
+
+/// Repeatedly writes and reads back the channels of a pixel held by value in its own instance of a CompoundLayout
+/// and ChannelContainerType, recording whether every channel held the value that was written to it.
+struct CompoundLayoutValueJob
+{
+	typedef Gander::Image::CompoundLayout<
+		BrothersLayout< float, Brothers_RGBA >, ChannelLayout< int, Chan_Z >, BrothersLayout< double, Brothers_UV >,
+		ChannelLayout< float, Chan_Forward >, ChannelLayout< int, Chan_Backward >
+	> CompoundLayout;
+
+	CompoundLayoutValueJob( int seed, bool &result ) :
+		m_seed( seed ),
+		m_result( result )
+	{
+	}
+
+	void operator()()
+	{
+		const int iterations = 1 << 14;
+
+		bool result = true;
+		for( int i = 0; i < iterations; ++i )
+		{
+			CompoundLayout layout;
+			CompoundLayout::ChannelContainerType container( layout );
+
+			const int v = m_seed * 100000 + i;
+			layout.channel< Chan_Red >( container ) = float( v );
+			layout.channel< Chan_Green >( container ) = float( v + 1 );
+			layout.channel< Chan_Blue >( container ) = float( v + 2 );
+			layout.channel< Chan_Alpha >( container ) = float( v + 3 );
+			layout.channel< Chan_Z >( container ) = v + 4;
+			layout.channel< Chan_U >( container ) = double( v + 5 );
+			layout.channel< Chan_V >( container ) = double( v + 6 );
+			layout.channel< Chan_Forward >( container ) = float( v + 7 );
+			layout.channel< Chan_Backward >( container ) = v + 8;
+
+			result &= layout.channelAtIndex< 0 >( container ) == float( v );
+			result &= layout.channelAtIndex< 1 >( container ) == float( v + 1 );
+			result &= layout.channelAtIndex< 2 >( container ) == float( v + 2 );
+			result &= layout.channelAtIndex< 3 >( container ) == float( v + 3 );
+			result &= layout.channelAtIndex< 4 >( container ) == v + 4;
+			result &= layout.channelAtIndex< 5 >( container ) == double( v + 5 );
+			result &= layout.channelAtIndex< 6 >( container ) == double( v + 6 );
+			result &= layout.channelAtIndex< 7 >( container ) == float( v + 7 );
+			result &= layout.channelAtIndex< 8 >( container ) == v + 8;
+		}
+		m_result = result;
+	}
+
+	int m_seed;
+	bool &m_result;
+};
+
 struct CompoundLayoutContainerTest
 {
 	void testCompoundLayoutContainer()
@@ -76,6 +203,162 @@ struct CompoundLayoutContainerTest
 
 		BOOST_CHECK_EQUAL( cc.size(), compoundLayout.channels().size() );		
 	}
+
+	void testChannelPointerContainer()
+	{
+		typedef Gander::Image::CompoundLayout<
+			BrothersLayout< float, Brothers_BGR >, ChannelLayout< float, Chan_Alpha >, ChannelLayout< int, Chan_Z >, BrothersLayout< double, Brothers_VU >, DynamicLayout< float >
+		> CompoundLayout;
+		typedef CompoundLayout::ChannelPointerContainerType CompoundLayoutContainer;
+
+		CompoundLayout compoundLayout;
+		compoundLayout.addChannels( Mask_Mask );
+		CompoundLayoutContainer cc( compoundLayout );
+
+		BOOST_CHECK( ( std::is_same< CompoundLayoutContainer::ChildTraitsAtIndex<0>::ContainerType, BrothersLayout< float, Brothers_BGR >::ChannelPointerContainerType >::value ) );
+		BOOST_CHECK( ( std::is_same< CompoundLayoutContainer::ChildTraitsAtIndex<3>::ContainerType, BrothersLayout< double, Brothers_VU >::ChannelPointerContainerType >::value ) );
+		BOOST_CHECK( ( std::is_same< CompoundLayoutContainer::ChildTraitsAtIndex<4>::ContainerType, DynamicLayout< float >::ChannelPointerContainerType >::value ) );
+		BOOST_CHECK_EQUAL( cc.size(), compoundLayout.numberOfChannelPointers() );
+
+		float bgr[9] = { 3., 2., 1., 6., 5., 4., 9., 8., 7. };
+		float alpha[3] = { 10., 11., 12. };
+		int z[3] = { 13, 14, 15 };
+		double vu[6] = { 17., 16., 19., 18., 21., 20. };
+		float mask[3] = { 22., 23., 24. };
+		compoundLayout.setChannelPointer( cc, Chan_Blue, &bgr[0] );
+		compoundLayout.setChannelPointer( cc, Chan_Alpha, &alpha[0] );
+		compoundLayout.setChannelPointer( cc, Chan_Z, &z[0] );
+		compoundLayout.setChannelPointer( cc, Chan_V, &vu[0] );
+		compoundLayout.setChannelPointer( cc, Chan_Mask, &mask[0] );
+
+		// Step forward one pixel at a time and check that the pointers of every child have been advanced by their own step.
+		for( int i = 0; i < 3; ++i )
+		{
+			BOOST_CHECK_EQUAL( compoundLayout.channel< Chan_Red >( cc ), bgr[i*3+2] );
+			BOOST_CHECK_EQUAL( compoundLayout.channel< Chan_Green >( cc ), bgr[i*3+1] );
+			BOOST_CHECK_EQUAL( compoundLayout.channel< Chan_Blue >( cc ), bgr[i*3] );
+			BOOST_CHECK_EQUAL( compoundLayout.channel< Chan_Alpha >( cc ), alpha[i] );
+			BOOST_CHECK_EQUAL( compoundLayout.channel< Chan_Z >( cc ), z[i] );
+			BOOST_CHECK_EQUAL( compoundLayout.channel< Chan_U >( cc ), vu[i*2+1] );
+			BOOST_CHECK_EQUAL( compoundLayout.channel< Chan_V >( cc ), vu[i*2] );
+			BOOST_CHECK_EQUAL( compoundLayout.channel< Chan_Mask >( cc ), mask[i] );
+			if( i < 2 )
+			{
+				compoundLayout.increment( cc, 1 );
+			}
+		}
+
+		// Step back over more than one pixel at once.
+		compoundLayout.decrement( cc, 2 );
+		BOOST_CHECK_EQUAL( compoundLayout.channel< Chan_Red >( cc ), 1. );
+		BOOST_CHECK_EQUAL( compoundLayout.channel< Chan_Alpha >( cc ), 10. );
+		BOOST_CHECK_EQUAL( compoundLayout.channel< Chan_Z >( cc ), 13 );
+		BOOST_CHECK_EQUAL( compoundLayout.channel< Chan_U >( cc ), 16. );
+		BOOST_CHECK_EQUAL( compoundLayout.channel< Chan_Mask >( cc ), 22. );
+
+		compoundLayout.increment( cc, 2 );
+		BOOST_CHECK_EQUAL( compoundLayout.channel< Chan_Red >( cc ), 7. );
+		BOOST_CHECK_EQUAL( compoundLayout.channel< Chan_Alpha >( cc ), 12. );
+		BOOST_CHECK_EQUAL( compoundLayout.channel< Chan_Z >( cc ), 15 );
+		BOOST_CHECK_EQUAL( compoundLayout.channel< Chan_U >( cc ), 20. );
+		BOOST_CHECK_EQUAL( compoundLayout.channel< Chan_Mask >( cc ), 24. );
+	}
+
+	void testMultiThreadedIteration()
+	{
+		const int numberOfThreads = 16;
+		bool results[numberOfThreads];
+		
+		boost::thread_group threads;
+		for( int i = 0; i < numberOfThreads; ++i )
+		{
+			results[i] = false;
+			threads.create_thread( CompoundLayoutIterationJob( i, results[i] ) );
+		}
+		threads.join_all();
+
+		for( int i = 0; i < numberOfThreads; ++i )
+		{
+			BOOST_CHECK( results[i] );
+		}
+	}
+
+	/// Times advancing the channel pointers of a compound layout with the flattened container against the recursive
+	/// container which calls the increment() method of each child.
+	void testChannelPointerIncrementThroughput()
+	{
+		typedef Gander::Image::CompoundLayout<
+			BrothersLayout< float, Brothers_RGBA >, ChannelLayout< float, Chan_Z >, BrothersLayout< float, Brothers_UV >,
+			ChannelLayout< float, Chan_Forward >, ChannelLayout< float, Chan_Backward >
+		> CompoundLayout;
+		typedef Gander::Image::Detail::CompoundLayoutContainer< CompoundLayout, Gander::Image::Detail::ChannelPointerContainer, true > FlattenedContainer;
+		typedef Gander::Image::Detail::CompoundLayoutContainer< CompoundLayout, Gander::Image::Detail::ChannelPointerContainer, false > RecursiveContainer;
+
+		const int width = 1 << 12, passes = 1 << 10;
+		std::vector< float > rgba( width * 4 ), z( width ), uv( width * 2 ), forward( width ), backward( width );
+
+		CompoundLayout layout;
+		FlattenedContainer flattened( layout );
+		RecursiveContainer recursive( layout );
+		flattened.child<0>()[0] = recursive.child<0>()[0] = &rgba[0];
+		flattened.child<1>()[0] = recursive.child<1>()[0] = &z[0];
+		flattened.child<2>()[0] = recursive.child<2>()[0] = &uv[0];
+		flattened.child<3>()[0] = recursive.child<3>()[0] = &forward[0];
+		flattened.child<4>()[0] = recursive.child<4>()[0] = &backward[0];
+
+		Gander::Test::Benchmark benchmark( "CompoundLayoutContainerTest", "Mpixels/s", double( width ) * passes * 1e-6 );
+		float flattenedSum = 0.f;
+		for( int pass = 0; pass < passes; ++pass )
+		{
+			for( int i = 0; i < width; ++i )
+			{
+				flattenedSum += *flattened.child<1>()[0];
+				flattened.increment( layout, 1 );
+			}
+			flattened.decrement( layout, width );
+		}
+		benchmark.stop( "flattened" );
+
+		float recursiveSum = 0.f;
+		benchmark.start();
+		for( int pass = 0; pass < passes; ++pass )
+		{
+			for( int i = 0; i < width; ++i )
+			{
+				recursiveSum += *recursive.child<1>()[0];
+				recursive.increment( layout, 1 );
+			}
+			recursive.decrement( layout, width );
+		}
+		benchmark.stop( "recursive" );
+		benchmark.report();
+
+		BOOST_CHECK_EQUAL( flattenedSum, recursiveSum );
+		flattened.increment( layout, 3 );
+		recursive.increment( layout, 3 );
+		BOOST_CHECK( flattened.child<0>()[0] == &rgba[12] && recursive.child<0>()[0] == &rgba[12] );
+		BOOST_CHECK( flattened.child<2>()[0] == &uv[6] && recursive.child<2>()[0] == &uv[6] );
+		BOOST_CHECK( flattened.child<4>()[0] == &backward[3] && recursive.child<4>()[0] == &backward[3] );
+	}
+
+	void testMultiThreadedChannelContainers()
+	{
+		const int numberOfThreads = 16;
+		bool results[numberOfThreads];
+		
+		boost::thread_group threads;
+		for( int i = 0; i < numberOfThreads; ++i )
+		{
+			results[i] = false;
+			threads.create_thread( CompoundLayoutValueJob( i, results[i] ) );
+		}
+		threads.join_all();
+
+		for( int i = 0; i < numberOfThreads; ++i )
+		{
+			BOOST_CHECK( results[i] );
+		}
+	}
 };
 
 struct CompoundLayoutContainerTestSuite : public boost::unit_test::test_suite
@@ -84,6 +367,10 @@ struct CompoundLayoutContainerTestSuite : public boost::unit_test::test_suite
 	{
 		boost::shared_ptr<CompoundLayoutContainerTest> instance( new CompoundLayoutContainerTest() );
 		add( BOOST_CLASS_TEST_CASE( &CompoundLayoutContainerTest::testCompoundLayoutContainer, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &CompoundLayoutContainerTest::testChannelPointerContainer, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &CompoundLayoutContainerTest::testMultiThreadedIteration, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &CompoundLayoutContainerTest::testMultiThreadedChannelContainers, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &CompoundLayoutContainerTest::testChannelPointerIncrementThroughput, instance ) );
 	}
 };
 
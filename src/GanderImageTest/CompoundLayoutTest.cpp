@@ -54,6 +54,7 @@ template< EnumType ID, ChannelDefault S > struct TestLayout
 	enum
 	{
 		IsDynamic = false,
+		IsConstant = false,
 		NumberOfChannels = 1,
 		NumberOfChannelPointers = 1,
 		ChannelMask = ChannelToMask<S>::Value,
@@ -0,0 +1,227 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#include <iostream>
+#include <cstdlib>
+
+#include "GanderImage/ConstantChannelLayout.h"
+#include "GanderImage/BrothersLayout.h"
+#include "GanderImage/CompoundLayout.h"
+#include "GanderImage/DynamicLayout.h"
+#include "GanderImage/PixelIterator.h"
+#include "GanderImageTest/ConstantChannelLayoutTest.h"
+
+#include "boost/test/floating_point_comparison.hpp"
+#include "boost/test/test_tools.hpp"
+
+using namespace Gander;
+using namespace Gander::Image;
+using namespace Gander::ImageTest;
+using namespace boost;
+using namespace boost::unit_test;
+
+namespace Gander
+{
+
+namespace ImageTest
+{
+
+/// A functor that sums each pair of channels, counting the pairs where the second channel is constant.
+struct SumChannels
+{
+	public :
+
+		inline void init()
+		{
+			m_sum = 0.;
+			m_constants = 0;
+		}
+		
+		template< class T, class S >
+		void operator () ( const T &t, const S &s )
+		{
+			m_sum += t + s;
+		}
+		
+		template< class T, class S >
+		void operator () ( const T &t, const ConstantChannel< S > &s )
+		{
+			m_sum += t + s;
+			++m_constants;
+		}
+
+		double m_sum;
+		int m_constants;
+};
+
+struct ConstantChannelLayoutTest
+{
+	void testCommonLayoutAttributes()
+	{
+		typedef ConstantChannelLayout< float, Chan_Alpha > Layout;
+		Layout layout( 1. );
+
+		BOOST_CHECK_EQUAL( int( Layout::NumberOfChannels ), 1 );
+		BOOST_CHECK_EQUAL( int( Layout::NumberOfChannelPointers ), 0 );
+		BOOST_CHECK_EQUAL( int( Layout::ChannelMask ), int( Mask_Alpha ) );
+		BOOST_CHECK_EQUAL( int( Layout::IsConstant ), 1 );
+		BOOST_CHECK_EQUAL( int( BrothersLayout< float, Brothers_RGB >::IsConstant ), 0 );
+
+		BOOST_CHECK_EQUAL( layout.channels(), ChannelSet( Mask_Alpha ) );
+		BOOST_CHECK_EQUAL( layout.requiredChannels(), ChannelSet() );
+		BOOST_CHECK_EQUAL( layout.numberOfChannelPointers(), 0u );
+		BOOST_CHECK_EQUAL( layout.value(), 1. );
+	}
+
+	void testContainerAccess() 
+	{
+		typedef ConstantChannelLayout< float, Chan_Mask > Layout;
+		Layout layout;
+		Layout::ChannelContainerType c( layout );
+		Layout::ChannelPointerContainerType cp( layout );
+		BOOST_CHECK_EQUAL( cp.size(), 0u );
+		
+		BOOST_CHECK_EQUAL( float( layout.channel< Layout::ChannelContainerType, Chan_Mask >( c ) ), 0. );
+		BOOST_CHECK_EQUAL( float( layout.channel< Layout::ChannelPointerContainerType, Chan_Mask >( cp ) ), 0. );
+		
+		layout.setValue( .5 );
+		BOOST_CHECK_EQUAL( float( layout.channel< Layout::ChannelPointerContainerType >( cp, Chan_Mask ) ), .5 );
+		BOOST_CHECK_EQUAL( float( layout.channelAtIndex< Layout::ChannelPointerContainerType >( cp, 0 ) ), .5 );
+		BOOST_CHECK_THROW( layout.channel< Layout::ChannelPointerContainerType >( cp, Chan_Alpha ), std::runtime_error );
+		
+		// The value doesn't change as the container is stepped.
+		layout.increment( cp, 3 );
+		BOOST_CHECK_EQUAL( float( layout.channel< Layout::ChannelPointerContainerType, Chan_Mask >( cp ) ), .5 );
+		
+		float mask = 1.;
+		BOOST_CHECK_THROW( layout.setChannelPointer< Layout::ChannelPointerContainerType >( cp, Chan_Mask, &mask ), std::runtime_error );
+	}
+
+	void testPixelIterator()
+	{
+		typedef CompoundLayout< BrothersLayout< float, Brothers_RGB >, ConstantChannelLayout< float, Chan_Alpha > > Layout;
+		typedef PixelIterator< Layout > PixelIterator;
+
+		// Only the RGB channels take up any space in the container.
+		BOOST_CHECK_EQUAL( int( Layout::NumberOfChannelPointers ), 1 );
+		BOOST_CHECK( int( Layout::ChannelTraits< Chan_Alpha >::LayoutType::IsConstant ) );
+		BOOST_CHECK( !int( Layout::ChannelTraits< Chan_Red >::LayoutType::IsConstant ) );
+
+		PixelIterator it;
+		BOOST_CHECK_EQUAL( it->channels(), ChannelSet( Mask_RGBA ) );
+		BOOST_CHECK_EQUAL( it->requiredChannels(), ChannelSet( Mask_Red ) );
+		
+		float rgb[6] = { 1., 2., 3., 4., 5., 6. };
+		it->setChannelPointer( Chan_Red, &rgb[0] );
+		it->setConstantValue< Chan_Alpha >( 1. );
+
+		PixelIterator it2( it );
+		BOOST_CHECK_EQUAL( it2->channel< Chan_Alpha >(), 1. );
+		BOOST_CHECK_EQUAL( it2->channel< Chan_Red >(), 1. );
+		++it2;
+		BOOST_CHECK_EQUAL( it2->channel< Chan_Alpha >(), 1. );
+		BOOST_CHECK_EQUAL( it2->channel< Chan_Blue >(), 6. );
+
+		SumChannels op;
+		const PixelIterator::PixelAccessor &p1( *it ), &p2( *it2 );
+		forEachChannel( p1, p2, op );
+		BOOST_CHECK_EQUAL( op.m_sum, 23. );
+		BOOST_CHECK_EQUAL( op.m_constants, 1 );
+	}
+
+	void testDynamicLayout()
+	{
+		typedef DynamicLayout< float > Layout;
+		Layout constant, varying;
+		Layout::ChannelPointerContainerType constantContainer( constant ), varyingContainer( varying );
+		constant.addConstantChannels( constantContainer, ChannelSet( Mask_Alpha ) );
+		varying.addChannels( varyingContainer, ChannelSet( Mask_Alpha ) );
+		
+		// A constant channel is a different arrangement of the same channels.
+		BOOST_CHECK_EQUAL( constant.channels(), varying.channels() );
+		BOOST_CHECK_EQUAL( constant.constantChannels(), ChannelSet( Mask_Alpha ) );
+		BOOST_CHECK_EQUAL( varying.constantChannels(), ChannelSet() );
+		BOOST_CHECK( constant.descriptor() != varying.descriptor() );
+		BOOST_CHECK_THROW( constant.addConstantChannels( constantContainer, ChannelSet( Mask_Alpha ) ), std::runtime_error );
+
+		typedef CompoundLayout< BrothersLayout< float, Brothers_RGB >, DynamicLayout< float > > CompoundLayoutType;
+		typedef PixelIterator< CompoundLayoutType > Iterator;
+		
+		Iterator it;
+		it->addChannels( ChannelSet( Mask_Z ) );
+		it->addConstantChannels( ChannelSet( Mask_Alpha ) );
+		BOOST_CHECK_EQUAL( it->channels(), ChannelSet( Mask_RGBA ) + ChannelSet( Mask_Z ) );
+		BOOST_CHECK_EQUAL( it->constantChannels(), ChannelSet( Mask_Alpha ) );
+
+		// The constant channel points to a single value, which is shared by every pixel.
+		float rgb[6] = { 1., 2., 3., 4., 5., 6. }, z[2] = { 7., 8. }, alpha = 1.;
+		it->setChannelPointer( Chan_Red, &rgb[0] );
+		it->setChannelPointer( Chan_Z, &z[0] );
+		it->setChannelPointer( Chan_Alpha, &alpha );
+		
+		Iterator it2( it );
+		++it2;
+		BOOST_CHECK_EQUAL( it2->channel< Chan_Blue >(), 6. );
+		BOOST_CHECK_EQUAL( it2->channel< Chan_Z >(), 8. );
+		BOOST_CHECK_EQUAL( it2->channel< Chan_Alpha >(), 1. );
+		it2 += 5;
+		BOOST_CHECK_EQUAL( &it2->channel< Chan_Alpha >(), &alpha );
+
+		// Constant channels of the static layouts are reported too.
+		typedef CompoundLayout< BrothersLayout< float, Brothers_RGB >, ConstantChannelLayout< float, Chan_Alpha >, DynamicLayout< float > > MixedLayout;
+		PixelIterator< MixedLayout > mixed;
+		mixed->addConstantChannels( ChannelSet( Mask_Mask ) );
+		BOOST_CHECK_EQUAL( mixed->constantChannels(), ChannelSet( Mask_Alpha ) + ChannelSet( Mask_Mask ) );
+	}
+};
+
+struct ConstantChannelLayoutTestSuite : public boost::unit_test::test_suite
+{
+	ConstantChannelLayoutTestSuite() : boost::unit_test::test_suite( "ConstantChannelLayoutTestSuite" )
+	{
+		boost::shared_ptr<ConstantChannelLayoutTest> instance( new ConstantChannelLayoutTest() );
+		add( BOOST_CLASS_TEST_CASE( &ConstantChannelLayoutTest::testCommonLayoutAttributes, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &ConstantChannelLayoutTest::testContainerAccess, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &ConstantChannelLayoutTest::testPixelIterator, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &ConstantChannelLayoutTest::testDynamicLayout, instance ) );
+	}
+};
+
+void addConstantChannelLayoutTest( boost::unit_test::test_suite *test )
+{
+	test->add( new ConstantChannelLayoutTestSuite() );
+}
+
+} // namespace ImageTest
+
+} // namespace Gander
@@ -0,0 +1,449 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "Gander/Half.h"
+#include "Gander/SampleConversion.h"
+
+#include "GanderImage/BrothersLayout.h"
+#include "GanderImage/ChannelLayout.h"
+#include "GanderImage/CompoundLayout.h"
+#include "GanderImage/ConvertLayout.h"
+#include "GanderImage/DynamicLayout.h"
+#include "GanderImage/PixelIterator.h"
+#include "GanderImage/SubsampledChannelLayout.h"
+#include "GanderImageTest/ConvertLayoutTest.h"
+
+#include "boost/test/floating_point_comparison.hpp"
+#include "boost/test/test_tools.hpp"
+
+using namespace Gander;
+using namespace Gander::Image;
+using namespace Gander::ImageTest;
+using namespace boost;
+using namespace boost::unit_test;
+
+namespace Gander
+{
+
+namespace ImageTest
+{
+
+struct ConvertLayoutTest
+{
+	void testKernelSelection()
+	{
+		typedef CompoundLayout< BrothersLayout< float, Brothers_RGBA > > RGBA;
+		typedef CompoundLayout< BrothersLayout< float, Brothers_BGRA > > BGRA;
+		typedef CompoundLayout< BrothersLayout< float, Brothers_RGB > > RGB;
+		typedef CompoundLayout< BrothersLayout< float, Brothers_BGR > > BGR;
+		typedef CompoundLayout< BrothersLayout< double, Brothers_BGRA > > BGRADouble;
+		typedef CompoundLayout< ChannelLayout< float, Chan_Red >, ChannelLayout< float, Chan_Green >, ChannelLayout< float, Chan_Blue >, ChannelLayout< float, Chan_Alpha > > Planar;
+		typedef CompoundLayout< ChannelLayout< float, Chan_Z > > Z;
+		
+		BOOST_CHECK_EQUAL( int( LayoutConverter< RGBA, RGBA >::Kernel ), int( Image::Detail::ConvertByCopying ) );
+		BOOST_CHECK_EQUAL( int( LayoutConverter< Z, Z >::Kernel ), int( Image::Detail::ConvertByCopying ) );
+		BOOST_CHECK_EQUAL( int( LayoutConverter< BGRA, RGBA >::Kernel ), int( Image::Detail::ConvertBySwizzling ) );
+		BOOST_CHECK_EQUAL( int( LayoutConverter< BGR, RGB >::Kernel ), int( Image::Detail::ConvertBySwizzling ) );
+		BOOST_CHECK_EQUAL( int( LayoutConverter< BGRADouble, RGBA >::Kernel ), int( Image::Detail::ConvertByStriding ) );
+		BOOST_CHECK_EQUAL( int( LayoutConverter< Planar, RGBA >::Kernel ), int( Image::Detail::ConvertByStriding ) );
+		BOOST_CHECK_EQUAL( int( LayoutConverter< Planar, Planar >::Kernel ), int( Image::Detail::ConvertByStriding ) );
+	}
+
+	void testCopy()
+	{
+		typedef CompoundLayout< BrothersLayout< float, Brothers_BGR > > Layout;
+
+		float src[15], dst[15] = { 0. };
+		for( unsigned int i = 0; i < 15; ++i )
+		{
+			src[i] = float( i );
+		}
+
+		PixelIterator< Layout > it;
+		it->setChannelPointer( Chan_Blue, &src[0] );
+		PixelIterator< Layout > out;
+		out->setChannelPointer( Chan_Blue, &dst[0] );
+		
+		PixelIterator< Layout > end( convertPixels( ConstPixelIterator< Layout >( it ), 5, out ) );
+		BOOST_CHECK( end == out + 5 );
+		for( unsigned int i = 0; i < 15; ++i )
+		{
+			BOOST_CHECK_EQUAL( dst[i], src[i] );
+		}
+	}
+
+	template< class T >
+	void checkSwizzle( unsigned int width )
+	{
+		typedef CompoundLayout< BrothersLayout< T, Brothers_RGBA > > SrcLayout;
+		typedef CompoundLayout< BrothersLayout< T, Brothers_BGRA > > DstLayout;
+		typedef CompoundLayout< BrothersLayout< T, Brothers_RGBA > > BackLayout;
+
+		std::vector< T > src( width * 4 ), dst( width * 4 ), back( width * 4 );
+		for( unsigned int i = 0; i < width * 4; ++i )
+		{
+			src[i] = T( i % 100 );
+		}
+
+		PixelIterator< SrcLayout > it;
+		it->setChannelPointer( Chan_Red, &src[0] );
+		PixelIterator< DstLayout > out;
+		out->setChannelPointer( Chan_Blue, &dst[0] );
+
+		convertPixels( ConstPixelIterator< SrcLayout >( it ), width, out );
+		for( unsigned int x = 0; x < width; ++x )
+		{
+			BOOST_CHECK_EQUAL( dst[x*4], src[x*4+2] );
+			BOOST_CHECK_EQUAL( dst[x*4+1], src[x*4+1] );
+			BOOST_CHECK_EQUAL( dst[x*4+2], src[x*4] );
+			BOOST_CHECK_EQUAL( dst[x*4+3], src[x*4+3] );
+		}
+
+		// Swizzling back again restores the original samples.
+		PixelIterator< BackLayout > backIt;
+		backIt->setChannelPointer( Chan_Red, &back[0] );
+		convertPixels( ConstPixelIterator< DstLayout >( out ), width, backIt );
+		BOOST_CHECK( back == src );
+	}
+
+	template< class T >
+	void checkRGBSwizzle( unsigned int width )
+	{
+		typedef CompoundLayout< BrothersLayout< T, Brothers_RGB > > SrcLayout;
+		typedef CompoundLayout< BrothersLayout< T, Brothers_BGR > > DstLayout;
+
+		std::vector< T > src( width * 3 ), dst( width * 3 ), back( width * 3 );
+		for( unsigned int i = 0; i < width * 3; ++i )
+		{
+			src[i] = T( i % 100 );
+		}
+
+		PixelIterator< SrcLayout > it;
+		it->setChannelPointer( Chan_Red, &src[0] );
+		PixelIterator< DstLayout > out;
+		out->setChannelPointer( Chan_Blue, &dst[0] );
+
+		convertPixels( ConstPixelIterator< SrcLayout >( it ), width, out );
+		for( unsigned int x = 0; x < width; ++x )
+		{
+			BOOST_CHECK_EQUAL( dst[x*3], src[x*3+2] );
+			BOOST_CHECK_EQUAL( dst[x*3+1], src[x*3+1] );
+			BOOST_CHECK_EQUAL( dst[x*3+2], src[x*3] );
+		}
+
+		PixelIterator< SrcLayout > backIt;
+		backIt->setChannelPointer( Chan_Red, &back[0] );
+		convertPixels( ConstPixelIterator< DstLayout >( out ), width, backIt );
+		BOOST_CHECK( back == src );
+	}
+
+	void testSwizzle()
+	{
+		checkSwizzle< float >( 7 );
+		checkSwizzle< int8u >( 1 );
+		checkSwizzle< int8u >( 13 );
+		checkSwizzle< int16u >( 5 );
+		checkRGBSwizzle< float >( 7 );
+		checkRGBSwizzle< int8u >( 13 );
+	}
+
+	void testPlanarToInterleaved()
+	{
+		typedef CompoundLayout< ChannelLayout< float, Chan_Red >, ChannelLayout< float, Chan_Green >, ChannelLayout< float, Chan_Blue > > Planar;
+		typedef CompoundLayout< BrothersLayout< float, Brothers_RGB > > Interleaved;
+		typedef CompoundLayout< BrothersLayout< double, Brothers_BGR > > InterleavedDouble;
+		
+		float r[4] = { 1., 2., 3., 4. };
+		float g[4] = { 5., 6., 7., 8. };
+		float b[4] = { 9., 10., 11., 12. };
+
+		PixelIterator< Planar > planar;
+		planar->setChannelPointer( Chan_Red, &r[0] );
+		planar->setChannelPointer( Chan_Green, &g[0] );
+		planar->setChannelPointer( Chan_Blue, &b[0] );
+
+		float rgb[12] = { 0. };
+		PixelIterator< Interleaved > interleaved;
+		interleaved->setChannelPointer( Chan_Red, &rgb[0] );
+		
+		convertPixels( ConstPixelIterator< Planar >( planar ), 4, interleaved );
+		for( unsigned int i = 0; i < 4; ++i )
+		{
+			BOOST_CHECK_EQUAL( rgb[i*3], r[i] );
+			BOOST_CHECK_EQUAL( rgb[i*3+1], g[i] );
+			BOOST_CHECK_EQUAL( rgb[i*3+2], b[i] );
+		}
+		
+		// Converting the type at the same time.
+		double bgr[12] = { 0. };
+		PixelIterator< InterleavedDouble > interleavedDouble;
+		interleavedDouble->setChannelPointer( Chan_Blue, &bgr[0] );
+		convertPixels( ConstPixelIterator< Interleaved >( interleaved ), 4, interleavedDouble );
+		for( unsigned int i = 0; i < 4; ++i )
+		{
+			BOOST_CHECK_EQUAL( bgr[i*3], b[i] );
+			BOOST_CHECK_EQUAL( bgr[i*3+1], g[i] );
+			BOOST_CHECK_EQUAL( bgr[i*3+2], r[i] );
+		}
+
+		// And back to planar again.
+		float r2[4] = { 0. }, g2[4] = { 0. }, b2[4] = { 0. };
+		PixelIterator< Planar > planar2;
+		planar2->setChannelPointer( Chan_Red, &r2[0] );
+		planar2->setChannelPointer( Chan_Green, &g2[0] );
+		planar2->setChannelPointer( Chan_Blue, &b2[0] );
+		convertPixels( ConstPixelIterator< InterleavedDouble >( interleavedDouble ), 4, planar2 );
+		for( unsigned int i = 0; i < 4; ++i )
+		{
+			BOOST_CHECK_EQUAL( r2[i], r[i] );
+			BOOST_CHECK_EQUAL( g2[i], g[i] );
+			BOOST_CHECK_EQUAL( b2[i], b[i] );
+		}
+	}
+
+	void testDynamicChannels()
+	{
+		typedef CompoundLayout< BrothersLayout< float, Brothers_RGB >, DynamicLayout< float > > SrcLayout;
+		typedef CompoundLayout< BrothersLayout< float, Brothers_BGR >, ChannelLayout< float, Chan_Alpha > > DstLayout;
+
+		float rgb[6] = { 1., 2., 3., 4., 5., 6. };
+		float alpha[2] = { 7., 8. };
+		
+		PixelIterator< SrcLayout > it;
+		it->addChannels( Mask_Alpha );
+		it->setChannelPointer( Chan_Red, &rgb[0] );
+		it->setChannelPointer( Chan_Alpha, &alpha[0] );
+		
+		float bgr[6] = { 0. };
+		float dstAlpha[2] = { 0. };
+		PixelIterator< DstLayout > out;
+		out->setChannelPointer( Chan_Blue, &bgr[0] );
+		out->setChannelPointer( Chan_Alpha, &dstAlpha[0] );
+
+		convertPixels( ConstPixelIterator< SrcLayout >( it ), 2, out );
+		for( unsigned int i = 0; i < 2; ++i )
+		{
+			BOOST_CHECK_EQUAL( bgr[i*3], rgb[i*3+2] );
+			BOOST_CHECK_EQUAL( bgr[i*3+1], rgb[i*3+1] );
+			BOOST_CHECK_EQUAL( bgr[i*3+2], rgb[i*3] );
+			BOOST_CHECK_EQUAL( dstAlpha[i], alpha[i] );
+		}
+	}
+
+	void testMismatchedChannels()
+	{
+		typedef CompoundLayout< BrothersLayout< float, Brothers_RGB > > SrcLayout;
+		typedef CompoundLayout< BrothersLayout< float, Brothers_RGB >, ChannelLayout< float, Chan_Alpha > > DstLayout;
+
+		float rgb[6] = { 1., 2., 3., 4., 5., 6. };
+		PixelIterator< SrcLayout > it;
+		it->setChannelPointer( Chan_Red, &rgb[0] );
+		ConstPixelIterator< SrcLayout > src( it );
+
+		float dstRGB[6] = { 0. };
+		float dstAlpha[2] = { 0. };
+		PixelIterator< DstLayout > out;
+		out->setChannelPointer( Chan_Red, &dstRGB[0] );
+		out->setChannelPointer( Chan_Alpha, &dstAlpha[0] );
+
+		BOOST_CHECK_THROW( convertPixels( src, 2, out ), std::runtime_error );
+		BOOST_CHECK_EQUAL( dstRGB[0], 0. );
+
+		convertPixels( src, 2, out, true );
+		for( unsigned int i = 0; i < 6; ++i )
+		{
+			BOOST_CHECK_EQUAL( dstRGB[i], rgb[i] );
+		}
+		BOOST_CHECK_EQUAL( dstAlpha[0], 0. );
+	}
+
+	void testSubsampledLayout()
+	{
+		typedef CompoundLayout< ChannelLayout< float, Chan_Red >, SubsampledChannelLayout< float, Chan_U, 2 > > SrcLayout;
+		typedef CompoundLayout< ChannelLayout< float, Chan_Red >, ChannelLayout< float, Chan_U > > DstLayout;
+
+		float r[6] = { 1., 2., 3., 4., 5., 6. };
+		float u[3] = { 10., 20., 30. };
+		PixelIterator< SrcLayout > it;
+		it->setChannelPointer( Chan_Red, &r[0] );
+		it->setChannelPointer( Chan_U, &u[0] );
+
+		float dstR[6] = { 0. };
+		float dstU[6] = { 0. };
+		PixelIterator< DstLayout > out;
+		out->setChannelPointer( Chan_Red, &dstR[0] );
+		out->setChannelPointer( Chan_U, &dstU[0] );
+
+		// Neighbouring pixels share a sample of the subsampled channel.
+		convertPixels( ConstPixelIterator< SrcLayout >( it ), 6, out );
+		for( unsigned int i = 0; i < 6; ++i )
+		{
+			BOOST_CHECK_EQUAL( dstR[i], r[i] );
+			BOOST_CHECK_EQUAL( dstU[i], u[i/2] );
+		}
+
+		// Converting the type at the same time.
+		typedef CompoundLayout< ChannelLayout< int8u, Chan_Red >, SubsampledChannelLayout< int8u, Chan_U, 2 > > ByteLayout;
+		int8u byteR[6] = { 0, 51, 102, 153, 204, 255 };
+		int8u byteU[3] = { 51, 102, 255 };
+		PixelIterator< ByteLayout > bytes;
+		bytes->setChannelPointer( Chan_Red, &byteR[0] );
+		bytes->setChannelPointer( Chan_U, &byteU[0] );
+
+		convertPixels( ConstPixelIterator< ByteLayout >( bytes ), 6, out, false, SampleConversion( true ) );
+		for( unsigned int i = 0; i < 6; ++i )
+		{
+			BOOST_CHECK_SMALL( dstR[i] - byteR[i] / 255.f, 1e-6f );
+			BOOST_CHECK_SMALL( dstU[i] - byteU[i/2] / 255.f, 1e-6f );
+		}
+	}
+
+	void testSampleConversion()
+	{
+		typedef CompoundLayout< BrothersLayout< int8u, Brothers_RGB > > SrcLayout;
+		typedef CompoundLayout< ChannelLayout< float, Chan_Red >, ChannelLayout< float, Chan_Green >, ChannelLayout< float, Chan_Blue > > DstLayout;
+		typedef CompoundLayout< BrothersLayout< half, Brothers_BGR > > HalfLayout;
+
+		int8u rgb[6] = { 0, 51, 102, 153, 204, 255 };
+		PixelIterator< SrcLayout > it;
+		it->setChannelPointer( Chan_Red, &rgb[0] );
+		
+		float r[2] = { 0. }, g[2] = { 0. }, b[2] = { 0. };
+		PixelIterator< DstLayout > out;
+		out->setChannelPointer( Chan_Red, &r[0] );
+		out->setChannelPointer( Chan_Green, &g[0] );
+		out->setChannelPointer( Chan_Blue, &b[0] );
+
+		// By default the values are converted without being scaled.
+		convertPixels( ConstPixelIterator< SrcLayout >( it ), 2, out );
+		BOOST_CHECK_EQUAL( g[1], 204.f );
+
+		// Normalising maps the full range of the integers to [0, 1].
+		convertPixels( ConstPixelIterator< SrcLayout >( it ), 2, out, false, SampleConversion( true ) );
+		BOOST_CHECK_EQUAL( r[0], 0.f );
+		BOOST_CHECK_CLOSE( g[0], .2f, 1e-4 );
+		BOOST_CHECK_CLOSE( b[0], .4f, 1e-4 );
+		BOOST_CHECK_CLOSE( r[1], .6f, 1e-4 );
+		BOOST_CHECK_EQUAL( b[1], 1.f );
+		
+		// And back again, clamping and rounding.
+		r[0] = -1.f;
+		b[1] = 0.5f;
+		int8u result[6] = { 0 };
+		PixelIterator< SrcLayout > back;
+		back->setChannelPointer( Chan_Red, &result[0] );
+		convertPixels( ConstPixelIterator< DstLayout >( out ), 2, back, false, SampleConversion( true ) );
+		BOOST_CHECK_EQUAL( result[0], int8u( 0 ) );
+		BOOST_CHECK_EQUAL( result[1], rgb[1] );
+		BOOST_CHECK_EQUAL( result[4], rgb[4] );
+		BOOST_CHECK_EQUAL( result[5], int8u( 128 ) );
+
+		// Halfs are converted through their addresses too.
+		half bgr[6];
+		PixelIterator< HalfLayout > halfs;
+		halfs->setChannelPointer( Chan_Blue, &bgr[0] );
+		convertPixels( ConstPixelIterator< SrcLayout >( it ), 2, halfs, false, SampleConversion( true ) );
+		BOOST_CHECK_EQUAL( float( bgr[2] ), 0.f );
+		BOOST_CHECK_EQUAL( float( bgr[3] ), 1.f );
+		BOOST_CHECK_CLOSE( float( bgr[1] ), .2f, 0.1 );
+	}
+
+	void testConvertImage()
+	{
+		typedef CompoundLayout< BrothersLayout< float, Brothers_RGBA > > SrcLayout;
+		typedef CompoundLayout< ChannelLayout< float, Chan_Red >, ChannelLayout< float, Chan_Green >, ChannelLayout< float, Chan_Blue >, ChannelLayout< float, Chan_Alpha > > DstLayout;
+
+		// The source rows are padded to a stride of 40 pixels.
+		const unsigned int width = 37, height = 23, srcStride = 40;
+		std::vector< float > src( srcStride * height * 4 );
+		for( unsigned int i = 0; i < src.size(); ++i )
+		{
+			src[i] = float( i );
+		}
+		
+		PixelIterator< SrcLayout > it;
+		it->setChannelPointer( Chan_Red, &src[0] );
+
+		for( unsigned int threads = 1; threads <= 4; ++threads )
+		{
+			std::vector< float > r( width * height, -1. ), g( width * height, -1. ), b( width * height, -1. ), a( width * height, -1. );
+			PixelIterator< DstLayout > out;
+			out->setChannelPointer( Chan_Red, &r[0] );
+			out->setChannelPointer( Chan_Green, &g[0] );
+			out->setChannelPointer( Chan_Blue, &b[0] );
+			out->setChannelPointer( Chan_Alpha, &a[0] );
+			
+			convertImage( ConstPixelIterator< SrcLayout >( it ), srcStride, out, width, width, height, threads );
+
+			bool equal = true;
+			for( unsigned int y = 0; y < height; ++y )
+			{
+				for( unsigned int x = 0; x < width; ++x )
+				{
+					const unsigned int s = ( y * srcStride + x ) * 4, d = y * width + x;
+					equal &= r[d] == src[s] && g[d] == src[s+1] && b[d] == src[s+2] && a[d] == src[s+3];
+				}
+			}
+			BOOST_CHECK( equal );
+		}
+	}
+};
+
+struct ConvertLayoutTestSuite : public boost::unit_test::test_suite
+{
+	ConvertLayoutTestSuite() : boost::unit_test::test_suite( "ConvertLayoutTestSuite" )
+	{
+		boost::shared_ptr<ConvertLayoutTest> instance( new ConvertLayoutTest() );
+		add( BOOST_CLASS_TEST_CASE( &ConvertLayoutTest::testKernelSelection, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &ConvertLayoutTest::testCopy, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &ConvertLayoutTest::testSwizzle, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &ConvertLayoutTest::testPlanarToInterleaved, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &ConvertLayoutTest::testDynamicChannels, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &ConvertLayoutTest::testMismatchedChannels, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &ConvertLayoutTest::testSubsampledLayout, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &ConvertLayoutTest::testSampleConversion, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &ConvertLayoutTest::testConvertImage, instance ) );
+	}
+};
+
+void addConvertLayoutTest( boost::unit_test::test_suite *test )
+{
+	test->add( new ConvertLayoutTestSuite() );
+}
+
+} // namespace ImageTest
+
+} // namespace Gander
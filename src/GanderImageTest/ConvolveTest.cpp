@@ -0,0 +1,206 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <numeric>
+
+#include "GanderImage/Convolve.h"
+#include "GanderImage/Op.h"
+#include "GanderImageTest/ConvolveTest.h"
+#include "GanderImageTest/SourceOp.h"
+
+#include "boost/test/floating_point_comparison.hpp"
+#include "boost/test/test_tools.hpp"
+
+using namespace Gander;
+using namespace Gander::Image;
+using namespace Gander::ImageTest;
+using namespace boost;
+using namespace boost::unit_test;
+
+namespace Gander
+{
+
+namespace ImageTest
+{
+
+inline float noiseValue( Channel c, int32 x, int32 y, int frame )
+{
+	const int32u h = ( int32u( x ) * 73856093u ) ^ ( int32u( y ) * 19349663u ) ^ ( int32u( c ) * 83492791u );
+	return float( h % 1000 ) / 100.f;
+}
+
+/// A source op whose samples are an irregular function of their position and channel.
+typedef SourceOp< noiseValue > NoiseOp;
+
+struct ConvolveTest
+{
+	void testKernels()
+	{
+		const std::vector< float > gaussian( Convolve::gaussianKernel( 1.5f ) );
+		BOOST_CHECK_EQUAL( gaussian.size(), size_t( 11 ) );
+		BOOST_CHECK_CLOSE( std::accumulate( gaussian.begin(), gaussian.end(), 0.f ), 1.f, 1e-4 );
+		BOOST_CHECK_EQUAL( gaussian[2], gaussian[8] );
+		BOOST_CHECK( gaussian[5] > gaussian[4] && gaussian[4] > gaussian[3] );
+		BOOST_CHECK_EQUAL( Convolve::gaussianKernel( 0.f ).size(), size_t( 1 ) );
+
+		const std::vector< float > box( Convolve::boxKernel( 2 ) );
+		BOOST_CHECK_EQUAL( box.size(), size_t( 5 ) );
+		BOOST_CHECK_EQUAL( box[0], .2f );
+		BOOST_CHECK_EQUAL( box[4], .2f );
+		
+		BOOST_CHECK_THROW( Convolve( std::vector< float >( 2, 1.f ), std::vector< float >( 1, 1.f ) ), std::runtime_error );
+		BOOST_CHECK_THROW( Convolve::boxKernel( -1 ), std::runtime_error );
+
+		// Changing the kernels changes the hash.
+		Convolve convolve;
+		Hash h1;
+		convolve.hash( h1 );
+		convolve.setKernels( box, gaussian );
+		Hash h2;
+		convolve.hash( h2 );
+		BOOST_CHECK( h1 != h2 );
+		BOOST_CHECK_EQUAL( convolve.minimumBlockHeight(), 160 );
+	}
+
+	/// Evaluates a convolution of the noise and compares it with a direct two dimensional convolution.
+	void checkConvolve( const std::vector< float > &horizontal, const std::vector< float > &vertical, unsigned int numberOfThreads, const Box &box = Box( -13, -7, 90, 71 ) )
+	{
+		boost::shared_ptr< NoiseOp > noise( new NoiseOp );
+		Convolve convolve( horizontal, vertical );
+		convolve.setInput( 0, noise );
+
+		Tile output( box, ChannelSet( Mask_RGB ) );
+		evaluate( convolve, output, numberOfThreads );
+
+		const int32 rx = int32( horizontal.size() / 2 ), ry = int32( vertical.size() / 2 );
+		const ChannelSet channels( Mask_RGB );
+		bool close = true;
+		for( ChannelSet::const_iterator c( channels.begin() ); c != channels.end(); ++c )
+		{
+			for( int32 y = box.y(); y < box.t(); ++y )
+			{
+				for( int32 x = box.x(); x < box.r(); ++x )
+				{
+					double expected = 0.;
+					for( int32 j = -ry; j <= ry; ++j )
+					{
+						for( int32 i = -rx; i <= rx; ++i )
+						{
+							expected += double( vertical[ j + ry ] ) * horizontal[ i + rx ] * NoiseOp::value( *c, x + i, y + j );
+						}
+					}
+
+					close &= std::fabs( output.sample( *c, x, y ) - expected ) <= 1e-4 * ( 1. + std::fabs( expected ) );
+				}
+			}
+		}
+		BOOST_CHECK( close );
+	}
+
+	void testConvolve()
+	{
+		std::vector< float > asymmetric( 3 );
+		asymmetric[0] = 1.f;
+		asymmetric[1] = 2.f;
+		asymmetric[2] = -.5f;
+
+		std::vector< float > identity( 1, 1.f );
+		
+		for( unsigned int threads = 1; threads <= 8; threads += 7 )
+		{
+			checkConvolve( asymmetric, Convolve::gaussianKernel( 1.2f ), threads );
+			checkConvolve( Convolve::gaussianKernel( 2.f ), asymmetric, threads );
+			checkConvolve( identity, identity, threads );
+			checkConvolve( Convolve::boxKernel( 3 ), Convolve::boxKernel( 2 ), threads );
+			checkConvolve( Convolve::boxKernel( 4 ), asymmetric, threads );
+			checkConvolve( asymmetric, Convolve::boxKernel( 5 ), threads );
+			checkConvolve( identity, Convolve::boxKernel( 1 ), threads );
+			
+			// A tile taller than the minimum block height of the kernel, which is split into several blocks
+			// however many threads there are.
+			checkConvolve( asymmetric, Convolve::boxKernel( 5 ), threads, Box( -5, -150, 40, 170 ) );
+		}
+	}
+
+	void testBoxMatchesKernel()
+	{
+		// A box is computed with running sums, but gives the same result as any other kernel.
+		boost::shared_ptr< NoiseOp > noise( new NoiseOp );
+		
+		const std::vector< float > box( Convolve::boxKernel( 3 ) );
+		Convolve running( box, box );
+		running.setInput( 0, noise );
+		
+		std::vector< float > perturbed( box );
+		perturbed[0] += 1e-7f;
+		Convolve direct( perturbed, perturbed );
+		direct.setInput( 0, noise );
+
+		const Box region( 0, 0, 257, 300 );
+		Tile a( region, ChannelSet( Mask_Red ) ), b( region, ChannelSet( Mask_Red ) );
+		evaluate( running, a, 4 );
+		evaluate( direct, b, 4 );
+		
+		bool close = true;
+		for( int32 y = region.y(); y < region.t(); ++y )
+		{
+			for( int32 x = region.x(); x < region.r(); ++x )
+			{
+				close &= std::fabs( a.sample( Chan_Red, x, y ) - b.sample( Chan_Red, x, y ) ) < 1e-4f;
+			}
+		}
+		BOOST_CHECK( close );
+	}
+};
+
+struct ConvolveTestSuite : public boost::unit_test::test_suite
+{
+	ConvolveTestSuite() : boost::unit_test::test_suite( "ConvolveTestSuite" )
+	{
+		boost::shared_ptr<ConvolveTest> instance( new ConvolveTest() );
+		add( BOOST_CLASS_TEST_CASE( &ConvolveTest::testKernels, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &ConvolveTest::testConvolve, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &ConvolveTest::testBoxMatchesKernel, instance ) );
+	}
+};
+
+void addConvolveTest( boost::unit_test::test_suite *test )
+{
+	test->add( new ConvolveTestSuite() );
+}
+
+} // namespace ImageTest
+
+} // namespace Gander
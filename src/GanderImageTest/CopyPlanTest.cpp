@@ -0,0 +1,199 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#include <iostream>
+#include <cstdlib>
+
+#include "GanderImage/CopyPlan.h"
+#include "GanderImage/BrothersLayout.h"
+#include "GanderImage/ChannelLayout.h"
+#include "GanderImage/CompoundLayout.h"
+#include "GanderImage/DynamicLayout.h"
+#include "GanderImage/PixelIterator.h"
+#include "GanderImageTest/CopyPlanTest.h"
+
+#include "boost/test/floating_point_comparison.hpp"
+#include "boost/test/test_tools.hpp"
+
+using namespace Gander;
+using namespace Gander::Image;
+using namespace Gander::ImageTest;
+using namespace boost;
+using namespace boost::unit_test;
+
+namespace Gander
+{
+
+namespace ImageTest
+{
+
+struct CopyPlanTest
+{
+	void testStaticCopy()
+	{
+		typedef CompoundLayout< BrothersLayout< float, Brothers_RGB >, ChannelLayout< float, Chan_Alpha > > SrcLayout;
+		typedef CompoundLayout< BrothersLayout< double, Brothers_BGRA > > DstLayout;
+		
+		float rgb[9] = { 1., 2., 3., 4., 5., 6., 7., 8., 9. };
+		float alpha[3] = { 10., 11., 12. };
+		double bgra[12] = { 0. };
+
+		PixelIterator< SrcLayout > it;
+		it->setChannelPointer( Chan_Red, &rgb[0] );
+		it->setChannelPointer( Chan_Alpha, &alpha[0] );
+		ConstPixelIterator< SrcLayout > src( it );
+		
+		PixelIterator< DstLayout > dst;
+		dst->setChannelPointer( Chan_Blue, &bgra[0] );
+
+		// Copy the pixels, converting them from float to double.
+		PixelIterator< DstLayout > end( copyPixels( src, src + 3, dst ) );
+		BOOST_CHECK( end == dst + 3 );
+
+		for( unsigned int i = 0; i < 3; ++i )
+		{
+			BOOST_CHECK_EQUAL( bgra[i*4], rgb[i*3+2] );
+			BOOST_CHECK_EQUAL( bgra[i*4+1], rgb[i*3+1] );
+			BOOST_CHECK_EQUAL( bgra[i*4+2], rgb[i*3] );
+			BOOST_CHECK_EQUAL( bgra[i*4+3], alpha[i] );
+		}
+		
+		// A plan can also copy between pixels and accessors.
+		CopyPlan< Pixel< SrcLayout >, PixelAccessor< DstLayout > > plan( Pixel< SrcLayout >(), *dst );
+		BOOST_CHECK_EQUAL( plan.channels(), ChannelSet( Mask_RGBA ) );
+
+		Pixel< SrcLayout > pixel;
+		plan( pixel, *( dst + 1 ) );
+		BOOST_CHECK_EQUAL( pixel.channel< Chan_Red >(), 4. );
+		BOOST_CHECK_EQUAL( pixel.channel< Chan_Alpha >(), 11. );
+		BOOST_CHECK( pixel == *( dst + 1 ) );
+	}
+
+	void testDynamicCopy()
+	{
+		typedef CompoundLayout< BrothersLayout< float, Brothers_RGB >, DynamicLayout< float > > SrcLayout;
+		typedef CompoundLayout< BrothersLayout< float, Brothers_RGB >, ChannelLayout< float, Chan_Z >, DynamicLayout< float > > DstLayout;
+
+		float rgb[6] = { 1., 2., 3., 4., 5., 6. };
+		float alpha[2] = { 7., 8. };
+		float z[2] = { 9., 10. };
+		
+		PixelIterator< SrcLayout > it;
+		it->addChannels( Mask_Z | Mask_Alpha );
+		it->setChannelPointer( Chan_Red, &rgb[0] );
+		it->setChannelPointer( Chan_Alpha, &alpha[0] );
+		it->setChannelPointer( Chan_Z, &z[0] );
+		ConstPixelIterator< SrcLayout > src( it );
+		
+		float dstRGB[6] = { 0. };
+		float dstAlpha[2] = { 0. };
+		float dstZ[2] = { 0. };
+
+		PixelIterator< DstLayout > dst;
+		dst->addChannels( Mask_Alpha );
+		dst->setChannelPointer( Chan_Red, &dstRGB[0] );
+		dst->setChannelPointer( Chan_Alpha, &dstAlpha[0] );
+		dst->setChannelPointer( Chan_Z, &dstZ[0] );
+		
+		// Z is static in the destination but dynamic in the source so it is looked up along with alpha when the plan is made.
+		BOOST_CHECK_EQUAL( int( CopyPlan< PixelAccessor< DstLayout >, PixelAccessor< SrcLayout > >::StaticMask ), int( Mask_RGB ) );
+
+		copyPixels( src, src + 2, dst );
+		for( unsigned int i = 0; i < 6; ++i )
+		{
+			BOOST_CHECK_EQUAL( dstRGB[i], rgb[i] );
+		}
+		BOOST_CHECK_EQUAL( dstAlpha[0], 7. );
+		BOOST_CHECK_EQUAL( dstAlpha[1], 8. );
+		BOOST_CHECK_EQUAL( dstZ[0], 9. );
+		BOOST_CHECK_EQUAL( dstZ[1], 10. );
+	}
+
+	void testMismatchedChannels()
+	{
+		typedef CompoundLayout< BrothersLayout< float, Brothers_RGB >, DynamicLayout< float > > Layout;
+
+		float rgb[6] = { 1., 2., 3., 4., 5., 6. };
+		float z[2] = { 7., 8. };
+		
+		PixelIterator< Layout > it;
+		it->addChannels( Mask_Z );
+		it->setChannelPointer( Chan_Red, &rgb[0] );
+		it->setChannelPointer( Chan_Z, &z[0] );
+		ConstPixelIterator< Layout > src( it );
+		
+		float dstRGB[6] = { 0. };
+		PixelIterator< Layout > dst;
+		dst->setChannelPointer( Chan_Red, &dstRGB[0] );
+
+		// The channels are checked once, when the plan is made.
+		typedef CopyPlan< PixelAccessor< Layout >, PixelAccessor< Layout > > Plan;
+		BOOST_CHECK_THROW( Plan( *dst, *src ), std::runtime_error );
+		BOOST_CHECK_THROW( copyPixels( src, src + 2, dst ), std::runtime_error );
+		BOOST_CHECK_EQUAL( dstRGB[0], 0. );
+
+		// Unless we ask for only the shared channels to be copied.
+		Plan plan( *dst, *src, true );
+		BOOST_CHECK_EQUAL( plan.channels(), ChannelSet( Mask_RGB ) );
+		
+		copyPixels( src, src + 2, dst, true );
+		for( unsigned int i = 0; i < 6; ++i )
+		{
+			BOOST_CHECK_EQUAL( dstRGB[i], rgb[i] );
+		}
+
+		// An empty range copies nothing and doesn't check the channels.
+		BOOST_CHECK( copyPixels( src, src, dst ) == dst );
+	}
+};
+
+struct CopyPlanTestSuite : public boost::unit_test::test_suite
+{
+	CopyPlanTestSuite() : boost::unit_test::test_suite( "CopyPlanTestSuite" )
+	{
+		boost::shared_ptr<CopyPlanTest> instance( new CopyPlanTest() );
+		add( BOOST_CLASS_TEST_CASE( &CopyPlanTest::testStaticCopy, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &CopyPlanTest::testDynamicCopy, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &CopyPlanTest::testMismatchedChannels, instance ) );
+	}
+};
+
+void addCopyPlanTest( boost::unit_test::test_suite *test )
+{
+	test->add( new CopyPlanTestSuite() );
+}
+
+} // namespace ImageTest
+
+} // namespace Gander
+
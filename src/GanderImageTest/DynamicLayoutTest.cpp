@@ -215,6 +215,44 @@ struct DynamicLayoutTest
 		BOOST_CHECK_THROW( l.addChannels( Chan_Red, Brothers_UV ), std::runtime_error );
 	}
 
+	void testSharedDescriptors()
+	{
+		typedef DynamicLayout< float > Layout;
+		
+		// A layout only holds a pointer to its interned descriptor.
+		BOOST_CHECK_EQUAL( sizeof( Layout ), sizeof( void * ) );
+
+		Layout l1, l2, l3;
+		BOOST_CHECK( l1.descriptor() == l2.descriptor() );
+		
+		l1.addChannels( Mask_RGB, Brothers_RGB );
+		l1.addChannels( Mask_Z );
+		BOOST_CHECK( l1.descriptor() != l2.descriptor() );
+
+		// Layouts with the same channels share a descriptor, whatever order the channels were added in.
+		l2.addChannels( Mask_Z );
+		l2.addChannels( Mask_RGB, Brothers_RGB );
+		BOOST_CHECK( l1.descriptor() == l2.descriptor() );
+		
+		// Layouts with the same channels but different brothers don't.
+		l3.addChannels( Mask_RGB );
+		l3.addChannels( Mask_Z );
+		BOOST_CHECK( l1.descriptor() != l3.descriptor() );
+		BOOST_CHECK_EQUAL( l1.channels(), l3.channels() );
+
+		Layout l4( l1 );
+		BOOST_CHECK( l4.descriptor() == l1.descriptor() );
+		
+		// Adding channels to a copy doesn't change the original.
+		l4.addChannels( Mask_Alpha );
+		BOOST_CHECK_EQUAL( l1.channels(), ChannelSet( Mask_RGB | Mask_Z ) );
+		BOOST_CHECK_EQUAL( l4.channels(), ChannelSet( Mask_RGBA | Mask_Z ) );
+		
+		// The failed addition of a channel leaves the layout unchanged.
+		BOOST_CHECK_THROW( l4.addChannels( Mask_Z ), std::runtime_error );
+		BOOST_CHECK_EQUAL( l4.channels(), ChannelSet( Mask_RGBA | Mask_Z ) );
+	}
+
 };
 
 struct DynamicLayoutTestSuite : public boost::unit_test::test_suite
@@ -229,6 +267,7 @@ struct DynamicLayoutTestSuite : public boost::unit_test::test_suite
 		add( BOOST_CLASS_TEST_CASE( &DynamicLayoutTest::testAddChannelWhichIsNotABrother, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &DynamicLayoutTest::testMaskedChannelIndex, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &DynamicLayoutTest::testContainerAccess, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &DynamicLayoutTest::testSharedDescriptors, instance ) );
 	}
 };
 
@@ -0,0 +1,248 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <set>
+#include <vector>
+#include <stdexcept>
+
+#include "boost/thread.hpp"
+
+#include "GanderImage/FramePipeline.h"
+#include "GanderImageTest/FramePipelineTest.h"
+
+#include "boost/test/test_tools.hpp"
+
+using namespace Gander;
+using namespace Gander::Image;
+using namespace Gander::ImageTest;
+using namespace boost;
+using namespace boost::unit_test;
+
+namespace Gander
+{
+
+namespace ImageTest
+{
+
+static void sleepMilliseconds( int milliseconds )
+{
+	if( milliseconds > 0 )
+	{
+		boost::this_thread::sleep( boost::posix_time::milliseconds( milliseconds ) );
+	}
+}
+
+/// Reads frames whose samples are a function of the frame number and records the tiles that it is given.
+class RampReader : public FrameReader
+{
+	public :
+
+		RampReader( int delay = 0 ) : m_delay( delay ) {}
+		
+		static float value( int32 frame, int32 x, int32 y )
+		{
+			return float( frame * 100 + y * 10 + x );
+		}
+
+		virtual void read( int32 frame, Tile &tile )
+		{
+			sleepMilliseconds( m_delay );
+			tile.reset( Box( 0, 0, 8, 4 ), ChannelSet( Mask_Red ) );
+			for( int32 y = 0; y < 4; ++y )
+			{
+				float *row( tile.row( Chan_Red, y ) );
+				for( int32 x = 0; x < 8; ++x )
+				{
+					row[x] = value( frame, x, y );
+				}
+			}
+			m_tiles.insert( &tile );
+		}
+
+		int m_delay;
+		std::set< const Tile * > m_tiles;
+};
+
+/// Doubles the samples of a frame, throwing when it is given a particular frame.
+class DoubleProcessor : public FrameProcessor
+{
+	public :
+
+		DoubleProcessor( int delay = 0, int32 throwAt = -1 ) : m_delay( delay ), m_throwAt( throwAt ) {}
+		
+		virtual void process( int32 frame, const Tile &input, Tile &output )
+		{
+			sleepMilliseconds( m_delay );
+			if( frame == m_throwAt )
+			{
+				throw std::runtime_error( "DoubleProcessor: Failed." );
+			}
+			
+			output.reset( input.box(), input.channels() );
+			for( int32 y = input.box().y(); y < input.box().t(); ++y )
+			{
+				const float *src( input.row( Chan_Red, y ) );
+				float *dst( output.row( Chan_Red, y ) );
+				for( int32 x = 0; x < input.box().width(); ++x )
+				{
+					dst[x] = src[x] * 2.f;
+				}
+			}
+		}
+
+		int m_delay;
+		int32 m_throwAt;
+};
+
+/// Records the frames that are written and checks their samples.
+class CheckingWriter : public FrameWriter
+{
+	public :
+
+		CheckingWriter( int delay = 0 ) : m_delay( delay ), m_correct( true ) {}
+		
+		virtual void write( int32 frame, const Tile &tile )
+		{
+			sleepMilliseconds( m_delay );
+			m_frames.push_back( frame );
+			m_correct &= tile.sample( Chan_Red, 3, 2 ) == RampReader::value( frame, 3, 2 ) * 2.f;
+			m_correct &= tile.sample( Chan_Red, 7, 0 ) == RampReader::value( frame, 7, 0 ) * 2.f;
+		}
+
+		int m_delay;
+		bool m_correct;
+		std::vector< int32 > m_frames;
+};
+
+struct FramePipelineTest
+{
+	void testPipeline()
+	{
+		RampReader reader;
+		DoubleProcessor processor;
+		CheckingWriter writer;
+		FramePipeline pipeline( reader, processor, writer, 2 );
+		pipeline.run( 10, 49 );
+
+		// Every frame is written, in order.
+		BOOST_CHECK( writer.m_correct );
+		BOOST_CHECK_EQUAL( writer.m_frames.size(), 40u );
+		for( unsigned int i = 0; i < writer.m_frames.size(); ++i )
+		{
+			BOOST_CHECK_EQUAL( writer.m_frames[i], int32( i + 10 ) );
+		}
+
+		// The tiles are recycled from a pool of a fixed size.
+		BOOST_CHECK( reader.m_tiles.size() <= 4u );
+
+		for( int i = 0; i < FramePipeline::NumberOfStages; ++i )
+		{
+			const FramePipeline::StageStatistics &statistics( pipeline.statistics( FramePipeline::Stage( i ) ) );
+			BOOST_CHECK_EQUAL( statistics.frames, 40u );
+			BOOST_CHECK( statistics.utilisation() >= 0. && statistics.utilisation() <= 1. );
+		}
+
+		// The pipeline can be run again.
+		writer.m_frames.clear();
+		pipeline.run( 0, 0 );
+		BOOST_CHECK_EQUAL( writer.m_frames.size(), 1u );
+		BOOST_CHECK( reader.m_tiles.size() <= 4u );
+	}
+
+	void testOverlap()
+	{
+		// Each stage takes the same time, so running them concurrently should take well under the sum of their times.
+		RampReader reader( 5 );
+		DoubleProcessor processor( 5 );
+		CheckingWriter writer( 5 );
+		FramePipeline pipeline( reader, processor, writer, 2 );
+		pipeline.run( 0, 9 );
+		BOOST_CHECK( writer.m_correct );
+
+		double busySeconds = 0.;
+		for( int i = 0; i < FramePipeline::NumberOfStages; ++i )
+		{
+			busySeconds += pipeline.statistics( FramePipeline::Stage( i ) ).busySeconds;
+		}
+		BOOST_CHECK( pipeline.statistics( FramePipeline::ReadStage ).totalSeconds < busySeconds * 0.8 );
+	}
+
+	void testBottleneck()
+	{
+		RampReader reader;
+		DoubleProcessor processor;
+		CheckingWriter writer( 5 );
+		FramePipeline pipeline( reader, processor, writer, 2 );
+		pipeline.run( 0, 9 );
+		BOOST_CHECK_EQUAL( pipeline.bottleneck(), FramePipeline::WriteStage );
+		BOOST_CHECK( pipeline.statistics( FramePipeline::WriteStage ).utilisation() > pipeline.statistics( FramePipeline::ReadStage ).utilisation() );
+	}
+
+	void testErrors()
+	{
+		RampReader reader;
+		DoubleProcessor processor( 0, 5 );
+		CheckingWriter writer;
+		FramePipeline pipeline( reader, processor, writer, 2 );
+		BOOST_CHECK_THROW( pipeline.run( 0, 99 ), std::runtime_error );
+		BOOST_CHECK( writer.m_frames.size() <= 5u );
+		
+		// A failed run doesn't stop the pipeline from being used again.
+		writer.m_frames.clear();
+		pipeline.run( 6, 9 );
+		BOOST_CHECK_EQUAL( writer.m_frames.size(), 4u );
+		BOOST_CHECK( writer.m_correct );
+	}
+};
+
+struct FramePipelineTestSuite : public boost::unit_test::test_suite
+{
+	FramePipelineTestSuite() : boost::unit_test::test_suite( "FramePipelineTestSuite" )
+	{
+		boost::shared_ptr<FramePipelineTest> instance( new FramePipelineTest() );
+		add( BOOST_CLASS_TEST_CASE( &FramePipelineTest::testPipeline, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &FramePipelineTest::testOverlap, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &FramePipelineTest::testBottleneck, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &FramePipelineTest::testErrors, instance ) );
+	}
+};
+
+void addFramePipelineTest( boost::unit_test::test_suite *test )
+{
+	test->add( new FramePipelineTestSuite() );
+}
+
+} // namespace ImageTest
+
+} // namespace Gander
@@ -46,13 +46,24 @@
 #include "GanderImageTest/ChannelBrothersTest.h"
 #include "GanderImageTest/PPMTest.h"
 #include "GanderImageTest/OpTest.h"
+#include "GanderImageTest/PointOpTest.h"
+#include "GanderImageTest/TileCacheTest.h"
+#include "GanderImageTest/FramePipelineTest.h"
+#include "GanderImageTest/PlaneAllocatorTest.h"
+#include "GanderImageTest/ConvertLayoutTest.h"
+#include "GanderImageTest/StencilTest.h"
+#include "GanderImageTest/ConvolveTest.h"
 #include "GanderImageTest/CompoundLayoutTest.h"
 #include "GanderImageTest/CompoundLayoutContainerTest.h"
 #include "GanderImageTest/ChannelLayoutTest.h"
+#include "GanderImageTest/SubsampledChannelLayoutTest.h"
+#include "GanderImageTest/ConstantChannelLayoutTest.h"
 #include "GanderImageTest/BrothersLayoutTest.h"
 #include "GanderImageTest/DynamicLayoutTest.h"
 #include "GanderImageTest/PixelTest.h"
 #include "GanderImageTest/PixelIteratorTest.h"
+#include "GanderImageTest/ChannelViewTest.h"
+#include "GanderImageTest/CopyPlanTest.h"
 #include "GanderImageTest/RowTest.h"
 #include "GanderImageTest/ImageTest.h"
 
@@ -72,13 +83,24 @@ test_suite* init_unit_test_suite( int argc, char* argv[] )
 		addChannelTest(test);
 		addChannelBrothersTest(test);
 		addChannelLayoutTest(test);
+		addSubsampledChannelLayoutTest(test);
+		addConstantChannelLayoutTest(test);
 		addBrothersLayoutTest(test);
 		addDynamicLayoutTest(test);
 		addCompoundLayoutTest(test);
 		addCompoundLayoutContainerTest(test);
 		addOpTest(test);
+		addPointOpTest(test);
+		addTileCacheTest(test);
+		addFramePipelineTest(test);
+		addPlaneAllocatorTest(test);
+		addConvertLayoutTest(test);
+		addStencilTest(test);
+		addConvolveTest(test);
 		addPixelTest(test);
 		addPixelIteratorTest(test);
+		addChannelViewTest(test);
+		addCopyPlanTest(test);
 		addRowTest(test);
 		addImageTest(test);
 	}
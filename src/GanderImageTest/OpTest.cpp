@@ -33,9 +33,13 @@
 //////////////////////////////////////////////////////////////////////////
 #include <iostream>
 #include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
 
 #include "GanderImage/Op.h"
+#include "GanderImage/Crop.h"
 #include "GanderImageTest/OpTest.h"
+#include "GanderImageTest/SourceOp.h"
 
 #include "boost/test/floating_point_comparison.hpp"
 #include "boost/test/test_tools.hpp"
@@ -52,12 +56,367 @@ namespace Gander
 namespace ImageTest
 {
 
+inline float rampValue( Channel c, int32 x, int32 y, int frame )
+{
+	return float( c * 10000 + y * 100 + x );
+}
+
+/// A source op whose samples are a function of their position and channel.
+typedef SourceOp< rampValue > RampOp;
+
+/// Averages each sample with its neighbours to the left and right.
+class HorizontalBlurOp : public Op
+{
+	public :
+
+		HorizontalBlurOp( int32 radius ) : Op( 1 ), m_radius( radius ) {}
+
+		virtual Box inputRegion( unsigned int index, const Box &region ) const
+		{
+			return region.padded( m_radius, 0 );
+		}
+
+		virtual void computeRows( int32 y, int32 t, const std::vector< const Tile * > &inputs, Tile &output ) const
+		{
+			const Box &box( output.box() );
+			const ChannelSet channels( output.channels() );
+			for( ChannelSet::const_iterator c( channels.begin() ); c != channels.end(); ++c )
+			{
+				for( int32 row = y; row < t; ++row )
+				{
+					float *dst( output.row( *c, row ) );
+					for( int32 x = box.x(); x < box.r(); ++x )
+					{
+						float sum = 0.f;
+						for( int32 i = -m_radius; i <= m_radius; ++i )
+						{
+							sum += inputs[0]->sample( *c, x + i, row );
+						}
+						*dst++ = sum / float( 2 * m_radius + 1 );
+					}
+				}
+			}
+		}
+
+	private :
+
+		int32 m_radius;
+};
+
+/// Adds its two inputs. The second input is offset by a number of pixels to the right.
+class AddOp : public Op
+{
+	public :
+
+		AddOp( int32 offset ) : Op( 2 ), m_offset( offset ) {}
+		
+		virtual Box inputRegion( unsigned int index, const Box &region ) const
+		{
+			return index == 0 ? region : Box( region.x() + m_offset, region.y(), region.r() + m_offset, region.t() );
+		}
+
+		virtual void computeRows( int32 y, int32 t, const std::vector< const Tile * > &inputs, Tile &output ) const
+		{
+			const Box &box( output.box() );
+			const ChannelSet channels( output.channels() );
+			for( ChannelSet::const_iterator c( channels.begin() ); c != channels.end(); ++c )
+			{
+				for( int32 row = y; row < t; ++row )
+				{
+					float *dst( output.row( *c, row ) );
+					for( int32 x = box.x(); x < box.r(); ++x )
+					{
+						*dst++ = inputs[0]->sample( *c, x, row ) + inputs[1]->sample( *c, x + m_offset, row );
+					}
+				}
+			}
+		}
+
+	private :
+
+		int32 m_offset;
+};
+
+/// Copies the red channel of its input to every channel of its output.
+class RedToAllOp : public Op
+{
+	public :
+
+		RedToAllOp() : Op( 1 ) {}
+		
+		virtual ChannelSet inputChannels( unsigned int index, ChannelSet channels ) const
+		{
+			return ChannelSet( Mask_Red );
+		}
+
+		virtual void computeRows( int32 y, int32 t, const std::vector< const Tile * > &inputs, Tile &output ) const
+		{
+			const ChannelSet channels( output.channels() );
+			for( ChannelSet::const_iterator c( channels.begin() ); c != channels.end(); ++c )
+			{
+				for( int32 row = y; row < t; ++row )
+				{
+					const float *src( inputs[0]->row( Chan_Red, row ) + ( output.box().x() - inputs[0]->box().x() ) );
+					std::copy( src, src + output.box().width(), output.row( *c, row ) );
+				}
+			}
+		}
+};
+
+/// Writes a mask into the alpha channel, passing the other channels through from its input.
+/// It records the channels that it was asked to compute.
+class MaskOp : public Op
+{
+	public :
+
+		MaskOp() : Op( 1 ) {}
+
+		virtual ChannelSet inputChannels( unsigned int index, ChannelSet channels ) const
+		{
+			return ChannelSet();
+		}
+		
+		virtual ChannelSet affectedChannels( ChannelSet channels ) const
+		{
+			channels &= Mask_Alpha;
+			return channels;
+		}
+
+		virtual void computeRows( int32 y, int32 t, const std::vector< const Tile * > &inputs, Tile &output ) const
+		{
+			m_computedChannels = output.channels();
+			for( int32 row = y; row < t; ++row )
+			{
+				float *dst( output.row( Chan_Alpha, row ) );
+				for( int32 x = output.box().x(); x < output.box().r(); ++x )
+				{
+					*dst++ = x < 4 ? 1.f : 0.f;
+				}
+			}
+		}
+
+		mutable ChannelSet m_computedChannels;
+};
+
+/// An op that fails when it is computed.
+class ThrowingOp : public Op
+{
+	public :
+
+		ThrowingOp() : Op( 1 ) {}
+		
+		virtual void computeRows( int32 y, int32 t, const std::vector< const Tile * > &inputs, Tile &output ) const
+		{
+			throw std::runtime_error( "ThrowingOp" );
+		}
+};
+
 struct OpTest
 {
 	void testOpPreprocess()
 	{
 //		BOOST_CHECK(0);
 	}
+
+	void testBox()
+	{
+		Box a( 0, 0, 10, 5 );
+		Box b( 5, 2, 20, 10 );
+		BOOST_CHECK_EQUAL( a.width(), 10 );
+		BOOST_CHECK_EQUAL( a.height(), 5 );
+		BOOST_CHECK( Box().isEmpty() );
+		BOOST_CHECK( Box( 5, 5, 5, 10 ).isEmpty() );
+		BOOST_CHECK( Box( 5, 5, 5, 10 ) == Box() );
+		
+		BOOST_CHECK_EQUAL( a.intersection( b ), Box( 5, 2, 10, 5 ) );
+		BOOST_CHECK( a.intersection( Box( 10, 0, 20, 5 ) ).isEmpty() );
+		BOOST_CHECK_EQUAL( a.merge( b ), Box( 0, 0, 20, 10 ) );
+		BOOST_CHECK_EQUAL( a.merge( Box() ), a );
+		BOOST_CHECK_EQUAL( Box().merge( a ), a );
+		BOOST_CHECK_EQUAL( a.padded( 2, 1 ), Box( -2, -1, 12, 6 ) );
+
+		BOOST_CHECK( a.contains( 9, 4 ) );
+		BOOST_CHECK( !a.contains( 10, 4 ) );
+		BOOST_CHECK( a.merge( b ).contains( b ) );
+		BOOST_CHECK( !a.contains( b ) );
+	}
+
+	void testTile()
+	{
+		Tile tile( Box( 2, 3, 6, 5 ), ChannelSet( Mask_Red | Mask_Alpha ) );
+		BOOST_CHECK_EQUAL( tile.row( Chan_Red, 3 )[0], 0.f );
+		
+		tile.row( Chan_Alpha, 4 )[3] = 1.f;
+		BOOST_CHECK_EQUAL( tile.sample( Chan_Alpha, 5, 4 ), 1.f );
+		BOOST_CHECK_EQUAL( tile.sample( Chan_Red, 5, 4 ), 0.f );
+		BOOST_CHECK( tile.row( Chan_Alpha, 4 ) - tile.row( Chan_Alpha, 3 ) == 4 );
+		
+		BOOST_CHECK_THROW( tile.row( Chan_Green, 3 ), std::runtime_error );
+		BOOST_CHECK_THROW( tile.row( Chan_Red, 5 ), std::runtime_error );
+	}
+
+	void testCopyOnWrite()
+	{
+		Tile a( Box( 0, 0, 8, 4 ), ChannelSet( Mask_Red | Mask_Green ) );
+		a.row( Chan_Red, 2 )[3] = 1.f;
+		
+		// Copies share their planes until one of them is written to.
+		Tile b( a );
+		BOOST_CHECK( a.isShared( Chan_Red ) && b.isShared( Chan_Red ) );
+		BOOST_CHECK( static_cast< const Tile & >( a ).row( Chan_Red, 2 ) == static_cast< const Tile & >( b ).row( Chan_Red, 2 ) );
+		BOOST_CHECK_EQUAL( b.sample( Chan_Red, 3, 2 ), 1.f );
+
+		b.row( Chan_Red, 2 )[3] = 2.f;
+		BOOST_CHECK_EQUAL( a.sample( Chan_Red, 3, 2 ), 1.f );
+		BOOST_CHECK_EQUAL( b.sample( Chan_Red, 3, 2 ), 2.f );
+		BOOST_CHECK( !a.isShared( Chan_Red ) && !b.isShared( Chan_Red ) );
+		BOOST_CHECK( a.isShared( Chan_Green ) );
+
+		b.makeUnique();
+		BOOST_CHECK( !a.isShared( Chan_Green ) && !b.isShared( Chan_Green ) );
+
+		// A channel can be shared with a tile that covers a smaller region.
+		Tile c( Box( 2, 1, 5, 3 ), ChannelSet( Mask_Blue ) );
+		c.shareChannel( a, Chan_Red );
+		BOOST_CHECK( c.channels() == ChannelSet( Mask_Red | Mask_Blue ) );
+		BOOST_CHECK_EQUAL( c.sample( Chan_Red, 3, 2 ), 1.f );
+		BOOST_CHECK_EQUAL( c.sample( Chan_Blue, 3, 2 ), 0.f );
+		BOOST_CHECK( c.isShared( Chan_Red ) );
+		
+		c.row( Chan_Red, 2 )[1] = 3.f;
+		BOOST_CHECK_EQUAL( c.sample( Chan_Red, 3, 2 ), 3.f );
+		BOOST_CHECK_EQUAL( a.sample( Chan_Red, 3, 2 ), 1.f );
+		BOOST_CHECK( !c.isShared( Chan_Red ) );
+
+		BOOST_CHECK_THROW( c.shareChannel( a, Chan_Blue ), std::runtime_error );
+		BOOST_CHECK_THROW( a.shareChannel( c, Chan_Red ), std::runtime_error );
+	}
+
+	void testPassThrough()
+	{
+		boost::shared_ptr< RampOp > ramp( new RampOp );
+		MaskOp mask;
+		mask.setInput( 0, ramp );
+
+		// Only alpha is computed by the mask, and only the other channels are computed by the ramp.
+		const Box box( 0, 0, 8, 6 );
+		TileCache cache( 1024 * 1024 );
+		Tile output( box, ChannelSet( Mask_RGBA ) );
+		evaluate( mask, output, 1, true, &cache );
+		BOOST_CHECK( mask.m_computedChannels == ChannelSet( Mask_Alpha ) );
+		BOOST_CHECK_EQUAL( ramp->m_samples, box.width() * box.height() * 3 );
+		BOOST_CHECK_EQUAL( output.sample( Chan_Green, 5, 3 ), RampOp::value( Chan_Green, 5, 3 ) );
+		BOOST_CHECK_EQUAL( output.sample( Chan_Alpha, 3, 3 ), 1.f );
+		BOOST_CHECK_EQUAL( output.sample( Chan_Alpha, 5, 3 ), 0.f );
+
+		// The passed channels are the ramp's own planes, which are also held by the cache.
+		BOOST_CHECK( output.isShared( Chan_Green ) );
+		
+		// Without a cache the output holds the only reference to the ramp's planes.
+		evaluate( mask, output, 2 );
+		BOOST_CHECK( !output.isShared( Chan_Green ) );
+		BOOST_CHECK_EQUAL( output.sample( Chan_Blue, 7, 5 ), RampOp::value( Chan_Blue, 7, 5 ) );
+		BOOST_CHECK_EQUAL( output.sample( Chan_Alpha, 0, 0 ), 1.f );
+	}
+
+	void testRegionOfInterest()
+	{
+		boost::shared_ptr< RampOp > ramp( new RampOp );
+		boost::shared_ptr< HorizontalBlurOp > blur( new HorizontalBlurOp( 2 ) );
+		blur->setInput( 0, ramp );
+		
+		const Box cropBox( 10, 20, 14, 23 );
+		Crop crop( cropBox );
+		crop.setInput( 0, blur );
+
+		// Ask for a full frame from the crop.
+		Tile output( Box( 0, 0, 64, 48 ), ChannelSet( Mask_RGB ) );
+		evaluate( crop, output, 1 );
+		
+		// Only the cropped region, padded by the blur, was computed by the ramp.
+		BOOST_CHECK_EQUAL( ramp->m_samples, ( cropBox.width() + 4 ) * cropBox.height() * 3 );
+
+		for( int32 y = 0; y < 48; ++y )
+		{
+			for( int32 x = 0; x < 64; ++x )
+			{
+				const float expected = cropBox.contains( x, y ) ? RampOp::value( Chan_Green, x, y ) : 0.f;
+				BOOST_CHECK_CLOSE( output.sample( Chan_Green, x, y ) + 1.f, expected + 1.f, 1e-4 );
+			}
+		}
+	}
+
+	void testChannelsOfInterest()
+	{
+		boost::shared_ptr< RampOp > ramp( new RampOp );
+		RedToAllOp redToAll;
+		redToAll.setInput( 0, ramp );
+		
+		Tile output( Box( 0, 0, 8, 8 ), ChannelSet( Mask_RGBA ) );
+		evaluate( redToAll, output );
+		
+		// Only the red channel was computed upstream.
+		BOOST_CHECK_EQUAL( ramp->m_samples, 64 );
+		BOOST_CHECK_EQUAL( output.sample( Chan_Alpha, 3, 4 ), RampOp::value( Chan_Red, 3, 4 ) );
+	}
+
+	void testSharedInputs()
+	{
+		boost::shared_ptr< RampOp > ramp( new RampOp );
+		AddOp add( 3 );
+		add.setInput( 0, ramp );
+		add.setInput( 1, ramp );
+		
+		// The ramp is computed once over the union of the regions that are asked of it.
+		Tile output( Box( 0, 0, 10, 4 ), ChannelSet( Mask_Red ) );
+		evaluate( add, output, 1 );
+		BOOST_CHECK_EQUAL( ramp->m_samples, 13 * 4 );
+		BOOST_CHECK_EQUAL( output.sample( Chan_Red, 2, 1 ), RampOp::value( Chan_Red, 2, 1 ) + RampOp::value( Chan_Red, 5, 1 ) );
+	}
+
+	void testThreadedEvaluation()
+	{
+		boost::shared_ptr< RampOp > ramp( new RampOp );
+		boost::shared_ptr< HorizontalBlurOp > blur1( new HorizontalBlurOp( 1 ) );
+		boost::shared_ptr< HorizontalBlurOp > blur2( new HorizontalBlurOp( 3 ) );
+		blur1->setInput( 0, ramp );
+		blur2->setInput( 0, ramp );
+		AddOp add( -2 );
+		add.setInput( 0, blur1 );
+		add.setInput( 1, blur2 );
+
+		const Box box( -5, -7, 120, 90 );
+		Tile single( box, ChannelSet( Mask_RGBA ) );
+		evaluate( add, single, 1 );
+		const int samples = ramp->m_samples;
+
+		Tile threaded( box, ChannelSet( Mask_RGBA ) );
+		evaluate( add, threaded, 8 );
+		BOOST_CHECK_EQUAL( ramp->m_samples, samples * 2 );
+		
+		bool equal = true;
+		for( int32 y = box.y(); y < box.t(); ++y )
+		{
+			equal &= std::equal( single.row( Chan_Blue, y ), single.row( Chan_Blue, y ) + box.width(), threaded.row( Chan_Blue, y ) );
+		}
+		BOOST_CHECK( equal );
+	}
+
+	void testErrors()
+	{
+		// Unconnected inputs are reported before anything is computed.
+		Crop crop( Box( 0, 0, 4, 4 ) );
+		Tile output( Box( 0, 0, 4, 4 ), ChannelSet( Mask_Red ) );
+		BOOST_CHECK_THROW( evaluate( crop, output ), std::runtime_error );
+		BOOST_CHECK_THROW( crop.setInput( 1, OpPtr() ), std::runtime_error );
+
+		// Exceptions that are thrown by ops are passed on to the caller.
+		boost::shared_ptr< RampOp > ramp( new RampOp );
+		boost::shared_ptr< ThrowingOp > throwing( new ThrowingOp );
+		throwing->setInput( 0, ramp );
+		crop.setInput( 0, throwing );
+		BOOST_CHECK_THROW( evaluate( crop, output, 4 ), std::runtime_error );
+	}
 };
 
 struct OpTestSuite : public boost::unit_test::test_suite
@@ -66,6 +425,15 @@ struct OpTestSuite : public boost::unit_test::test_suite
 	{
 		boost::shared_ptr<OpTest> instance( new OpTest() );
 		add( BOOST_CLASS_TEST_CASE( &OpTest::testOpPreprocess, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &OpTest::testBox, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &OpTest::testTile, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &OpTest::testCopyOnWrite, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &OpTest::testPassThrough, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &OpTest::testRegionOfInterest, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &OpTest::testChannelsOfInterest, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &OpTest::testSharedInputs, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &OpTest::testThreadedEvaluation, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &OpTest::testErrors, instance ) );
 		}
 	};
 
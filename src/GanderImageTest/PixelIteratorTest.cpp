@@ -33,9 +33,13 @@
 //////////////////////////////////////////////////////////////////////////
 #include <iostream>
 #include <cstdlib>
+#include <limits>
 
 #include "GanderImageTest/PixelIteratorTest.h"
 #include "GanderImage/PixelIterator.h"
+#include "GanderImage/SubsampledChannelLayout.h"
+
+#include "Gander/Half.h"
 
 #include "boost/test/floating_point_comparison.hpp"
 #include "boost/test/test_tools.hpp"
@@ -201,6 +205,75 @@ struct PixelIteratorTest
 		BOOST_CHECK( ( it != it2 ) );
 
 	}
+
+	void testSubsampledPixelIterator()
+	{
+		typedef PixelIterator< CompoundLayout< BrothersLayout< float, Brothers_RGB >, SubsampledChannelLayout< float, Chan_U, 2 >, SubsampledChannelLayout< float, Chan_V, 4 > > > PixelIterator;
+		PixelIterator it;
+
+		BOOST_CHECK_EQUAL( it->channels(), ChannelSet( Mask_RGB | Mask_U | Mask_V ) );
+		BOOST_CHECK_EQUAL( it->requiredChannels(), ChannelSet( Mask_Red | Mask_U | Mask_V ) );
+	
+		float rgb[15] = { 1., 2., 3., 4., 5., 6., 7., 8., 9., 10., 11., 12., 13., 14., 15. };
+		float u[3] = { 20., 21., 22. };
+		float v[2] = { 30., 31. };
+		it->setChannelPointer( Chan_Red, &rgb[0] );	
+		it->setChannelPointer( Chan_U, &u[0] );	
+		it->setChannelPointer( Chan_V, &v[0] );	
+
+		for( int x = 0; x < 5; ++x, ++it )
+		{
+			BOOST_CHECK_EQUAL( it->channel<Chan_Green>(), rgb[x * 3 + 1] );
+			BOOST_CHECK_EQUAL( it->channel<Chan_U>(), u[x / 2] );
+			BOOST_CHECK_EQUAL( it->channel<Chan_V>(), v[x / 4] );
+		}
+
+		it -= 2;
+		BOOST_CHECK_EQUAL( it->channel<Chan_Red>(), 10. );
+		BOOST_CHECK_EQUAL( it->channel<Chan_U>(), 21. );
+		BOOST_CHECK_EQUAL( it->channel<Chan_V>(), 30. );
+		
+		it->channel<Chan_U>() = 0.;
+		BOOST_CHECK_EQUAL( u[1], 0. );
+	}
+
+	void testHalfPixelIterator()
+	{
+		typedef PixelIterator< CompoundLayout< BrothersLayout< half, Brothers_BGR >, ChannelLayout< half, Chan_Alpha >, DynamicLayout< half > > > PixelIterator;
+		PixelIterator it;
+		
+		it->addChannels( Mask_U, Brothers_VU );
+		it->addChannels( Mask_Z );
+
+		half bgr[6] = { 3.f, 2.f, 1.f, 6.f, 5.f, 4.f };
+		half alpha[2] = { .5f, .25f };
+		half vu[4] = { 10.f, 9.f, 12.f, 11.f };
+		half z[2] = { 13.f, 14.f };
+		it->setChannelPointer( Chan_Blue, &bgr[0] );	
+		it->setChannelPointer( Chan_Alpha, &alpha );	
+		it->setChannelPointer( Chan_Z, &z );	
+		it->setChannelPointer( Chan_U, &vu[1] );	
+
+		BOOST_CHECK_EQUAL( it->channel<Chan_Red>(), 1.f );
+		BOOST_CHECK_EQUAL( it->channel<Chan_Blue>(), 3.f );
+		BOOST_CHECK_EQUAL( it->channel<Chan_Alpha>(), .5f );
+		BOOST_CHECK_EQUAL( it->channel<Chan_Z>(), 13.f );
+		BOOST_CHECK_EQUAL( it->channel<Chan_U>(), 9.f );
+
+		// Writing a float through channel() should store the nearest half.
+		it->channel<Chan_Green>() = 0.1f;
+		BOOST_CHECK_EQUAL( bgr[1].bits(), half( 0.1f ).bits() );
+		BOOST_CHECK_CLOSE( float( it->channel<Chan_Green>() ), 0.1f, 0.1 );
+		it->channel<Chan_Z>() = 1e6f;
+		BOOST_CHECK_EQUAL( float( z[0] ), std::numeric_limits< float >::infinity() );
+
+		it++;
+		BOOST_CHECK_EQUAL( it->channel<Chan_Red>(), 4.f );
+		BOOST_CHECK_EQUAL( it->channel<Chan_Green>(), 5.f );
+		BOOST_CHECK_EQUAL( it->channel<Chan_Alpha>(), .25f );
+		BOOST_CHECK_EQUAL( it->channel<Chan_Z>(), 14.f );
+		BOOST_CHECK_EQUAL( it->channel<Chan_U>(), 11.f );
+	}
 };
 
 struct PixelIteratorTestSuite : public boost::unit_test::test_suite
@@ -211,6 +284,8 @@ struct PixelIteratorTestSuite : public boost::unit_test::test_suite
 		add( BOOST_CLASS_TEST_CASE( &PixelIteratorTest::testPixelIterator, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &PixelIteratorTest::testConstPixelIterator, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &PixelIteratorTest::testPixelIteratorConstructors, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &PixelIteratorTest::testSubsampledPixelIterator, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &PixelIteratorTest::testHalfPixelIterator, instance ) );
 	}
 };
 
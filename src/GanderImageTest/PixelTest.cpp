@@ -36,6 +36,7 @@
 
 #include "GanderImageTest/PixelTest.h"
 #include "GanderImage/Pixel.h"
+#include "GanderTest/Benchmark.h"
 
 #include "boost/test/floating_point_comparison.hpp"
 #include "boost/test/test_tools.hpp"
@@ -251,6 +252,107 @@ struct PixelTest
 		BOOST_CHECK( pixel == pixelAccessor );
 	}
 
+	void testDynamicPixelStorage()
+	{
+		typedef CompoundLayout< ChannelLayout< float, Chan_Backward >, DynamicLayout< float > > Layout;
+		typedef Gander::Image::Pixel< Layout > Pixel;
+
+		// A pixel with a few dynamic channels holds them inside itself, so creating and copying it doesn't allocate.
+		Pixel pixel;
+		pixel.addChannels( Mask_RGBA, Brothers_RGBA );
+		pixel.channel<Chan_Red>() = 1.;
+		pixel.channel<Chan_Alpha>() = 4.;
+
+		Pixel pixel2( pixel );
+		BOOST_CHECK( pixel == pixel2 );
+		
+		const char *begin = reinterpret_cast< const char * >( &pixel2 );
+		const char *red = reinterpret_cast< const char * >( &pixel2.channel<Chan_Red>() );
+		const char *alpha = reinterpret_cast< const char * >( &pixel2.channel<Chan_Alpha>() );
+		BOOST_CHECK( red >= begin && red < begin + sizeof( Pixel ) );
+		BOOST_CHECK( alpha >= begin && alpha < begin + sizeof( Pixel ) );
+
+		// Pixels with more channels than can be held inline still behave as values.
+		pixel.addChannels( Mask_Z );
+		pixel.addChannels( Mask_UV, Brothers_UV );
+		pixel.channel<Chan_Z>() = 5.;
+		pixel.channel<Chan_V>() = 7.;
+		
+		Pixel pixel3( pixel );
+		BOOST_CHECK( pixel == pixel3 );
+		pixel3.channel<Chan_V>() = 8.;
+		BOOST_CHECK( pixel != pixel3 );
+		BOOST_CHECK_EQUAL( pixel.channel<Chan_V>(), 7. );
+		
+		pixel2 = pixel3;
+		BOOST_CHECK( pixel2 == pixel3 );
+		BOOST_CHECK_EQUAL( pixel2.channel<Chan_Red>(), 1. );
+		BOOST_CHECK_EQUAL( pixel2.channel<Chan_V>(), 8. );
+	}
+
+	/// Times creating and copying pixels with four dynamic channels, which are held inside the pixel, against pixels
+	/// with eight, which are held on the heap as the channels of every dynamic pixel were before.
+	void testDynamicPixelThroughput()
+	{
+		typedef Gander::Image::Pixel< CompoundLayout< DynamicLayout< float > > > Pixel;
+		const int pixels = 1 << 18;
+
+		Gander::Test::Benchmark construction( "PixelTest construction", "Mpixels/s", pixels * 1e-6 );
+		float fourSum = 0.f;
+		for( int i = 0; i < pixels; ++i )
+		{
+			Pixel pixel;
+			pixel.addChannels( Mask_RGBA, Brothers_RGBA );
+			pixel.channel<Chan_Red>() = float( i & 7 );
+			fourSum += pixel.channel<Chan_Red>();
+		}
+		construction.stop( "four channels" );
+
+		construction.start();
+		float eightSum = 0.f;
+		for( int i = 0; i < pixels; ++i )
+		{
+			Pixel pixel;
+			pixel.addChannels( Mask_RGBA, Brothers_RGBA );
+			pixel.addChannels( Mask_UV, Brothers_UV );
+			pixel.addChannels( Mask_Z | Mask_Backward );
+			pixel.channel<Chan_Red>() = float( i & 7 );
+			eightSum += pixel.channel<Chan_Red>();
+		}
+		construction.stop( "eight channels" );
+		construction.report();
+		BOOST_CHECK_EQUAL( fourSum, eightSum );
+
+		Pixel four;
+		four.addChannels( Mask_RGBA, Brothers_RGBA );
+		Pixel eight( four );
+		eight.addChannels( Mask_UV, Brothers_UV );
+		eight.addChannels( Mask_Z | Mask_Backward );
+		BOOST_CHECK_EQUAL( eight.channels().size(), 8u );
+
+		Gander::Test::Benchmark copy( "PixelTest copy", "Mpixels/s", pixels * 1e-6 );
+		fourSum = 0.f;
+		for( int i = 0; i < pixels; ++i )
+		{
+			Pixel pixel( four );
+			pixel.channel<Chan_Alpha>() += float( i & 7 );
+			fourSum += pixel.channel<Chan_Alpha>();
+		}
+		copy.stop( "four channels" );
+
+		copy.start();
+		eightSum = 0.f;
+		for( int i = 0; i < pixels; ++i )
+		{
+			Pixel pixel( eight );
+			pixel.channel<Chan_Alpha>() += float( i & 7 );
+			eightSum += pixel.channel<Chan_Alpha>();
+		}
+		copy.stop( "eight channels" );
+		copy.report();
+		BOOST_CHECK_EQUAL( fourSum, eightSum );
+	}
+
 	void testPixelWithCompoundLayout()
 	{
 		typedef BrothersLayout< float, Brothers_BGRA > Layout1;
@@ -417,6 +519,8 @@ struct PixelTestSuite : public boost::unit_test::test_suite
 		add( BOOST_CLASS_TEST_CASE( &PixelTest::testPixelWithCompoundLayout, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &PixelTest::testPixelWithDynamicCompoundLayout, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &PixelTest::testManyDynamicPixels, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &PixelTest::testDynamicPixelStorage, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &PixelTest::testDynamicPixelThroughput, instance ) );
 	}
 };
 
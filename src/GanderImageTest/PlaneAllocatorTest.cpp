@@ -0,0 +1,243 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+
+#include "boost/bind.hpp"
+#include "boost/thread.hpp"
+
+#include "GanderImage/PlaneAllocator.h"
+#include "GanderImage/Tile.h"
+#include "GanderImageTest/PlaneAllocatorTest.h"
+
+#include "boost/test/test_tools.hpp"
+
+using namespace Gander;
+using namespace Gander::Image;
+using namespace Gander::ImageTest;
+using namespace boost;
+using namespace boost::unit_test;
+
+namespace Gander
+{
+
+namespace ImageTest
+{
+
+struct PlaneAllocatorTest
+{
+	void testCapacity()
+	{
+		PlaneAllocator allocator;
+		BOOST_CHECK_EQUAL( allocator.capacity( 0 ), 0u );
+		BOOST_CHECK_EQUAL( allocator.capacity( 1 ), 64u );
+		
+		// Capacities are aligned and waste at most a quarter of the block.
+		const size_t sizes[] = { 100, 1000, 4097, 100000, 1000000, 3000000 };
+		for( unsigned int i = 0; i < sizeof( sizes ) / sizeof( size_t ); ++i )
+		{
+			const size_t capacity = allocator.capacity( sizes[i] );
+			BOOST_CHECK( capacity >= sizes[i] );
+			BOOST_CHECK( capacity <= sizes[i] + sizes[i] / 4 + 4096 );
+			BOOST_CHECK_EQUAL( capacity % 64, 0u );
+		}
+		
+		// Sizes that are close together share a capacity so that their blocks can be reused.
+		BOOST_CHECK_EQUAL( allocator.capacity( 1000000 ), allocator.capacity( 1000001 ) );
+		
+		// Large blocks are whole pages, and whole huge pages when they are used.
+		BOOST_CHECK_EQUAL( allocator.capacity( 1000000 ) % 4096, 0u );
+		allocator.setHugePages( true );
+		BOOST_CHECK( allocator.hugePages() );
+		BOOST_CHECK_EQUAL( allocator.capacity( 3000000 ) % ( 1 << 21 ), 0u );
+	}
+
+	void testPooling()
+	{
+		PlaneAllocator allocator( 1 << 24 );
+
+		const size_t sizes[] = { 100, 1 << 20 };
+		for( unsigned int i = 0; i < 2; ++i )
+		{
+			size_t capacity = 0;
+			void *block = allocator.allocate( sizes[i], capacity );
+			BOOST_CHECK( block );
+			BOOST_CHECK_EQUAL( reinterpret_cast< size_t >( block ) % 64, 0u );
+			std::memset( block, 1, sizes[i] );
+			allocator.deallocate( block, capacity );
+			
+			// The same block is handed out again.
+			size_t capacity2 = 0;
+			void *block2 = allocator.allocate( sizes[i] - 1, capacity2 );
+			BOOST_CHECK( block2 == block );
+			BOOST_CHECK_EQUAL( capacity2, capacity );
+			allocator.deallocate( block2, capacity2 );
+		}
+		
+		PlaneAllocator::Statistics statistics( allocator.statistics() );
+		BOOST_CHECK_EQUAL( statistics.systemAllocations, 2u );
+		BOOST_CHECK_EQUAL( statistics.pooledAllocations, 2u );
+		BOOST_CHECK_EQUAL( statistics.usedBytes, 0u );
+		BOOST_CHECK_EQUAL( statistics.pooledBytes, allocator.capacity( 100 ) + allocator.capacity( 1 << 20 ) );
+		BOOST_CHECK_EQUAL( statistics.reservedBytes, statistics.pooledBytes );
+		BOOST_CHECK_EQUAL( statistics.peakReservedBytes, statistics.reservedBytes );
+
+		allocator.trim();
+		statistics = allocator.statistics();
+		BOOST_CHECK_EQUAL( statistics.pooledBytes, 0u );
+		BOOST_CHECK_EQUAL( statistics.reservedBytes, 0u );
+		BOOST_CHECK_EQUAL( statistics.peakReservedBytes, allocator.capacity( 100 ) + allocator.capacity( 1 << 20 ) );
+		allocator.resetPeak();
+		BOOST_CHECK_EQUAL( allocator.statistics().peakReservedBytes, 0u );
+	}
+
+	void testPoolLimit()
+	{
+		PlaneAllocator allocator( 0 );
+		
+		size_t capacity = 0;
+		void *block = allocator.allocate( 1 << 20, capacity );
+		BOOST_CHECK_EQUAL( allocator.statistics().reservedBytes, capacity );
+		allocator.deallocate( block, capacity );
+		BOOST_CHECK_EQUAL( allocator.statistics().reservedBytes, 0u );
+		BOOST_CHECK_EQUAL( allocator.statistics().peakReservedBytes, capacity );
+
+		// Lowering the limit frees pooled blocks.
+		allocator.setPoolLimit( capacity * 2 );
+		void *blocks[2];
+		blocks[0] = allocator.allocate( 1 << 20, capacity );
+		blocks[1] = allocator.allocate( 1 << 20, capacity );
+		allocator.deallocate( blocks[0], capacity );
+		allocator.deallocate( blocks[1], capacity );
+		BOOST_CHECK_EQUAL( allocator.statistics().pooledBytes, capacity * 2 );
+		allocator.setPoolLimit( capacity );
+		BOOST_CHECK_EQUAL( allocator.poolLimit(), capacity );
+		BOOST_CHECK_EQUAL( allocator.statistics().pooledBytes, capacity );
+		BOOST_CHECK_EQUAL( allocator.statistics().reservedBytes, capacity );
+	}
+
+	void testHugePages()
+	{
+		// Huge pages are used where they are available, and otherwise normal pages are.
+		PlaneAllocator allocator( 0, true );
+		size_t capacity = 0;
+		float *block = static_cast< float * >( allocator.allocate( 3 << 20, capacity ) );
+		BOOST_CHECK( block );
+		BOOST_CHECK_EQUAL( capacity, size_t( 4 << 20 ) );
+		block[0] = 1.f;
+		block[ ( 3 << 18 ) - 1 ] = 2.f;
+		BOOST_CHECK_EQUAL( block[0] + block[ ( 3 << 18 ) - 1 ], 3.f );
+		allocator.deallocate( block, capacity );
+	}
+
+	static void allocateRepeatedly( PlaneAllocator *allocator, size_t size )
+	{
+		for( unsigned int i = 0; i < 1000; ++i )
+		{
+			size_t capacity = 0;
+			char *block = static_cast< char * >( allocator->allocate( size, capacity ) );
+			block[0] = block[size - 1] = 1;
+			allocator->deallocate( block, capacity );
+		}
+	}
+
+	void testThreads()
+	{
+		PlaneAllocator allocator;
+		boost::thread_group threads;
+		for( unsigned int i = 0; i < 4; ++i )
+		{
+			threads.create_thread( boost::bind( &PlaneAllocatorTest::allocateRepeatedly, &allocator, size_t( 1000 ) << i ) );
+		}
+		threads.join_all();
+
+		// No more than one block of each size is needed at a time by each thread.
+		PlaneAllocator::Statistics statistics( allocator.statistics() );
+		BOOST_CHECK_EQUAL( statistics.usedBytes, 0u );
+		BOOST_CHECK_EQUAL( statistics.systemAllocations + statistics.pooledAllocations, 4000u );
+		BOOST_CHECK( statistics.systemAllocations <= 4u );
+	}
+
+	void testTile()
+	{
+		PlaneAllocator &allocator( PlaneAllocator::defaultAllocator() );
+		const size_t used = allocator.statistics().usedBytes;
+		
+		Tile tile( Box( 0, 0, 64, 32 ), ChannelSet( Mask_Red | Mask_Green ) );
+		BOOST_CHECK_EQUAL( allocator.statistics().usedBytes, used + allocator.capacity( 64 * 32 * 2 * sizeof( float ) ) );
+		BOOST_CHECK_EQUAL( tile.sample( Chan_Green, 63, 31 ), 0.f );
+		tile.row( Chan_Green, 31 )[63] = 2.f;
+
+		Tile copy( tile );
+		BOOST_CHECK( copy.box() == tile.box() );
+		BOOST_CHECK_EQUAL( copy.sample( Chan_Green, 63, 31 ), 2.f );
+		BOOST_CHECK( copy.row( Chan_Green, 31 ) != tile.row( Chan_Green, 31 ) );
+		copy.clear();
+
+		// A tile that shrinks keeps its memory.
+		const float *data( tile.row( Chan_Red, 0 ) );
+		tile.reset( Box( 0, 0, 16, 16 ), ChannelSet( Mask_Red ), false );
+		BOOST_CHECK( tile.row( Chan_Red, 0 ) == data );
+		
+		tile.row( Chan_Red, 3 )[4] = 1.f;
+		tile.clearRows( 3, 4 );
+		BOOST_CHECK_EQUAL( tile.sample( Chan_Red, 4, 3 ), 0.f );
+
+		tile.clear();
+		BOOST_CHECK_EQUAL( allocator.statistics().usedBytes, used );
+	}
+};
+
+struct PlaneAllocatorTestSuite : public boost::unit_test::test_suite
+{
+	PlaneAllocatorTestSuite() : boost::unit_test::test_suite( "PlaneAllocatorTestSuite" )
+	{
+		boost::shared_ptr<PlaneAllocatorTest> instance( new PlaneAllocatorTest() );
+		add( BOOST_CLASS_TEST_CASE( &PlaneAllocatorTest::testCapacity, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &PlaneAllocatorTest::testPooling, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &PlaneAllocatorTest::testPoolLimit, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &PlaneAllocatorTest::testHugePages, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &PlaneAllocatorTest::testThreads, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &PlaneAllocatorTest::testTile, instance ) );
+	}
+};
+
+void addPlaneAllocatorTest( boost::unit_test::test_suite *test )
+{
+	test->add( new PlaneAllocatorTestSuite() );
+}
+
+} // namespace ImageTest
+
+} // namespace Gander
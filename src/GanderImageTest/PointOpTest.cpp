@@ -0,0 +1,264 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#include <iostream>
+#include <cstdlib>
+#include <algorithm>
+
+#include "GanderImage/PointOp.h"
+#include "GanderTest/Benchmark.h"
+#include "GanderImageTest/PointOpTest.h"
+#include "GanderImageTest/SourceOp.h"
+
+#include "boost/test/floating_point_comparison.hpp"
+#include "boost/test/test_tools.hpp"
+
+using namespace Gander;
+using namespace Gander::Image;
+using namespace Gander::ImageTest;
+using namespace boost;
+using namespace boost::unit_test;
+
+namespace Gander
+{
+
+namespace ImageTest
+{
+
+inline float patternValue( Channel c, int32 x, int32 y, int frame )
+{
+	return float( ( c * 7 + x * 3 + y * 5 ) % 31 ) / 10.f - 1.f;
+}
+
+/// A source op with samples in the range [-1, 2].
+typedef SourceOp< patternValue > PatternOp;
+
+/// A grade that counts the number of times that it computes a tile of its own.
+class CountingGrade : public Grade
+{
+	public :
+
+		CountingGrade( float gain, float offset ) : Grade( gain, offset ), m_computeRows( 0 ) {}
+
+		virtual void computeRows( int32 y, int32 t, const std::vector< const Tile * > &inputs, Tile &output ) const
+		{
+			__sync_fetch_and_add( &m_computeRows, 1 );
+			Grade::computeRows( y, t, inputs, output );
+		}
+
+		mutable int m_computeRows;
+};
+
+/// Adds its two inputs.
+class SumOp : public Op
+{
+	public :
+
+		SumOp() : Op( 2 ) {}
+
+		virtual void computeRows( int32 y, int32 t, const std::vector< const Tile * > &inputs, Tile &output ) const
+		{
+			const ChannelSet channels( output.channels() );
+			for( ChannelSet::const_iterator c( channels.begin() ); c != channels.end(); ++c )
+			{
+				for( int32 row = y; row < t; ++row )
+				{
+					for( int32 x = output.box().x(); x < output.box().r(); ++x )
+					{
+						output.row( *c, row )[ x - output.box().x() ] = inputs[0]->sample( *c, x, row ) + inputs[1]->sample( *c, x, row );
+					}
+				}
+			}
+		}
+};
+
+struct PointOpTest
+{
+	void testPointOps()
+	{
+		boost::shared_ptr< PatternOp > source( new PatternOp );
+		boost::shared_ptr< Grade > grade( new Grade( 2.f, 0.5f ) );
+		boost::shared_ptr< Clamp > clamp( new Clamp( 0.f, 1.f ) );
+		Premultiply premultiply;
+		grade->setInput( 0, source );
+		clamp->setInput( 0, grade );
+		premultiply.setInput( 0, clamp );
+
+		// Premultiply needs alpha even when it isn't asked for.
+		BOOST_CHECK_EQUAL( premultiply.inputChannels( 0, ChannelSet( Mask_RGB ) ), ChannelSet( Mask_RGBA ) );
+		BOOST_CHECK_EQUAL( premultiply.inputChannels( 0, ChannelSet( Mask_Alpha ) ), ChannelSet( Mask_Alpha ) );
+
+		const Box box( 0, 0, 17, 9 );
+		Tile output( box, ChannelSet( Mask_RGB ) );
+		evaluate( premultiply, output, 2 );
+		
+		for( int32 y = box.y(); y < box.t(); ++y )
+		{
+			for( int32 x = box.x(); x < box.r(); ++x )
+			{
+				const float alpha = std::min( std::max( PatternOp::value( Chan_Alpha, x, y ) * 2.f + 0.5f, 0.f ), 1.f );
+				const float red = std::min( std::max( PatternOp::value( Chan_Red, x, y ) * 2.f + 0.5f, 0.f ), 1.f );
+				BOOST_CHECK_EQUAL( output.sample( Chan_Red, x, y ), red * alpha );
+			}
+		}
+	}
+
+	void testFusion()
+	{
+		boost::shared_ptr< PatternOp > source( new PatternOp );
+		boost::shared_ptr< CountingGrade > grade1( new CountingGrade( 2.f, -0.25f ) );
+		boost::shared_ptr< CountingGrade > grade2( new CountingGrade( 0.5f, 0.1f ) );
+		boost::shared_ptr< Clamp > clamp( new Clamp( 0.f, 1.f ) );
+		Premultiply premultiply;
+		grade1->setInput( 0, source );
+		grade2->setInput( 0, grade1 );
+		clamp->setInput( 0, grade2 );
+		premultiply.setInput( 0, clamp );
+
+		const Box box( -3, -2, 61, 47 );
+		Tile unfused( box, ChannelSet( Mask_RGB ) );
+		evaluate( premultiply, unfused, 4, false );
+		BOOST_CHECK( grade1->m_computeRows > 0 );
+		BOOST_CHECK( grade2->m_computeRows > 0 );
+		
+		// When fused, the grades never compute tiles of their own and the source is still computed once.
+		grade1->m_computeRows = grade2->m_computeRows = 0;
+		const int samples = source->m_samples;
+		Tile fused( box, ChannelSet( Mask_RGB ) );
+		evaluate( premultiply, fused, 4 );
+		BOOST_CHECK_EQUAL( grade1->m_computeRows, 0 );
+		BOOST_CHECK_EQUAL( grade2->m_computeRows, 0 );
+		BOOST_CHECK_EQUAL( source->m_samples, samples * 2 );
+
+		bool equal = true;
+		for( int32 y = box.y(); y < box.t(); ++y )
+		{
+			equal &= std::equal( unfused.row( Chan_Green, y ), unfused.row( Chan_Green, y ) + box.width(), fused.row( Chan_Green, y ) );
+		}
+		BOOST_CHECK( equal );
+	}
+
+	/// Times a chain of four point ops over a large image with and without fusion and reports the throughput of each.
+	void testFusionThroughput()
+	{
+		boost::shared_ptr< PatternOp > source( new PatternOp );
+		boost::shared_ptr< Grade > grade1( new Grade( 2.f, -0.25f ) );
+		boost::shared_ptr< Grade > grade2( new Grade( 0.5f, 0.1f ) );
+		boost::shared_ptr< Clamp > clamp( new Clamp( 0.f, 1.f ) );
+		Premultiply premultiply;
+		grade1->setInput( 0, source );
+		grade2->setInput( 0, grade1 );
+		clamp->setInput( 0, grade2 );
+		premultiply.setInput( 0, clamp );
+
+		const Box box( 0, 0, 1024, 1024 );
+		const int passes = 4;
+		Tile unfused( box, ChannelSet( Mask_RGB ) ), fused( box, ChannelSet( Mask_RGB ) );
+
+		Gander::Test::Benchmark benchmark( "PointOpTest", "Mpixels/s", double( box.width() ) * box.height() * passes * 1e-6 );
+		for( int pass = 0; pass < passes; ++pass )
+		{
+			evaluate( premultiply, unfused, 1, false );
+		}
+		benchmark.stop( "unfused" );
+
+		benchmark.start();
+		for( int pass = 0; pass < passes; ++pass )
+		{
+			evaluate( premultiply, fused, 1 );
+		}
+		benchmark.stop( "fused" );
+		benchmark.report();
+
+		const Channel channels[3] = { Chan_Red, Chan_Green, Chan_Blue };
+		bool equal = true;
+		for( int c = 0; c < 3; ++c )
+		{
+			for( int32 y = box.y(); y < box.t(); ++y )
+			{
+				equal &= std::equal( unfused.row( channels[c], y ), unfused.row( channels[c], y ) + box.width(), fused.row( channels[c], y ) );
+			}
+		}
+		BOOST_CHECK( equal );
+	}
+
+	void testSharedPointOpsAreNotFused()
+	{
+		// The first grade is used by two ops, so its tile has to be computed.
+		boost::shared_ptr< PatternOp > source( new PatternOp );
+		boost::shared_ptr< CountingGrade > shared( new CountingGrade( 2.f, 0.f ) );
+		shared->setInput( 0, source );
+		
+		boost::shared_ptr< Grade > grade( new Grade( 3.f, 0.f ) );
+		boost::shared_ptr< CountingGrade > after( new CountingGrade( 0.5f, 0.f ) );
+		grade->setInput( 0, shared );
+		after->setInput( 0, grade );
+		
+		boost::shared_ptr< Clamp > clamp( new Clamp( 0.f, 1.f ) );
+		clamp->setInput( 0, shared );
+
+		SumOp sum;
+		sum.setInput( 0, after );
+		sum.setInput( 1, clamp );
+		
+		Tile output( Box( 0, 0, 8, 8 ), ChannelSet( Mask_Red ) );
+		evaluate( sum, output, 1 );
+		BOOST_CHECK( shared->m_computeRows > 0 );
+		BOOST_CHECK_EQUAL( after->m_computeRows, 0 );
+		
+		const float value = PatternOp::value( Chan_Red, 3, 5 ) * 2.f;
+		BOOST_CHECK_CLOSE( output.sample( Chan_Red, 3, 5 ), value * 1.5f + std::min( std::max( value, 0.f ), 1.f ), 1e-4 );
+	}
+};
+
+struct PointOpTestSuite : public boost::unit_test::test_suite
+{
+	PointOpTestSuite() : boost::unit_test::test_suite( "PointOpTestSuite" )
+	{
+		boost::shared_ptr<PointOpTest> instance( new PointOpTest() );
+		add( BOOST_CLASS_TEST_CASE( &PointOpTest::testPointOps, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &PointOpTest::testFusion, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &PointOpTest::testFusionThroughput, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &PointOpTest::testSharedPointOpsAreNotFused, instance ) );
+	}
+};
+
+void addPointOpTest( boost::unit_test::test_suite *test )
+{
+	test->add( new PointOpTestSuite() );
+}
+
+} // namespace ImageTest
+
+} // namespace Gander
+
@@ -0,0 +1,193 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "GanderImage/Stencil.h"
+#include "GanderImage/Tile.h"
+#include "GanderImageTest/StencilTest.h"
+
+#include "boost/test/test_tools.hpp"
+
+using namespace Gander;
+using namespace Gander::Image;
+using namespace Gander::ImageTest;
+using namespace boost;
+using namespace boost::unit_test;
+
+namespace Gander
+{
+
+namespace ImageTest
+{
+
+struct StencilTest
+{
+	/// Fills a tile with samples that encode their position.
+	void fillTile( Tile &tile, Channel c )
+	{
+		for( int32 y = tile.box().y(); y < tile.box().t(); ++y )
+		{
+			float *row = tile.row( c, y );
+			for( int32 x = tile.box().x(); x < tile.box().r(); ++x )
+			{
+				row[ x - tile.box().x() ] = float( y * 100 + x );
+			}
+		}
+	}
+
+	void testBorderCoordinate()
+	{
+		BOOST_CHECK_EQUAL( Image::Detail::borderCoordinate( 3, 2, 6, Border_Mirror ), 3 );
+		BOOST_CHECK_EQUAL( Image::Detail::borderCoordinate( 1, 2, 6, Border_Clamp ), 2 );
+		BOOST_CHECK_EQUAL( Image::Detail::borderCoordinate( 9, 2, 6, Border_Clamp ), 5 );
+
+		// Mirroring doesn't repeat the edge and folds back again when it passes the far edge.
+		BOOST_CHECK_EQUAL( Image::Detail::borderCoordinate( 1, 2, 6, Border_Mirror ), 3 );
+		BOOST_CHECK_EQUAL( Image::Detail::borderCoordinate( 0, 2, 6, Border_Mirror ), 4 );
+		BOOST_CHECK_EQUAL( Image::Detail::borderCoordinate( -1, 2, 6, Border_Mirror ), 5 );
+		BOOST_CHECK_EQUAL( Image::Detail::borderCoordinate( -2, 2, 6, Border_Mirror ), 4 );
+		BOOST_CHECK_EQUAL( Image::Detail::borderCoordinate( 6, 2, 6, Border_Mirror ), 4 );
+		BOOST_CHECK_EQUAL( Image::Detail::borderCoordinate( 9, 2, 6, Border_Mirror ), 3 );
+		BOOST_CHECK_EQUAL( Image::Detail::borderCoordinate( 12, 2, 6, Border_Mirror ), 4 );
+
+		// A range of one sample can only be clamped.
+		BOOST_CHECK_EQUAL( Image::Detail::borderCoordinate( -3, 0, 1, Border_Mirror ), 0 );
+	}
+
+	/// Checks every sample of the window around every pixel of a region against the expected value.
+	void checkStencil( const Tile &tile, const Box &region, int32 radius, Border border )
+	{
+		const Box &box( tile.box() );
+		const float constant = -1.f;
+		Stencil stencil( tile, Chan_Red, region, radius, border, constant );
+		
+		bool equal = true;
+		for( int32 y = region.y(); y < region.t(); ++y )
+		{
+			// Alternate between moving to the next row and jumping straight to one.
+			if( y % 2 )
+			{
+				stencil.setRow( y );
+			}
+			else
+			{
+				stencil.setRow( y - 1 );
+				stencil.nextRow();
+			}
+			BOOST_CHECK_EQUAL( stencil.y(), y );
+
+			int32 x = region.x();
+			for( Stencil::Iterator it( stencil.begin() ); it != stencil.end(); ++it, ++x )
+			{
+				equal &= it.x() == x;
+				for( int32 dy = -radius; dy <= radius; ++dy )
+				{
+					for( int32 dx = -radius; dx <= radius; ++dx )
+					{
+						float expected = constant;
+						if( border != Border_Constant || box.contains( x + dx, y + dy ) )
+						{
+							const int32 xx = Image::Detail::borderCoordinate( x + dx, box.x(), box.r(), border );
+							const int32 yy = Image::Detail::borderCoordinate( y + dy, box.y(), box.t(), border );
+							expected = float( yy * 100 + xx );
+						}
+						
+						equal &= it( dx, dy ) == expected;
+						equal &= it.row( dy )[dx] == expected;
+						equal &= stencil.row( dy )[ x - region.x() + dx ] == expected;
+					}
+				}
+			}
+			equal &= x == region.r();
+		}
+		BOOST_CHECK( equal );
+	}
+
+	void testStencil()
+	{
+		Tile tile( Box( 10, 20, 17, 26 ), Mask_RGB );
+		fillTile( tile, Chan_Red );
+
+		const Border borders[3] = { Border_Clamp, Border_Mirror, Border_Constant };
+		for( unsigned int i = 0; i < 3; ++i )
+		{
+			// A region inside the tile, whose windows use its rows directly.
+			checkStencil( tile, Box( 12, 22, 15, 24 ), 1, borders[i] );
+			checkStencil( tile, Box( 12, 20, 15, 26 ), 2, borders[i] );
+
+			// The whole tile, and beyond it.
+			checkStencil( tile, tile.box(), 1, borders[i] );
+			checkStencil( tile, Box( 7, 17, 20, 29 ), 2, borders[i] );
+
+			// A radius larger than the tile, and a region that lies entirely outside it.
+			checkStencil( tile, tile.box(), 8, borders[i] );
+			checkStencil( tile, Box( 30, 0, 33, 3 ), 1, borders[i] );
+			
+			// A radius of 0 visits just the pixels themselves.
+			checkStencil( tile, Box( 5, 15, 25, 35 ), 0, borders[i] );
+		}
+	}
+
+	void testEmptyRegion()
+	{
+		Tile tile( Box( 0, 0, 4, 4 ), Mask_Red );
+		fillTile( tile, Chan_Red );
+
+		Stencil stencil( tile, Chan_Red, Box( 2, 2, 2, 3 ), 1 );
+		stencil.setRow( 2 );
+		BOOST_CHECK( stencil.begin() == stencil.end() );
+
+		BOOST_CHECK_THROW( Stencil( tile, Chan_Green, tile.box(), 1 ), std::runtime_error );
+		BOOST_CHECK_THROW( Stencil( tile, Chan_Red, tile.box(), -1 ), std::runtime_error );
+	}
+};
+
+struct StencilTestSuite : public boost::unit_test::test_suite
+{
+	StencilTestSuite() : boost::unit_test::test_suite( "StencilTestSuite" )
+	{
+		boost::shared_ptr<StencilTest> instance( new StencilTest() );
+		add( BOOST_CLASS_TEST_CASE( &StencilTest::testBorderCoordinate, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &StencilTest::testStencil, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &StencilTest::testEmptyRegion, instance ) );
+	}
+};
+
+void addStencilTest( boost::unit_test::test_suite *test )
+{
+	test->add( new StencilTestSuite() );
+}
+
+} // namespace ImageTest
+
+} // namespace Gander
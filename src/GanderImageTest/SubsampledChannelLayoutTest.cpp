@@ -0,0 +1,175 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#include <iostream>
+#include <cstdlib>
+
+#include "GanderImage/SubsampledChannelLayout.h"
+#include "GanderImage/ChannelLayout.h"
+#include "GanderImage/CompoundLayout.h"
+#include "GanderImageTest/SubsampledChannelLayoutTest.h"
+
+#include "boost/test/floating_point_comparison.hpp"
+#include "boost/test/test_tools.hpp"
+
+using namespace Gander;
+using namespace Gander::Image;
+using namespace Gander::ImageTest;
+using namespace boost;
+using namespace boost::unit_test;
+
+namespace Gander
+{
+
+namespace ImageTest
+{
+
+struct SubsampledChannelLayoutTest
+{
+	void testCommonLayoutAttributes()
+	{
+		typedef SubsampledChannelLayout< float, Chan_U, 2 > Layout1;
+		typedef SubsampledChannelLayout< float, Chan_V, 2, 2 > Layout2;
+
+		BOOST_CHECK_EQUAL( int( Layout1::NumberOfChannels ), 1 );
+		BOOST_CHECK_EQUAL( int( Layout1::ChannelMask ), int( Mask_U ) );
+		BOOST_CHECK_EQUAL( int( Layout1::XSubsampling ), 2 );
+		BOOST_CHECK_EQUAL( int( Layout1::YSubsampling ), 1 );
+		BOOST_CHECK_EQUAL( int( Layout2::ChannelMask ), int( Mask_V ) );
+		BOOST_CHECK_EQUAL( int( Layout2::XSubsampling ), 2 );
+		BOOST_CHECK_EQUAL( int( Layout2::YSubsampling ), 2 );
+		BOOST_CHECK_EQUAL( int( ChannelLayout< float, Chan_Red >::XSubsampling ), 1 );
+		
+		BOOST_CHECK_EQUAL( Layout1::subsampledRow( 5 ), 5u );
+		BOOST_CHECK_EQUAL( Layout2::subsampledRow( 5 ), 2u );
+		BOOST_CHECK_EQUAL( Layout2::subsampledWidth( 5 ), 3u );
+		BOOST_CHECK_EQUAL( Layout2::subsampledWidth( 6 ), 3u );
+
+		Layout2 l2;
+		BOOST_CHECK_EQUAL( l2.channels(), ChannelSet( Mask_V ) );
+		BOOST_CHECK_EQUAL( l2.requiredChannels(), ChannelSet( Mask_V ) );
+		BOOST_CHECK_EQUAL( l2.numberOfChannelPointers(), 1u );
+	}
+
+	void testContainerAccess() 
+	{
+		typedef SubsampledChannelLayout< float, Chan_U, 3 > Layout;
+		Layout layout;
+		Layout::ChannelContainerType c( layout );
+		Layout::ChannelPointerContainerType cp( layout );
+		
+		layout.channel< Layout::ChannelContainerType >( c, Chan_U ) = 2.;
+		BOOST_CHECK_EQUAL( float( layout.channel< Layout::ChannelContainerType >( c, Chan_U ) ), 2. );
+		BOOST_CHECK_THROW( layout.channel< Layout::ChannelContainerType >( c, Chan_V ), std::runtime_error );
+	
+		float u[4] = { 1., 2., 3., 4. };
+		layout.setChannelPointer< Layout::ChannelPointerContainerType >( cp, Chan_U, &u[0] );
+		
+		// Each value of the channel is shared by three consecutive pixels.
+		for( int x = 0; x < 12; ++x )
+		{
+			BOOST_CHECK_EQUAL( float( layout.channel< Layout::ChannelPointerContainerType, Chan_U >( cp ) ), u[x / 3] );
+			layout.increment( cp, 1 );
+		}
+		
+		layout.decrement( cp, 1 );
+		BOOST_CHECK_EQUAL( float( layout.channelAtIndex< Layout::ChannelPointerContainerType >( cp, 0 ) ), 4. );
+		layout.decrement( cp, 7 );
+		BOOST_CHECK_EQUAL( float( layout.channelAtIndex< Layout::ChannelPointerContainerType >( cp, 0 ) ), 2. );
+		layout.increment( cp, 3 );
+		BOOST_CHECK_EQUAL( float( layout.channelAtIndex< Layout::ChannelPointerContainerType >( cp, 0 ) ), 3. );
+		layout.decrement( cp, 7 );
+		BOOST_CHECK_EQUAL( float( layout.channelAtIndex< Layout::ChannelPointerContainerType >( cp, 0 ) ), 1. );
+		
+		// Setting the pointer resets the position within the block.
+		layout.increment( cp, 1 );
+		layout.setChannelPointer< Layout::ChannelPointerContainerType >( cp, Chan_U, &u[1] );
+		layout.increment( cp, 2 );
+		BOOST_CHECK_EQUAL( float( layout.channel< Layout::ChannelPointerContainerType, Chan_U >( cp ) ), 2. );
+		layout.increment( cp, 1 );
+		BOOST_CHECK_EQUAL( float( layout.channel< Layout::ChannelPointerContainerType, Chan_U >( cp ) ), 3. );
+	}
+
+	void testCompoundLayout()
+	{
+		// A 4:2:0 layout with a full resolution luma channel.
+		typedef CompoundLayout<
+			ChannelLayout< float, Chan_Red >,
+			SubsampledChannelLayout< float, Chan_U, 2, 2 >,
+			SubsampledChannelLayout< float, Chan_V, 2, 2 >
+		> Layout;
+		
+		Layout layout;
+		Layout::ChannelPointerContainerType cp( layout );
+		
+		float y[5] = { 1., 2., 3., 4., 5. };
+		float u[3] = { 10., 20., 30. };
+		float v[3] = { -10., -20., -30. };
+		layout.setChannelPointer( cp, Chan_Red, &y[0] );
+		layout.setChannelPointer( cp, Chan_U, &u[0] );
+		layout.setChannelPointer( cp, Chan_V, &v[0] );
+
+		for( int x = 0; x < 5; ++x )
+		{
+			BOOST_CHECK_EQUAL( layout.channel< Chan_Red >( cp ), y[x] );
+			BOOST_CHECK_EQUAL( layout.channel< Chan_U >( cp ), u[x / 2] );
+			BOOST_CHECK_EQUAL( layout.channel< Chan_V >( cp ), v[x / 2] );
+			layout.increment( cp, 1 );
+		}
+
+		layout.decrement( cp, 4 );
+		BOOST_CHECK_EQUAL( layout.channel< Chan_Red >( cp ), 2. );
+		BOOST_CHECK_EQUAL( layout.channel< Chan_U >( cp ), 10. );
+		BOOST_CHECK_EQUAL( layout.channel< Chan_V >( cp ), -10. );
+	}
+};
+
+struct SubsampledChannelLayoutTestSuite : public boost::unit_test::test_suite
+{
+	SubsampledChannelLayoutTestSuite() : boost::unit_test::test_suite( "SubsampledChannelLayoutTestSuite" )
+	{
+		boost::shared_ptr<SubsampledChannelLayoutTest> instance( new SubsampledChannelLayoutTest() );
+		add( BOOST_CLASS_TEST_CASE( &SubsampledChannelLayoutTest::testCommonLayoutAttributes, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &SubsampledChannelLayoutTest::testContainerAccess, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &SubsampledChannelLayoutTest::testCompoundLayout, instance ) );
+	}
+};
+
+void addSubsampledChannelLayoutTest( boost::unit_test::test_suite *test )
+{
+	test->add( new SubsampledChannelLayoutTestSuite() );
+}
+
+} // namespace ImageTest
+
+} // namespace Gander
@@ -0,0 +1,208 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+
+#include "Gander/Hash.h"
+#include "GanderImage/TileCache.h"
+#include "GanderImage/PointOp.h"
+#include "GanderImageTest/SourceOp.h"
+#include "GanderImageTest/TileCacheTest.h"
+
+#include "boost/test/floating_point_comparison.hpp"
+#include "boost/test/test_tools.hpp"
+
+using namespace Gander;
+using namespace Gander::Image;
+using namespace Gander::ImageTest;
+using namespace boost;
+using namespace boost::unit_test;
+
+namespace Gander
+{
+
+namespace ImageTest
+{
+
+inline float frameValue( Channel c, int32 x, int32 y, int frame )
+{
+	return float( c * 100 + x * 10 + y + frame * 1000 );
+}
+
+/// A source op whose output changes with its frame.
+typedef SourceOp< frameValue > FrameOp;
+
+struct TileCacheTest
+{
+	void testHash()
+	{
+		Hash a, b;
+		BOOST_CHECK( a == b );
+		
+		a.append( 1.f ).append( "grade" );
+		b.append( 1.f ).append( "grade" );
+		BOOST_CHECK( a == b );
+		
+		b.append( 0 );
+		BOOST_CHECK( a != b );
+
+		// Strings are delimited so that moving characters between them changes the hash.
+		Hash c, d;
+		c.append( "ab" ).append( "c" );
+		d.append( "a" ).append( "bc" );
+		BOOST_CHECK( c != d );
+		
+		// The hash of an op changes with its parameters and differs between types.
+		Hash g1, g2, g3, clamp;
+		Grade( 2.f, 0.f ).hash( g1 );
+		Grade( 2.f, 0.f ).hash( g2 );
+		Grade( 2.f, 0.5f ).hash( g3 );
+		Clamp( 2.f, 0.f ).hash( clamp );
+		BOOST_CHECK( g1 == g2 );
+		BOOST_CHECK( g1 != g3 );
+		BOOST_CHECK( g1 != clamp );
+	}
+
+	void testCache()
+	{
+		const Box box( 0, 0, 4, 4 );
+		const size_t tileSize = box.width() * box.height() * sizeof( float );
+		TileCache cache( tileSize * 2 );
+
+		Hash h1, h2, h3;
+		h1.append( 1 );
+		h2.append( 2 );
+		h3.append( 3 );
+		
+		ConstTilePtr t1( new Tile( box, ChannelSet( Mask_Red ) ) );
+		ConstTilePtr t2( new Tile( box, ChannelSet( Mask_Red ) ) );
+		ConstTilePtr t3( new Tile( box, ChannelSet( Mask_Red ) ) );
+		
+		cache.insert( h1, t1 );
+		cache.insert( h2, t2 );
+		BOOST_CHECK_EQUAL( cache.size(), 2u );
+		BOOST_CHECK_EQUAL( cache.memoryUsage(), tileSize * 2 );
+		
+		// Tiles are shared rather than copied, and are found for any region and channels that they cover.
+		BOOST_CHECK( cache.get( h1, box, ChannelSet( Mask_Red ) ) == t1 );
+		BOOST_CHECK( cache.get( h1, Box( 1, 1, 3, 2 ), ChannelSet( Mask_Red ) ) == t1 );
+		BOOST_CHECK( !cache.get( h1, Box( 1, 1, 5, 2 ), ChannelSet( Mask_Red ) ) );
+		BOOST_CHECK( !cache.get( h1, box, ChannelSet( Mask_Red | Mask_Green ) ) );
+		BOOST_CHECK( !cache.get( h3, box, ChannelSet( Mask_Red ) ) );
+		
+		// The least recently used tile is evicted to keep within the limit. t1 was used after t2.
+		cache.insert( h3, t3 );
+		BOOST_CHECK_EQUAL( cache.size(), 2u );
+		BOOST_CHECK_EQUAL( cache.memoryUsage(), tileSize * 2 );
+		BOOST_CHECK( cache.get( h1, box, ChannelSet( Mask_Red ) ) == t1 );
+		BOOST_CHECK( !cache.get( h2, box, ChannelSet( Mask_Red ) ) );
+		BOOST_CHECK( cache.get( h3, box, ChannelSet( Mask_Red ) ) == t3 );
+
+		// Tiles that are larger than the limit aren't held.
+		cache.insert( h2, ConstTilePtr( new Tile( Box( 0, 0, 8, 8 ), ChannelSet( Mask_Red ) ) ) );
+		BOOST_CHECK( !cache.get( h2, box, ChannelSet( Mask_Red ) ) );
+
+		cache.setMemoryLimit( tileSize );
+		BOOST_CHECK_EQUAL( cache.size(), 1u );
+		BOOST_CHECK( cache.get( h3, box, ChannelSet( Mask_Red ) ) == t3 );
+
+		cache.clear();
+		BOOST_CHECK_EQUAL( cache.size(), 0u );
+		BOOST_CHECK_EQUAL( cache.memoryUsage(), 0u );
+	}
+
+	void testEvaluateWithCache()
+	{
+		boost::shared_ptr< FrameOp > source( new FrameOp );
+		boost::shared_ptr< Grade > grade( new Grade( 2.f, 1.f ) );
+		Clamp clamp( 0.f, 10000.f );
+		grade->setInput( 0, source );
+		clamp.setInput( 0, grade );
+
+		TileCache cache( 1024 * 1024 );
+		const Box box( 0, 0, 16, 8 );
+		Tile output( box, ChannelSet( Mask_Red | Mask_Blue ) );
+		evaluate( clamp, output, 2, true, &cache );
+		const int samples = source->m_samples;
+		BOOST_CHECK_EQUAL( samples, box.width() * box.height() * 2 );
+		BOOST_CHECK_EQUAL( output.sample( Chan_Blue, 3, 5 ), FrameOp::value( Chan_Blue, 3, 5, 0 ) * 2.f + 1.f );
+
+		// Evaluating the same graph again computes nothing, and neither does asking for less of it.
+		Tile again( box, ChannelSet( Mask_Red | Mask_Blue ) );
+		evaluate( clamp, again, 2, true, &cache );
+		BOOST_CHECK_EQUAL( source->m_samples, samples );
+		BOOST_CHECK( std::equal( output.row( Chan_Red, 2 ), output.row( Chan_Red, 2 ) + box.width(), again.row( Chan_Red, 2 ) ) );
+		
+		Tile part( Box( 2, 3, 5, 4 ), ChannelSet( Mask_Blue ) );
+		evaluate( clamp, part, 1, true, &cache );
+		BOOST_CHECK_EQUAL( source->m_samples, samples );
+		BOOST_CHECK_EQUAL( part.sample( Chan_Blue, 3, 3 ), output.sample( Chan_Blue, 3, 3 ) );
+
+		// Changing a parameter only recomputes the ops downstream of it.
+		grade->setGain( 3.f );
+		evaluate( clamp, output, 2, true, &cache );
+		BOOST_CHECK_EQUAL( output.sample( Chan_Red, 7, 1 ), FrameOp::value( Chan_Red, 7, 1, 0 ) * 3.f + 1.f );
+		BOOST_CHECK_EQUAL( source->m_samples, samples );
+		
+		// Changing the source recomputes everything.
+		source->m_frame = 1;
+		evaluate( clamp, output, 2, true, &cache );
+		BOOST_CHECK_EQUAL( output.sample( Chan_Red, 7, 1 ), FrameOp::value( Chan_Red, 7, 1, 1 ) * 3.f + 1.f );
+		BOOST_CHECK_EQUAL( source->m_samples, samples * 2 );
+
+		// Without a cache everything is computed every time.
+		evaluate( clamp, output, 2, true );
+		BOOST_CHECK_EQUAL( source->m_samples, samples * 3 );
+	}
+};
+
+struct TileCacheTestSuite : public boost::unit_test::test_suite
+{
+	TileCacheTestSuite() : boost::unit_test::test_suite( "TileCacheTestSuite" )
+	{
+		boost::shared_ptr<TileCacheTest> instance( new TileCacheTest() );
+		add( BOOST_CLASS_TEST_CASE( &TileCacheTest::testHash, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &TileCacheTest::testCache, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &TileCacheTest::testEvaluateWithCache, instance ) );
+	}
+};
+
+void addTileCacheTest( boost::unit_test::test_suite *test )
+{
+	test->add( new TileCacheTestSuite() );
+}
+
+} // namespace ImageTest
+
+} // namespace Gander
@@ -33,9 +33,14 @@
 //////////////////////////////////////////////////////////////////////////
 #include <iostream>
 #include <cstdlib>
+#include <vector>
+#include <algorithm>
 
 #include "Gander/AngleConversion.h"
 #include "GanderTest/AngleConversionTest.h"
+#include "GanderTest/TestTools.h"
+
+#include "Eigen/Geometry"
 
 #include "boost/test/floating_point_comparison.hpp"
 #include "boost/test/test_tools.hpp"
@@ -65,6 +70,94 @@ struct AngleConversionTest
 		BOOST_CHECK_EQUAL( radiansToDegrees( M_PI*2. ), 360. );
 		BOOST_CHECK_EQUAL( degreesToRadians( 720. ), M_PI*4. );
 	}
+
+	/// Converts enough values to be split across several threads and checks them against the scalar conversions.
+	void testArrayConversions()
+	{
+		try
+		{
+			srand(1);
+			const std::size_t n = 1 << 17;
+
+			// Degrees and radians.
+			std::vector< double > degrees( n ), radians( n ), result( n );
+			for( std::size_t i = 0; i < n; ++i )
+			{
+				degrees[i] = randomNumber( -720., 720. );
+			}
+
+			degreesToRadians( &degrees[0], &radians[0], n );
+			radiansToDegrees( &radians[0], &result[0], n );
+			double maxRadiansError = 0., maxDegreesError = 0.;
+			for( std::size_t i = 0; i < n; ++i )
+			{
+				maxRadiansError = std::max( maxRadiansError, std::fabs( radians[i] - degreesToRadians( degrees[i] ) ) );
+				maxDegreesError = std::max( maxDegreesError, std::fabs( result[i] - degrees[i] ) );
+			}
+			BOOST_CHECK_SMALL( maxRadiansError, 1e-14 );
+			BOOST_CHECK_SMALL( maxDegreesError, 1e-12 );
+
+			// Euler angles, rotation matrices and quaternions.
+			Eigen::Array< double, Eigen::Dynamic, 3 > angles( n, 3 );
+			for( std::size_t i = 0; i < n; ++i )
+			{
+				angles( i, 0 ) = randomNumber( -M_PI*.99, M_PI*.99 );
+				angles( i, 1 ) = randomNumber( -M_PI*.49, M_PI*.49 );
+				angles( i, 2 ) = randomNumber( -M_PI*.99, M_PI*.99 );
+			}
+
+			Eigen::Array< double, Eigen::Dynamic, 9 > matrices, quaternionMatrices;
+			Eigen::Array< double, Eigen::Dynamic, 3 > extractedAngles, quaternionAngles;
+			Eigen::Array< double, Eigen::Dynamic, 4 > quaternions, matrixQuaternions;
+			eulerAnglesToRotationMatrices( angles, matrices );
+			rotationMatricesToEulerAngles( matrices, extractedAngles );
+			eulerAnglesToQuaternions( angles, quaternions );
+			quaternionsToRotationMatrices( quaternions, quaternionMatrices );
+			quaternionsToEulerAngles( quaternions, quaternionAngles );
+			rotationMatricesToQuaternions( matrices, matrixQuaternions );
+
+			double maxMatrixError = 0., maxQuaternionError = 0., maxQuaternionMatrixError = 0., maxMatrixQuaternionError = 0.;
+			for( std::size_t i = 0; i < n; ++i )
+			{
+				Eigen::Quaterniond q;
+				q = Eigen::AngleAxisd( angles( i, 2 ), Eigen::Vector3d::UnitZ() )
+					* Eigen::AngleAxisd( angles( i, 1 ), Eigen::Vector3d::UnitY() )
+					* Eigen::AngleAxisd( angles( i, 0 ), Eigen::Vector3d::UnitX() );
+				Eigen::Matrix3d rotation( q.toRotationMatrix() );
+
+				for( unsigned int j = 0; j < 9; ++j )
+				{
+					maxMatrixError = std::max( maxMatrixError, std::fabs( matrices( i, j ) - rotation( j / 3, j % 3 ) ) );
+					maxQuaternionMatrixError = std::max( maxQuaternionMatrixError, std::fabs( quaternionMatrices( i, j ) - rotation( j / 3, j % 3 ) ) );
+				}
+
+				// The quaternions extracted from the matrices have a non-negative w.
+				const double sign = q.w() < 0. ? -1. : 1.;
+				for( unsigned int j = 0; j < 4; ++j )
+				{
+					maxQuaternionError = std::max( maxQuaternionError, std::fabs( quaternions( i, j ) - q.coeffs()( j ) ) );
+					maxMatrixQuaternionError = std::max( maxMatrixQuaternionError, std::fabs( matrixQuaternions( i, j ) - sign * q.coeffs()( j ) ) );
+				}
+			}
+
+			BOOST_CHECK_SMALL( maxMatrixError, 1e-14 );
+			BOOST_CHECK_SMALL( maxQuaternionError, 1e-14 );
+			BOOST_CHECK_SMALL( maxQuaternionMatrixError, 1e-14 );
+			BOOST_CHECK_SMALL( maxMatrixQuaternionError, 1e-14 );
+			BOOST_CHECK_SMALL( ( extractedAngles - angles ).abs().maxCoeff(), 1e-12 );
+			BOOST_CHECK_SMALL( ( quaternionAngles - angles ).abs().maxCoeff(), 1e-12 );
+
+			// Check the single precision versions against the double precision ones.
+			Eigen::Array< float, Eigen::Dynamic, 9 > matricesf;
+			eulerAnglesToRotationMatrices( Eigen::Array< float, Eigen::Dynamic, 3 >( angles.cast< float >() ), matricesf );
+			BOOST_CHECK_SMALL( ( matricesf.cast< double >() - matrices ).abs().maxCoeff(), 1e-5 );
+		}
+		catch ( std::exception &e ) 
+		{
+			BOOST_WARN( !e.what() );
+			BOOST_CHECK( !"Exception thrown during AngleConversionTest." );
+		}
+	}
 };
 
 struct AngleConversionTestSuite : public boost::unit_test::test_suite
@@ -73,6 +166,7 @@ struct AngleConversionTestSuite : public boost::unit_test::test_suite
 	{
 		boost::shared_ptr<AngleConversionTest> instance( new AngleConversionTest() );
 		add( BOOST_CLASS_TEST_CASE( &AngleConversionTest::testDegreesToRadians, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &AngleConversionTest::testArrayConversions, instance ) );
 	}
 };
 
@@ -0,0 +1,144 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "boost/bind.hpp"
+#include "boost/thread.hpp"
+
+#include "Gander/BoundedQueue.h"
+#include "GanderTest/BoundedQueueTest.h"
+
+#include "boost/test/test_tools.hpp"
+
+using namespace Gander;
+using namespace Gander::Test;
+using namespace boost;
+using namespace boost::unit_test;
+
+namespace Gander
+{
+
+namespace Test
+{
+
+struct BoundedQueueTest
+{
+	void testPushAndPop()
+	{
+		BoundedQueue< int > queue( 3 );
+		BOOST_CHECK_EQUAL( queue.capacity(), 3u );
+		BOOST_CHECK( queue.empty() );
+
+		int value = 0;
+		BOOST_CHECK( !queue.pop( value ) );
+		
+		BOOST_CHECK( queue.push( 1 ) );
+		BOOST_CHECK( queue.push( 2 ) );
+		BOOST_CHECK( queue.push( 3 ) );
+		BOOST_CHECK( !queue.push( 4 ) );
+		BOOST_CHECK_EQUAL( queue.size(), 3u );
+
+		BOOST_CHECK( queue.pop( value ) );
+		BOOST_CHECK_EQUAL( value, 1 );
+		
+		// Wrap around the end of the buffer.
+		BOOST_CHECK( queue.push( 4 ) );
+		BOOST_CHECK_EQUAL( queue.size(), 3u );
+		for( int i = 2; i <= 4; ++i )
+		{
+			BOOST_CHECK( queue.pop( value ) );
+			BOOST_CHECK_EQUAL( value, i );
+		}
+		BOOST_CHECK( queue.empty() );
+		BOOST_CHECK( !queue.pop( value ) );
+
+		queue.push( 5 );
+		queue.clear();
+		BOOST_CHECK( queue.empty() );
+
+		BOOST_CHECK_THROW( BoundedQueue< int >( 0 ), std::runtime_error );
+	}
+
+	static void produce( BoundedQueue< int > &queue, int count )
+	{
+		for( int i = 0; i < count; ++i )
+		{
+			while( !queue.push( i ) )
+			{
+				boost::this_thread::yield();
+			}
+		}
+	}
+
+	void testThreads()
+	{
+		const int count = 100000;
+		BoundedQueue< int > queue( 16 );
+		boost::thread producer( boost::bind( &BoundedQueueTest::produce, boost::ref( queue ), count ) );
+
+		// Every value arrives, in order.
+		bool ordered = true;
+		for( int i = 0; i < count; ++i )
+		{
+			int value = -1;
+			while( !queue.pop( value ) )
+			{
+				boost::this_thread::yield();
+			}
+			ordered &= value == i;
+		}
+		producer.join();
+		
+		BOOST_CHECK( ordered );
+		BOOST_CHECK( queue.empty() );
+	}
+};
+
+struct BoundedQueueTestSuite : public boost::unit_test::test_suite
+{
+	BoundedQueueTestSuite() : boost::unit_test::test_suite( "BoundedQueueTestSuite" )
+	{
+		boost::shared_ptr<BoundedQueueTest> instance( new BoundedQueueTest() );
+		add( BOOST_CLASS_TEST_CASE( &BoundedQueueTest::testPushAndPop, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &BoundedQueueTest::testThreads, instance ) );
+	}
+};
+
+void addBoundedQueueTest( boost::unit_test::test_suite *test )
+{
+	test->add( new BoundedQueueTestSuite() );
+}
+
+} // namespace Test
+
+} // namespace Gander
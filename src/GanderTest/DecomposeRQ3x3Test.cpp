@@ -125,6 +125,79 @@ namespace Test
 				BOOST_CHECK( !"Exception thrown during DecomposeRQ3x3Test." );
 			}
 		}
+
+		void testBatchedDecomposeRQ3x3()
+		{
+			try
+			{
+				srand(1);
+				
+				// Build a set of matrices from random rotations and calibration matrices and store them in a structure of arrays.
+				// The first matrix is the one which requires the validation check of givensDecomposeRQ3x3.
+				const unsigned int nMatrices = 1001;
+				Eigen::Array< double, Eigen::Dynamic, 9 > A( nMatrices, 9 );
+				for( unsigned int i = 0; i < nMatrices; ++i )
+				{
+					Eigen::Vector3d xyz;
+					Eigen::Matrix3d C;
+					if( i == 0 )
+					{
+						xyz << degreesToRadians( -90. ), degreesToRadians( 24.5916 ), degreesToRadians( -90. );
+						C << 1.94444, 0, 0, 0, 2.1875, 0, 0.0141111, 0.127, 1.;
+					}
+					else
+					{
+						xyz << randomNumber( -M_PI*.5, M_PI*.5 ), randomNumber( -M_PI*.5, M_PI*.5 ), randomNumber( -M_PI*.5, M_PI*.5 );
+						C << randomNumber( 0.1, 3. ), 0, 0, 0, randomNumber( 0.1, 3. ), 0, randomNumber( 0.1, 3. ), randomNumber( 0.1, 3. ), 1.;
+					}
+
+					Eigen::Matrix3d rotation;
+					rotation = Eigen::AngleAxisd( xyz[2], Eigen::Vector3d::UnitZ() )
+						* Eigen::AngleAxisd( xyz[1], Eigen::Vector3d::UnitY() )
+						* Eigen::AngleAxisd( xyz[0], Eigen::Vector3d::UnitX() );
+
+					Eigen::Matrix3d m( rotation * C );
+					for( unsigned int j = 0; j < 9; ++j )
+					{
+						A( i, j ) = m( j / 3, j % 3 );
+					}
+				}
+
+				// Decompose all of the matrices at once and compare them against the single matrix version.
+				Eigen::Array< double, Eigen::Dynamic, 9 > R, Q, Qx, Qy, Qz;
+				givensDecomposeRQ3x3( A, R, Q, &Qx, &Qy, &Qz );
+
+				for( unsigned int i = 0; i < nMatrices; ++i )
+				{
+					Eigen::Matrix3d a, r, q, qx, qy, qz;
+					for( unsigned int j = 0; j < 9; ++j )
+					{
+						a( j / 3, j % 3 ) = A( i, j );
+					}
+					givensDecomposeRQ3x3( a, r, q, qx, qy, qz );
+
+					for( unsigned int j = 0; j < 9; ++j )
+					{
+						BOOST_CHECK_SMALL( R( i, j ) - r( j / 3, j % 3 ), 10e-10 );
+						BOOST_CHECK_SMALL( Q( i, j ) - q( j / 3, j % 3 ), 10e-10 );
+						BOOST_CHECK_SMALL( Qx( i, j ) - qx( j / 3, j % 3 ), 10e-10 );
+						BOOST_CHECK_SMALL( Qy( i, j ) - qy( j / 3, j % 3 ), 10e-10 );
+						BOOST_CHECK_SMALL( Qz( i, j ) - qz( j / 3, j % 3 ), 10e-10 );
+					}
+				}
+
+				// Check that the results are the same when the Givens rotations aren't requested.
+				Eigen::Array< double, Eigen::Dynamic, 9 > R2, Q2;
+				givensDecomposeRQ3x3( A, R2, Q2 );
+				BOOST_CHECK( ( R2 == R ).all() );
+				BOOST_CHECK( ( Q2 == Q ).all() );
+			}
+			catch ( std::exception &e ) 
+			{
+				BOOST_WARN( !e.what() );
+				BOOST_CHECK( !"Exception thrown during DecomposeRQ3x3Test." );
+			}
+		}
 	};
 
 	struct DecomposeRQ3x3TestSuite : public boost::unit_test::test_suite
@@ -133,6 +206,7 @@ namespace Test
 		{
 			boost::shared_ptr<DecomposeRQ3x3Test> instance( new DecomposeRQ3x3Test() );
 			add( BOOST_CLASS_TEST_CASE( &DecomposeRQ3x3Test::testDecomposeRQ3x3, instance ) );
+			add( BOOST_CLASS_TEST_CASE( &DecomposeRQ3x3Test::testBatchedDecomposeRQ3x3, instance ) );
 		}
 	};
 
@@ -43,12 +43,19 @@
 
 #include "GanderTest/LevenbergMarquardtTest.h"
 #include "GanderTest/HomographyTest.h"
+#include "GanderTest/RANSACTest.h"
 #include "GanderTest/AngleConversionTest.h"
+#include "GanderTest/HalfTest.h"
+#include "GanderTest/SampleConversionTest.h"
+#include "GanderTest/PackedBitsTest.h"
+#include "GanderTest/UpsampleTest.h"
 #include "GanderTest/DecomposeRQ3x3Test.h"
 #include "GanderTest/CommonTest.h"
 #include "GanderTest/EnumHelperTest.h"
 #include "GanderTest/BitTwiddlerTest.h"
 #include "GanderTest/TupleTest.h"
+#include "GanderTest/BoundedQueueTest.h"
+#include "GanderTest/ThreadPoolTest.h"
 #include "GanderTest/InterfacesTest.h"
 #include "GanderTest/CurveSolverTest.h"
 #include "GanderTest/ParameterizedModelTest.h"
@@ -67,12 +74,19 @@ test_suite* init_unit_test_suite( int argc, char* argv[] )
 	{
 		addLevenbergMarquardtTest(test);
 		addHomographyTest(test);
-//		addDecomposeRQ3x3Test(test);
+		addRANSACTest(test);
+		addDecomposeRQ3x3Test(test);
 		addAngleConversionTest(test);
+		addHalfTest(test);
+		addSampleConversionTest(test);
+		addPackedBitsTest(test);
+		addUpsampleTest(test);
 		addCommonTest(test);
 		addEnumHelperTest(test);
 		addBitTwiddlerTest(test);
 		addTupleTest(test);
+		addBoundedQueueTest(test);
+		addThreadPoolTest(test);
 		addInterfacesTest(test);
 		addCurveSolverTest(test);
 		addParameterizedModelTest(test);
@@ -0,0 +1,162 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+
+#include "Gander/Half.h"
+#include "GanderTest/HalfTest.h"
+
+#include "boost/test/floating_point_comparison.hpp"
+#include "boost/test/test_tools.hpp"
+
+using namespace Gander;
+using namespace Gander::Test;
+using namespace boost;
+using namespace boost::unit_test;
+
+namespace Gander
+{
+
+namespace Test
+{
+
+struct HalfTest
+{
+	void testHalfConversion()
+	{
+		try
+		{
+			// Every half other than a NaN should survive a round trip through a float unchanged.
+			for( unsigned int i = 0; i < 0x10000; ++i )
+			{
+				const int16u bits = int16u( i );
+				const float f = halfBitsToFloat( bits );
+				if( std::isnan( f ) )
+				{
+					BOOST_CHECK( ( bits & 0x7c00 ) == 0x7c00 && ( bits & 0x3ff ) != 0 );
+					BOOST_CHECK( std::isnan( float( half( f ) ) ) );
+				}
+				else
+				{
+					BOOST_CHECK_EQUAL( floatToHalfBits( f ), bits );
+				}
+			}
+
+			BOOST_CHECK_EQUAL( float( half( 1.f ) ), 1.f );
+			BOOST_CHECK_EQUAL( float( half( -2.5f ) ), -2.5f );
+			BOOST_CHECK_EQUAL( float( half( 65504.f ) ), 65504.f );
+			BOOST_CHECK( std::isinf( float( half( 65520.f ) ) ) );
+			BOOST_CHECK( std::isinf( float( half( 1e10f ) ) ) );
+			BOOST_CHECK_EQUAL( half( 1e-10f ).bits(), int16u( 0 ) );
+			BOOST_CHECK_EQUAL( half( -1e-10f ).bits(), int16u( 0x8000 ) );
+			BOOST_CHECK_EQUAL( float( half( 5.9604644775390625e-8f ) ), 5.9604644775390625e-8f );
+
+			// Ties round to the nearest even half. The halfs either side of 1 are 1 - 2^-11 and 1 + 2^-10.
+			BOOST_CHECK_EQUAL( half( 1.f + std::ldexp( 1.f, -11 ) ).bits(), half( 1.f ).bits() );
+			BOOST_CHECK_EQUAL( half( 1.f + 3.f * std::ldexp( 1.f, -11 ) ).bits(), half( 1.f + std::ldexp( 1.f, -9 ) ).bits() );
+			BOOST_CHECK_EQUAL( half( 1.f + std::ldexp( 1.f, -11 ) + std::ldexp( 1.f, -20 ) ).bits(), half( 1.f + std::ldexp( 1.f, -10 ) ).bits() );
+			BOOST_CHECK_EQUAL( half( 3.f * std::ldexp( 1.f, -25 ) ).bits(), int16u( 2 ) );
+
+			half h( 2.f );
+			h += 1.f;
+			h *= 2.f;
+			BOOST_CHECK_EQUAL( float( h ), 6.f );
+			BOOST_CHECK( h == half( 6.f ) );
+			BOOST_CHECK( h != half( 5.f ) );
+		}
+		catch ( std::exception &e ) 
+		{
+			BOOST_WARN( !e.what() );
+			BOOST_CHECK( !"Exception thrown during HalfTest." );
+		}
+	}
+
+	void testArrayConversion()
+	{
+		try
+		{
+			// Use a length that isn't a multiple of the vector width so that the remainder is tested too.
+			const std::size_t n = 1003;
+			std::vector< float > src( n ), result( n );
+			std::vector< half > halfs( n );
+			for( std::size_t i = 0; i < n; ++i )
+			{
+				src[i] = ( float( rand() ) / float( RAND_MAX ) - .5f ) * std::ldexp( 1.f, int( i % 40 ) - 24 );
+			}
+			src[0] = 65520.f;
+			src[1] = -1e-10f;
+			src[2] = 1.f + std::ldexp( 1.f, -11 );
+
+			convertFloatToHalf( &src[0], &halfs[0], n );
+			for( std::size_t i = 0; i < n; ++i )
+			{
+				BOOST_CHECK_EQUAL( halfs[i].bits(), floatToHalfBits( src[i] ) );
+			}
+
+			convertHalfToFloat( &halfs[0], &result[0], n );
+			for( std::size_t i = 0; i < n; ++i )
+			{
+				BOOST_CHECK_EQUAL( result[i], halfBitsToFloat( halfs[i].bits() ) );
+			}
+		}
+		catch ( std::exception &e ) 
+		{
+			BOOST_WARN( !e.what() );
+			BOOST_CHECK( !"Exception thrown during HalfTest." );
+		}
+	}
+};
+
+struct HalfTestSuite : public boost::unit_test::test_suite
+{
+	HalfTestSuite() : boost::unit_test::test_suite( "HalfTestSuite" )
+	{
+		boost::shared_ptr<HalfTest> instance( new HalfTest() );
+		add( BOOST_CLASS_TEST_CASE( &HalfTest::testHalfConversion, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &HalfTest::testArrayConversion, instance ) );
+	}
+};
+
+void addHalfTest( boost::unit_test::test_suite *test )
+{
+	test->add( new HalfTestSuite( ) );
+}
+
+}; // namespace Test
+
+}; // namespace Gander
+
@@ -32,9 +32,11 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <iostream>
 #include <cstdlib>
 
+#include "GanderTest/Benchmark.h"
 #include "GanderTest/HomographyTest.h"
 #include "Gander/Math.h"
 #include "Gander/Homography.h"
@@ -90,6 +92,36 @@ void testMatrices( Eigen::MatrixXd &matrix1, Eigen::MatrixXd &matrix2, int inlie
 	}
 }
 
+/// Builds correspondences that lie on each of several planes, in order, followed by some outliers.
+void planeMatrices( Eigen::MatrixXd &points1, Eigen::MatrixXd &points2, const Eigen::Transform<double, 2, Eigen::Affine> *transforms,
+	const int *nPointsPerPlane, int nPlanes, int nOutliers )
+{
+	srand(1);
+
+	int nPoints( nOutliers );
+	for( int plane = 0; plane < nPlanes; ++plane )
+	{
+		nPoints += nPointsPerPlane[plane];
+	}
+	points1.resize( 2, nPoints );
+	points2.resize( 2, nPoints );
+
+	for( int plane = 0, i = 0; plane < nPlanes; ++plane )
+	{
+		for( int j = 0; j < nPointsPerPlane[plane]; ++j, ++i )
+		{
+			Eigen::Vector2d p1( ( rand() % 1000 ) / 100., ( rand() % 1000 ) / 100. );
+			points1.col(i) = p1;
+			points2.col(i) = transforms[plane] * p1;
+		}
+	}
+	for( int i = nPoints - nOutliers; i < nPoints; ++i )
+	{
+		points1.col(i) = Eigen::Vector2d( ( rand() % 1000 ) / 100., ( rand() % 1000 ) / 100. );
+		points2.col(i) = Eigen::Vector2d( ( rand() % 1000 ) / 100., ( rand() % 1000 ) / 100. );
+	}
+}
+
 struct HomographyTest
 {
 	void testFourPointHomography()
@@ -215,6 +247,160 @@ struct HomographyTest
 			BOOST_CHECK( !"Exception thrown during HomographyTest." );
 		}
 	}
+
+	// Test that the single and mixed precision versions of the RANSAC agree with the double precision version.
+	void testMixedPrecisionHomographyRANSAC()
+	{
+		try
+		{
+			double angleInRadians = 40 * 0.0174532925;
+			Eigen::Rotation2D<double> rotation( angleInRadians );
+			Eigen::Translation2d translation( -1.1, 3.2 );
+			Eigen::Transform<double, 2, Eigen::Affine> transform( translation * rotation );
+			
+			Eigen::MatrixXd points1, points2, H;
+			testMatrices( points1, points2, 20, 9, true, transform );
+	
+			std::vector<bool> mask;
+			BOOST_CHECK( computePlaneToPlaneHomography( points1, points2, H, mask, 1 ) );
+
+			// The single precision version should be close to the double precision one.
+			Eigen::MatrixXf points1f( points1.cast<float>() ), points2f( points2.cast<float>() ), Hf;
+			std::vector<bool> maskf;
+			BOOST_CHECK( computePlaneToPlaneHomography( points1f, points2f, Hf, maskf, 1 ) );
+			BOOST_CHECK( Hf.cast<double>().isApprox( H, 1e-2 ) );
+
+			// Whereas the mixed precision version should find the same inliers and match to within the accuracy of the least squares fit.
+			Eigen::MatrixXd Hm;
+			std::vector<bool> maskm;
+			BOOST_CHECK( computePlaneToPlaneHomographyMixedPrecision( points1, points2, Hm, maskm, 1 ) );
+			BOOST_CHECK( maskm == mask );
+			for( int j = 0; j < H.cols(); ++j )
+			{
+				for( int i = 0; i < H.rows(); ++i )
+				{
+					BOOST_CHECK_SMALL( fabs( Hm(i,j) - H(i,j) ), 10e-8 );
+				}
+			}
+		}
+		catch ( std::exception &e ) 
+		{
+			BOOST_WARN( !e.what() );
+			BOOST_CHECK( !"Exception thrown during HomographyTest." );
+		}
+	}
+
+	// Test the extraction of several homographies from a shared set of points.
+	void testMultipleHomographyRANSAC()
+	{
+		try
+		{
+			// Build two different transforms, one for each of the planes.
+			Eigen::Transform<double, 2, Eigen::Affine> transforms[2] = {
+				Eigen::Transform<double, 2, Eigen::Affine>( Eigen::Translation2d( -1.1, 3.2 ) * Eigen::Rotation2D<double>( 40 * 0.0174532925 ) ),
+				Eigen::Transform<double, 2, Eigen::Affine>( Eigen::Translation2d( 4., -2. ) * Eigen::Rotation2D<double>( -25 * 0.0174532925 ) )
+			};
+
+			// Create 30 correspondences on the first plane, 20 on the second and 10 outliers.
+			const int nPointsPerPlane[2] = { 30, 20 }, nOutliers = 10, nPoints = 60;
+			Eigen::MatrixXd points1, points2;
+			planeMatrices( points1, points2, transforms, nPointsPerPlane, 2, nOutliers );
+
+			std::vector<Eigen::MatrixXd> H;
+			std::vector<int> labels;
+			unsigned int nHomographies = computeMultiplePlaneToPlaneHomographies( points1, points2, H, labels, 3, .1 );
+			
+			// Both planes should have been found, largest first, and each point labelled with the plane it lies on.
+			BOOST_CHECK_EQUAL( nHomographies, 2u );
+			BOOST_CHECK_EQUAL( H.size(), 2u );
+			BOOST_CHECK_EQUAL( labels.size(), (unsigned int)nPoints );
+			for( int i = 0; i < nPointsPerPlane[0] + nPointsPerPlane[1]; ++i )
+			{
+				BOOST_CHECK_EQUAL( labels[i], i < nPointsPerPlane[0] ? 0 : 1 );
+			}
+
+			for( unsigned int h = 0; h < H.size(); ++h )
+			{
+				for( int j = 0; j < 3; ++j )
+				{
+					for( int i = 0; i < 3; ++i )
+					{
+						BOOST_CHECK_SMALL( fabs( H[h](i,j) - transforms[h].matrix()(i,j) ), 10e-6 );
+					}
+				}
+			}
+		}
+		catch ( std::exception &e ) 
+		{
+			BOOST_WARN( !e.what() );
+			BOOST_CHECK( !"Exception thrown during HomographyTest." );
+		}
+	}
+
+	// Compare the extraction of several homographies together with extracting them one at a time
+	// with computePlaneToPlaneHomography(), removing the inliers of each before finding the next.
+	void testMultipleHomographyThroughput()
+	{
+		Eigen::Transform<double, 2, Eigen::Affine> transforms[3] = {
+			Eigen::Transform<double, 2, Eigen::Affine>( Eigen::Translation2d( -1.1, 3.2 ) * Eigen::Rotation2D<double>( 40 * 0.0174532925 ) ),
+			Eigen::Transform<double, 2, Eigen::Affine>( Eigen::Translation2d( 4., -2. ) * Eigen::Rotation2D<double>( -25 * 0.0174532925 ) ),
+			Eigen::Transform<double, 2, Eigen::Affine>( Eigen::Translation2d( .5, 7. ) * Eigen::Rotation2D<double>( 70 * 0.0174532925 ) )
+		};
+		const int nPointsPerPlane[3] = { 120, 90, 60 }, nOutliers = 30;
+		Eigen::MatrixXd points1, points2;
+		planeMatrices( points1, points2, transforms, nPointsPerPlane, 3, nOutliers );
+		const unsigned int maxHomographies = 3, minInliers = 8, runs = 20;
+		const double threshold = .1;
+
+		Benchmark benchmark( "HomographyTest", "extractions/s", double( runs ) );
+		unsigned int nMultiple = 0;
+		for( unsigned int run = 0; run < runs; ++run )
+		{
+			std::vector<Eigen::MatrixXd> H;
+			std::vector<int> labels;
+			nMultiple = computeMultiplePlaneToPlaneHomographies( points1, points2, H, labels, maxHomographies, threshold, minInliers );
+		}
+		benchmark.stop( "multiple" );
+
+		benchmark.start();
+		unsigned int nSerial = 0;
+		for( unsigned int run = 0; run < runs; ++run )
+		{
+			Eigen::MatrixXd remaining1( points1 ), remaining2( points2 );
+			for( nSerial = 0; nSerial < maxHomographies && remaining1.cols() >= int( minInliers ); ++nSerial )
+			{
+				Eigen::MatrixXd H;
+				std::vector<bool> mask;
+				if( !computePlaneToPlaneHomography( remaining1, remaining2, H, mask, threshold ) )
+				{
+					break;
+				}
+
+				const int nInliers = int( std::count( mask.begin(), mask.end(), true ) );
+				if( nInliers < int( minInliers ) )
+				{
+					break;
+				}
+				
+				Eigen::MatrixXd outliers1( 2, remaining1.cols() - nInliers ), outliers2( 2, remaining2.cols() - nInliers );
+				for( int i = 0, j = 0; i < remaining1.cols(); ++i )
+				{
+					if( !mask[i] )
+					{
+						outliers1.col(j) = remaining1.col(i);
+						outliers2.col(j++) = remaining2.col(i);
+					}
+				}
+				remaining1.swap( outliers1 );
+				remaining2.swap( outliers2 );
+			}
+		}
+		benchmark.stop( "serial" );
+		benchmark.report();
+
+		BOOST_CHECK_EQUAL( nMultiple, 3u );
+		BOOST_CHECK_EQUAL( nSerial, 3u );
+	}
 };
 
 struct HomographyTestSuite : public boost::unit_test::test_suite
@@ -225,6 +411,9 @@ struct HomographyTestSuite : public boost::unit_test::test_suite
 		add( BOOST_CLASS_TEST_CASE( &HomographyTest::testFourPointHomography, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &HomographyTest::testHomographyRefinement, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &HomographyTest::testHomographyRANSAC, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &HomographyTest::testMixedPrecisionHomographyRANSAC, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &HomographyTest::testMultipleHomographyRANSAC, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &HomographyTest::testMultipleHomographyThroughput, instance ) );
 	}
 };
 
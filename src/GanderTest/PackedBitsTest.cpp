@@ -0,0 +1,198 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+
+#include "Gander/PackedBits.h"
+#include "GanderTest/PackedBitsTest.h"
+
+#include "boost/test/floating_point_comparison.hpp"
+#include "boost/test/test_tools.hpp"
+
+using namespace Gander;
+using namespace Gander::Test;
+using namespace boost;
+using namespace boost::unit_test;
+
+namespace Gander
+{
+
+namespace Test
+{
+
+struct PackedBitsTest
+{
+	/// Returns the value of element i from a stream of WIDTH bit values by reading it one bit at a time.
+	template< unsigned WIDTH >
+	static int16u readBits( const std::vector< int8u > &data, std::size_t bit, std::size_t i )
+	{
+		int16u value = 0;
+		for( unsigned int b = 0; b < WIDTH; ++b )
+		{
+			const std::size_t position = bit + i * WIDTH + b;
+			value |= int16u( ( data[position >> 3] >> ( position & 7 ) ) & 1 ) << b;
+		}
+		return value;
+	}
+
+	template< unsigned WIDTH >
+	void testPackedBitsPointer()
+	{
+		const std::size_t n = 100;
+		std::vector< int8u > data( ( n * WIDTH ) / 8 + 2, 0xff );
+		std::vector< int16u > values( n );
+
+		for( unsigned int bit = 0; bit < 8; ++bit )
+		{
+			std::fill( data.begin(), data.end(), int8u( 0xff ) );
+			PackedBitsPointer< WIDTH > p( &data[0], bit );
+			for( std::size_t i = 0; i < n; ++i )
+			{
+				values[i] = int16u( rand() ) & PackedBits< WIDTH >::MaximumValue;
+				p[i] = values[i];
+			}
+
+			// The bits that precede the first value should be untouched.
+			BOOST_CHECK_EQUAL( data[0] & ( ( 1u << bit ) - 1 ), int( ( 1u << bit ) - 1 ) );
+
+			PackedBitsPointer< WIDTH > it( &data[0], bit );
+			for( std::size_t i = 0; i < n; ++i, ++it )
+			{
+				BOOST_CHECK_EQUAL( int16u( *it ), values[i] );
+				BOOST_CHECK_EQUAL( readBits< WIDTH >( data, bit, i ), values[i] );
+			}
+
+			BOOST_CHECK( ( it - n ) == PackedBitsPointer< WIDTH >( &data[0], bit ) );
+			BOOST_CHECK( ( p + 8 ).data() == &data[WIDTH] );
+		}
+
+		// A value held by itself in an int16u is written whole and masked to WIDTH bits.
+		int16u value;
+		PackedBitsReference< WIDTH > reference( value );
+		reference = 0xffff;
+		BOOST_CHECK_EQUAL( value, int16u( PackedBits< WIDTH >::MaximumValue ) );
+		BOOST_CHECK_EQUAL( int16u( reference ), int16u( PackedBits< WIDTH >::MaximumValue ) );
+	}
+
+	template< unsigned WIDTH >
+	void testPackUnpack()
+	{
+		// Use a length that isn't a multiple of the vector width so that the remainder is tested too.
+		const std::size_t n = 1003;
+		std::vector< float > src( n ), result( n );
+		for( std::size_t i = 0; i < n; ++i )
+		{
+			src[i] = float( rand() ) / float( RAND_MAX ) * 1.2f - .1f;
+		}
+
+		for( unsigned int bit = 0; bit < 8; bit += 3 )
+		{
+			std::vector< int8u > data( ( bit + n * WIDTH ) / 8 + 2, 0xff );
+			PackedBitsPointer< WIDTH > p( &data[0], bit );
+			packFloatToBits( &src[0], p, n );
+
+			// The bits either side of the packed values should be untouched.
+			BOOST_CHECK_EQUAL( data[0] & ( ( 1u << bit ) - 1 ), int( ( 1u << bit ) - 1 ) );
+			BOOST_CHECK_EQUAL( int( data.back() ), 0xff );
+
+			for( std::size_t i = 0; i < n; ++i )
+			{
+				const float clamped = std::min( std::max( src[i], 0.f ), 1.f );
+				const int16u expected = int16u( nearbyintf( clamped * float( PackedBits< WIDTH >::MaximumValue ) ) );
+				BOOST_CHECK_EQUAL( int16u( p[i] ), expected );
+			}
+
+			unpackBitsToFloat( p, &result[0], n );
+			const float scale = 1.f / float( PackedBits< WIDTH >::MaximumValue );
+			for( std::size_t i = 0; i < n; ++i )
+			{
+				BOOST_CHECK_EQUAL( result[i], float( int16u( p[i] ) ) * scale );
+			}
+		}
+
+		// Packing an empty row shouldn't touch the destination at all.
+		packFloatToBits( &src[0], PackedBitsPointer< WIDTH >(), 0 );
+	}
+
+	void testPackedBits()
+	{
+		try
+		{
+			testPackedBitsPointer< 10 >();
+			testPackedBitsPointer< 12 >();
+		}
+		catch ( std::exception &e ) 
+		{
+			BOOST_WARN( !e.what() );
+			BOOST_CHECK( !"Exception thrown during PackedBitsTest." );
+		}
+	}
+
+	void testRowConversion()
+	{
+		try
+		{
+			testPackUnpack< 10 >();
+			testPackUnpack< 12 >();
+		}
+		catch ( std::exception &e ) 
+		{
+			BOOST_WARN( !e.what() );
+			BOOST_CHECK( !"Exception thrown during PackedBitsTest." );
+		}
+	}
+};
+
+struct PackedBitsTestSuite : public boost::unit_test::test_suite
+{
+	PackedBitsTestSuite() : boost::unit_test::test_suite( "PackedBitsTestSuite" )
+	{
+		boost::shared_ptr<PackedBitsTest> instance( new PackedBitsTest() );
+		add( BOOST_CLASS_TEST_CASE( &PackedBitsTest::testPackedBits, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &PackedBitsTest::testRowConversion, instance ) );
+	}
+};
+
+void addPackedBitsTest( boost::unit_test::test_suite *test )
+{
+	test->add( new PackedBitsTestSuite( ) );
+}
+
+}; // namespace Test
+
+}; // namespace Gander
+
@@ -0,0 +1,250 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+
+#include "GanderTest/RANSACTest.h"
+#include "GanderTest/TestTools.h"
+#include "Gander/Math.h"
+#include "Gander/RANSAC.h"
+
+#include "boost/test/floating_point_comparison.hpp"
+#include "boost/test/test_tools.hpp"
+
+using namespace Gander;
+using namespace Gander::Test;
+using namespace boost;
+using namespace boost::unit_test;
+
+namespace Gander
+{
+
+namespace Test
+{
+
+namespace Detail
+{
+
+/// A simple RANSAC estimator which fits the line y = a * x + b to a set of points.
+/// The x coordinates are held in points1 and the y coordinates in points2. The model is the 2x1 matrix [a, b].
+class LineEstimator : public Gander::RANSAC
+{
+
+	public :
+
+		LineEstimator() : RANSAC( 2, 1 ) {}
+
+	protected :
+
+		virtual int runKernel( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, Eigen::MatrixXd &model )
+		{
+			double dx = points1(0,1) - points1(0,0);
+			if( fabs( dx ) < std::numeric_limits<double>::epsilon() )
+			{
+				return 0;
+			}
+			model(0,0) = ( points2(0,1) - points2(0,0) ) / dx;
+			model(1,0) = points2(0,0) - model(0,0) * points1(0,0);
+			return 1;
+		}
+
+		virtual double computeModelError( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, const Eigen::MatrixXd &model, Eigen::VectorXd &error )
+		{
+			const unsigned int nPoints = points1.cols();
+			error.resize( nPoints );
+			double sum = 0.;
+			for( unsigned int i = 0; i < nPoints; ++i )
+			{
+				double err = points2(0,i) - ( model(0,0) * points1(0,i) + model(1,0) );
+				sum += error[i] = err * err;
+			}
+			return sum / double( nPoints );
+		}
+
+		virtual bool runLeastSquaresKernel( const Eigen::MatrixXd &points1, const Eigen::MatrixXd &points2, Eigen::MatrixXd &model )
+		{
+			const unsigned int nPoints = points1.cols();
+			Eigen::MatrixXd A( nPoints, 2 );
+			A.col(0) = points1.row(0).transpose();
+			A.col(1).setOnes();
+			model = A.jacobiSvd( Eigen::ComputeThinU | Eigen::ComputeThinV ).solve( points2.row(0).transpose() );
+			return true;
+		}
+
+};
+
+} // namespace Detail
+
+struct RANSACTest
+{
+	void createLinePoints( Eigen::MatrixXd &x, Eigen::MatrixXd &y, int inliers, int outliers )
+	{
+		srand(1);
+		x.resize( 1, inliers + outliers );
+		y.resize( 1, inliers + outliers );
+		for( int i = 0; i < inliers; ++i )
+		{
+			x(0,i) = randomNumber( -10., 10. );
+			y(0,i) = 2. * x(0,i) + 3. + randomNumber( -.1, .1 );
+		}
+		for( int i = inliers; i < inliers + outliers; ++i )
+		{
+			x(0,i) = randomNumber( -10., 10. );
+			y(0,i) = randomNumber( -30., 30. );
+		}
+	}
+
+	// Checks that the local optimization finds at least as many inliers in fewer iterations.
+	void testLocalOptimization()
+	{
+		try
+		{
+			Eigen::MatrixXd x, y;
+			createLinePoints( x, y, 150, 150 );
+
+			Detail::LineEstimator estimator;
+			estimator.setThreshold( .1 );
+			estimator.setSeed( 3 );
+
+			Eigen::MatrixXd model( 2, 1 );
+			std::vector<bool> mask;
+			estimator.setLocalOptimization( false );
+			BOOST_CHECK( estimator( x, y, model, mask ) );
+			int plainIterations = estimator.getIterationsRun();
+			int plainInliers = std::count( mask.begin(), mask.end(), true );
+
+			Eigen::MatrixXd loModel( 2, 1 );
+			std::vector<bool> loMask;
+			estimator.setLocalOptimization( true );
+			BOOST_CHECK( estimator( x, y, loModel, loMask ) );
+			int loIterations = estimator.getIterationsRun();
+			int loInliers = std::count( loMask.begin(), loMask.end(), true );
+
+			BOOST_CHECK( loIterations > 0 );
+			BOOST_CHECK( loIterations <= plainIterations );
+			BOOST_CHECK( loInliers >= plainInliers );
+			BOOST_CHECK_SMALL( loModel(0,0) - 2., 1e-2 );
+			BOOST_CHECK_SMALL( loModel(1,0) - 3., 1e-1 );
+
+			// None of the outliers should have made it into the consensus set.
+			for( unsigned int i = 150; i < loMask.size(); ++i )
+			{
+				if( loMask[i] )
+				{
+					BOOST_CHECK_SMALL( y(0,i) - ( 2. * x(0,i) + 3. ), .2 );
+				}
+			}
+		}
+		catch ( std::exception &e ) 
+		{
+			BOOST_WARN( !e.what() );
+			BOOST_CHECK( !"Exception thrown during RANSACTest." );
+		}
+	}
+
+	// Checks that the local optimization finds a strictly larger consensus set than any minimal sample can.
+	// The inliers lie alternately above and below the line by .06. A line through two points on the same side misses the
+	// other side by .12 and a line through two points on opposite sides tilts away from the points at one end, so with a
+	// threshold of .1 no minimal sample explains more than 84 of the 100 inliers. The least squares refit of the inliers of
+	// a tilted line passes closer between the two sides with every step and, given enough refits, explains all of them.
+	void testLocalOptimizationGrowsConsensus()
+	{
+		try
+		{
+			const int nInliers = 100, nOutliers = 50;
+			Eigen::MatrixXd x( 1, nInliers + nOutliers ), y( 1, nInliers + nOutliers );
+			for( int i = 0; i < nInliers; ++i )
+			{
+				x(0,i) = -10. + 20. * i / ( nInliers - 1 );
+				y(0,i) = 2. * x(0,i) + 3. + ( i % 2 ? -.06 : .06 );
+			}
+			for( int i = nInliers; i < nInliers + nOutliers; ++i )
+			{
+				// Keep the outliers well away from the line so that they can never join the consensus set.
+				x(0,i) = -10. + 20. * ( i - nInliers ) / ( nOutliers - 1 );
+				y(0,i) = 2. * x(0,i) + 3. + ( i % 2 ? -5. : 5. );
+			}
+
+			Detail::LineEstimator estimator;
+			estimator.setThreshold( .1 );
+			estimator.setSeed( 3 );
+			estimator.setMaxLocalOptimizationIterations( 20 );
+
+			Eigen::MatrixXd model( 2, 1 );
+			std::vector<bool> mask;
+			estimator.setLocalOptimization( false );
+			BOOST_CHECK( estimator( x, y, model, mask ) );
+			int plainInliers = std::count( mask.begin(), mask.end(), true );
+
+			Eigen::MatrixXd loModel( 2, 1 );
+			std::vector<bool> loMask;
+			estimator.setLocalOptimization( true );
+			BOOST_CHECK( estimator( x, y, loModel, loMask ) );
+			int loInliers = std::count( loMask.begin(), loMask.end(), true );
+
+			BOOST_CHECK( plainInliers < nInliers );
+			BOOST_CHECK( loInliers > plainInliers );
+			BOOST_CHECK_EQUAL( loInliers, nInliers );
+			for( int i = 0; i < nInliers; ++i )
+			{
+				BOOST_CHECK( loMask[i] );
+			}
+		}
+		catch ( std::exception &e ) 
+		{
+			BOOST_WARN( !e.what() );
+			BOOST_CHECK( !"Exception thrown during RANSACTest." );
+		}
+	}
+};
+
+struct RANSACTestSuite : public boost::unit_test::test_suite
+{
+	RANSACTestSuite() : boost::unit_test::test_suite( "RANSACTestSuite" )
+	{
+		boost::shared_ptr<RANSACTest> instance( new RANSACTest() );
+		add( BOOST_CLASS_TEST_CASE( &RANSACTest::testLocalOptimization, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &RANSACTest::testLocalOptimizationGrowsConsensus, instance ) );
+	}
+};
+
+void addRANSACTest( boost::unit_test::test_suite *test )
+{
+	test->add( new RANSACTestSuite( ) );
+}
+
+} // namespace Test
+
+} // namespace Gander
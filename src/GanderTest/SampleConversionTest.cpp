@@ -0,0 +1,236 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "Gander/SampleConversion.h"
+#include "GanderTest/SampleConversionTest.h"
+
+#include "boost/test/floating_point_comparison.hpp"
+#include "boost/test/test_tools.hpp"
+
+using namespace Gander;
+using namespace Gander::Test;
+using namespace boost;
+using namespace boost::unit_test;
+
+namespace Gander
+{
+
+namespace Test
+{
+
+struct SampleConversionTest
+{
+	void testSampleConversion()
+	{
+		try
+		{
+			const SampleConversion normalised( true );
+			const SampleConversion raw;
+			
+			BOOST_CHECK_EQUAL( convertSample< float >( int8u( 255 ), normalised ), 1.f );
+			BOOST_CHECK_EQUAL( convertSample< float >( int8u( 0 ), normalised ), 0.f );
+			BOOST_CHECK_EQUAL( convertSample< float >( int16u( 65535 ), normalised ), 1.f );
+			BOOST_CHECK_EQUAL( convertSample< float >( int8u( 200 ), raw ), 200.f );
+			
+			// Narrowing clamps and rounds to the nearest integer, with NaNs becoming zero.
+			BOOST_CHECK_EQUAL( convertSample< int8u >( 2.f, normalised ), int8u( 255 ) );
+			BOOST_CHECK_EQUAL( convertSample< int8u >( -1.f, normalised ), int8u( 0 ) );
+			BOOST_CHECK_EQUAL( convertSample< int8u >( 0.5f, normalised ), int8u( 128 ) );
+			BOOST_CHECK_EQUAL( convertSample< int8u >( std::nanf( "" ), normalised ), int8u( 0 ) );
+			BOOST_CHECK_EQUAL( convertSample< int8u >( 300.f, raw ), int8u( 255 ) );
+			BOOST_CHECK_EQUAL( convertSample< int8u >( 2.5f, raw ), int8u( 2 ) );
+			BOOST_CHECK_EQUAL( convertSample< int8u >( 3.5f, raw ), int8u( 4 ) );
+			BOOST_CHECK_EQUAL( convertSample< int16u >( 1e6f, raw ), int16u( 65535 ) );
+			
+			// Between the integer types the full ranges map onto each other.
+			BOOST_CHECK_EQUAL( convertSample< int16u >( int8u( 255 ), normalised ), int16u( 65535 ) );
+			BOOST_CHECK_EQUAL( convertSample< int16u >( int8u( 1 ), normalised ), int16u( 257 ) );
+			BOOST_CHECK_EQUAL( convertSample< int8u >( int16u( 257 * 7 ), normalised ), int8u( 7 ) );
+			BOOST_CHECK_EQUAL( convertSample< int16u >( int8u( 7 ), raw ), int16u( 7 ) );
+
+			// Halfs are floating point and aren't scaled.
+			BOOST_CHECK_EQUAL( float( convertSample< half >( int8u( 255 ), normalised ) ), 1.f );
+			BOOST_CHECK_EQUAL( float( convertSample< half >( int8u( 255 ), raw ) ), 255.f );
+			BOOST_CHECK_EQUAL( convertSample< int8u >( half( 0.5f ), normalised ), int8u( 128 ) );
+
+			// Every integer survives a round trip through a float.
+			for( unsigned int i = 0; i < 256; ++i )
+			{
+				BOOST_CHECK_EQUAL( convertSample< int8u >( convertSample< float >( int8u( i ), normalised ), normalised ), int8u( i ) );
+			}
+			for( unsigned int i = 0; i < 65536; i += 7 )
+			{
+				BOOST_CHECK_EQUAL( convertSample< int16u >( convertSample< float >( int16u( i ), normalised ), normalised ), int16u( i ) );
+			}
+		}
+		catch ( std::exception &e ) 
+		{
+			BOOST_WARN( !e.what() );
+			BOOST_CHECK( !"Exception thrown during SampleConversionTest." );
+		}
+	}
+
+	template< class S, class D >
+	void checkArrayConversion( const std::vector< S > &src, const SampleConversion &conversion )
+	{
+		std::vector< D > dst( src.size() );
+		convertSamples( &src[0], &dst[0], src.size(), conversion );
+
+		// The vectorised conversion matches the scalar one exactly.
+		bool equal = true;
+		for( std::size_t i = 0; i < src.size(); ++i )
+		{
+			const D expected( convertSample< D >( src[i], conversion, unsigned( i ) ) );
+			equal &= std::memcmp( &dst[i], &expected, sizeof( D ) ) == 0;
+		}
+		BOOST_CHECK( equal );
+	}
+
+	template< class S >
+	void checkArrayConversions( const std::vector< S > &src )
+	{
+		const SampleConversion conversions[4] = {
+			SampleConversion( true ), SampleConversion(), SampleConversion( true, RoundWithDither ), SampleConversion( false, RoundWithDither, 77 )
+		};
+		
+		for( unsigned int i = 0; i < 4; ++i )
+		{
+			checkArrayConversion< S, int8u >( src, conversions[i] );
+			checkArrayConversion< S, int16u >( src, conversions[i] );
+			checkArrayConversion< S, half >( src, conversions[i] );
+			checkArrayConversion< S, float >( src, conversions[i] );
+		}
+	}
+	
+	void testArrayConversion()
+	{
+		try
+		{
+			// Use a length that is longer than the internal buffer and isn't a multiple of the vector width.
+			const std::size_t n = 1003;
+			std::vector< float > floats( n );
+			std::vector< half > halfs( n );
+			std::vector< int8u > bytes( n );
+			std::vector< int16u > shorts( n );
+			for( std::size_t i = 0; i < n; ++i )
+			{
+				floats[i] = ( float( rand() ) / float( RAND_MAX ) ) * 1.2f - .1f;
+				floats[i] *= i % 2 ? 1.f : 300.f;
+				halfs[i] = floats[i];
+				bytes[i] = int8u( rand() );
+				shorts[i] = int16u( rand() );
+			}
+			floats[0] = std::nanf( "" );
+			floats[1] = 1e20f;
+			floats[2] = -1e20f;
+
+			checkArrayConversions( floats );
+			checkArrayConversions( halfs );
+			checkArrayConversions( bytes );
+			checkArrayConversions( shorts );
+		}
+		catch ( std::exception &e ) 
+		{
+			BOOST_WARN( !e.what() );
+			BOOST_CHECK( !"Exception thrown during SampleConversionTest." );
+		}
+	}
+
+	void testDither()
+	{
+		try
+		{
+			// A value that lies between two integers is rounded to a mix of both, averaging to the original value.
+			const std::size_t n = 4096;
+			std::vector< float > src( n, 100.25f );
+			std::vector< int8u > dst( n );
+			
+			convertSamples( &src[0], &dst[0], n, SampleConversion( false ) );
+			BOOST_CHECK_EQUAL( dst[0], int8u( 100 ) );
+			BOOST_CHECK_EQUAL( dst[n-1], int8u( 100 ) );
+
+			convertSamples( &src[0], &dst[0], n, SampleConversion( false, RoundWithDither ) );
+			double sum = 0.;
+			for( std::size_t i = 0; i < n; ++i )
+			{
+				BOOST_CHECK( dst[i] == 100 || dst[i] == 101 );
+				sum += dst[i];
+			}
+			BOOST_CHECK_CLOSE( sum / double( n ), 100.25, 0.1 );
+
+			// Values that are already integers are unchanged.
+			std::vector< float > integers( n );
+			for( std::size_t i = 0; i < n; ++i )
+			{
+				integers[i] = float( i % 256 );
+			}
+			convertSamples( &integers[0], &dst[0], n, SampleConversion( false, RoundWithDither ) );
+			bool equal = true;
+			for( std::size_t i = 0; i < n; ++i )
+			{
+				equal &= dst[i] == int8u( i % 256 );
+			}
+			BOOST_CHECK( equal );
+		}
+		catch ( std::exception &e ) 
+		{
+			BOOST_WARN( !e.what() );
+			BOOST_CHECK( !"Exception thrown during SampleConversionTest." );
+		}
+	}
+};
+
+struct SampleConversionTestSuite : public boost::unit_test::test_suite
+{
+	SampleConversionTestSuite() : boost::unit_test::test_suite( "SampleConversionTestSuite" )
+	{
+		boost::shared_ptr<SampleConversionTest> instance( new SampleConversionTest() );
+		add( BOOST_CLASS_TEST_CASE( &SampleConversionTest::testSampleConversion, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &SampleConversionTest::testArrayConversion, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &SampleConversionTest::testDither, instance ) );
+	}
+};
+
+void addSampleConversionTest( boost::unit_test::test_suite *test )
+{
+	test->add( new SampleConversionTestSuite( ) );
+}
+
+}; // namespace Test
+
+}; // namespace Gander
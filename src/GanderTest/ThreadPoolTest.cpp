@@ -0,0 +1,153 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "boost/bind.hpp"
+#include "boost/thread.hpp"
+
+#include "Gander/ThreadPool.h"
+#include "GanderTest/ThreadPoolTest.h"
+
+#include "boost/test/test_tools.hpp"
+
+using namespace Gander;
+using namespace Gander::Test;
+using namespace boost;
+using namespace boost::unit_test;
+
+namespace Gander
+{
+
+namespace Test
+{
+
+/// Counts the number of times that each element of a range is visited.
+struct CountVisits
+{
+	CountVisits( std::vector< int > &visits ) : m_visits( &visits ) {}
+
+	void operator()( std::size_t begin, std::size_t end ) const
+	{
+		for( std::size_t i = begin; i < end; ++i )
+		{
+			++(*m_visits)[i];
+		}
+	}
+
+	std::vector< int > *m_visits;
+};
+
+void throwError()
+{
+	throw std::runtime_error( "ThreadPoolTest: Expected error." );
+}
+
+void addOne( int *value )
+{
+	__sync_fetch_and_add( value, 1 );
+}
+
+struct ThreadPoolTest
+{
+	void testTasksRunConcurrently()
+	{
+		// Each task waits for all of the others, so this only returns if every task has a thread of its own.
+		ThreadPool pool;
+		boost::barrier barrier( 6 );
+		std::vector< ThreadPool::Task > tasks( 6, boost::bind( &boost::barrier::wait, &barrier ) );
+		pool.run( tasks );
+		BOOST_CHECK_EQUAL( pool.numberOfThreads(), 5u );
+
+		// The threads are reused by later calls.
+		int count = 0;
+		std::vector< ThreadPool::Task > counters( 6, boost::bind( &addOne, &count ) );
+		for( int i = 0; i < 10; ++i )
+		{
+			pool.run( counters );
+		}
+		BOOST_CHECK_EQUAL( count, 60 );
+		BOOST_CHECK_EQUAL( pool.numberOfThreads(), 5u );
+	}
+
+	void testErrors()
+	{
+		ThreadPool pool;
+		int count = 0;
+		std::vector< ThreadPool::Task > tasks( 4, boost::bind( &addOne, &count ) );
+		tasks[2] = &throwError;
+		BOOST_CHECK_THROW( pool.run( tasks ), std::runtime_error );
+		
+		// The other tasks still run.
+		BOOST_CHECK_EQUAL( count, 3 );
+	}
+
+	void testParallelFor()
+	{
+		// Every element is visited once, whether or not the range is split.
+		const std::size_t sizes[4] = { 0, 1, 1000, std::size_t( MinimumElementsPerThread ) * 5 + 3 };
+		for( int i = 0; i < 4; ++i )
+		{
+			std::vector< int > visits( sizes[i], 0 );
+			parallelFor( sizes[i], CountVisits( visits ) );
+			BOOST_CHECK( std::count( visits.begin(), visits.end(), 1 ) == std::ptrdiff_t( sizes[i] ) );
+
+			std::fill( visits.begin(), visits.end(), 0 );
+			parallelFor( sizes[i], CountVisits( visits ), 1, 7 );
+			BOOST_CHECK( std::count( visits.begin(), visits.end(), 1 ) == std::ptrdiff_t( sizes[i] ) );
+		}
+	}
+};
+
+struct ThreadPoolTestSuite : public boost::unit_test::test_suite
+{
+	ThreadPoolTestSuite() : boost::unit_test::test_suite( "ThreadPoolTestSuite" )
+	{
+		boost::shared_ptr<ThreadPoolTest> instance( new ThreadPoolTest() );
+		add( BOOST_CLASS_TEST_CASE( &ThreadPoolTest::testTasksRunConcurrently, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &ThreadPoolTest::testErrors, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &ThreadPoolTest::testParallelFor, instance ) );
+	}
+};
+
+void addThreadPoolTest( boost::unit_test::test_suite *test )
+{
+	test->add( new ThreadPoolTestSuite() );
+}
+
+} // namespace Test
+
+} // namespace Gander
@@ -33,6 +33,9 @@
 //////////////////////////////////////////////////////////////////////////
 #include <iostream>
 #include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <utility>
 
 #include "Gander/Tuple.h"
 #include "GanderTest/TupleTest.h"
@@ -82,6 +85,118 @@ void staticTupleTest()
 	}
 };
 
+template< class T, unsigned N >
+bool isHeldInline( const Tuple<T, N, true> &tuple )
+{
+	const char *data = reinterpret_cast< const char * >( tuple.begin() );
+	const char *self = reinterpret_cast< const char * >( &tuple );
+	return data >= self && data < self + sizeof( tuple );
+}
+
+template< class T, unsigned N >
+void dynamicTupleTest()
+{
+	typedef Tuple<T, N, true> TestTuple;
+	const unsigned int inlineElements = TestTuple::InlineElements;
+	
+	// The default constructor creates N elements.
+	TestTuple tuple;
+	BOOST_CHECK_EQUAL( N, tuple.size() );
+	BOOST_CHECK( isHeldInline( tuple ) );
+
+	// Test push_back() and insert() up to the inline capacity.
+	std::vector<T> values;
+	tuple.resize( 0 );
+	for( unsigned int i = 0; i < inlineElements; ++i )
+	{
+		T value = ( rand() % 100 ) / 7;
+		unsigned int index = rand() % ( values.size() + 1 );
+		values.insert( values.begin() + index, value );
+		tuple.insert( tuple.begin() + index, value );
+	}
+	BOOST_CHECK( isHeldInline( tuple ) );
+	BOOST_CHECK_EQUAL( inlineElements, tuple.capacity() );
+	BOOST_CHECK( std::equal( values.begin(), values.end(), tuple.begin() ) );
+
+	// A copy of an inline tuple is also held inline.
+	TestTuple inlineCopy( tuple );
+	BOOST_CHECK( isHeldInline( inlineCopy ) );
+	BOOST_CHECK( std::equal( values.begin(), values.end(), inlineCopy.begin() ) );
+
+	// Growing past the inline capacity moves the elements to the heap.
+	for( unsigned int i = 0; i < inlineElements * 3; ++i )
+	{
+		T value = ( rand() % 100 ) / 7;
+		values.push_back( value );
+		tuple.push_back( value );
+	}
+	BOOST_CHECK( !isHeldInline( tuple ) );
+	BOOST_CHECK_EQUAL( values.size(), tuple.size() );
+	BOOST_CHECK_EQUAL( int( values.size() ), int( tuple.end() - tuple.begin() ) );
+	BOOST_CHECK( std::equal( values.begin(), values.end(), tuple.begin() ) );
+
+	// Inserting an element of the tuple into itself must survive the reallocation.
+	while( tuple.size() < tuple.capacity() )
+	{
+		values.push_back( values[0] );
+		tuple.push_back( tuple[0] );
+	}
+	values.insert( values.begin() + 1, values.back() );
+	tuple.insert( tuple.begin() + 1, tuple[ tuple.size() - 1 ] );
+	BOOST_CHECK( std::equal( values.begin(), values.end(), tuple.begin() ) );
+
+	// Test copying and assigning a tuple that is held on the heap.
+	TestTuple heapCopy( tuple );
+	BOOST_CHECK( heapCopy.begin() != tuple.begin() );
+	BOOST_CHECK( std::equal( values.begin(), values.end(), heapCopy.begin() ) );
+	
+	inlineCopy = tuple;
+	BOOST_CHECK_EQUAL( values.size(), inlineCopy.size() );
+	BOOST_CHECK( std::equal( values.begin(), values.end(), inlineCopy.begin() ) );
+
+	// Moving a tuple that is held on the heap takes its elements without copying them.
+	const T *heapData = heapCopy.begin();
+	TestTuple moved( std::move( heapCopy ) );
+	BOOST_CHECK( moved.begin() == heapData );
+	BOOST_CHECK_EQUAL( 0u, heapCopy.size() );
+	BOOST_CHECK( isHeldInline( heapCopy ) );
+	BOOST_CHECK( std::equal( values.begin(), values.end(), moved.begin() ) );
+
+	// Moving an inline tuple copies its elements into the inline buffer of the other.
+	TestTuple small( 2 );
+	small[0] = T( 1 );
+	small[1] = T( 2 );
+	moved = std::move( small );
+	BOOST_CHECK( isHeldInline( moved ) );
+	BOOST_CHECK_EQUAL( 2u, moved.size() );
+	BOOST_CHECK( moved[0] == T( 1 ) && moved[1] == T( 2 ) );
+	BOOST_CHECK_EQUAL( 0u, small.size() );
+
+	// Test erase().
+	while( !values.empty() )
+	{
+		unsigned int index = rand() % values.size();
+		values.erase( values.begin() + index );
+		tuple.erase( tuple.begin() + index );
+		BOOST_CHECK_EQUAL( values.size(), tuple.size() );
+		BOOST_CHECK( std::equal( values.begin(), values.end(), tuple.begin() ) );
+	}
+
+	// Test that resize() zeros any new elements and clear() zeros all of them.
+	tuple.resize( 3 );
+	for( unsigned int i = 0; i < 3; ++i )
+	{
+		BOOST_CHECK( tuple[i] == T( 0 ) );
+		tuple[i] = T( i + 1 );
+	}
+	tuple.clear();
+	BOOST_CHECK_EQUAL( 3u, tuple.size() );
+	for( unsigned int i = 0; i < 3; ++i )
+	{
+		BOOST_CHECK( tuple[i] == T( 0 ) );
+	}
+};
+
 namespace Gander
 {
 
@@ -100,6 +215,17 @@ struct TupleTest
 		staticTupleTest< int, 17 >();
 		staticTupleTest< short, 12 >();
 	}
+	
+	void testDynamicTuple()
+	{
+		srand(1);
+
+		// Test a range of Tuple sizes and types.
+		dynamicTupleTest< float, 0 >();
+		dynamicTupleTest< double, 4 >();
+		dynamicTupleTest< int, 9 >();
+		dynamicTupleTest< unsigned char, 2 >();
+	}
 };
 
 struct TupleTestSuite : public boost::unit_test::test_suite
@@ -108,6 +234,7 @@ struct TupleTestSuite : public boost::unit_test::test_suite
 	{
 		boost::shared_ptr<TupleTest> instance( new TupleTest() );
 		add( BOOST_CLASS_TEST_CASE( &TupleTest::testStaticTuple, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &TupleTest::testDynamicTuple, instance ) );
 	}
 };
 
@@ -0,0 +1,162 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Luke Goddard. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Luke Goddard nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+#include "Gander/Upsample.h"
+#include "GanderTest/UpsampleTest.h"
+
+#include "boost/test/floating_point_comparison.hpp"
+#include "boost/test/test_tools.hpp"
+
+using namespace Gander;
+using namespace Gander::Test;
+using namespace boost;
+using namespace boost::unit_test;
+
+namespace Gander
+{
+
+namespace Test
+{
+
+struct UpsampleTest
+{
+	void testUpsampleNearest()
+	{
+		try
+		{
+			for( unsigned int ratio = 1; ratio <= 4; ++ratio )
+			{
+				for( std::size_t width = 0; width < 40; ++width )
+				{
+					const std::size_t srcWidth = ( width + ratio - 1 ) / ratio;
+					std::vector< float > src( srcWidth );
+					for( std::size_t i = 0; i < srcWidth; ++i )
+					{
+						src[i] = float( rand() ) / float( RAND_MAX );
+					}
+					
+					// The extra value at the end of dst should be left untouched.
+					std::vector< float > dst( width + 1, -1.f );
+					upsampleNearest( src.empty() ? NULL : &src[0], &dst[0], width, ratio );
+					for( std::size_t x = 0; x < width; ++x )
+					{
+						BOOST_CHECK_EQUAL( dst[x], src[x / ratio] );
+					}
+					BOOST_CHECK_EQUAL( dst[width], -1.f );
+				}
+			}
+		}
+		catch ( std::exception &e ) 
+		{
+			BOOST_WARN( !e.what() );
+			BOOST_CHECK( !"Exception thrown during UpsampleTest." );
+		}
+	}
+
+	void testUpsampleLinear()
+	{
+		try
+		{
+			for( unsigned int ratio = 1; ratio <= 4; ++ratio )
+			{
+				for( std::size_t width = 0; width < 40; ++width )
+				{
+					const std::size_t srcWidth = ( width + ratio - 1 ) / ratio;
+					std::vector< float > src( srcWidth );
+					for( std::size_t i = 0; i < srcWidth; ++i )
+					{
+						src[i] = float( rand() ) / float( RAND_MAX ) + 1.f;
+					}
+					
+					std::vector< float > dst( width + 1, -1.f );
+					upsampleLinear( src.empty() ? NULL : &src[0], &dst[0], width, ratio );
+					for( std::size_t x = 0; x < width; ++x )
+					{
+						// Find the two subsampled values either side of x, holding the values at the ends of the row.
+						const double s = ( double( x ) + .5 ) / double( ratio ) - .5;
+						const double i = std::floor( s );
+						const double f = s - i;
+						const int last = int( srcWidth ) - 1;
+						const double a = src[ std::min( std::max( int( i ), 0 ), last ) ];
+						const double b = src[ std::min( int( i ) + 1, last ) ];
+						BOOST_CHECK_CLOSE( double( dst[x] ), ( 1. - f ) * a + f * b, 1e-4 );
+					}
+					BOOST_CHECK_EQUAL( dst[width], -1.f );
+				}
+			}
+
+			// A ramp is reproduced exactly away from the ends of the row.
+			std::vector< float > ramp( 32 );
+			for( std::size_t i = 0; i < ramp.size(); ++i )
+			{
+				ramp[i] = float( i * 2 ) + .5f;
+			}
+			std::vector< float > dst( 64 );
+			upsampleLinear( &ramp[0], &dst[0], dst.size(), 2 );
+			for( std::size_t x = 1; x < dst.size() - 1; ++x )
+			{
+				BOOST_CHECK_EQUAL( dst[x], float( x ) );
+			}
+		}
+		catch ( std::exception &e ) 
+		{
+			BOOST_WARN( !e.what() );
+			BOOST_CHECK( !"Exception thrown during UpsampleTest." );
+		}
+	}
+};
+
+struct UpsampleTestSuite : public boost::unit_test::test_suite
+{
+	UpsampleTestSuite() : boost::unit_test::test_suite( "UpsampleTestSuite" )
+	{
+		boost::shared_ptr<UpsampleTest> instance( new UpsampleTest() );
+		add( BOOST_CLASS_TEST_CASE( &UpsampleTest::testUpsampleNearest, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &UpsampleTest::testUpsampleLinear, instance ) );
+	}
+};
+
+void addUpsampleTest( boost::unit_test::test_suite *test )
+{
+	test->add( new UpsampleTestSuite( ) );
+}
+
+}; // namespace Test
+
+}; // namespace Gander